@@ -47,6 +47,8 @@ typedef struct CdbExplain_StatInst
 	instr_time	firststart;		/* Start time of first iteration of node */
 	double		peakMemBalance; /* Max mem account balance */
 	int			numPartScanned; /* Number of part tables scanned */
+	int			codegenCacheHits;	/* Compiled codegen modules found in cache */
+	int			codegenCacheMisses; /* Codegen modules compiled for this node */
 	int			bnotes;			/* Offset to beginning of node's extra text */
 	int			enotes;			/* Offset to end of node's extra text */
 } CdbExplain_StatInst;
@@ -114,6 +116,9 @@ typedef struct CdbExplain_NodeSummary
 	CdbExplain_Agg peakMemBalance;
 	/* Used for DynamicTableScan, DynamicIndexScan and DynamicBitmapTableScan */
 	CdbExplain_Agg totalPartTableScanned;
+	/* Used for nodes with generated code */
+	CdbExplain_Agg codegenCacheHits;
+	CdbExplain_Agg codegenCacheMisses;
 
 	/* insts array info */
 	int			segindex0;		/* segment id of insts[0] */
@@ -843,6 +848,8 @@ cdbexplain_collectStatsFromNode(PlanState *planstate, CdbExplain_SendStatCtx *ct
 	si->peakMemBalance = MemoryAccounting_GetAccountPeakBalance(planstate->plan->memoryAccountId);
 	si->firststart = instr->firststart;
 	si->numPartScanned = instr->numPartScanned;
+	si->codegenCacheHits = instr->codegenCacheHits;
+	si->codegenCacheMisses = instr->codegenCacheMisses;
 }	/* cdbexplain_collectStatsFromNode */
 
 
@@ -969,6 +976,8 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 	CdbExplain_DepStatAcc memory_accounting_global_peak;
 	CdbExplain_DepStatAcc peakMemBalance;
 	CdbExplain_DepStatAcc totalPartTableScanned;
+	CdbExplain_DepStatAcc codegenCacheHits;
+	CdbExplain_DepStatAcc codegenCacheMisses;
 	int			imsgptr;
 	int			nInst;
 
@@ -993,6 +1002,8 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 	cdbexplain_depStatAcc_init0(&totalWorkfileCreated);
 	cdbexplain_depStatAcc_init0(&peakMemBalance);
 	cdbexplain_depStatAcc_init0(&totalPartTableScanned);
+	cdbexplain_depStatAcc_init0(&codegenCacheHits);
+	cdbexplain_depStatAcc_init0(&codegenCacheMisses);
 
 	/* Initialize per-slice accumulators. */
 	cdbexplain_depStatAcc_init0(&peakmemused);
@@ -1039,6 +1050,8 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 		cdbexplain_depStatAcc_upd(&totalWorkfileCreated, (rsi->workfileCreated ? 1 : 0), rsh, rsi, nsi);
 		cdbexplain_depStatAcc_upd(&peakMemBalance, rsi->peakMemBalance, rsh, rsi, nsi);
 		cdbexplain_depStatAcc_upd(&totalPartTableScanned, rsi->numPartScanned, rsh, rsi, nsi);
+		cdbexplain_depStatAcc_upd(&codegenCacheHits, rsi->codegenCacheHits, rsh, rsi, nsi);
+		cdbexplain_depStatAcc_upd(&codegenCacheMisses, rsi->codegenCacheMisses, rsh, rsi, nsi);
 
 		/* Update per-slice accumulators. */
 		cdbexplain_depStatAcc_upd(&peakmemused, rsh->worker.peakmemused, rsh, rsi, nsi);
@@ -1054,6 +1067,8 @@ cdbexplain_depositStatsToNode(PlanState *planstate, CdbExplain_RecvStatCtx *ctx)
 	ns->totalWorkfileCreated = totalWorkfileCreated.agg;
 	ns->peakMemBalance = peakMemBalance.agg;
 	ns->totalPartTableScanned = totalPartTableScanned.agg;
+	ns->codegenCacheHits = codegenCacheHits.agg;
+	ns->codegenCacheMisses = codegenCacheMisses.agg;
 
 	/* Roll up summary over all nodes of slice into RecvStatCtx. */
 	ctx->workmemused_max = Max(ctx->workmemused_max, workmemused.agg.vmax);
@@ -1723,6 +1738,18 @@ cdbexplain_showExecStats(struct PlanState *planstate,
 		}
 	}
 
+	/*
+	 * Reuse of compiled codegen modules, summed over all workers.
+	 */
+	if (ns->codegenCacheHits.vcnt > 0 || ns->codegenCacheMisses.vcnt > 0)
+	{
+		appendStringInfoFill(str, 2 * indent, ' ');
+		appendStringInfo(str,
+						 "Codegen cache:  %.0f hits, %.0f misses.\n",
+						 ns->codegenCacheHits.vsum,
+						 ns->codegenCacheMisses.vsum);
+	}
+
 	/*
 	 * Extra message text.
 	 */
@@ -37,15 +37,6 @@
 #include "cdb/cdbhash.h"
 #include "cdb/cdbutil.h"
 
-/* 32 bit FNV-1  non-zero initial basis */
-#define FNV1_32_INIT ((uint32)0x811c9dc5)
-
-/* Constant prime value used for an FNV1 hash */
-#define FNV_32_PRIME ((uint32)0x01000193)
-
-/* Constant used for hashing a NULL value */
-#define NULL_VAL ((uint32)0XF0F0F0F1)
-
 /* Constant used for hashing a NAN value  */
 #define NAN_VAL ((uint32)0XE0E0E0E1)
 
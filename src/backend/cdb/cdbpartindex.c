@@ -88,8 +88,10 @@ typedef struct PartitionIndexNode
 } PartitionIndexNode;
 
 static void recordIndexesOnLeafPart(PartitionIndexNode **pNodePtr,
-					Oid partOid, Oid rootOid);
-static void recordIndexes(PartitionIndexNode **partIndexTree);
+					Oid partOid, Relation rootRel);
+static void recordIndexes(PartitionIndexNode **partIndexTree, Relation rootRel);
+static Node *getPartConstraintsRel(Relation rootRel, Relation conRel,
+					Oid partOid, List *partKey);
 static void getPartitionIndexNode(Oid rootOid, int2 level,
 					Oid parent, PartitionIndexNode **n,
 					bool isDefault, List *defaultLevels);
@@ -216,6 +218,7 @@ BuildLogicalIndexInfo(Oid relid)
 	HASH_SEQ_STATUS hash_seq;
 	LogicalIndexInfoHashEntry *entry;
 	PartitionIndexNode *n = NULL;
+	Relation	rootRel;
 
 	/*
 	 * create a memory context to hold allocations, so we can get rid of
@@ -239,14 +242,23 @@ BuildLogicalIndexInfo(Oid relid)
 	getPartitionIndexNode(relid, 0, InvalidOid, &n, false, NIL);
 
 	if (!n)
+	{
+		MemoryContextSwitchTo(callerContext);
+		MemoryContextDelete(partContext);
 		return NULL;
+	}
 
 	/* create the hash tables to hold the logical index info */
 	createIndexHashTables();
 	
 
-	/* now walk the tree and annotate with logical index id at each leaf */
-	recordIndexes(&n);
+	/*
+	 * now walk the tree and annotate with logical index id at each leaf. The
+	 * root is opened once for all the leaves, to map their attnums.
+	 */
+	rootRel = heap_open(relid, AccessShareLock);
+	recordIndexes(&n, rootRel);
+	heap_close(rootRel, AccessShareLock);
 
 	hash_freeze(LogicalIndexInfoHash);
 
@@ -506,7 +518,7 @@ createIndexHashTables()
  *   Invoke the recordIndexesOnPart routine on every leaf partition.
  */
 static void
-recordIndexes(PartitionIndexNode **partIndexTree)
+recordIndexes(PartitionIndexNode **partIndexTree, Relation rootRel)
 {
 	ListCell *lc; 
 	PartitionIndexNode *partIndexNode = *partIndexTree;
@@ -516,14 +528,17 @@ recordIndexes(PartitionIndexNode **partIndexTree)
 		foreach (lc, partIndexNode->children)
 		{
 			PartitionIndexNode *child = (PartitionIndexNode *) lfirst(lc);
-			recordIndexes(&child);
+			recordIndexes(&child, rootRel);
 		}
 	}
 	else 
+	{
 		/* at a leaf */
+		Assert(RelationGetRelid(rootRel) == partIndexNode->parrelid);
 		recordIndexesOnLeafPart(partIndexTree, 
 					partIndexNode->parchildrelid, 
-					partIndexNode->parrelid);
+					rootRel);
+	}
 }
 
 /*
@@ -540,8 +555,9 @@ recordIndexes(PartitionIndexNode **partIndexTree)
 static void
 recordIndexesOnLeafPart(PartitionIndexNode **pNodePtr,
 			Oid partOid,
-			Oid rootOid)
+			Relation rootRel)
 {
+	Oid					rootOid = RelationGetRelid(rootRel);
 	char 				*partIndexHashKey;
 	bool 				foundPartIndexHash;
 	bool 				foundLogicalIndexHash;
@@ -557,8 +573,6 @@ recordIndexesOnLeafPart(PartitionIndexNode **pNodePtr,
 
 	char relstorage = partRel->rd_rel->relstorage;
 
-	heap_close(partRel, AccessShareLock);
-
 	/* fetch each index on part */
 	indexoidlist = RelationGetIndexList(partRel);
 	foreach(lc, indexoidlist)
@@ -589,19 +603,7 @@ recordIndexesOnLeafPart(PartitionIndexNode **pNodePtr,
 		 * to root attnums. Get the attMap needed for mapping.
 		 */
 		if (!attmap)
-		{
-			Relation partRel = heap_open(partOid, AccessShareLock);
-			Relation rootRel = heap_open(rootOid, AccessShareLock);
-
-			TupleDesc rootTupDesc = rootRel->rd_att;
-			TupleDesc partTupDesc = partRel->rd_att;
-		
-			attmap = varattnos_map(partTupDesc, rootTupDesc);
-			
-			/* can we close here ? */
-			heap_close(partRel, AccessShareLock);
-			heap_close(rootRel, AccessShareLock);
-		}
+			attmap = varattnos_map(partRel->rd_att, rootRel->rd_att);
 
 		/* populate index info structure */
 		ii = populateIndexInfo(indRel);
@@ -666,6 +668,8 @@ recordIndexesOnLeafPart(PartitionIndexNode **pNodePtr,
 		/* update the PartitionIndexNode -> index bitmap */
 		pNode->index = bms_add_member(pNode->index, partIndexHashEntry->logicalIndexId);
 	}
+
+	heap_close(partRel, AccessShareLock);
 }
 
 /*
@@ -801,10 +805,32 @@ indexParts(PartitionIndexNode **np, bool isDefault)
  */
 static Node *
 getPartConstraints(Oid partOid, Oid rootOid, List *partKey)
+{
+	Relation	rootRel;
+	Relation	conRel;
+	Node	   *result;
+
+	rootRel = heap_open(rootOid, AccessShareLock);
+	conRel = heap_open(ConstraintRelationId, AccessShareLock);
+
+	result = getPartConstraintsRel(rootRel, conRel, partOid, partKey);
+
+	heap_close(conRel, AccessShareLock);
+	heap_close(rootRel, AccessShareLock);
+
+	return result;
+}
+
+/*
+ * getPartConstraintsRel
+ *   Like getPartConstraints, with the root and pg_constraint already open,
+ *   so that callers fetching the constraints of many parts open them once.
+ */
+static Node *
+getPartConstraintsRel(Relation rootRel, Relation conRel, Oid partOid, List *partKey)
 {
 	ScanKeyData scankey;
 	SysScanDesc sscan;
-	Relation        conRel;
 	HeapTuple       conTup;
 	Node            *conExpr;
 	Node            *result = NULL;
@@ -816,17 +842,13 @@ getPartConstraints(Oid partOid, Oid rootOid, List *partKey)
 	AttrMap		*map;
 
 	/* create the map needed for mapping attnums */
-	Relation rootRel = heap_open(rootOid, AccessShareLock);
 	Relation partRel = heap_open(partOid, AccessShareLock);
 
 	map_part_attrs(partRel, rootRel, &map, false); 
 
-	heap_close(rootRel, AccessShareLock);
 	heap_close(partRel, AccessShareLock);
 
 	/* Fetch the pg_constraint row. */
-	conRel = heap_open(ConstraintRelationId, AccessShareLock);
-
 	ScanKeyInit(&scankey,
 				Anum_pg_constraint_conrelid,
 				BTEqualStrategyNumber, F_OIDEQ,
@@ -877,7 +899,6 @@ getPartConstraints(Oid partOid, Oid rootOid, List *partKey)
 	}
 
 	systable_endscan(sscan);
-	heap_close(conRel, AccessShareLock);
 
 	ListCell *lc = NULL;
 	foreach (lc, partKey)
@@ -921,6 +942,10 @@ get_relation_part_constraints(Oid rootOid, List **defaultLevels)
 	List *partkeys = rel_partition_keys_ordered(rootOid);
 	int nLevels = list_length(partkeys);
 
+	// open the root and pg_constraint once for all the parts
+	Relation rootRel = heap_open(rootOid, AccessShareLock);
+	Relation conRel = heap_open(ConstraintRelationId, AccessShareLock);
+
 	Node *allCons = NULL;
 	for (int level = 0; level < nLevels; level++)
 	{
@@ -937,7 +962,7 @@ get_relation_part_constraints(Oid rootOid, List **defaultLevels)
 		{
 			Oid partOid = lfirst_oid(lc);
 			// fetch part constraint mapped to root
-			partCons = getPartConstraints(partOid, rootOid, partKey);
+			partCons = getPartConstraintsRel(rootRel, conRel, partOid, partKey);
 
 			if (NULL == partCons)
 			{
@@ -958,6 +983,9 @@ get_relation_part_constraints(Oid rootOid, List **defaultLevels)
 		}
 	}
 
+	heap_close(conRel, AccessShareLock);
+	heap_close(rootRel, AccessShareLock);
+
 	if (NULL == allCons)
 	{
 		allCons = makeBoolConst(false /*value*/, false /*isnull*/);
@@ -196,11 +196,13 @@ int			Gp_interconnect_queue_depth = 4;	/* max number of messages
 												 * waiting in rx-queue before
 												 * we drop. */
 int			Gp_interconnect_snd_queue_depth = 2;
+int			Gp_interconnect_batch_size = 1;
 int			Gp_interconnect_timer_period = 5;
 int			Gp_interconnect_timer_checking_period = 20;
 int			Gp_interconnect_default_rtt = 20;
 int			Gp_interconnect_min_rto = 20;
 int			Gp_interconnect_fc_method = INTERCONNECT_FC_METHOD_LOSS;
+int			Gp_interconnect_congestion_control = INTERCONNECT_CC_RENO;
 int			Gp_interconnect_transmit_timeout = 3600;
 int			Gp_interconnect_min_retries_before_timeout = 100;
 
@@ -216,6 +218,8 @@ bool		gp_interconnect_full_crc = false;	/* sanity check UDP data. */
 
 bool		gp_interconnect_log_stats = false;	/* emit stats at log-level */
 
+bool		gp_interconnect_coalesce_recv = false;	/* form tuples in place */
+
 bool		gp_interconnect_cache_future_packets = true;
 
 int			Gp_udp_bufsize_k;	/* UPD recv buf size, in KB */
@@ -908,8 +912,10 @@ gpvars_assign_gp_interconnect_type(const char *newval, bool doit, GucSource sour
 		newtype = INTERCONNECT_TYPE_UDPIFC;
 	else if (!pg_strcasecmp("udpifc", newval))
 		newtype = INTERCONNECT_TYPE_UDPIFC;
+	else if (!pg_strcasecmp("udpifc_shm", newval))
+		newtype = INTERCONNECT_TYPE_UDPIFC_SHM;
 	else
-		elog(ERROR, "Only support UDPIFC, (current type is '%s')", gpvars_show_gp_interconnect_type());
+		elog(ERROR, "Only support UDPIFC and UDPIFC_SHM, (current type is '%s')", gpvars_show_gp_interconnect_type());
 
 	if (doit)
 	{
@@ -922,7 +928,14 @@ gpvars_assign_gp_interconnect_type(const char *newval, bool doit, GucSource sour
 const char *
 gpvars_show_gp_interconnect_type(void)
 {
-	return "UDPIFC";
+	switch (Gp_interconnect_type)
+	{
+		case INTERCONNECT_TYPE_UDPIFC_SHM:
+			return "UDPIFC_SHM";
+		case INTERCONNECT_TYPE_UDPIFC:
+		default:
+			return "UDPIFC";
+	}
 }	/* gpvars_show_gp_log_interconnect */
 
 /*
@@ -964,6 +977,49 @@ gpvars_show_gp_interconnect_fc_method(void)
 	}
 }	/* gpvars_show_gp_interconnect_fc_method */
 
+/*
+ * gpvars_assign_gp_interconnect_congestion_control
+ * gpvars_show_gp_interconnect_congestion_control
+ */
+const char *
+gpvars_assign_gp_interconnect_congestion_control(const char *newval, bool doit, GucSource source __attribute__((unused)))
+{
+	int			newalgorithm = 0;
+
+	if (newval == NULL || newval[0] == 0 ||
+		!pg_strcasecmp("reno", newval))
+		newalgorithm = INTERCONNECT_CC_RENO;
+	else if (!pg_strcasecmp("cubic", newval))
+		newalgorithm = INTERCONNECT_CC_CUBIC;
+	else if (!pg_strcasecmp("paced", newval))
+		newalgorithm = INTERCONNECT_CC_PACED;
+	else
+		elog(ERROR, "Unknown interconnect congestion control algorithm. (current algorithm is '%s')", gpvars_show_gp_interconnect_congestion_control());
+
+	if (doit)
+	{
+		Gp_interconnect_congestion_control = newalgorithm;
+	}
+
+	return newval;
+}	/* gpvars_assign_gp_interconnect_congestion_control */
+
+const char *
+gpvars_show_gp_interconnect_congestion_control(void)
+{
+	switch (Gp_interconnect_congestion_control)
+	{
+		case INTERCONNECT_CC_RENO:
+			return "RENO";
+		case INTERCONNECT_CC_CUBIC:
+			return "CUBIC";
+		case INTERCONNECT_CC_PACED:
+			return "PACED";
+		default:
+			return "RENO";
+	}
+}	/* gpvars_show_gp_interconnect_congestion_control */
+
 /*
  * Parse the string value of gp_autostats_mode and gp_autostats_mode_in_functions
  */
@@ -60,6 +60,16 @@ static void processIncomingChunks(MotionLayerState *mlStates,
 								  int16 motNodeID,
 								  int16 srcRoute);
 
+static void processIncomingPacket(MotionLayerState *mlStates,
+								  ChunkTransportState *transportStates,
+								  MotionNodeEntry * pMNEntry,
+								  TupleChunkListItem pktItem,
+								  int16 motNodeID,
+								  int16 srcRoute,
+								  int *numChunks,
+								  int *chunkBytes,
+								  int *tupleBytes);
+
 static inline void reconstructTuple(MotionNodeEntry * pMNEntry, ChunkSorterEntry * pCSEntry);
 
 /* Stats-function declarations. */
@@ -669,6 +679,18 @@ processIncomingChunks(MotionLayerState *mlStates,
 	chunkBytes = 0;
 	tupleBytes = 0;
 
+	if (gp_interconnect_coalesce_recv && tcItem != NULL)
+	{
+		/* The transport handed us a whole packet, see RecvTupleChunk(). */
+		Assert(tcItem->p_next == NULL);
+
+		processIncomingPacket(mlStates, transportStates, pMNEntry, tcItem,
+							  motNodeID, srcRoute,
+							  &numChunks, &chunkBytes, &tupleBytes);
+		pfree(tcItem);
+		tcItem = NULL;
+	}
+
 	while (tcItem != NULL)
 	{
 		numChunks++;
@@ -705,6 +727,88 @@ processIncomingChunks(MotionLayerState *mlStates,
 	MemoryContextSwitchTo(oldCtxt);
 }
 
+/*
+ * Process all the chunks of a packet, for gp_interconnect_coalesce_recv.
+ *
+ * pktItem points in place to the chunks of the packet. Whole tuples are
+ * formed straight from the packet, which is the common case for narrow
+ * tuples; only partial tuples and end-of-stream go through the chunk-sorter.
+ */
+static void
+processIncomingPacket(MotionLayerState *mlStates,
+					  ChunkTransportState *transportStates,
+					  MotionNodeEntry * pMNEntry,
+					  TupleChunkListItem pktItem,
+					  int16 motNodeID,
+					  int16 srcRoute,
+					  int *numChunks,
+					  int *chunkBytes,
+					  int *tupleBytes)
+{
+	ChunkSorterEntry *pCSEntry;
+	char	   *data = pktItem->inplace;
+	int			len = pktItem->chunk_length;
+	int			pos = 0;
+
+	pCSEntry = getChunkSorterEntry(mlStates, pMNEntry, srcRoute);
+
+	while (pos < len)
+	{
+		uint16		dataSize;
+		uint16		tcType;
+		int			chunkLength;
+
+		if (len - pos < TUPLE_CHUNK_HEADER_SIZE)
+		{
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error parsing message: insufficient data received."),
+							errdetail("packet data %d processed %d < chunk-header %d",
+									  len, pos, TUPLE_CHUNK_HEADER_SIZE)));
+		}
+
+		memcpy(&dataSize, data + pos, sizeof(uint16));
+		memcpy(&tcType, data + pos + 2, sizeof(uint16));
+		chunkLength = TUPLE_CHUNK_HEADER_SIZE + dataSize;
+
+		if (chunkLength > len - pos)
+		{
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error parsing message"),
+							errdetail("chunk length %d > packet data %d processed %d",
+									  chunkLength, len, pos)));
+		}
+
+		/* Track stats. */
+		(*numChunks)++;
+		*chunkBytes += chunkLength;
+		*tupleBytes += dataSize;
+
+		if ((tcType == TC_WHOLE || tcType == TC_EMPTY) &&
+			pCSEntry->chunk_list.num_chunks == 0)
+		{
+			HeapTuple	htup;
+
+			htup = CvtChunkToHeapTup(data + pos, chunkLength, &pMNEntry->ser_tup_info);
+			htfifo_addtuple(pCSEntry->ready_tuples, htup);
+
+			/* Stats */
+			statNewTupleArrived(pMNEntry, pCSEntry);
+		}
+		else
+		{
+			TupleChunkListItem tcItem;
+
+			tcItem = (TupleChunkListItem) palloc0(sizeof(TupleChunkListItemData));
+			tcItem->chunk_length = chunkLength;
+			tcItem->inplace = data + pos;
+
+			addChunkToSorter(mlStates, transportStates, pMNEntry, tcItem, motNodeID, srcRoute);
+		}
+
+		pos += TYPEALIGN(TUPLE_CHUNK_ALIGN, chunkLength);
+	}
+}
+
 void
 EndMotionLayerNode(MotionLayerState *mlStates, int16 motNodeID, bool flushCommLayer)
 {
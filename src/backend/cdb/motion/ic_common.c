@@ -177,6 +177,20 @@ RecvTupleChunk(MotionConn *conn, bool inTeardown)
 	/* go through and form us some TupleChunks. */
 	bytesProcessed = sizeof(struct icpkthdr);
 
+	if (gp_interconnect_coalesce_recv && conn->msgSize > bytesProcessed)
+	{
+		/*
+		 * Hand the whole packet to the motion layer as one item, it walks
+		 * the chunks itself (see processIncomingPacket()).
+		 */
+		firstTcItem = (TupleChunkListItem) palloc0(sizeof(TupleChunkListItemData));
+
+		firstTcItem->chunk_length = conn->msgSize - bytesProcessed;
+		firstTcItem->inplace = (char *) (conn->msgPos + bytesProcessed);
+
+		bytesProcessed = conn->msgSize;
+	}
+
 #ifdef AMS_VERBOSE_LOGGING
 	elog(DEBUG5, "recvtuple chunk recv bytes %d msgsize %d conn->pBuff %p conn->msgPos: %p",
 		 conn->recvBytes, conn->msgSize, conn->pBuff, conn->msgPos);
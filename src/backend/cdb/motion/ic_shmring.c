@@ -0,0 +1,613 @@
+/*-------------------------------------------------------------------------
+ * ic_shmring.c
+ *	   Shared-memory packet ring for interconnect connections between
+ *	   processes on the same host.
+ *
+ * The ring lives in a POSIX shared memory object named after the
+ * connection, so that the sender and the receiver can attach to it in any
+ * order without talking to each other first. Whichever comes first creates
+ * and sizes it; the other waits until it has its final size.
+ *
+ * There is exactly one sender and one receiver. The sender only writes
+ * head, the receiver only writes tail and stop, and both are free-running
+ * counters, so a slot is full when head - tail reaches the number of
+ * slots. Memory barriers order the packet contents with the counters; no
+ * lock is needed.
+ *
+ * A sender that waits for a slot sleeps on tail, as a futex on Linux, and
+ * the receiver wakes it up when it releases a packet or asks it to stop.
+ * The receiver cannot sleep on one ring, as it waits for several
+ * connections at once, so it polls; see receiveChunksUDPIFC.
+ *
+ * The sender always removes the name when it is done. The receiver only
+ * removes it if the sender has attached: otherwise a sender that is late to
+ * set up would create a new ring that nobody reads, so the receiver leaves
+ * the ring, with stop set, for the sender to find, and removes it when the
+ * statement is over for sure: at the next interconnect setup, or when it
+ * exits. Rings left behind by processes that died are removed at
+ * postmaster start-up.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+#include "cdb/ic_shmring.h"
+#include "fmgr.h"
+#include "miscadmin.h"
+#include "nodes/pg_list.h"
+#include "port/atomics.h"
+#include "storage/ipc.h"
+#include "storage/shmem.h"
+#include "storage/spin.h"
+#include "utils/builtins.h"
+#include "utils/memutils.h"
+
+#define IC_SHMRING_NAME_PREFIX "gpdb_ic."
+
+/* keep the counters of the two sides in different cache lines */
+#define IC_SHMRING_LINE_SIZE (128)
+
+typedef struct ICShmRingHeader
+{
+	/* number of packets published by the sender, written by the sender only */
+	volatile uint32 head;
+
+	/* set by the sender when it has mapped the ring */
+	volatile uint32 senderAttached;
+
+	/* set by the sender while it sleeps in ICShmRingWaitRelease */
+	volatile uint32 senderWaiting;
+	char		pad1[IC_SHMRING_LINE_SIZE - 3 * sizeof(uint32)];
+
+	/* number of packets released by the receiver, written by the receiver only */
+	volatile uint32 tail;
+
+	/* set by the receiver when it does not want any more packets */
+	volatile uint32 stop;
+	char		pad2[IC_SHMRING_LINE_SIZE - 2 * sizeof(uint32)];
+} ICShmRingHeader;
+
+struct ICShmRing
+{
+	ICShmRingHeader *hdr;
+	uint8	   *slots;
+	uint32		nslots;
+	Size		slotSize;
+	Size		mapSize;
+	bool		isSender;
+	char		name[64];
+};
+
+/* Statistics of the segment, in the main shared memory */
+typedef struct ICShmRingStats
+{
+	slock_t		mutex;
+	uint64		sentPackets;	/* packets sent through rings */
+} ICShmRingStats;
+
+static ICShmRingStats *icShmRingStats = NULL;
+
+/* Names of the rings this receiver left for a sender, see ICShmRingDetach */
+static List *leftoverRings = NIL;
+static bool leftoverCallbackRegistered = false;
+
+static void removeLeftoverRingsCallback(int code, Datum arg);
+static void wakeSender(ICShmRing *ring);
+
+/*
+ * ICShmRingName
+ * 		Name of the ring of a connection.
+ *
+ * The pids identify the two processes on the host; the session and the
+ * interconnect instance keep the names of consecutive statements apart.
+ */
+void
+ICShmRingName(char *buf, int bufsize, int sessionId, int icId,
+			  int motNodeId, int srcPid, int dstPid)
+{
+	snprintf(buf, bufsize, "/" IC_SHMRING_NAME_PREFIX "%d.%d.%d.%d.%d",
+			 sessionId, icId, motNodeId, srcPid, dstPid);
+}
+
+#ifndef WIN32
+
+/*
+ * ICShmRingAttach
+ * 		Create or attach to the ring of the given name.
+ *
+ * Both sides must pass the same number and size of slots.
+ */
+ICShmRing *
+ICShmRingAttach(const char *name, int nslots, int slotSize, bool isSender)
+{
+	ICShmRing  *ring;
+	struct stat st;
+	int			fd;
+
+	Assert(nslots > 0 && slotSize > 0);
+
+	ring = palloc0(sizeof(ICShmRing));
+	strlcpy(ring->name, name, sizeof(ring->name));
+	ring->nslots = nslots;
+	ring->isSender = isSender;
+	ring->slotSize = MAXALIGN(slotSize);
+	ring->mapSize = sizeof(ICShmRingHeader) + ring->nslots * ring->slotSize;
+
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+	if (fd >= 0)
+	{
+		/* we are first: size it, the object is zero-filled */
+		int			ret = ftruncate(fd, ring->mapSize);
+
+#ifdef __linux__
+		/* allocate now, rather than getting SIGBUS on first use */
+		if (ret == 0)
+		{
+			ret = posix_fallocate(fd, 0, ring->mapSize);
+			if (ret != 0)
+			{
+				errno = ret;
+				ret = -1;
+			}
+		}
+#endif
+		if (ret != 0)
+		{
+			int			save_errno = errno;
+
+			close(fd);
+			shm_unlink(name);
+			errno = save_errno;
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error: could not resize shared memory ring \"%s\" to %lu bytes: %m",
+								   name, (unsigned long) ring->mapSize)));
+		}
+	}
+	else if (errno == EEXIST)
+	{
+		fd = shm_open(name, O_RDWR, 0);
+		if (fd < 0)
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error: could not open shared memory ring \"%s\": %m",
+								   name)));
+
+		/* the peer is sizing it */
+		for (;;)
+		{
+			if (fstat(fd, &st) != 0)
+			{
+				int			save_errno = errno;
+
+				close(fd);
+				errno = save_errno;
+				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+								errmsg("Interconnect error: could not stat shared memory ring \"%s\": %m",
+									   name)));
+			}
+
+			if (st.st_size == ring->mapSize)
+				break;
+
+			if (st.st_size > ring->mapSize)
+			{
+				close(fd);
+				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+								errmsg("Interconnect error: shared memory ring \"%s\" has size %lu, expected %lu",
+									   name, (unsigned long) st.st_size, (unsigned long) ring->mapSize)));
+			}
+
+			CHECK_FOR_INTERRUPTS();
+			pg_usleep(100L);
+		}
+	}
+	else
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Interconnect error: could not create shared memory ring \"%s\": %m",
+							   name)));
+
+	ring->hdr = (ICShmRingHeader *) mmap(NULL, ring->mapSize, PROT_READ | PROT_WRITE,
+										 MAP_SHARED, fd, 0);
+	if (ring->hdr == MAP_FAILED)
+	{
+		int			save_errno = errno;
+
+		close(fd);
+		errno = save_errno;
+		ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+						errmsg("Interconnect error: could not map shared memory ring \"%s\": %m",
+							   name)));
+	}
+	close(fd);
+
+	ring->slots = (uint8 *) ring->hdr + sizeof(ICShmRingHeader);
+
+	if (isSender)
+	{
+		/* pairs with the barrier in ICShmRingDetach of the receiver */
+		ring->hdr->senderAttached = 1;
+		pg_memory_barrier();
+	}
+
+	return ring;
+}
+
+/*
+ * ICShmRingDetach
+ * 		Unmap the ring, and remove its name if the peer is done with it.
+ *
+ * The receiver asks the sender to stop first. A peer that has the ring
+ * mapped keeps using it. Does not throw errors, so it is safe to call in
+ * teardown.
+ */
+void
+ICShmRingDetach(ICShmRing *ring)
+{
+	bool		unlink = true;
+
+	if (ring == NULL)
+		return;
+
+	if (!ring->isSender)
+	{
+		ICShmRingRequestStop(ring);
+
+		/* a sender that has not attached yet will find the stop */
+		unlink = (ring->hdr->senderAttached != 0);
+	}
+
+	munmap((void *) ring->hdr, ring->mapSize);
+	if (unlink)
+		shm_unlink(ring->name);
+	else
+	{
+		MemoryContext oldContext = MemoryContextSwitchTo(TopMemoryContext);
+
+		leftoverRings = lappend(leftoverRings, pstrdup(ring->name));
+		MemoryContextSwitchTo(oldContext);
+
+		if (!leftoverCallbackRegistered)
+		{
+			on_proc_exit(removeLeftoverRingsCallback, 0);
+			leftoverCallbackRegistered = true;
+		}
+	}
+
+	pfree(ring);
+}
+
+/*
+ * ICShmRingRemoveLeftovers
+ * 		Remove the rings this receiver left for senders that never came.
+ *
+ * Must only be called when the statements they belong to are over.
+ */
+void
+ICShmRingRemoveLeftovers(void)
+{
+	ListCell   *cell;
+
+	foreach(cell, leftoverRings)
+		shm_unlink((char *) lfirst(cell));
+
+	list_free_deep(leftoverRings);
+	leftoverRings = NIL;
+}
+
+static void
+removeLeftoverRingsCallback(int code, Datum arg)
+{
+	ICShmRingRemoveLeftovers();
+}
+
+/*
+ * ICShmRingRemoveOrphans
+ * 		Remove the rings left behind by processes that died.
+ *
+ * All the segments of a host share the namespace, so only the rings whose
+ * sender and receiver are both gone are removed. Called at postmaster
+ * start-up and after a crash.
+ */
+void
+ICShmRingRemoveOrphans(void)
+{
+#ifdef __linux__
+	DIR		   *dir;
+	struct dirent *de;
+
+	dir = opendir("/dev/shm");
+	if (dir == NULL)
+		return;
+
+	while ((de = readdir(dir)) != NULL)
+	{
+		int			sessionId,
+					icId,
+					motNodeId,
+					srcPid,
+					dstPid;
+		char		name[MAXPGPATH];
+
+		if (strncmp(de->d_name, IC_SHMRING_NAME_PREFIX, strlen(IC_SHMRING_NAME_PREFIX)) != 0)
+			continue;
+
+		if (sscanf(de->d_name, IC_SHMRING_NAME_PREFIX "%d.%d.%d.%d.%d",
+				   &sessionId, &icId, &motNodeId, &srcPid, &dstPid) != 5)
+			continue;
+
+		if ((kill(srcPid, 0) == 0 || errno != ESRCH) ||
+			(kill(dstPid, 0) == 0 || errno != ESRCH))
+			continue;
+
+		snprintf(name, sizeof(name), "/%s", de->d_name);
+		if (shm_unlink(name) == 0)
+			elog(LOG, "removed orphaned interconnect shared memory ring \"%s\"", name);
+	}
+
+	closedir(dir);
+#endif
+}
+
+#else							/* WIN32 */
+
+ICShmRing *
+ICShmRingAttach(const char *name, int nslots, int slotSize, bool isSender)
+{
+	ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					errmsg("shared memory interconnect is not supported on this platform")));
+	return NULL;
+}
+
+void
+ICShmRingDetach(ICShmRing *ring)
+{
+}
+
+void
+ICShmRingRemoveLeftovers(void)
+{
+}
+
+void
+ICShmRingRemoveOrphans(void)
+{
+}
+
+#endif							/* WIN32 */
+
+/*
+ * ICShmRingGetWriteSlot
+ * 		Returns the slot for the next packet, or NULL if the ring is full.
+ *
+ * The same slot is returned until it is published.
+ */
+uint8 *
+ICShmRingGetWriteSlot(ICShmRing *ring)
+{
+	uint32		head = ring->hdr->head;
+
+	if (head - ring->hdr->tail >= ring->nslots)
+		return NULL;
+
+	/* the receiver is done with the slot before we overwrite it */
+	pg_memory_barrier();
+
+	return ring->slots + (head % ring->nslots) * ring->slotSize;
+}
+
+/*
+ * ICShmRingPublish
+ * 		Make the packet in the write slot visible to the receiver.
+ */
+void
+ICShmRingPublish(ICShmRing *ring)
+{
+	Assert(ring->hdr->head - ring->hdr->tail < ring->nslots);
+
+	pg_write_barrier();
+	ring->hdr->head = ring->hdr->head + 1;
+}
+
+/*
+ * ICShmRingIsEmpty
+ * 		Has the receiver released all the published packets?
+ */
+bool
+ICShmRingIsEmpty(ICShmRing *ring)
+{
+	return ring->hdr->tail == ring->hdr->head;
+}
+
+/*
+ * ICShmRingStopRequested
+ * 		Has the receiver asked for no more packets?
+ */
+bool
+ICShmRingStopRequested(ICShmRing *ring)
+{
+	return ring->hdr->stop != 0;
+}
+
+/*
+ * ICShmRingWaitRelease
+ * 		Sleep until the receiver has released more than 'released' packets,
+ * 		or asks us to stop, or for at most timeout microseconds.
+ *
+ * May return early; the caller must check the ring again.
+ */
+void
+ICShmRingWaitRelease(ICShmRing *ring, uint32 released, long timeout)
+{
+#ifdef __linux__
+	struct timespec ts;
+
+	ts.tv_sec = timeout / 1000000L;
+	ts.tv_nsec = (timeout % 1000000L) * 1000L;
+
+	/* pairs with the barrier in wakeSender */
+	ring->hdr->senderWaiting = 1;
+	pg_memory_barrier();
+
+	if (ring->hdr->tail == released && ring->hdr->stop == 0)
+		(void) syscall(SYS_futex, &ring->hdr->tail, FUTEX_WAIT, released, &ts, NULL, 0);
+
+	ring->hdr->senderWaiting = 0;
+#else
+	pg_usleep(timeout);
+#endif
+}
+
+/*
+ * ICShmRingPeek
+ * 		Returns the oldest unreleased packet, or NULL if there is none.
+ */
+uint8 *
+ICShmRingPeek(ICShmRing *ring)
+{
+	uint32		tail = ring->hdr->tail;
+
+	if (ring->hdr->head == tail)
+		return NULL;
+
+	/* read the packet only after seeing it published */
+	pg_read_barrier();
+
+	return ring->slots + (tail % ring->nslots) * ring->slotSize;
+}
+
+/*
+ * ICShmRingRelease
+ * 		Give the oldest packet back to the sender.
+ */
+void
+ICShmRingRelease(ICShmRing *ring)
+{
+	Assert(ring->hdr->head != ring->hdr->tail);
+
+	/* finish reading the packet before the sender can reuse its slot */
+	pg_memory_barrier();
+	ring->hdr->tail = ring->hdr->tail + 1;
+
+	wakeSender(ring);
+}
+
+/*
+ * ICShmRingRequestStop
+ * 		Ask the sender to stop sending.
+ */
+void
+ICShmRingRequestStop(ICShmRing *ring)
+{
+	ring->hdr->stop = 1;
+
+	wakeSender(ring);
+}
+
+/*
+ * Wake up the sender if it sleeps in ICShmRingWaitRelease.
+ */
+static void
+wakeSender(ICShmRing *ring)
+{
+	/* the sender sees our update, or we see it waiting */
+	pg_memory_barrier();
+
+#ifdef __linux__
+	if (ring->hdr->senderWaiting)
+		(void) syscall(SYS_futex, &ring->hdr->tail, FUTEX_WAKE, 1, NULL, NULL, 0);
+#endif
+}
+
+/*
+ * ICShmRingNumReleased
+ * 		Number of packets released by the receiver so far.
+ *
+ * The sender uses it to tell a slow receiver from one that is gone.
+ */
+uint32
+ICShmRingNumReleased(ICShmRing *ring)
+{
+	return ring->hdr->tail;
+}
+
+/*
+ * ICShmRingShmemSize
+ * 		Size of the ring statistics in the main shared memory.
+ */
+Size
+ICShmRingShmemSize(void)
+{
+	return MAXALIGN(sizeof(ICShmRingStats));
+}
+
+/*
+ * ICShmRingShmemInit
+ * 		Initialize the ring statistics, or attach to them.
+ */
+void
+ICShmRingShmemInit(void)
+{
+	bool		found;
+
+	icShmRingStats = (ICShmRingStats *)
+		ShmemInitStruct("Interconnect Shared Memory Ring Stats", sizeof(ICShmRingStats), &found);
+	if (!found)
+	{
+		SpinLockInit(&icShmRingStats->mutex);
+		icShmRingStats->sentPackets = 0;
+	}
+}
+
+/*
+ * ICShmRingCountSent
+ * 		Add to the number of packets sent through rings on this segment.
+ *
+ * Called once per statement, not per packet, to keep the senders of the
+ * segment off a shared cache line.
+ */
+void
+ICShmRingCountSent(uint64 npackets)
+{
+	if (icShmRingStats == NULL || npackets == 0)
+		return;
+
+	SpinLockAcquire(&icShmRingStats->mutex);
+	icShmRingStats->sentPackets += npackets;
+	SpinLockRelease(&icShmRingStats->mutex);
+}
+
+/*
+ * gp_interconnect_shm_packets
+ * 		Number of packets sent through shared-memory rings on this segment
+ * 		since start-up.
+ */
+Datum
+gp_interconnect_shm_packets(PG_FUNCTION_ARGS)
+{
+	uint64		npackets = 0;
+
+	if (icShmRingStats != NULL)
+	{
+		SpinLockAcquire(&icShmRingStats->mutex);
+		npackets = icShmRingStats->sentPackets;
+		SpinLockRelease(&icShmRingStats->mutex);
+	}
+
+	PG_RETURN_INT64((int64) npackets);
+}
@@ -44,9 +44,11 @@
 #include "cdb/cdbdisp.h"
 #include "cdb/cdbdispatchresult.h"
 #include "cdb/cdbicudpfaultinjection.h"
+#include "cdb/ic_shmring.h"
 
 #include <fcntl.h>
 #include <limits.h>
+#include <math.h>
 #include <unistd.h>
 #include <arpa/inet.h>
 #include "pgtime.h"
@@ -134,6 +136,25 @@ timeoutArray[] =
 /* 1/4 sec in msec */
 #define RX_THREAD_POLL_TIMEOUT (250)
 
+/*
+ * Batched socket I/O, see gp_interconnect_batch_size.
+ *
+ * sendmmsg() and recvmmsg() are Linux-specific; elsewhere packets are always
+ * sent and received one at a time.
+ */
+#if defined(__linux__) && defined(MSG_WAITFORONE)
+#define UDPIFC_HAVE_MMSG
+#endif
+
+/* must match the maximum of gp_interconnect_batch_size */
+#define UDPIFC_MAX_BATCH_SIZE (64)
+
+#ifdef UDPIFC_HAVE_MMSG
+#define UDPIFC_BATCH_SIZE() (Min(Gp_interconnect_batch_size, UDPIFC_MAX_BATCH_SIZE))
+#else
+#define UDPIFC_BATCH_SIZE() (1)
+#endif
+
 /*
  * Flags definitions for flag-field of UDP-messages
  *
@@ -239,6 +260,32 @@ struct CursorICHistoryTable
  */
 #define MAIN_THREAD_COND_TIMEOUT (250000)
 
+/*
+ * Waits on shared-memory connections, in usec
+ *
+ * A sender waiting for a free slot sleeps on its ring, and the receiver
+ * wakes it up, but wakes up itself after SHM_RING_MIN_WAIT, doubling up to
+ * SHM_RING_MAX_WAIT, to check for acks of its UDP connections.
+ *
+ * The receiver waits for all its connections at once, and nothing wakes
+ * it up when a sender on the same host fills a ring, so it polls the rings,
+ * backing off the same way. While it waits on shared-memory connections, an
+ * idle receiver thus wakes up about 1000 times a second, which costs CPU
+ * when a host runs many motions at once.
+ */
+#define SHM_RING_MIN_WAIT (10)
+#define SHM_RING_MAX_WAIT (1000)
+
+/*
+ * Packets in the ring of a shared-memory connection
+ *
+ * Each ring is a shared memory object of SHM_RING_SLOTS packets of
+ * gp_max_packet_size, so this is kept small, and independent of the UDP
+ * queue depths, which may be large: a ring of 32 packets takes 256kB
+ * with the default packet size.
+ */
+#define SHM_RING_SLOTS (32)
+
 /*
  *  Used for synchronization between main thread (receiver) and background thread.
  *
@@ -372,14 +419,95 @@ struct SendControlInfo
 	/* slow start threshold */
 	float ssthresh;
 
+	/* pacing rate in packets per second, 0 if packets are not paced */
+	double pacingRate;
+
+	/* earliest time to send the next paced packet */
+	uint64 nextSendTime;
+
+	/* cubic: window before the last reduction */
+	float wMax;
+
+	/* cubic: start of the current growth epoch, 0 if not started */
+	uint64 epochStart;
+
+	/* cubic: time (in s) to grow back to wMax */
+	double cubicK;
+
+	/* paced: minimal rtt in the filter window, and when it was measured */
+	uint64 minRtt;
+	uint64 minRttStamp;
+
+	/* paced: estimated bottleneck bandwidth in packets per second */
+	double btlBw;
+
+	/* paced: start of the current round, and packets acked in it */
+	uint64 roundStart;
+	uint32 roundDelivered;
+
+	/* paced: startup ends when the bandwidth stops growing */
+	bool fullPipe;
+	double fullBw;
+	int fullBwRounds;
+
+	/* paced: position in the pacing gain cycle */
+	int cycleIdx;
 };
 
+/*
+ * CongestionControl
+ *
+ * A congestion control algorithm of the loss flow control method, chosen by
+ * gp_interconnect_congestion_control. The algorithms maintain the congestion
+ * window in snd_control_info, which is shared by all the connections of a
+ * sender, and may also pace packets by setting a pacing rate.
+ *
+ * The "capacity" flow control method uses the fixed per-connection window
+ * (conn->capacity) only, and does not use an algorithm.
+ */
+typedef struct CongestionControl
+{
+	const char *name;
+
+	/* Called at setup, after cwnd, minCwnd and ssthresh are initialized. */
+	void (*init)(uint64 now);
+
+	/* Called for the ack of a packet that was sent once, ackTime is its rtt. */
+	void (*onAck)(MotionConn *conn, uint64 ackTime, uint64 now);
+
+	/* Called when packets are resent, after a timeout or a disorder message. */
+	void (*onLoss)(bool timeout, uint64 now);
+} CongestionControl;
+
 /*
  * Main thread use the information in this data structure to do ack handling
  * and congestion control.
  */
 static SendControlInfo snd_control_info;
 
+/*
+ * Congestion control algorithms, indexed by Gp_interconnect_congestion_control.
+ */
+static void renoInit(uint64 now);
+static void renoOnAck(MotionConn *conn, uint64 ackTime, uint64 now);
+static void renoOnLoss(bool timeout, uint64 now);
+static void cubicInit(uint64 now);
+static void cubicOnAck(MotionConn *conn, uint64 ackTime, uint64 now);
+static void cubicOnLoss(bool timeout, uint64 now);
+static void pacedInit(uint64 now);
+static void pacedOnAck(MotionConn *conn, uint64 ackTime, uint64 now);
+static void pacedOnLoss(bool timeout, uint64 now);
+
+static const CongestionControl congestion_controls[] =
+{
+	{"reno", renoInit, renoOnAck, renoOnLoss},		/* INTERCONNECT_CC_RENO */
+	{"cubic", cubicInit, cubicOnAck, cubicOnLoss},	/* INTERCONNECT_CC_CUBIC */
+	{"paced", pacedInit, pacedOnAck, pacedOnLoss}	/* INTERCONNECT_CC_PACED */
+};
+
+/* The algorithm of the current interconnect, chosen at setup. */
+static const CongestionControl *congestion_control = &congestion_controls[INTERCONNECT_CC_RENO];
+
 /*
  * ICGlobalControlInfo
  *
@@ -521,6 +649,29 @@ static ICGlobalControlInfo ic_control_info;
 
 #define MAX_SEQS_IN_DISORDER_ACK (4)
 
+/*
+ * Constants of the congestion control algorithms
+ *
+ * CUBIC_C                    - cubic scaling constant, window in packets and time in s
+ * CUBIC_BETA                 - cubic multiplicative decrease factor
+ * PACED_MIN_RTT_WINDOW       - time after which the minimal rtt is measured again, in us
+ * PACED_STARTUP_GAIN         - pacing gain while searching for the bottleneck bandwidth
+ * PACED_CWND_GAIN            - window in bandwidth-delay products
+ * PACED_FULL_BW_THRESH       - bandwidth growth that keeps the startup going
+ * PACED_FULL_BW_ROUNDS       - rounds without such growth that end the startup
+ */
+#define CUBIC_C (0.4)
+#define CUBIC_BETA (0.7)
+
+#define PACED_MIN_RTT_WINDOW (10 * 1000 * 1000) /* 10s */
+#define PACED_STARTUP_GAIN (2.89)
+#define PACED_CWND_GAIN (2.0)
+#define PACED_FULL_BW_THRESH (1.25)
+#define PACED_FULL_BW_ROUNDS (3)
+
+/* pacing gains of the rounds after startup, probing for more bandwidth then draining */
+static const double paced_gain_cycle[] = {1.25, 0.75, 1, 1, 1, 1, 1, 1};
+
 /*
  * UnackQueueRing
  *
@@ -619,6 +770,8 @@ typedef struct ICStatistics
 	int32   duplicatedPktNum;
 	int32	recvAckNum;
 	int32	statusQueryMsgNum;
+	int32	shmSndPktNum;
+	int32	shmRecvPktNum;
 } ICStatistics;
 
 /* Statistics for UDP interconnect. */
@@ -662,6 +815,7 @@ static MotionConn *findConnByHeader(ConnHashTable *ht, icpkthdr *hdr);
 static void destroyConnHashTable(ConnHashTable *ht);
 
 static inline void sendAckWithParam(AckSendParam *param);
+static void sendAcksWithParams(AckSendParam *params, int nparams);
 static void sendAck(MotionConn *conn, int32 flags, uint32 seq, uint32 extraSeq);
 static void sendDisorderAck(MotionConn *conn, uint32 seq, uint32 extraSeq, uint32 lostPktCnt);
 static void sendStatusQueryMessage(MotionConn *conn, int fd, uint32 seq);
@@ -726,6 +880,11 @@ static void checkQDConnectionAlive(void);
 
 
 static void *rxThreadFunc(void *arg);
+static bool rxPacketIsValid(icpkthdr *pkt, int read_count);
+static bool dispatchRxPacket(icpkthdr *pkt, struct sockaddr_storage *peer, socklen_t *peerlen, AckSendParam *param);
+#ifdef UDPIFC_HAVE_MMSG
+static bool receivePacketBatch(icpkthdr **pkts, int batchSize);
+#endif
 
 static bool handleMismatch(icpkthdr *pkt, struct sockaddr_storage *peer, int peer_len);
 static void handleAckedPacket(MotionConn *ackConn, ICBuffer *buf, uint64 now);
@@ -741,6 +900,7 @@ static inline void addCRC(icpkthdr *pkt);
 static inline bool checkCRC(icpkthdr *pkt);
 static void sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn);
 static void sendOnce(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer *buf, MotionConn * conn);
+static void sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer **bufs, int nbufs);
 static inline uint64 computeExpirationPeriod(MotionConn *conn, uint32 retry);
 
 static ICBuffer *getSndBuffer(MotionConn *conn);
@@ -765,6 +925,18 @@ static void aggregateStatistics(ChunkTransportStateEntry *pEntry);
 
 static inline bool pollAcks(ChunkTransportState *transportStates, int fd, int timeout);
 
+/* Shared-memory connections between processes on the same host. */
+static CdbProcess *getLocalCdbProcess(Slice *slice);
+static bool useShmConnection(CdbProcess *sender, CdbProcess *receiver);
+static ICShmRing *attachShmRing(ChunkTransportStateEntry *pEntry, CdbProcess *sender,
+			  CdbProcess *receiver, bool isSender);
+static bool waitShmRing(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry,
+						MotionConn *conn, bool drain, bool *gotStops);
+static bool sendChunkShm(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry,
+						 MotionConn *conn, TupleChunkListItem tcItem, int16 motionId);
+static void prepareShmConnForRead(MotionConn *conn, uint8 *pkt);
+static MotionConn *pollShmConns(ChunkTransportStateEntry *pEntry, MotionConn *conn, bool *anyActive);
+
 /* #define TRANSFER_PROTOCOL_STATS */
 
 #ifdef TRANSFER_PROTOCOL_STATS
@@ -1803,6 +1975,77 @@ sendAckWithParam(AckSendParam *param)
 	sendControlMessage(&param->msg, UDP_listenerFd, (struct sockaddr *)&param->peer, param->peer_len);
 }
 
+/*
+ * sendAcksWithParams
+ * 		Send a batch of acknowledgments, with one sendmmsg() call if possible.
+ *
+ * Like sendControlMessage, a message that cannot be sent is left to the
+ * retransmit logic.
+ */
+static void
+sendAcksWithParams(AckSendParam *params, int nparams)
+{
+#ifdef UDPIFC_HAVE_MMSG
+	struct mmsghdr msgs[UDPIFC_MAX_BATCH_SIZE];
+	struct iovec iovs[UDPIFC_MAX_BATCH_SIZE];
+	int			nmsgs = 0;
+	int			sent = 0;
+	int			i;
+
+	Assert(nparams <= UDPIFC_MAX_BATCH_SIZE);
+
+	if (nparams <= 1)
+	{
+		if (nparams == 1)
+			sendAckWithParam(&params[0]);
+		return;
+	}
+
+	memset(msgs, 0, nparams * sizeof(struct mmsghdr));
+	for (i = 0; i < nparams; i++)
+	{
+		icpkthdr   *pkt = &params[i].msg;
+
+#ifdef USE_ASSERT_CHECKING
+		if (testmode_inject_fault(gp_udpic_dropacks_percent))
+			continue;
+#endif
+
+		/* Add CRC for the control message. */
+		if (gp_interconnect_full_crc)
+			addCRC(pkt);
+
+		iovs[nmsgs].iov_base = pkt;
+		iovs[nmsgs].iov_len = pkt->len;
+		msgs[nmsgs].msg_hdr.msg_name = &params[i].peer;
+		msgs[nmsgs].msg_hdr.msg_namelen = params[i].peer_len;
+		msgs[nmsgs].msg_hdr.msg_iov = &iovs[nmsgs];
+		msgs[nmsgs].msg_hdr.msg_iovlen = 1;
+		nmsgs++;
+	}
+
+	while (sent < nmsgs)
+	{
+		int			n = sendmmsg(UDP_listenerFd, msgs + sent, nmsgs - sent, 0);
+
+		if (n <= 0)
+		{
+			/* skip the message that failed, like sendControlMessage would */
+			write_log("sendcontrolmessage: got error %d errno %d seq %d", n, errno,
+					  ((icpkthdr *) iovs[sent].iov_base)->seq);
+			sent++;
+			continue;
+		}
+		sent += n;
+	}
+#else
+	int			i;
+
+	for (i = 0; i < nparams; i++)
+		sendAckWithParam(&params[i]);
+#endif
+}
+
 /*
  * sendAck
  * 		Send acknowledgment to sender.
@@ -1953,6 +2196,17 @@ MlPutRxBufferIFC(ChunkTransportState *transportStates, int motNodeID, int route)
 
 	conn = pEntry->conns + route;
 
+	/* the ring is not shared with the rx thread, and there is nobody to ack */
+	if (conn->shmRing != NULL)
+	{
+		if (conn->pBuff == NULL)
+			elog(FATAL, "Interconnect error: tried to release a NULL buffer");
+
+		ICShmRingRelease(conn->shmRing);
+		conn->pBuff = NULL;
+		return;
+	}
+
 	memset(&param, 0, sizeof(AckSendParam));
 
 	pthread_mutex_lock(&ic_control_info.lock);
@@ -2598,6 +2852,7 @@ startOutgoingUDPConnections(ChunkTransportState *transportStates,
 	ListCell   *cell;
 	Slice	   *recvSlice;
 	CdbProcess *cdbProc;
+	CdbProcess *myProc;
 	int					i;
 	uint16 port = 0;
 
@@ -2621,6 +2876,9 @@ startOutgoingUDPConnections(ChunkTransportState *transportStates,
 									   list_length(recvSlice->primaryProcesses));
 
 	Assert(pEntry && pEntry->valid);
+
+	myProc = getLocalCdbProcess(sendSlice);
+
 	/*
 	 * Setup a MotionConn entry for each of our outbound connections.
 	 * Request a connection to each receiving backend's listening port.
@@ -2639,13 +2897,28 @@ startOutgoingUDPConnections(ChunkTransportState *transportStates,
 			icBufferListInit(&conn->unackQueue, ICBufferListType_Primary);
 			conn->capacity = Gp_interconnect_queue_depth;
 
-			/* send buffer pool must be initialized before this. */
-			snd_buffer_pool.maxCount += Gp_interconnect_snd_queue_depth;
-			snd_control_info.cwnd += 1;
-			conn->curBuff = getSndBuffer(conn);
+			if (useShmConnection(myProc, cdbProc))
+			{
+				/* packets are built in place in the ring */
+				conn->shmRing = attachShmRing(pEntry, myProc, cdbProc, true);
+				conn->curBuff = NULL;
+				conn->pBuff = ICShmRingGetWriteSlot(conn->shmRing);
 
-			/* should have at least one buffer for each connection */
-			Assert(conn->curBuff != NULL);
+				/* a new ring is empty */
+				Assert(conn->pBuff != NULL);
+			}
+			else
+			{
+				/* send buffer pool must be initialized before this. */
+				snd_buffer_pool.maxCount += Gp_interconnect_snd_queue_depth;
+				snd_control_info.cwnd += 1;
+				conn->curBuff = getSndBuffer(conn);
+
+				/* should have at least one buffer for each connection */
+				Assert(conn->curBuff != NULL);
+
+				conn->pBuff = (uint8 *)conn->curBuff->pkt;
+			}
 
 			conn->rtt = DEFAULT_RTT;
 			conn->dev = DEFAULT_DEV;
@@ -2655,7 +2928,6 @@ startOutgoingUDPConnections(ChunkTransportState *transportStates,
 			conn->sentSeq = 0;
 			conn->receivedAckSeq = 0;
 			conn->consumedSeq = 0;
-			conn->pBuff = (uint8 *)conn->curBuff->pkt;
 			conn->state = mcsSetupOutgoingConnection;
 			conn->route = i++;
 
@@ -2980,6 +3252,7 @@ SetupUDPIFCInterconnect_Internal(EState *estate)
 	Slice	   *mySlice;
 	Slice	   *aSlice;
 	MotionConn *conn=NULL;
+	CdbProcess *myProc;
 	int			incoming_count = 0;
 	int			outgoing_count = 0;
 	int			expectedTotalIncoming = 0;
@@ -2987,6 +3260,9 @@ SetupUDPIFCInterconnect_Internal(EState *estate)
 
 	ChunkTransportStateEntry *sendingChunkTransportState = NULL;
 
+	/* the previous statements are over, no sender will come for their rings */
+	ICShmRingRemoveLeftovers();
+
 	pthread_mutex_lock(&ic_control_info.lock);
 
 	gp_interconnect_id = estate->es_sliceTable->ic_instance_id;
@@ -3056,6 +3332,8 @@ SetupUDPIFCInterconnect_Internal(EState *estate)
 		rx_control_info.lastDXatId = distTransId;
 	}
 
+	myProc = getLocalCdbProcess(mySlice);
+
 	/* now we'll do some setup for each of our Receiving Motion Nodes. */
 	foreach(cell, mySlice->children)
 	{
@@ -3119,6 +3397,9 @@ SetupUDPIFCInterconnect_Internal(EState *estate)
 				conn->conn_info.flags = UDPIC_FLAGS_RECEIVER_TO_SENDER;
 
 				connAddHash(&ic_control_info.connHtab, conn);
+
+				if (useShmConnection(conn->cdbProc, myProc))
+					conn->shmRing = attachShmRing(pEntry, conn->cdbProc, myProc, false);
 			}
 		}
 
@@ -3158,6 +3439,11 @@ SetupUDPIFCInterconnect_Internal(EState *estate)
 		snd_control_info.minCwnd = snd_control_info.cwnd;
 		snd_control_info.ssthresh = snd_buffer_pool.maxCount;
 
+		congestion_control = &congestion_controls[Gp_interconnect_congestion_control];
+		snd_control_info.pacingRate = 0;
+		snd_control_info.nextSendTime = 0;
+		congestion_control->init(ic_control_info.lastExpirationCheckTime);
+
 	#ifdef TRANSFER_PROTOCOL_STATS
 		initTransProtoStats();
 	#endif
@@ -3408,6 +3694,20 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 					computeNetworkStatistics(conn->rtt, &minRtt, &maxRtt, &avgRtt);
 					computeNetworkStatistics(conn->dev, &minDev, &maxDev, &avgDev);
 
+					if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+						elog(DEBUG1, "Interconnect connection route %d contentId %d: "
+							 "rtt/dev " UINT64_FORMAT "/" UINT64_FORMAT " acks " UINT64_FORMAT
+							 " resent " UINT64_FORMAT " cwnd %f",
+							 conn->route, conn->remoteContentId, conn->rtt, conn->dev,
+							 conn->stat_count_acks, conn->stat_count_resent, snd_control_info.cwnd);
+
+					if (conn->shmRing != NULL)
+					{
+						ICShmRingDetach(conn->shmRing);
+						conn->shmRing = NULL;
+						conn->pBuff = NULL;
+					}
+
 					icBufferListReturn(&conn->sndQueue, false);
 					icBufferListReturn(&conn->unackQueue, Gp_interconnect_fc_method == INTERCONNECT_FC_METHOD_CAPACITY ? false : true);
 
@@ -3475,6 +3775,13 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 
 					rx_buffer_pool.maxCount -= Gp_interconnect_queue_depth;
 
+					/* a sender that is still sending will see the stop */
+					if (conn->shmRing != NULL)
+					{
+						ICShmRingDetach(conn->shmRing);
+						conn->shmRing = NULL;
+					}
+
 					/* out of memory has occurred, break out */
 					if (!conn->pkt_q)
 						break;
@@ -3541,7 +3848,8 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 			" freebuf_avg %f "
 			"mismatch_pkt_num %d disordered_pkt_num %d duplicated_pkt_num %d"
 			" rtt/dev [" UINT64_FORMAT "/" UINT64_FORMAT ", %f/%f, " UINT64_FORMAT "/" UINT64_FORMAT "] "
-			" cwnd %f status_query_msg_num %d",
+			" cwnd %f ssthresh %f congestion_control %s pacing_rate %f status_query_msg_num %d"
+			" shm_snd_pkt_count %d shm_recv_pkt_count %d",
 			ic_control_info.isSender, isReceiver,
 			Gp_interconnect_snd_queue_depth, Gp_interconnect_queue_depth, Gp_max_packet_size,
 			UNACK_QUEUE_RING_SLOTS_NUM, TIMER_SPAN, DEFAULT_RTT,
@@ -3554,7 +3862,11 @@ TeardownUDPIFCInterconnect_Internal(ChunkTransportState *transportStates,
 			(double)((double)ic_statistics.totalBuffers)/((double)ic_statistics.bufferCountingTime),
 			ic_statistics.mismatchNum, ic_statistics.disorderedPktNum, ic_statistics.duplicatedPktNum,
 			(minRtt == ~((uint64)0) ? 0 : minRtt), (minDev == ~((uint64)0) ? 0 : minDev), avgRtt, avgDev, maxRtt, maxDev,
-			snd_control_info.cwnd, ic_statistics.statusQueryMsgNum);
+			snd_control_info.cwnd, snd_control_info.ssthresh, congestion_control->name,
+			snd_control_info.pacingRate, ic_statistics.statusQueryMsgNum,
+			ic_statistics.shmSndPktNum, ic_statistics.shmRecvPktNum);
+
+	ICShmRingCountSent(ic_statistics.shmSndPktNum);
 
 	ic_control_info.isSender = false;
 	memset(&ic_statistics, 0, sizeof(ICStatistics));
@@ -3640,6 +3952,8 @@ receiveChunksUDPIFC(ChunkTransportState *pTransportStates, ChunkTransportStateEn
 {
 	int			retries = 0;
 	bool		directed = false;
+	bool		shmActive = false;
+	int			shmWait = SHM_RING_MIN_WAIT;
 	MotionConn *rxconn = NULL;
 	TupleChunkListItem	tcItem=NULL;
 
@@ -3677,6 +3991,13 @@ receiveChunksUDPIFC(ChunkTransportState *pTransportStates, ChunkTransportStateEn
 			elog(DEBUG2, "receiveChunksUDPIFC: non-directed rx woke on route %d", rx_control_info.mainWaitingState.reachRoute);
 			resetMainThreadWaiting(&rx_control_info.mainWaitingState);
 		}
+		else
+		{
+			/* senders on this host do not wake us up, look at their rings */
+			rxconn = pollShmConns(pEntry, conn, &shmActive);
+			if (rxconn != NULL)
+				resetMainThreadWaiting(&rx_control_info.mainWaitingState);
+		}
 
 		aggregateStatistics(pEntry);
 
@@ -3699,11 +4020,14 @@ receiveChunksUDPIFC(ChunkTransportState *pTransportStates, ChunkTransportStateEn
 		retries++;
 
 		/* 2. Wait for data to become ready */
-		if (waitOnCondition(MAIN_THREAD_COND_TIMEOUT, &ic_control_info.cond, &ic_control_info.lock))
+		if (waitOnCondition(shmActive ? shmWait : MAIN_THREAD_COND_TIMEOUT, &ic_control_info.cond, &ic_control_info.lock))
 		{
 			continue; /* success ! */
 		}
 
+		if (shmActive)
+			shmWait = Min(shmWait * 2, SHM_RING_MAX_WAIT);
+
 		/* handle timeout, check for cancel */
 		pthread_mutex_unlock(&ic_control_info.lock);
 
@@ -3775,7 +4099,18 @@ RecvTupleChunkFromAnyUDPIFC_Internal(MotionLayerState *mlStates,
 		ic_statistics.totalRecvQueueSize += conn->pkt_q_size;
 		ic_statistics.recvQueueSizeCountingTime++;
 
-		if (conn->pkt_q_size > 0)
+		if (conn->shmRing != NULL)
+		{
+			uint8	   *pkt;
+
+			if (conn->stillActive && (pkt = ICShmRingPeek(conn->shmRing)) != NULL)
+			{
+				found = true;
+				prepareShmConnForRead(conn, pkt);
+				break;
+			}
+		}
+		else if (conn->pkt_q_size > 0)
 		{
 			found = true;
 			prepareRxConnForRead(conn);
@@ -3854,6 +4189,7 @@ RecvTupleChunkFromUDPIFC_Internal(ChunkTransportState *transportStates,
 {
 	ChunkTransportStateEntry	*pEntry = NULL;
 	MotionConn			*conn=NULL;
+	uint8				*pkt;
 	int16				route;
 
 	if (!transportStates)
@@ -3897,6 +4233,15 @@ RecvTupleChunkFromUDPIFC_Internal(ChunkTransportState *transportStates,
 	ic_statistics.totalRecvQueueSize += conn->pkt_q_size;
 	ic_statistics.recvQueueSizeCountingTime++;
 
+	if (conn->shmRing != NULL && (pkt = ICShmRingPeek(conn->shmRing)) != NULL)
+	{
+		prepareShmConnForRead(conn, pkt);
+
+		pthread_mutex_unlock(&ic_control_info.lock);
+
+		return RecvTupleChunk(conn, transportStates->teardownActive);
+	}
+
 	if (conn->pkt_q[conn->pkt_q_head] != NULL)
 	{
 		prepareRxConnForRead(conn);
@@ -4021,6 +4366,214 @@ logPkt(char *prefix, icpkthdr *pkt)
 			pkt->flags);
 }
 
+/*
+ * renoInit
+ * 		Start in slow start, up to the size of the send buffer pool.
+ */
+static void
+renoInit(uint64 now)
+{
+}
+
+/*
+ * renoOnAck
+ * 		Grow the window by one packet per ack in slow start, and by one
+ * 		packet per window afterwards.
+ */
+static void
+renoOnAck(MotionConn *conn, uint64 ackTime, uint64 now)
+{
+	if (snd_control_info.cwnd < snd_control_info.ssthresh)
+		snd_control_info.cwnd += 1;
+	else
+		snd_control_info.cwnd += 1/snd_control_info.cwnd;
+	snd_control_info.cwnd = Min(snd_control_info.cwnd, snd_buffer_pool.maxCount);
+}
+
+/*
+ * renoOnLoss
+ * 		Halve the window on a disorder message, and restart from the
+ * 		minimal window on a timeout.
+ */
+static void
+renoOnLoss(bool timeout, uint64 now)
+{
+	snd_control_info.ssthresh = Max(snd_control_info.cwnd/2, snd_control_info.minCwnd);
+	snd_control_info.cwnd = timeout ? snd_control_info.minCwnd : snd_control_info.ssthresh;
+}
+
+/*
+ * cubicInit
+ * 		Start in slow start, like reno.
+ */
+static void
+cubicInit(uint64 now)
+{
+	snd_control_info.wMax = 0;
+	snd_control_info.epochStart = 0;
+	snd_control_info.cubicK = 0;
+}
+
+/*
+ * cubicOnAck
+ * 		After slow start, grow the window towards
+ * 			W(t) = CUBIC_C * (t - K)^3 + wMax
+ * 		where t is the time since the last reduction. The window grows fast
+ * 		far from wMax, flattens around it, and then probes beyond it.
+ */
+static void
+cubicOnAck(MotionConn *conn, uint64 ackTime, uint64 now)
+{
+	if (snd_control_info.cwnd < snd_control_info.ssthresh)
+		snd_control_info.cwnd += 1;
+	else
+	{
+		double		t;
+		double		target;
+
+		if (snd_control_info.epochStart == 0)
+		{
+			/* first epoch without a loss: probe from the current window */
+			snd_control_info.epochStart = now;
+			snd_control_info.wMax = Max(snd_control_info.wMax, snd_control_info.cwnd);
+			snd_control_info.cubicK = cbrt((snd_control_info.wMax - snd_control_info.cwnd) / CUBIC_C);
+		}
+
+		/* target window one rtt ahead */
+		t = (double) (now - snd_control_info.epochStart + conn->rtt) / 1000000;
+		target = CUBIC_C * pow(t - snd_control_info.cubicK, 3) + snd_control_info.wMax;
+
+		if (target > snd_control_info.cwnd)
+			snd_control_info.cwnd += (target - snd_control_info.cwnd) / snd_control_info.cwnd;
+		else
+			snd_control_info.cwnd += 0.01 / snd_control_info.cwnd;
+	}
+	snd_control_info.cwnd = Min(snd_control_info.cwnd, snd_buffer_pool.maxCount);
+}
+
+/*
+ * cubicOnLoss
+ * 		Reduce the window by CUBIC_BETA on a disorder message, and restart
+ * 		from the minimal window on a timeout. Remember the window before the
+ * 		reduction as the point to grow back to.
+ */
+static void
+cubicOnLoss(bool timeout, uint64 now)
+{
+	/* the available bandwidth shrank, leave room for the other senders */
+	if (snd_control_info.cwnd < snd_control_info.wMax)
+		snd_control_info.wMax = snd_control_info.cwnd * (1 + CUBIC_BETA) / 2;
+	else
+		snd_control_info.wMax = snd_control_info.cwnd;
+
+	snd_control_info.ssthresh = Max(snd_control_info.cwnd * CUBIC_BETA, snd_control_info.minCwnd);
+	snd_control_info.cwnd = timeout ? snd_control_info.minCwnd : snd_control_info.ssthresh;
+
+	snd_control_info.epochStart = now;
+	snd_control_info.cubicK = cbrt(Max(snd_control_info.wMax - snd_control_info.cwnd, 0) / CUBIC_C);
+}
+
+/*
+ * pacedInit
+ * 		Start searching for the bottleneck bandwidth, without pacing until
+ * 		the first bandwidth sample.
+ */
+static void
+pacedInit(uint64 now)
+{
+	snd_control_info.minRtt = DEFAULT_RTT;
+	snd_control_info.minRttStamp = now;
+	snd_control_info.btlBw = 0;
+	snd_control_info.roundStart = now;
+	snd_control_info.roundDelivered = 0;
+	snd_control_info.fullPipe = false;
+	snd_control_info.fullBw = 0;
+	snd_control_info.fullBwRounds = 0;
+	snd_control_info.cycleIdx = 0;
+}
+
+/*
+ * pacedOnAck
+ * 		Estimate the bottleneck bandwidth as the delivery rate of the recent
+ * 		rounds, and the propagation delay as the minimal rtt. Then pace the
+ * 		packets at that bandwidth, with the window limited to a few
+ * 		bandwidth-delay products.
+ *
+ * A round lasts one minimal rtt. During startup, the pacing gain is high
+ * enough to double the delivery rate every round, until it stops growing.
+ * Afterwards, the gain cycles to probe for more bandwidth, and to drain the
+ * queue that the probing built.
+ */
+static void
+pacedOnAck(MotionConn *conn, uint64 ackTime, uint64 now)
+{
+	double		gain;
+	double		bdp;
+
+	if (ackTime < snd_control_info.minRtt || now - snd_control_info.minRttStamp > PACED_MIN_RTT_WINDOW)
+	{
+		snd_control_info.minRtt = Max(ackTime, MIN_RTT);
+		snd_control_info.minRttStamp = now;
+	}
+
+	snd_control_info.roundDelivered++;
+	if (now - snd_control_info.roundStart >= snd_control_info.minRtt)
+	{
+		double		rate = (double) snd_control_info.roundDelivered * 1000000 / (now - snd_control_info.roundStart);
+
+		/* max filter, decaying to forget bandwidth that is gone */
+		snd_control_info.btlBw = Max(rate, snd_control_info.btlBw * 7 / 8);
+
+		if (!snd_control_info.fullPipe)
+		{
+			if (snd_control_info.btlBw >= snd_control_info.fullBw * PACED_FULL_BW_THRESH)
+			{
+				snd_control_info.fullBw = snd_control_info.btlBw;
+				snd_control_info.fullBwRounds = 0;
+			}
+			else if (++snd_control_info.fullBwRounds >= PACED_FULL_BW_ROUNDS)
+				snd_control_info.fullPipe = true;
+		}
+		else
+			snd_control_info.cycleIdx = (snd_control_info.cycleIdx + 1) % lengthof(paced_gain_cycle);
+
+		snd_control_info.roundStart = now;
+		snd_control_info.roundDelivered = 0;
+	}
+
+	if (snd_control_info.btlBw == 0)
+	{
+		/* no bandwidth sample yet, grow like slow start */
+		snd_control_info.cwnd = Min(snd_control_info.cwnd + 1, snd_buffer_pool.maxCount);
+		return;
+	}
+
+	gain = snd_control_info.fullPipe ? paced_gain_cycle[snd_control_info.cycleIdx] : PACED_STARTUP_GAIN;
+	snd_control_info.pacingRate = gain * snd_control_info.btlBw;
+
+	bdp = snd_control_info.btlBw * snd_control_info.minRtt / 1000000;
+	snd_control_info.cwnd = snd_control_info.minCwnd + (snd_control_info.fullPipe ? PACED_CWND_GAIN : PACED_STARTUP_GAIN) * bdp;
+	snd_control_info.cwnd = Min(snd_control_info.cwnd, snd_buffer_pool.maxCount);
+}
+
+/*
+ * pacedOnLoss
+ * 		Isolated losses reported by disorder messages are not taken as
+ * 		congestion, the delivery rate already reflects them. A timeout means
+ * 		the estimates are off: halve the bandwidth estimate and the window.
+ */
+static void
+pacedOnLoss(bool timeout, uint64 now)
+{
+	if (!timeout)
+		return;
+
+	snd_control_info.btlBw /= 2;
+	snd_control_info.fullBw = snd_control_info.btlBw;
+	snd_control_info.pacingRate /= 2;
+	snd_control_info.cwnd = Max(snd_control_info.cwnd / 2, snd_control_info.minCwnd);
+}
+
 /*
  * handleAckedPacket
  * 		Called by sender to process acked packet.
@@ -4087,11 +4640,7 @@ handleAckedPacket(MotionConn *ackConn, ICBuffer *buf, uint64 now)
 	        	buf->conn->dev = newDEV;
 
 				/* adjust the congestion control window. */
-	        	if (snd_control_info.cwnd < snd_control_info.ssthresh)
-	        		snd_control_info.cwnd += 1;
-	        	else
-	        		snd_control_info.cwnd += 1/snd_control_info.cwnd;
-	        	snd_control_info.cwnd = Min(snd_control_info.cwnd, snd_buffer_pool.maxCount);
+				congestion_control->onAck(buf->conn, ackTime, now);
 	        }
 		}
 	}
@@ -4400,7 +4949,8 @@ prepareXmit(MotionConn *conn)
 	/* increase the sequence no */
 	conn->conn_info.seq++;
 
-	if (gp_interconnect_full_crc)
+	/* packets in shared memory are not checked */
+	if (gp_interconnect_full_crc && conn->shmRing == NULL)
 	{
 		icpkthdr *pkt = (icpkthdr *)conn->pBuff;
 		addCRC(pkt);
@@ -4478,45 +5028,139 @@ xmit_retry:
 
 
 /*
- * handleStopMsgs
- *		handle stop messages.
+ * sendBatch
+ * 		Send a batch of packets from the send queues, with as few sendmmsg()
+ * 		calls as possible.
  *
+ * A packet that sendmmsg() fails on is handed to sendOnce, which retries it
+ * or reports the error, and the rest of the batch is sent afterwards.
  */
 static void
-handleStopMsgs(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, int16 motionId)
+sendBatch(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, ICBuffer **bufs, int nbufs)
 {
-	int 	i = 0;
+	int			i;
 
-#ifdef AMS_VERBOSE_LOGGING
-	elog(DEBUG3, "handleStopMsgs: node %d", motionId);
-#endif
-	while (i < pEntry->numConns)
+#ifdef UDPIFC_HAVE_MMSG
+	if (nbufs > 1)
 	{
-		MotionConn *conn=NULL;
-
-		conn = pEntry->conns + i;
+		struct mmsghdr msgs[UDPIFC_MAX_BATCH_SIZE];
+		struct iovec iovs[UDPIFC_MAX_BATCH_SIZE];
+		ICBuffer   *msgBufs[UDPIFC_MAX_BATCH_SIZE];
+		int			nmsgs = 0;
+		int			sent = 0;
 
-#ifdef AMS_VERBOSE_LOGGING
-		elog(DEBUG3, "handleStopMsgs: node %d route %d %s %s", motionId, conn->route,
-			(conn->stillActive ? "active" : "NOT active"), (conn->stopRequested ? "stop requested" : ""));
-		elog(DEBUG3, "handleStopMsgs: node %d route %d msgSize %d", motionId, conn->route, conn->msgSize);
-#endif
+		Assert(nbufs <= UDPIFC_MAX_BATCH_SIZE);
 
-		/*
-		 * MPP-2427: we're guaranteed to have recently flushed, but
-		 * this might not be empty (if we got a stop on a buffer that
-		 * wasn't the one we were sending) ... empty it first so the
-		 * outbound buffer is empty when we get here.
-		 */
-		if (conn->stillActive && conn->stopRequested)
+		memset(msgs, 0, nbufs * sizeof(struct mmsghdr));
+		for (i = 0; i < nbufs; i++)
 		{
+			ICBuffer   *buf = bufs[i];
 
-			/* mark buffer empty */
-			conn->tupleCount = 0;
-			conn->msgSize = sizeof(conn->conn_info);
+#ifdef USE_ASSERT_CHECKING
+			if (testmode_inject_fault(gp_udpic_dropxmit_percent))
+			{
+			#ifdef AMS_VERBOSE_LOGGING
+				write_log("THROW PKT with seq %d srcpid %d despid %d", buf->pkt->seq, buf->pkt->srcPid, buf->pkt->dstPid);
+			#endif
+				continue;
+			}
+#endif
 
-			/* now send our stop-ack EOS */
-			conn->conn_info.flags |= UDPIC_FLAGS_EOS;
+			iovs[nmsgs].iov_base = buf->pkt;
+			iovs[nmsgs].iov_len = buf->pkt->len;
+			msgs[nmsgs].msg_hdr.msg_name = &buf->conn->peer;
+			msgs[nmsgs].msg_hdr.msg_namelen = buf->conn->peer_len;
+			msgs[nmsgs].msg_hdr.msg_iov = &iovs[nmsgs];
+			msgs[nmsgs].msg_hdr.msg_iovlen = 1;
+			msgBufs[nmsgs] = buf;
+			nmsgs++;
+		}
+
+		while (sent < nmsgs)
+		{
+			int			n = sendmmsg(pEntry->txfd, msgs + sent, nmsgs - sent, 0);
+
+			if (n < 0)
+			{
+				if (errno == EINTR)
+					continue;
+
+				sendOnce(transportStates, pEntry, msgBufs[sent], msgBufs[sent]->conn);
+				sent++;
+				continue;
+			}
+
+			for (i = sent; i < sent + n; i++)
+			{
+				if (msgs[i].msg_len != msgBufs[i]->pkt->len && DEBUG1 >= log_min_messages)
+					write_log("Interconnect error writing an outgoing packet [seq %d]: short transmit (given %d sent %d) during sendmmsg() call."
+							  "For Remote Connection: contentId=%d at %s", msgBufs[i]->pkt->seq, msgBufs[i]->pkt->len, msgs[i].msg_len,
+							  msgBufs[i]->conn->remoteContentId,
+							  msgBufs[i]->conn->remoteHostAndPort);
+			}
+			sent += n;
+		}
+	}
+	else
+#endif
+	{
+		for (i = 0; i < nbufs; i++)
+			sendOnce(transportStates, pEntry, bufs[i], bufs[i]->conn);
+	}
+
+	for (i = 0; i < nbufs; i++)
+	{
+		ic_statistics.sndPktNum++;
+
+#ifdef AMS_VERBOSE_LOGGING
+		logPkt("SEND PKT DETAIL", bufs[i]->pkt);
+#endif
+
+		bufs[i]->conn->sentSeq = bufs[i]->pkt->seq;
+	}
+}
+
+
+/*
+ * handleStopMsgs
+ *		handle stop messages.
+ *
+ */
+static void
+handleStopMsgs(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, int16 motionId)
+{
+	int 	i = 0;
+
+#ifdef AMS_VERBOSE_LOGGING
+	elog(DEBUG3, "handleStopMsgs: node %d", motionId);
+#endif
+	while (i < pEntry->numConns)
+	{
+		MotionConn *conn=NULL;
+
+		conn = pEntry->conns + i;
+
+#ifdef AMS_VERBOSE_LOGGING
+		elog(DEBUG3, "handleStopMsgs: node %d route %d %s %s", motionId, conn->route,
+			(conn->stillActive ? "active" : "NOT active"), (conn->stopRequested ? "stop requested" : ""));
+		elog(DEBUG3, "handleStopMsgs: node %d route %d msgSize %d", motionId, conn->route, conn->msgSize);
+#endif
+
+		/*
+		 * MPP-2427: we're guaranteed to have recently flushed, but
+		 * this might not be empty (if we got a stop on a buffer that
+		 * wasn't the one we were sending) ... empty it first so the
+		 * outbound buffer is empty when we get here.
+		 */
+		if (conn->stillActive && conn->stopRequested)
+		{
+
+			/* mark buffer empty */
+			conn->tupleCount = 0;
+			conn->msgSize = sizeof(conn->conn_info);
+
+			/* now send our stop-ack EOS */
+			conn->conn_info.flags |= UDPIC_FLAGS_EOS;
 
 			Assert(conn->curBuff != NULL);
 
@@ -4585,12 +5229,18 @@ handleStopMsgs(ChunkTransportState *transportStates, ChunkTransportStateEntry *p
 static void
 sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry, MotionConn *conn)
 {
+	ICBuffer   *batch[UDPIFC_MAX_BATCH_SIZE];
+	int			batchSize = UDPIFC_BATCH_SIZE();
+	int			nbatch = 0;
+
 	while (conn->capacity > 0 && icBufferListLength(&conn->sndQueue) > 0)
 	{
 		ICBuffer *buf = NULL;
+		uint64 now = getCurrentTime();
 
 		if (Gp_interconnect_fc_method == INTERCONNECT_FC_METHOD_LOSS && (icBufferListLength(&conn->unackQueue) > 0
-				&& unack_queue_ring.numSharedOutStanding >= (snd_control_info.cwnd - snd_control_info.minCwnd)))
+				&& (unack_queue_ring.numSharedOutStanding >= (snd_control_info.cwnd - snd_control_info.minCwnd)
+					|| now < snd_control_info.nextSendTime)))
 			break;
 
 		/* for connection setup, we only allow one outstanding packet. */
@@ -4599,7 +5249,6 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 
 		buf = icBufferListPop(&conn->sndQueue);
 
-		uint64 now = getCurrentTime();
 		buf->sentTime = now;
 		buf->unackQueueRingSlot = -1;
 		buf->nRetry = 0;
@@ -4610,6 +5259,11 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 
 		if (Gp_interconnect_fc_method == INTERCONNECT_FC_METHOD_LOSS)
 		{
+			/* space the packets out at the pacing rate, if any */
+			if (snd_control_info.pacingRate > 0)
+				snd_control_info.nextSendTime = Max(now, snd_control_info.nextSendTime) +
+					(uint64) (1000000 / snd_control_info.pacingRate);
+
 			unack_queue_ring.numOutStanding++;
 			if (icBufferListLength(&conn->unackQueue) > 1)
 				unack_queue_ring.numSharedOutStanding++;
@@ -4625,20 +5279,23 @@ sendBuffers(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEnt
 		 * message will be output. In the time of error message output,
 		 * interrupts is potentially checked, if there is a pending query cancel,
 		 * it will lead to a dangled buffer (memory leak).
+		 * The same holds for the packets of a batch.
 		 */
 #ifdef TRANSFER_PROTOCOL_STATS
 		updateStats(TPE_DATA_PKT_SEND, conn, buf->pkt);
 #endif
 
-		sendOnce(transportStates, pEntry, buf, conn);
-		ic_statistics.sndPktNum++;
-
-#ifdef AMS_VERBOSE_LOGGING
-		logPkt("SEND PKT DETAIL", buf->pkt);
-#endif
-
-		buf->conn->sentSeq = buf->pkt->seq;
+		batch[nbatch++] = buf;
+		if (nbatch == batchSize)
+		{
+			sendBatch(transportStates, pEntry, batch, nbatch);
+			nbatch = 0;
+		}
 	}
+
+	/* send the rest of the last batch */
+	if (nbatch > 0)
+		sendBatch(transportStates, pEntry, batch, nbatch);
 }
 
 /*
@@ -4822,10 +5479,7 @@ handleAckForDisorderPkt(ChunkTransportState *transportStates, ChunkTransportStat
 		}
 	}
 	if (Gp_interconnect_fc_method == INTERCONNECT_FC_METHOD_LOSS)
-	{
-		snd_control_info.ssthresh = Max(snd_control_info.cwnd/2, snd_control_info.minCwnd);
-		snd_control_info.cwnd = snd_control_info.ssthresh;
-	}
+		congestion_control->onLoss(false, now);
 #ifdef AMS_VERBOSE_LOGGING
 	write_log("After DISORDER: sndQ %d unackQ %d", icBufferListLength(&conn->sndQueue), icBufferListLength(&conn->unackQueue));
 	if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
@@ -4965,10 +5619,7 @@ checkExpiration(ChunkTransportState *transportStates, ChunkTransportStateEntry *
 	 */
 	unack_queue_ring.currentTime = now - (now % TIMER_SPAN);
 	if (retransmits > 0 )
-	{
-		snd_control_info.ssthresh = Max(snd_control_info.cwnd/2, snd_control_info.minCwnd);
-		snd_control_info.cwnd = snd_control_info.minCwnd;
-	}
+		congestion_control->onLoss(true, now);
 }
 
 /*
@@ -5174,6 +5825,244 @@ computeTimeout(MotionConn *conn, int retry)
     return TIMEOUT(buf->nRetry);
 }
 
+/*
+ * getLocalCdbProcess
+ * 		Find the process of this backend in a slice.
+ *
+ * Pids are only unique on a host, so the segment must match as well.
+ */
+static CdbProcess *
+getLocalCdbProcess(Slice *slice)
+{
+	ListCell   *cell;
+
+	foreach(cell, slice->primaryProcesses)
+	{
+		CdbProcess *cdbProc = (CdbProcess *) lfirst(cell);
+
+		if (cdbProc && cdbProc->contentid == Gp_segment && cdbProc->pid == MyProcPid)
+			return cdbProc;
+	}
+
+	return NULL;
+}
+
+/*
+ * useShmConnection
+ * 		Should a connection go through shared memory instead of UDP?
+ *
+ * Both ends must come to the same answer from their own copy of the slice
+ * table. The listener address of the master is only filled in locally (see
+ * adjustMasterRouting), so only connections between segments qualify; they
+ * are on the same host if they listen on the same address.
+ */
+static bool
+useShmConnection(CdbProcess *sender, CdbProcess *receiver)
+{
+#ifdef WIN32
+	return false;
+#else
+	if (Gp_interconnect_type != INTERCONNECT_TYPE_UDPIFC_SHM)
+		return false;
+
+	if (sender == NULL || receiver == NULL)
+		return false;
+
+	if (sender->contentid < 0 || receiver->contentid < 0)
+		return false;
+
+	if (sender->listenerAddr == NULL || receiver->listenerAddr == NULL)
+		return false;
+
+	return strcmp(sender->listenerAddr, receiver->listenerAddr) == 0;
+#endif
+}
+
+/*
+ * attachShmRing
+ * 		Create or attach to the ring of a shared-memory connection.
+ */
+static ICShmRing *
+attachShmRing(ChunkTransportStateEntry *pEntry, CdbProcess *sender,
+			  CdbProcess *receiver, bool isSender)
+{
+	char		name[64];
+
+	ICShmRingName(name, sizeof(name), gp_session_id, gp_interconnect_id,
+				  pEntry->motNodeId, sender->pid, receiver->pid);
+
+	if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+		elog(DEBUG1, "Interconnect using shared memory ring %s for node %d from seg%d to seg%d",
+			 name, pEntry->motNodeId, sender->contentid, receiver->contentid);
+
+	return ICShmRingAttach(name, SHM_RING_SLOTS, Gp_max_packet_size, isSender);
+}
+
+/*
+ * waitShmRing
+ * 		Wait until the receiver of a shared-memory connection frees a slot
+ * 		in the ring, which then becomes the connection's buffer, or, if drain
+ * 		is true, until it has consumed all the packets.
+ *
+ * Acks of the UDP connections of the same motion are handled while waiting.
+ * If some of them carry stops, *gotStops is set, and the caller must call
+ * handleStopMsgs.
+ *
+ * Returns false if the receiver asked us to stop; the connection is then
+ * inactive. Like for UDP connections, it is an error if the receiver does
+ * not consume anything for gp_interconnect_transmit_timeout.
+ */
+static bool
+waitShmRing(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry,
+			MotionConn *conn, bool drain, bool *gotStops)
+{
+	int			retry = 0;
+	long		wait = SHM_RING_MIN_WAIT;
+	uint32		released = ICShmRingNumReleased(conn->shmRing);
+	uint64		progressTime = getCurrentTime();
+
+	for (;;)
+	{
+		uint64		now;
+
+		if (ICShmRingStopRequested(conn->shmRing))
+		{
+			if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+				elog(DEBUG1, "waitShmRing: node %d route %d, receiver requested stop",
+					 pEntry->motNodeId, conn->route);
+
+			conn->state = mcsEosSent;
+			conn->stillActive = false;
+			conn->pBuff = NULL;
+			return false;
+		}
+
+		if (drain)
+		{
+			if (ICShmRingIsEmpty(conn->shmRing))
+				return true;
+		}
+		else if ((conn->pBuff = ICShmRingGetWriteSlot(conn->shmRing)) != NULL)
+			return true;
+
+		if (pollAcks(transportStates, pEntry->txfd, 0) &&
+			handleAcks(transportStates, pEntry) && gotStops != NULL)
+			*gotStops = true;
+
+		checkExceptions(transportStates, pEntry, conn, retry++, 0);
+
+		now = getCurrentTime();
+		if (ICShmRingNumReleased(conn->shmRing) != released)
+		{
+			released = ICShmRingNumReleased(conn->shmRing);
+			progressTime = now;
+		}
+		else if ((now - progressTime) > ((uint64)Gp_interconnect_transmit_timeout * 1000 * 1000))
+		{
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect encountered a network error, please check your network"),
+							errdetail("Did not get any response from %s (pid %d cid %d) in %d seconds",
+									  conn->remoteHostAndPort, conn->conn_info.dstPid,
+									  conn->conn_info.dstContentId, Gp_interconnect_transmit_timeout)));
+		}
+
+		ICShmRingWaitRelease(conn->shmRing, released, wait);
+		wait = Min(wait * 2, SHM_RING_MAX_WAIT);
+	}
+}
+
+/*
+ * sendChunkShm
+ * 		The part of SendChunkUDPIFC for a full buffer of a shared-memory
+ * 		connection: publish it, and start the next packet in the next slot.
+ */
+static bool
+sendChunkShm(ChunkTransportState *transportStates, ChunkTransportStateEntry *pEntry,
+			 MotionConn *conn, TupleChunkListItem tcItem, int16 motionId)
+{
+	int			length = TYPEALIGN(TUPLE_CHUNK_ALIGN, tcItem->chunk_length);
+	bool		gotStops = false;
+	bool		gotSlot;
+
+	prepareXmit(conn);
+	ICShmRingPublish(conn->shmRing);
+	ic_statistics.shmSndPktNum++;
+	conn->pBuff = NULL;
+
+	gotSlot = waitShmRing(transportStates, pEntry, conn, false, &gotStops);
+
+	if (gotStops)
+		handleStopMsgs(transportStates, pEntry, motionId);
+
+	if (!gotSlot)
+		return true;
+
+	conn->tupleCount = 0;
+	conn->msgSize = sizeof(conn->conn_info);
+
+	memcpy(conn->pBuff + conn->msgSize, tcItem->chunk_data, tcItem->chunk_length);
+	conn->msgSize += length;
+
+	conn->tupleCount++;
+
+	return true;
+}
+
+/*
+ * prepareShmConnForRead
+ * 		Make the packet at the head of the ring the buffer of the connection.
+ *
+ * The packet is read in place, and released by MlPutRxBufferIFC.
+ */
+static void
+prepareShmConnForRead(MotionConn *conn, uint8 *pkt)
+{
+	conn->pBuff = pkt;
+	conn->msgPos = conn->pBuff;
+	conn->msgSize = ((icpkthdr *)conn->pBuff)->len;
+	conn->recvBytes = conn->msgSize;
+
+	ic_statistics.shmRecvPktNum++;
+}
+
+/*
+ * pollShmConns
+ * 		Look for a packet in the rings of the active shared-memory
+ * 		connections, or only in that of conn if it is given.
+ *
+ * Returns the connection, prepared for reading, or NULL. *anyActive tells
+ * whether there is any active shared-memory connection to wait for.
+ */
+static MotionConn *
+pollShmConns(ChunkTransportStateEntry *pEntry, MotionConn *conn, bool *anyActive)
+{
+	int			i;
+
+	*anyActive = false;
+
+	for (i = 0; i < pEntry->numConns; i++)
+	{
+		MotionConn *shmConn = (conn != NULL ? conn : pEntry->conns + i);
+		uint8	   *pkt;
+
+		if (shmConn->shmRing != NULL && shmConn->stillActive)
+		{
+			*anyActive = true;
+
+			if ((pkt = ICShmRingPeek(shmConn->shmRing)) != NULL)
+			{
+				prepareShmConnForRead(shmConn, pkt);
+				return shmConn;
+			}
+		}
+
+		if (conn != NULL)
+			break;
+	}
+
+	return NULL;
+}
+
 /*
  * SendChunkUDPIFC
  * 		is used to send a tcItem to a single destination. Tuples often are
@@ -5213,6 +6102,9 @@ SendChunkUDPIFC(MotionLayerState *mlStates,
 		return true;
 	}
 
+	if (conn->shmRing != NULL)
+		return sendChunkShm(transportStates, pEntry, conn, tcItem, motionId);
+
 	/* prepare this for transmit */
 
 	ic_statistics.totalCapacity += conn->capacity;
@@ -5352,9 +6244,18 @@ SendEosUDPIFC(MotionLayerState *mlStates,
 
 			prepareXmit(conn);
 
-			/* place it into the send queue */
-			icBufferListAppend(&conn->sndQueue, conn->curBuff);
-			sendBuffers(transportStates, pEntry, conn);
+			if (conn->shmRing != NULL)
+			{
+				ICShmRingPublish(conn->shmRing);
+				ic_statistics.shmSndPktNum++;
+				conn->pBuff = NULL;
+			}
+			else
+			{
+				/* place it into the send queue */
+				icBufferListAppend(&conn->sndQueue, conn->curBuff);
+				sendBuffers(transportStates, pEntry, conn);
+			}
 
 			conn->tupleCount = 0;
 			conn->msgSize = sizeof(conn->conn_info);
@@ -5382,7 +6283,12 @@ SendEosUDPIFC(MotionLayerState *mlStates,
 		{
 			conn = pEntry->conns + i;
 
-			if (conn->stillActive)
+			if (conn->stillActive && conn->shmRing != NULL)
+			{
+				/* wait until the receiver has consumed everything, or stopped */
+				waitShmRing(transportStates, pEntry, conn, true, NULL);
+			}
+			else if (conn->stillActive)
 			{
 				retry = 0;
 				ic_control_info.lastPacketSendTime = 0;
@@ -5402,7 +6308,8 @@ SendEosUDPIFC(MotionLayerState *mlStates,
 				}
 			}
 
-			if ((!conn->cdbProc) || (icBufferListLength(&conn->unackQueue) == 0 &&
+			if ((!conn->cdbProc) || conn->shmRing != NULL ||
+				(icBufferListLength(&conn->unackQueue) == 0 &&
 					icBufferListLength(&conn->sndQueue) == 0))
 			{
 				conn->state = mcsEosSent;
@@ -5454,7 +6361,17 @@ doSendStopMessageUDPIFC(ChunkTransportState *transportStates, int16 motNodeID)
 		 */
 		if (conn->stillActive)
 		{
-			if (conn->conn_info.flags & UDPIC_FLAGS_EOS)
+			if (conn->shmRing != NULL)
+			{
+				/* the sender sees the request in the ring, no handshake is needed */
+				if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
+					elog(DEBUG1, "sent stop through shared memory. node %d route %d", motNodeID, i);
+
+				ICShmRingRequestStop(conn->shmRing);
+				conn->stopRequested = true;
+				conn->stillActive = false;
+			}
+			else if (conn->conn_info.flags & UDPIC_FLAGS_EOS)
 			{
 				/* we have a queued packet that has EOS in it. We've acked it, so we're done */
 				if (gp_log_interconnect >= GPVARS_VERBOSITY_DEBUG)
@@ -5966,6 +6883,12 @@ rxThreadFunc(void *arg)
 	icpkthdr *pkt = NULL;
 	bool	skip_poll = false;
 	uint32 	expected = 1;
+#ifdef UDPIFC_HAVE_MMSG
+	icpkthdr *batch[UDPIFC_MAX_BATCH_SIZE];
+	int		i;
+
+	memset(batch, 0, sizeof(batch));
+#endif
 
 	gp_set_thread_sigmasks();
 
@@ -5973,6 +6896,7 @@ rxThreadFunc(void *arg)
 	{
 		struct pollfd nfd;
 		int		n;
+		int		batchSize = UDPIFC_BATCH_SIZE();
 
 		/* check shutdown condition*/
 		expected = 1;
@@ -5985,8 +6909,8 @@ rxThreadFunc(void *arg)
 			break;
 		}
 
-		/* Try to get a buffer */
-		if (pkt == NULL)
+		/* Try to get a buffer, a batch gets its buffers when receiving */
+		if (pkt == NULL && batchSize == 1)
 		{
 			pthread_mutex_lock(&ic_control_info.lock);
 			pkt = getRxBuffer(&rx_buffer_pool);
@@ -6037,12 +6961,20 @@ rxThreadFunc(void *arg)
 				continue;
 		}
 
+#ifdef UDPIFC_HAVE_MMSG
+		/* drain the socket with one call, see gp_interconnect_batch_size */
+		if (batchSize > 1 && (skip_poll || (n == 1 && (nfd.events & POLLIN))))
+		{
+			skip_poll = receivePacketBatch(batch, batchSize);
+			continue;
+		}
+#endif
+
 		if (skip_poll || (n == 1 && (nfd.events & POLLIN)))
 		{
 			/* we've got something interesting to read */
 			/* handle incoming */
 			/* ready to read on our socket */
-			MotionConn *conn = NULL;
 			int read_count = 0;
 
 			struct sockaddr_storage peer;
@@ -6084,48 +7016,12 @@ rxThreadFunc(void *arg)
 				continue;
 			}
 
-			if (read_count < sizeof(icpkthdr))
-			{
-				if (DEBUG1 >= log_min_messages)
-					write_log("Interconnect error: short conn receive (%d)", read_count);
-				continue;
-			}
-
 			/* when we get a "good" recvfrom() result, we can skip poll() until we get a bad one. */
-			skip_poll = true;
+			if (read_count >= sizeof(icpkthdr))
+				skip_poll = true;
 
-			/* length must be >= 0 */
-			if (pkt->len < 0)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound with negative length");
+			if (!rxPacketIsValid(pkt, read_count))
 				continue;
-			}
-
-			if (pkt->len != read_count)
-			{
-				if (DEBUG3 >= log_min_messages)
-					write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
-				continue;
-			}
-
-			/*
-			 * check the CRC of the payload.
-			 */
-			if (gp_interconnect_full_crc)
-			{
-				if (!checkCRC(pkt))
-				{
-					pg_atomic_add_fetch_u32((pg_atomic_uint32 *)&ic_statistics.crcErrors, 1);
-					if (DEBUG2 >= log_min_messages)
-						write_log("received network data error, dropping bad packet, user data unaffected.");
-					continue;
-				}
-			}
-
-			#ifdef AMS_VERBOSE_LOGGING
-				logPkt("GOT MESSAGE", pkt);
-			#endif
 
 			AckSendParam param;
 			memset(&param, 0, sizeof(AckSendParam));
@@ -6140,38 +7036,8 @@ rxThreadFunc(void *arg)
 			 */
 
 			pthread_mutex_lock(&ic_control_info.lock);
-			conn = findConnByHeader(&ic_control_info.connHtab, pkt);
-
-			if (conn != NULL)
-			{
-				/* Handling a regular packet */
-				if (handleDataPacket(conn, pkt, &peer, &peerlen, &param))
-					pkt = NULL;
-				ic_statistics.recvPktNum++;
-			}
-			else
-			{
-				/*
-				 * There may have two kinds of Mismatched packets:
-				 *    a) Past packets from previous command after I was torn down
-				 *    b) Future packets from current command before my connections are built.
-				 *
-				 * The handling logic is to "Ack the past and Nak the future".
-				 */
-				if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
-				{
-					if (DEBUG1 >= log_min_messages)
-						write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
-
-				#ifdef AMS_VERBOSE_LOGGING
-					logPkt("Got a Mismatched Packet", pkt);
-				#endif
-
-					if (handleMismatch(pkt, &peer, peerlen))
-						pkt = NULL;
-					ic_statistics.mismatchNum++;
-				}
-			}
+			if (dispatchRxPacket(pkt, &peer, &peerlen, &param))
+				pkt = NULL;
 			pthread_mutex_unlock(&ic_control_info.lock);
 
 			/* real ack sending is after lock release to decrease the lock holding time. */
@@ -6191,10 +7057,223 @@ rxThreadFunc(void *arg)
 		pthread_mutex_unlock(&ic_control_info.lock);
 	}
 
+#ifdef UDPIFC_HAVE_MMSG
+	pthread_mutex_lock(&ic_control_info.lock);
+	for (i = 0; i < UDPIFC_MAX_BATCH_SIZE; i++)
+	{
+		if (batch[i])
+			freeRxBuffer(&rx_buffer_pool, batch[i]);
+	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+#endif
+
 	/* nothing to return */
 	return NULL;
 }
 
+/*
+ * rxPacketIsValid
+ * 		Check the length and the CRC of a packet received by the rx thread.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ * elog is NOT thread-safe.
+ */
+static bool
+rxPacketIsValid(icpkthdr *pkt, int read_count)
+{
+	if (read_count < sizeof(icpkthdr))
+	{
+		if (DEBUG1 >= log_min_messages)
+			write_log("Interconnect error: short conn receive (%d)", read_count);
+		return false;
+	}
+
+	/* length must be >= 0 */
+	if (pkt->len < 0)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound with negative length");
+		return false;
+	}
+
+	if (pkt->len != read_count)
+	{
+		if (DEBUG3 >= log_min_messages)
+			write_log("received inbound packet [%d], short: read %d bytes, pkt->len %d", pkt->seq, read_count, pkt->len);
+		return false;
+	}
+
+	/*
+	 * check the CRC of the payload.
+	 */
+	if (gp_interconnect_full_crc)
+	{
+		if (!checkCRC(pkt))
+		{
+			pg_atomic_add_fetch_u32((pg_atomic_uint32 *)&ic_statistics.crcErrors, 1);
+			if (DEBUG2 >= log_min_messages)
+				write_log("received network data error, dropping bad packet, user data unaffected.");
+			return false;
+		}
+	}
+
+	#ifdef AMS_VERBOSE_LOGGING
+		logPkt("GOT MESSAGE", pkt);
+	#endif
+
+	return true;
+}
+
+/*
+ * dispatchRxPacket
+ * 		Hand a valid packet received by the rx thread to its connection.
+ *
+ * Returns true if the packet buffer has been kept by the connection. The ack
+ * to send for the packet, if any, is set in param.
+ *
+ * SHOULD BE CALLED WITH ic_control_info.lock *LOCKED*
+ */
+static bool
+dispatchRxPacket(icpkthdr *pkt, struct sockaddr_storage *peer, socklen_t *peerlen, AckSendParam *param)
+{
+	MotionConn *conn = NULL;
+	bool		consumed = false;
+
+	conn = findConnByHeader(&ic_control_info.connHtab, pkt);
+
+	if (conn != NULL)
+	{
+		/* Handling a regular packet */
+		if (handleDataPacket(conn, pkt, peer, peerlen, param))
+			consumed = true;
+		ic_statistics.recvPktNum++;
+	}
+	else
+	{
+		/*
+		 * There may have two kinds of Mismatched packets:
+		 *    a) Past packets from previous command after I was torn down
+		 *    b) Future packets from current command before my connections are built.
+		 *
+		 * The handling logic is to "Ack the past and Nak the future".
+		 */
+		if ((pkt->flags & UDPIC_FLAGS_RECEIVER_TO_SENDER) == 0)
+		{
+			if (DEBUG1 >= log_min_messages)
+				write_log("mismatched packet received, seq %d, srcpid %d, dstpid %d, icid %d, sid %d", pkt->seq, pkt->srcPid, pkt->dstPid, pkt->icId, pkt->sessionId);
+
+		#ifdef AMS_VERBOSE_LOGGING
+			logPkt("Got a Mismatched Packet", pkt);
+		#endif
+
+			if (handleMismatch(pkt, peer, *peerlen))
+				consumed = true;
+			ic_statistics.mismatchNum++;
+		}
+	}
+
+	return consumed;
+}
+
+#ifdef UDPIFC_HAVE_MMSG
+/*
+ * receivePacketBatch
+ * 		Called by rx thread to drain the socket with one recvmmsg() call.
+ *
+ * pkts is the rx thread's batch of receive buffers; empty slots are filled
+ * from the rx buffer pool first, and the slots of the packets kept by their
+ * connections are emptied. The acks of the batch are sent with one
+ * sendmmsg() call, after the lock is released.
+ *
+ * Returns false if nothing was received.
+ *
+ * NOTE: This function MUST NOT contain elog or ereport statements.
+ * elog is NOT thread-safe.
+ */
+static bool
+receivePacketBatch(icpkthdr **pkts, int batchSize)
+{
+	struct mmsghdr msgs[UDPIFC_MAX_BATCH_SIZE];
+	struct iovec iovs[UDPIFC_MAX_BATCH_SIZE];
+	struct sockaddr_storage peers[UDPIFC_MAX_BATCH_SIZE];
+	AckSendParam params[UDPIFC_MAX_BATCH_SIZE];
+	bool		valid[UDPIFC_MAX_BATCH_SIZE];
+	int			nbufs;
+	int			nacks = 0;
+	int			n;
+	int			i;
+
+	Assert(batchSize <= UDPIFC_MAX_BATCH_SIZE);
+
+	/* Try to get buffers */
+	pthread_mutex_lock(&ic_control_info.lock);
+	for (nbufs = 0; nbufs < batchSize; nbufs++)
+	{
+		if (pkts[nbufs] == NULL)
+			pkts[nbufs] = getRxBuffer(&rx_buffer_pool);
+		if (pkts[nbufs] == NULL)
+			break;
+	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	if (nbufs == 0)
+	{
+		setRxThreadError(ENOMEM);
+		return false;
+	}
+
+	memset(msgs, 0, nbufs * sizeof(struct mmsghdr));
+	for (i = 0; i < nbufs; i++)
+	{
+		iovs[i].iov_base = pkts[i];
+		iovs[i].iov_len = Gp_max_packet_size;
+		msgs[i].msg_hdr.msg_name = &peers[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(peers[i]);
+		msgs[i].msg_hdr.msg_iov = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	n = recvmmsg(UDP_listenerFd, msgs, nbufs, 0, NULL);
+
+	if (DEBUG5 >= log_min_messages)
+		write_log("received %d inbound packets", n);
+
+	if (n < 0)
+	{
+		if (errno == EWOULDBLOCK || errno == EINTR)
+			return false;
+
+		write_log("Interconnect error: recvmmsg (%d)", errno);
+		/* let main thread report the error, see rxThreadFunc */
+		setRxThreadError(errno);
+		return false;
+	}
+
+	/* check the packets before taking the lock */
+	for (i = 0; i < n; i++)
+		valid[i] = rxPacketIsValid(pkts[i], msgs[i].msg_len);
+
+	pthread_mutex_lock(&ic_control_info.lock);
+	for (i = 0; i < n; i++)
+	{
+		if (!valid[i])
+			continue;
+
+		memset(&params[nacks], 0, sizeof(AckSendParam));
+		if (dispatchRxPacket(pkts[i], &peers[i], &msgs[i].msg_hdr.msg_namelen, &params[nacks]))
+			pkts[i] = NULL;
+		if (params[nacks].msg.len != 0)
+			nacks++;
+	}
+	pthread_mutex_unlock(&ic_control_info.lock);
+
+	/* real ack sending is after lock release to decrease the lock holding time. */
+	sendAcksWithParams(params, nacks);
+
+	return n > 0;
+}
+#endif
+
 /*
  * handleMismatch
  * 		If the mismatched packet is from an old connection, we may need to
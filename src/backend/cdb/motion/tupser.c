@@ -1017,6 +1017,106 @@ DeserializeTuple(SerTupInfo * pSerInfo, StringInfo serialTup)
 	return htup;
 }
 
+/*
+ * Form a HeapTuple from the serialized tuple data at the cursor of serData.
+ *
+ * The data is only read, so it may point into a receive buffer.
+ */
+static HeapTuple
+deserializeTupleData(SerTupInfo *pSerInfo, StringInfo serData)
+{
+	HeapTuple	htup;
+	TupSerHeader *tshp;
+	unsigned int	datalen;
+	unsigned int	nullslen;
+	unsigned int	hoff;
+	HeapTupleHeader t_data;
+	char *pos = serData->data + serData->cursor;
+
+	tshp = (TupSerHeader *)pos;
+
+	if ((tshp->tuplen & MEMTUP_LEAD_BIT) != 0)
+	{
+		uint32 tuplen = memtuple_size_from_uint32(tshp->tuplen);
+		htup = (HeapTuple) palloc(tuplen);
+		memcpy(htup, pos, tuplen);
+
+		pos += TYPEALIGN(TUPLE_CHUNK_ALIGN,tuplen);
+	}
+	else
+	{
+		pos += sizeof(TupSerHeader);	
+		/* if the tuple had toasted elements we have to deserialize
+		 * the old slow way. */
+		if ((tshp->infomask & HEAP_HASEXTERNAL) != 0)
+		{
+			serData->cursor += sizeof(TupSerHeader);
+
+			return DeserializeTuple(pSerInfo, serData);
+		}
+
+		/* reconstruct lengths of null bitmap and data part */
+		if (tshp->infomask & HEAP_HASNULL)
+			nullslen = BITMAPLEN(tshp->natts);
+		else
+			nullslen = 0;
+
+		if (tshp->tuplen < sizeof(TupSerHeader) + nullslen)
+			ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
+							errmsg("Interconnect error: cannot convert chunks to a  heap tuple."),
+							errdetail("tuple len %d < nullslen %d + headersize (%d)",
+									  tshp->tuplen, nullslen, (int)sizeof(TupSerHeader))));
+
+		datalen = tshp->tuplen - sizeof(TupSerHeader) - TYPEALIGN(TUPLE_CHUNK_ALIGN, nullslen);
+
+		/* determine overhead size of tuple (should match heap_form_tuple) */
+		hoff = offsetof(HeapTupleHeaderData, t_bits) + TYPEALIGN(TUPLE_CHUNK_ALIGN, nullslen);
+		if (tshp->infomask & HEAP_HASOID)
+			hoff += sizeof(Oid);
+		hoff = MAXALIGN(hoff);
+
+		/* Allocate the space in one chunk, like heap_form_tuple */
+		htup = (HeapTuple)palloc(HEAPTUPLESIZE + hoff + datalen);
+
+		t_data = (HeapTupleHeader) ((char *)htup + HEAPTUPLESIZE);
+
+		/* make sure unused header fields are zeroed */
+		MemSetAligned(t_data, 0, hoff);
+
+		/* reconstruct the HeapTupleData fields */
+		htup->t_len = hoff + datalen;
+		ItemPointerSetInvalid(&(htup->t_self));
+		htup->t_data = t_data;
+
+		/* reconstruct the HeapTupleHeaderData fields */
+		ItemPointerSetInvalid(&(t_data->t_ctid));
+		HeapTupleHeaderSetNatts(t_data, tshp->natts);
+		t_data->t_infomask = tshp->infomask & ~HEAP_XACT_MASK;
+		t_data->t_infomask |= HEAP_XMIN_INVALID | HEAP_XMAX_INVALID;
+		t_data->t_hoff = hoff;
+
+		if (nullslen)
+		{
+			memcpy((void *)t_data->t_bits, pos, nullslen);
+			pos += TYPEALIGN(TUPLE_CHUNK_ALIGN,nullslen);
+		}
+
+		/* does the tuple descriptor expect an OID ? Note: we don't
+		 * have to set the oid itself, just the flag! (see heap_formtuple()) */
+		if (pSerInfo->tupdesc->tdhasoid)		/* else leave infomask = 0 */
+		{
+			t_data->t_infomask |= HEAP_HASOID;
+		}
+
+		/* and now the data proper (it would be nice if we could just
+		 * point our caller into our existing buffer in-place, but
+		 * we'll leave that for another day) */
+		memcpy((char *)t_data + hoff, pos, datalen);
+	}
+
+	return htup;
+}
+
 HeapTuple
 CvtChunksToHeapTup(TupleChunkList tcList, SerTupInfo * pSerInfo)
 {
@@ -1125,102 +1225,48 @@ CvtChunksToHeapTup(TupleChunkList tcList, SerTupInfo * pSerInfo)
 	/* we've finished with the TCList, free it now. */
 	clearTCList(NULL, tcList);
 
-	{
-		TupSerHeader *tshp;
-		unsigned int	datalen;
-		unsigned int	nullslen;
-		unsigned int	hoff;
-		HeapTupleHeader t_data;
-		char *pos = (char *)serData.data;
-
-		tshp = (TupSerHeader *)pos;
+	htup = deserializeTupleData(pSerInfo, &serData);
 
-		if ((tshp->tuplen & MEMTUP_LEAD_BIT) != 0)
-		{
-			uint32 tuplen = memtuple_size_from_uint32(tshp->tuplen);
-			htup = (HeapTuple) palloc(tuplen);
-			memcpy(htup, pos, tuplen);
-
-			pos += TYPEALIGN(TUPLE_CHUNK_ALIGN,tuplen);
-		}
-		else
-		{
-			pos += sizeof(TupSerHeader);	
-			/* if the tuple had toasted elements we have to deserialize
-			 * the old slow way. */
-			if ((tshp->infomask & HEAP_HASEXTERNAL) != 0)
-			{
-				serData.cursor += sizeof(TupSerHeader);
-
-				htup = DeserializeTuple(pSerInfo, &serData);
-
-				/* Free up memory we used. */
-				pfree(serData.data);
-				return htup;
-			}
-
-			/* reconstruct lengths of null bitmap and data part */
-			if (tshp->infomask & HEAP_HASNULL)
-				nullslen = BITMAPLEN(tshp->natts);
-			else
-				nullslen = 0;
-
-			if (tshp->tuplen < sizeof(TupSerHeader) + nullslen)
-				ereport(ERROR, (errcode(ERRCODE_GP_INTERCONNECTION_ERROR),
-								errmsg("Interconnect error: cannot convert chunks to a  heap tuple."),
-								errdetail("tuple len %d < nullslen %d + headersize (%d)",
-										  tshp->tuplen, nullslen, (int)sizeof(TupSerHeader))));
-
-			datalen = tshp->tuplen - sizeof(TupSerHeader) - TYPEALIGN(TUPLE_CHUNK_ALIGN, nullslen);
-
-			/* determine overhead size of tuple (should match heap_form_tuple) */
-			hoff = offsetof(HeapTupleHeaderData, t_bits) + TYPEALIGN(TUPLE_CHUNK_ALIGN, nullslen);
-			if (tshp->infomask & HEAP_HASOID)
-				hoff += sizeof(Oid);
-			hoff = MAXALIGN(hoff);
-
-			/* Allocate the space in one chunk, like heap_form_tuple */
-			htup = (HeapTuple)palloc(HEAPTUPLESIZE + hoff + datalen);
-
-			t_data = (HeapTupleHeader) ((char *)htup + HEAPTUPLESIZE);
-
-			/* make sure unused header fields are zeroed */
-			MemSetAligned(t_data, 0, hoff);
+	/* Free up memory we used. */
+	pfree(serData.data);
 
-			/* reconstruct the HeapTupleData fields */
-			htup->t_len = hoff + datalen;
-			ItemPointerSetInvalid(&(htup->t_self));
-			htup->t_data = t_data;
+	return htup;
+}
 
-			/* reconstruct the HeapTupleHeaderData fields */
-			ItemPointerSetInvalid(&(t_data->t_ctid));
-			HeapTupleHeaderSetNatts(t_data, tshp->natts);
-			t_data->t_infomask = tshp->infomask & ~HEAP_XACT_MASK;
-			t_data->t_infomask |= HEAP_XMIN_INVALID | HEAP_XMAX_INVALID;
-			t_data->t_hoff = hoff;
+/*
+ * Convert a single TC_WHOLE or TC_EMPTY chunk into a HeapTuple.
+ *
+ * Unlike CvtChunksToHeapTup(), the tuple is formed straight from the chunk,
+ * which may be in place in a receive buffer, without going through a
+ * TupleChunkList or copying the serialized data.
+ */
+HeapTuple
+CvtChunkToHeapTup(const char *chunk, int chunkLength, SerTupInfo *pSerInfo)
+{
+	StringInfoData serData;
+	uint16		tcType;
 
-			if (nullslen)
-			{
-				memcpy((void *)t_data->t_bits, pos, nullslen);
-				pos += TYPEALIGN(TUPLE_CHUNK_ALIGN,nullslen);
-			}
+	AssertArg(chunk != NULL);
+	AssertArg(chunkLength >= TUPLE_CHUNK_HEADER_SIZE);
+	AssertArg(pSerInfo != NULL);
 
-			/* does the tuple descriptor expect an OID ? Note: we don't
-			 * have to set the oid itself, just the flag! (see heap_formtuple()) */
-			if (pSerInfo->tupdesc->tdhasoid)		/* else leave infomask = 0 */
-			{
-				t_data->t_infomask |= HEAP_HASOID;
-			}
+	memcpy(&tcType, chunk + 2, sizeof(uint16));
 
-			/* and now the data proper (it would be nice if we could just
-			 * point our caller into our existing buffer in-place, but
-			 * we'll leave that for another day) */
-			memcpy((char *)t_data + hoff, pos, datalen);
-		}
+	if (tcType == TC_EMPTY)
+	{
+		/* a row with no attributes, see CvtChunksToHeapTup() */
+		return heap_form_tuple(pSerInfo->tupdesc, pSerInfo->values, pSerInfo->nulls);
 	}
 
-	/* Free up memory we used. */
-	pfree(serData.data);
+	if (tcType != TC_WHOLE)
+		ereport(ERROR, (errcode(ERRCODE_PROTOCOL_VIOLATION),
+						errmsg("Single chunk's type must be TC_WHOLE.")));
 
-	return htup;
+	/* a read-only StringInfo over the chunk data, without the header */
+	serData.data = (char *) chunk + TUPLE_CHUNK_HEADER_SIZE;
+	serData.len = chunkLength - TUPLE_CHUNK_HEADER_SIZE;
+	serData.maxlen = serData.len;
+	serData.cursor = 0;
+
+	return deserializeTupleData(pSerInfo, &serData);
 }
@@ -0,0 +1,471 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    codegen_benchmark.cc
+//
+//  @doc:
+//    Micro-benchmark of the generated versions of ExecVariableList,
+//    slot_getattr, ExecEvalExpr and advance_aggregates against their regular
+//    versions. Reports the time per tuple of each version, and the time to
+//    generate and compile the code at every optimization level.
+//
+//---------------------------------------------------------------------------
+
+#include "codegen/codegen_wrapper.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "codegen/codegen_config.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "access/heapam.h"
+#include "access/tupdesc.h"
+#include "catalog/pg_authid.h"
+#include "catalog/pg_type.h"
+#include "executor/executor.h"
+#include "executor/nodeAgg.h"
+#include "executor/tuptable.h"
+#include "miscadmin.h"
+#include "nodes/execnodes.h"
+#include "nodes/makefuncs.h"
+#include "nodes/primnodes.h"
+#include "utils/guc.h"
+#include "utils/memutils.h"
+}
+
+namespace {
+
+// Number of synthetic tuples, and of timed passes over all of them
+constexpr int kNumTuples = 1 << 16;
+constexpr int kNumPasses = 20;
+
+// Every synthetic tuple has this many int4 attributes
+constexpr int kNumAttrs = 8;
+
+// pg_proc and pg_operator Oids of the built-in functions used below
+constexpr Oid kInt4PlOid = 177;
+constexpr Oid kInt4PlOpOid = 551;
+constexpr Oid kInt4GtOid = 147;
+constexpr Oid kInt4GtOpOid = 521;
+constexpr Oid kInt4SumOid = 1841;
+constexpr Oid kSumInt4AggOid = 2108;
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// Builds a TupleDesc of natts int4 attributes without going through the
+// catalog, as TupleDescInitEntry() does.
+TupleDesc MakeInt4TupleDesc(int natts) {
+  TupleDesc tupdesc = CreateTemplateTupleDesc(natts, false);
+  for (int i = 0; i < natts; ++i) {
+    Form_pg_attribute att = tupdesc->attrs[i];
+    memset(att, 0, ATTRIBUTE_FIXED_PART_SIZE);
+    snprintf(NameStr(att->attname), NAMEDATALEN, "a%d", i + 1);
+    att->attnum = i + 1;
+    att->atttypid = INT4OID;
+    att->atttypmod = -1;
+    att->attlen = sizeof(int32);
+    att->attbyval = true;
+    att->attalign = 'i';
+    att->attstorage = 'p';
+    att->attcacheoff = -1;
+    att->attndims = 0;
+    att->attislocal = true;
+  }
+  return tupdesc;
+}
+
+// Target list of Vars referencing the given attributes of varno
+List* MakeVarTargetList(Index varno, const std::vector<AttrNumber>& attnos) {
+  List* tlist = NIL;
+  AttrNumber resno = 1;
+  for (AttrNumber attno : attnos) {
+    Var* var = makeVar(varno, attno, INT4OID, -1, 0);
+    tlist = lappend(tlist, makeTargetEntry(reinterpret_cast<Expr*>(var),
+                                           resno++, nullptr, false));
+  }
+  return tlist;
+}
+
+OpExpr* MakeOpExpr(Oid opno, Oid opfuncid, Oid opresulttype,
+                   Expr* left, Expr* right) {
+  OpExpr* op = makeNode(OpExpr);
+  op->opno = opno;
+  op->opfuncid = opfuncid;
+  op->opresulttype = opresulttype;
+  op->opretset = false;
+  op->args = list_make2(left, right);
+  op->location = -1;
+  return op;
+}
+
+/**
+ * @brief One operator being measured. Each run stores every synthetic tuple
+ *        in turn in the input slot and calls the operator through its
+ *        function pointer, which may point to either version.
+ **/
+class OperatorBenchmark {
+ public:
+  OperatorBenchmark(const char* name, TupleTableSlot* slot,
+                    const std::vector<HeapTuple>& tuples)
+      : name_(name), slot_(slot), tuples_(tuples) {
+  }
+
+  virtual ~OperatorBenchmark() = default;
+
+  const char* name() const {
+    return name_;
+  }
+
+  /**
+   * @brief Enroll the generator of the operator with the active manager,
+   *        which also points the function pointer to the regular version.
+   **/
+  virtual void Enroll() = 0;
+
+  /**
+   * @brief Process every tuple once.
+   *
+   * @return A checksum of the results, which must not depend on the version
+   *         that computed them.
+   **/
+  virtual int64 Run() = 0;
+
+ protected:
+  void StoreTuple(int i) {
+    ExecStoreHeapTuple(tuples_[i], slot_, InvalidBuffer, false);
+  }
+
+  const char* name_;
+  TupleTableSlot* slot_;
+  const std::vector<HeapTuple>& tuples_;
+};
+
+// Projects all the attributes of the scan tuple. The generated
+// ExecVariableList deforms the tuple with a generated slot_getattr, so this
+// covers both.
+class ExecVariableListBenchmark : public OperatorBenchmark {
+ public:
+  ExecVariableListBenchmark(TupleTableSlot* slot,
+                            const std::vector<HeapTuple>& tuples)
+      : OperatorBenchmark("ExecVariableList/slot_getattr", slot, tuples) {
+    std::vector<AttrNumber> attnos;
+    for (int i = 1; i <= kNumAttrs; ++i) {
+      attnos.push_back(i);
+    }
+    List* tlist = MakeVarTargetList(1, attnos);
+    econtext_ = CreateStandaloneExprContext();
+    econtext_->ecxt_scantuple = slot;
+    proj_info_ = ExecBuildProjectionInfo(
+        reinterpret_cast<List*>(ExecInitExpr(
+            reinterpret_cast<Expr*>(tlist), nullptr)),
+        econtext_,
+        MakeSingleTupleTableSlot(slot->tts_tupleDescriptor),
+        slot->tts_tupleDescriptor);
+    Assert(proj_info_->pi_isVarList);
+  }
+
+  void Enroll() override {
+    enroll_ExecVariableList_codegen(
+        ExecVariableList,
+        &proj_info_->ExecVariableList_gen_info.ExecVariableList_fn,
+        proj_info_, slot_);
+  }
+
+  int64 Run() override {
+    Datum values[kNumAttrs];
+    bool isnull[kNumAttrs];
+    int64 checksum = 0;
+    for (size_t i = 0; i < tuples_.size(); ++i) {
+      StoreTuple(i);
+      call_ExecVariableList(proj_info_, values, isnull);
+      for (int j = 0; j < kNumAttrs; ++j) {
+        checksum += isnull[j] ? 0 : DatumGetInt32(values[j]);
+      }
+    }
+    return checksum;
+  }
+
+ private:
+  ExprContext* econtext_;
+  ProjectionInfo* proj_info_;
+};
+
+// Evaluates (a1 + a2) > a3 over the scan tuple, the way a SeqScan evaluates
+// its quals.
+class ExecEvalExprBenchmark : public OperatorBenchmark {
+ public:
+  ExecEvalExprBenchmark(TupleTableSlot* slot,
+                        const std::vector<HeapTuple>& tuples)
+      : OperatorBenchmark("ExecEvalExpr", slot, tuples) {
+    Expr* a1 = reinterpret_cast<Expr*>(makeVar(1, 1, INT4OID, -1, 0));
+    Expr* a2 = reinterpret_cast<Expr*>(makeVar(1, 2, INT4OID, -1, 0));
+    Expr* a3 = reinterpret_cast<Expr*>(makeVar(1, 3, INT4OID, -1, 0));
+    OpExpr* sum = MakeOpExpr(kInt4PlOpOid, kInt4PlOid, INT4OID, a1, a2);
+    OpExpr* gt = MakeOpExpr(kInt4GtOpOid, kInt4GtOid, BOOLOID,
+                            reinterpret_cast<Expr*>(sum), a3);
+
+    econtext_ = CreateStandaloneExprContext();
+    econtext_->ecxt_scantuple = slot;
+    scan_state_ = makeNode(SeqScanState);
+    scan_state_->ss.ss_ScanTupleSlot = slot;
+    exprstate_ = ExecInitExpr(reinterpret_cast<Expr*>(gt), nullptr);
+
+    // The first call looks up the functions and switches evalfunc to the
+    // function used for every later call, which is the one to measure.
+    bool isnull;
+    StoreTuple(0);
+    ExecEvalExpr(exprstate_, econtext_, &isnull, nullptr);
+    regular_evalfunc_ = exprstate_->evalfunc;
+  }
+
+  void Enroll() override {
+    enroll_ExecEvalExpr_codegen(regular_evalfunc_, &exprstate_->evalfunc,
+                                exprstate_, econtext_,
+                                reinterpret_cast<PlanState*>(scan_state_));
+  }
+
+  int64 Run() override {
+    int64 checksum = 0;
+    for (size_t i = 0; i < tuples_.size(); ++i) {
+      bool isnull;
+      StoreTuple(i);
+      Datum result = ExecEvalExpr(exprstate_, econtext_, &isnull, nullptr);
+      checksum += (!isnull && DatumGetBool(result)) ? 1 : 0;
+    }
+    return checksum;
+  }
+
+ private:
+  ExprContext* econtext_;
+  SeqScanState* scan_state_;
+  ExprState* exprstate_;
+  ExprStateEvalFunc regular_evalfunc_;
+};
+
+// Advances sum(a1) and sum(a4) of a plain Agg over the outer tuple. The
+// AggState is set up by hand with only what advance_aggregates() reads, since
+// ExecInitAgg() needs the catalog.
+class AdvanceAggregatesBenchmark : public OperatorBenchmark {
+ public:
+  static constexpr int kNumAggs = 2;
+
+  AdvanceAggregatesBenchmark(TupleTableSlot* slot,
+                             const std::vector<HeapTuple>& tuples)
+      : OperatorBenchmark("advance_aggregates", slot, tuples) {
+    const AttrNumber agg_attnos[kNumAggs] = {1, 4};
+
+    aggstate_ = makeNode(AggState);
+    aggstate_->numaggs = kNumAggs;
+    aggstate_->tmpcontext = CreateStandaloneExprContext();
+    aggstate_->tmpcontext->ecxt_outertuple = slot;
+    aggstate_->peragg = static_cast<AggStatePerAgg>(
+        palloc0(sizeof(AggStatePerAggData) * kNumAggs));
+    pergroup_ = static_cast<AggStatePerGroup>(
+        palloc0(sizeof(AggStatePerGroupData) * kNumAggs));
+
+    for (int aggno = 0; aggno < kNumAggs; ++aggno) {
+      AggStatePerAgg peraggstate = &aggstate_->peragg[aggno];
+      List* args = MakeVarTargetList(OUTER, {agg_attnos[aggno]});
+
+      Aggref* aggref = makeNode(Aggref);
+      aggref->aggfnoid = kSumInt4AggOid;
+      aggref->aggtype = INT8OID;
+      aggref->args = args;
+      peraggstate->aggref = aggref;
+      peraggstate->numArguments = 1;
+      peraggstate->numInputs = 1;
+      peraggstate->transfn_oid = kInt4SumOid;
+      fmgr_info(kInt4SumOid, &peraggstate->transfn);
+      peraggstate->initValueIsNull = true;
+      peraggstate->inputtypeLen = sizeof(int32);
+      peraggstate->inputtypeByVal = true;
+      peraggstate->transtypeLen = sizeof(int64);
+      peraggstate->transtypeByVal = true;
+      peraggstate->resulttypeLen = sizeof(int64);
+      peraggstate->resulttypeByVal = true;
+      peraggstate->evaldesc = MakeInt4TupleDesc(1);
+      peraggstate->evalslot = MakeSingleTupleTableSlot(peraggstate->evaldesc);
+      peraggstate->evalproj = ExecBuildProjectionInfo(
+          reinterpret_cast<List*>(ExecInitExpr(
+              reinterpret_cast<Expr*>(args), nullptr)),
+          aggstate_->tmpcontext,
+          peraggstate->evalslot,
+          nullptr);
+    }
+  }
+
+  void Enroll() override {
+    enroll_AdvanceAggregates_codegen(
+        advance_aggregates,
+        &aggstate_->AdvanceAggregates_gen_info.AdvanceAggregates_fn,
+        aggstate_);
+  }
+
+  int64 Run() override {
+    for (int aggno = 0; aggno < kNumAggs; ++aggno) {
+      pergroup_[aggno].transValue = 0;
+      pergroup_[aggno].transValueIsNull = true;
+      pergroup_[aggno].noTransValue = true;
+    }
+    for (size_t i = 0; i < tuples_.size(); ++i) {
+      StoreTuple(i);
+      call_AdvanceAggregates(aggstate_, pergroup_, nullptr);
+      ResetExprContext(aggstate_->tmpcontext);
+    }
+    int64 checksum = 0;
+    for (int aggno = 0; aggno < kNumAggs; ++aggno) {
+      if (!pergroup_[aggno].transValueIsNull) {
+        checksum += DatumGetInt64(pergroup_[aggno].transValue);
+      }
+    }
+    return checksum;
+  }
+
+ private:
+  AggState* aggstate_;
+  AggStatePerGroup pergroup_;
+};
+
+// Time kNumPasses runs after a warm-up run, in nanoseconds per tuple.
+double MeasureNsPerTuple(OperatorBenchmark* benchmark, int64* checksum) {
+  *checksum = benchmark->Run();
+  Clock::time_point start = Clock::now();
+  for (int pass = 0; pass < kNumPasses; ++pass) {
+    benchmark->Run();
+  }
+  return ElapsedMs(start) * 1e6 /
+      (static_cast<double>(kNumPasses) * kNumTuples);
+}
+
+/**
+ * @brief Measure the regular version of the operator, then generate, compile
+ *        and measure the generated version at every optimization level.
+ *
+ * @return false if the generated version could not be used, or computed a
+ *         different result.
+ **/
+bool RunBenchmark(OperatorBenchmark* benchmark) {
+  bool success = true;
+
+  // Without a manager the regular version stays in place
+  codegen = false;
+  benchmark->Enroll();
+  codegen = true;
+  int64 regular_checksum;
+  double regular_ns = MeasureNsPerTuple(benchmark, &regular_checksum);
+
+  for (int level = CODEGEN_OPTIMIZATION_LEVEL_NONE;
+       level <= CODEGEN_OPTIMIZATION_LEVEL_AGGRESSIVE; ++level) {
+    codegen_optimization_level = level;
+    void* manager = CodeGeneratorManagerCreate(benchmark->name(), -1);
+
+    START_CODE_GENERATOR_MANAGER(manager);
+    {
+      benchmark->Enroll();
+    }
+    END_CODE_GENERATOR_MANAGER();
+
+    Clock::time_point start = Clock::now();
+    unsigned int generated = CodeGeneratorManagerGenerateCode(manager);
+    double generate_ms = ElapsedMs(start);
+    start = Clock::now();
+    unsigned int prepared =
+        CodeGeneratorManagerPrepareGeneratedFunctions(manager);
+    double compile_ms = ElapsedMs(start);
+
+    if (0 == generated || 0 == prepared) {
+      printf("%-30s O%d  code generation failed\n", benchmark->name(), level);
+      success = false;
+    } else {
+      int64 generated_checksum;
+      double generated_ns = MeasureNsPerTuple(benchmark, &generated_checksum);
+      printf("%-30s O%d  %10.3f %10.3f %10.2f %10.2f %8.2fx%s\n",
+             benchmark->name(), level, generate_ms, compile_ms,
+             regular_ns, generated_ns, regular_ns / generated_ns,
+             generated_checksum == regular_checksum ? "" : "  MISMATCH");
+      success = success && generated_checksum == regular_checksum;
+    }
+
+    CodeGeneratorManagerDestroy(manager);
+  }
+  return success;
+}
+
+// Deterministic int4 values, with a NULL in every 64th row of the last
+// attribute
+std::vector<HeapTuple> MakeTuples(TupleDesc tupdesc) {
+  std::vector<HeapTuple> tuples;
+  tuples.reserve(kNumTuples);
+  Datum values[kNumAttrs];
+  bool isnull[kNumAttrs];
+  unsigned int seed = 42;
+  for (int i = 0; i < kNumTuples; ++i) {
+    for (int j = 0; j < kNumAttrs; ++j) {
+      seed = seed * 1103515245 + 12345;
+      values[j] = Int32GetDatum(static_cast<int32>((seed >> 16) % 10000));
+      isnull[j] = (j == kNumAttrs - 1) && (i % 64 == 0);
+    }
+    tuples.push_back(heap_form_tuple(tupdesc, values, isnull));
+  }
+  return tuples;
+}
+
+}  // namespace
+
+int main() {
+  MemoryContextInit();
+  // Function permission checks pass for the bootstrap superuser without
+  // looking up pg_authid, since we are not under the postmaster.
+  SetUserIdAndSecContext(BOOTSTRAP_SUPERUSERID, 0);
+
+  if (0 == InitCodegen()) {
+    fprintf(stderr, "failed to initialize LLVM library\n");
+    return EXIT_FAILURE;
+  }
+  codegen = true;
+  codegen_exec_variable_list = true;
+  codegen_slot_getattr = true;
+  codegen_exec_eval_expr = true;
+  codegen_advance_aggregate = true;
+  // Compile synchronously and without the object cache, so that every level
+  // pays for the whole compilation.
+  codegen_async_compile = false;
+  codegen_object_cache_size = 0;
+  codegen_min_rows = 0;
+  codegen_aggressive_rows = 0;
+
+  TupleDesc tupdesc = MakeInt4TupleDesc(kNumAttrs);
+  TupleTableSlot* slot = MakeSingleTupleTableSlot(tupdesc);
+  std::vector<HeapTuple> tuples = MakeTuples(tupdesc);
+
+  std::vector<std::unique_ptr<OperatorBenchmark>> benchmarks;
+  benchmarks.emplace_back(new ExecVariableListBenchmark(slot, tuples));
+  benchmarks.emplace_back(new ExecEvalExprBenchmark(slot, tuples));
+  benchmarks.emplace_back(new AdvanceAggregatesBenchmark(slot, tuples));
+
+  printf("%d tuples of %d int4 attributes, %d passes\n\n",
+         kNumTuples, kNumAttrs, kNumPasses);
+  printf("%-30s %-3s %10s %10s %10s %10s %9s\n", "operator", "opt",
+         "gen (ms)", "jit (ms)", "regular", "generated", "speedup");
+  printf("%-30s %-3s %10s %10s %10s %10s\n", "", "", "", "",
+         "(ns/tuple)", "(ns/tuple)");
+
+  bool success = true;
+  for (auto& benchmark : benchmarks) {
+    success = RunBenchmark(benchmark.get()) && success;
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,190 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    bool_expr_tree_generator.cc
+//
+//  @doc:
+//    Object that generate code for AND, OR and NOT expressions.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "codegen/bool_expr_tree_generator.h"
+#include "codegen/expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "nodes/execnodes.h"
+#include "utils/elog.h"
+#include "nodes/nodes.h"
+#include "nodes/pg_list.h"
+#include "nodes/primnodes.h"
+}
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+using gpcodegen::BoolExprTreeGenerator;
+using gpcodegen::ExprTreeGenerator;
+using gpcodegen::GpCodegenUtils;
+
+BoolExprTreeGenerator::BoolExprTreeGenerator(
+    const ExprState* expr_state,
+    std::vector<
+        std::unique_ptr<ExprTreeGenerator>>&& arguments)  // NOLINT(build/c++11)
+    :  ExprTreeGenerator(expr_state, ExprTreeNodeType::kBool),
+       arguments_(std::move(arguments)) {
+}
+
+bool BoolExprTreeGenerator::VerifyAndCreateExprTree(
+    const ExprState* expr_state,
+    ExprTreeGeneratorInfo* gen_info,
+    std::unique_ptr<ExprTreeGenerator>* expr_tree) {
+  assert(nullptr != expr_state &&
+         nullptr != expr_state->expr &&
+         T_BoolExpr == nodeTag(expr_state->expr) &&
+         nullptr != expr_tree);
+
+  expr_tree->reset(nullptr);
+  BoolExpr* bool_expr = reinterpret_cast<BoolExpr*>(expr_state->expr);
+  List* arguments = reinterpret_cast<const BoolExprState*>(expr_state)->args;
+  if (NOT_EXPR == bool_expr->boolop) {
+    assert(1 == list_length(arguments));
+  } else if (AND_EXPR != bool_expr->boolop && OR_EXPR != bool_expr->boolop) {
+    elog(DEBUG1, "Unsupported boolean expression type %d.", bool_expr->boolop);
+    return false;
+  }
+
+  ListCell* arg = nullptr;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> expr_tree_arguments;
+  foreach(arg, arguments) {
+    ExprState* argstate = reinterpret_cast<ExprState*>(lfirst(arg));
+    assert(nullptr != argstate);
+    std::unique_ptr<ExprTreeGenerator> arg_tree(nullptr);
+    if (!ExprTreeGenerator::VerifyAndCreateExprTree(argstate,
+                                                    gen_info,
+                                                    &arg_tree)) {
+      return false;
+    }
+    expr_tree_arguments.push_back(std::move(arg_tree));
+  }
+  expr_tree->reset(new BoolExprTreeGenerator(expr_state,
+                                             std::move(expr_tree_arguments)));
+  return true;
+}
+
+bool BoolExprTreeGenerator::GenerateCode(GpCodegenUtils* codegen_utils,
+                                         const ExprTreeGeneratorInfo& gen_info,
+                                         llvm::Value** llvm_out_value,
+                                         llvm::Value* const llvm_isnull_ptr) {
+  assert(nullptr != llvm_out_value);
+  assert(nullptr != llvm_isnull_ptr);
+  *llvm_out_value = nullptr;
+  BoolExpr* bool_expr = reinterpret_cast<BoolExpr*>(expr_state()->expr);
+
+  switch (bool_expr->boolop) {
+    case AND_EXPR:
+      return GenerateAndOr(codegen_utils, gen_info, true /* is_and */,
+                           llvm_out_value, llvm_isnull_ptr);
+    case OR_EXPR:
+      return GenerateAndOr(codegen_utils, gen_info, false /* is_and */,
+                           llvm_out_value, llvm_isnull_ptr);
+    case NOT_EXPR: {
+      // Same as ExecEvalNot(): NOT NULL is NULL
+      auto irb = codegen_utils->ir_builder();
+      llvm::Value* llvm_arg = nullptr;
+      llvm::Value* llvm_arg_isnull = nullptr;
+      if (!GenerateArgumentCode(codegen_utils, gen_info, arguments_[0].get(),
+                                &llvm_arg, &llvm_arg_isnull)) {
+        return false;
+      }
+      irb->CreateStore(llvm_arg_isnull, llvm_isnull_ptr);
+      *llvm_out_value = irb->CreateSelect(
+          llvm_arg_isnull,
+          codegen_utils->GetConstant<Datum>(0),
+          codegen_utils->CreateCppTypeToDatumCast(irb->CreateICmpEQ(
+              llvm_arg, codegen_utils->GetConstant<Datum>(0))));
+      return true;
+    }
+    default:
+      elog(WARNING, "Unsupported boolean expression type %d.",
+           bool_expr->boolop);
+      return false;
+  }
+}
+
+bool BoolExprTreeGenerator::GenerateAndOr(
+    GpCodegenUtils* codegen_utils,
+    const ExprTreeGeneratorInfo& gen_info,
+    bool is_and,
+    llvm::Value** llvm_out_value,
+    llvm::Value* const llvm_isnull_ptr) {
+  auto irb = codegen_utils->ir_builder();
+
+  // Reached as soon as an argument is false for AND, or true for OR
+  llvm::BasicBlock* decided_block = codegen_utils->CreateBasicBlock(
+      is_and ? "and_false_block" : "or_true_block", gen_info.llvm_main_func);
+  llvm::BasicBlock* done_block = codegen_utils->CreateBasicBlock(
+      is_and ? "and_done_block" : "or_done_block", gen_info.llvm_main_func);
+
+  // The arguments are generated one after the other, each in the block that
+  // the previous one falls through to, so values computed for an argument
+  // are available to the following ones.
+  llvm::Value* llvm_any_null = codegen_utils->GetConstant<bool>(false);
+  for (auto& argument : arguments_) {
+    llvm::Value* llvm_arg = nullptr;
+    llvm::Value* llvm_arg_isnull = nullptr;
+    if (!GenerateArgumentCode(codegen_utils, gen_info, argument.get(),
+                              &llvm_arg, &llvm_arg_isnull)) {
+      return false;
+    }
+    llvm_any_null = irb->CreateOr(llvm_any_null, llvm_arg_isnull);
+
+    // DatumGetBool(arg) != is_and, for a non-NULL arg, decides the result
+    llvm::Value* llvm_arg_is_true = irb->CreateICmpNE(
+        llvm_arg, codegen_utils->GetConstant<Datum>(0));
+    llvm::Value* llvm_decides = irb->CreateAnd(
+        irb->CreateNot(llvm_arg_isnull),
+        is_and ? irb->CreateNot(llvm_arg_is_true) : llvm_arg_is_true);
+
+    llvm::BasicBlock* next_block = codegen_utils->CreateBasicBlock(
+        is_and ? "and_next_arg_block" : "or_next_arg_block",
+        gen_info.llvm_main_func);
+    irb->CreateCondBr(llvm_decides, decided_block /* true */,
+                      next_block /* false */);
+    irb->SetInsertPoint(next_block);
+  }
+
+  // No argument decided the result: it is NULL if any argument was NULL,
+  // and true for AND (false for OR) otherwise
+  irb->CreateStore(llvm_any_null, llvm_isnull_ptr);
+  llvm::Value* llvm_undecided_value = irb->CreateSelect(
+      llvm_any_null,
+      codegen_utils->GetConstant<Datum>(0),
+      codegen_utils->GetConstant<Datum>(BoolGetDatum(is_and)));
+  llvm::BasicBlock* undecided_last_block = irb->GetInsertBlock();
+  irb->CreateBr(done_block);
+
+  irb->SetInsertPoint(decided_block);
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+  irb->CreateBr(done_block);
+
+  irb->SetInsertPoint(done_block);
+  llvm::PHINode* llvm_result = irb->CreatePHI(
+      codegen_utils->GetType<Datum>(), 2);
+  llvm_result->addIncoming(
+      codegen_utils->GetConstant<Datum>(BoolGetDatum(!is_and)),
+      decided_block);
+  llvm_result->addIncoming(llvm_undecided_value, undecided_last_block);
+  *llvm_out_value = llvm_result;
+  return true;
+}
@@ -0,0 +1,211 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    case_expr_tree_generator.cc
+//
+//  @doc:
+//    Object that generate code for CASE expressions.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "codegen/case_expr_tree_generator.h"
+#include "codegen/expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "nodes/execnodes.h"
+#include "utils/elog.h"
+#include "nodes/nodes.h"
+#include "nodes/pg_list.h"
+#include "nodes/primnodes.h"
+}
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+using gpcodegen::CaseExprTreeGenerator;
+using gpcodegen::ExprTreeGenerator;
+using gpcodegen::GpCodegenUtils;
+
+CaseExprTreeGenerator::CaseExprTreeGenerator(
+    const ExprState* expr_state,
+    std::unique_ptr<ExprTreeGenerator> arg,
+    std::vector<
+        std::unique_ptr<ExprTreeGenerator>>&& conditions,  // NOLINT
+    std::vector<
+        std::unique_ptr<ExprTreeGenerator>>&& results,  // NOLINT
+    std::unique_ptr<ExprTreeGenerator> defresult)
+    :  ExprTreeGenerator(expr_state, ExprTreeNodeType::kCase),
+       arg_(std::move(arg)),
+       conditions_(std::move(conditions)),
+       results_(std::move(results)),
+       defresult_(std::move(defresult)) {
+}
+
+bool CaseExprTreeGenerator::VerifyAndCreateExprTree(
+    const ExprState* expr_state,
+    ExprTreeGeneratorInfo* gen_info,
+    std::unique_ptr<ExprTreeGenerator>* expr_tree) {
+  assert(nullptr != expr_state &&
+         nullptr != expr_state->expr &&
+         T_CaseExpr == nodeTag(expr_state->expr) &&
+         nullptr != expr_tree);
+
+  expr_tree->reset(nullptr);
+  const CaseExprState* case_state =
+      reinterpret_cast<const CaseExprState*>(expr_state);
+
+  std::unique_ptr<ExprTreeGenerator> arg(nullptr);
+  if (nullptr != case_state->arg &&
+      !ExprTreeGenerator::VerifyAndCreateExprTree(case_state->arg,
+                                                  gen_info,
+                                                  &arg)) {
+    return false;
+  }
+
+  ListCell* clause = nullptr;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> conditions;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> results;
+  foreach(clause, case_state->args) {
+    CaseWhenState* wclause = reinterpret_cast<CaseWhenState*>(lfirst(clause));
+    assert(nullptr != wclause);
+    std::unique_ptr<ExprTreeGenerator> condition(nullptr);
+    std::unique_ptr<ExprTreeGenerator> result(nullptr);
+    if (!ExprTreeGenerator::VerifyAndCreateExprTree(wclause->expr,
+                                                    gen_info,
+                                                    &condition) ||
+        !ExprTreeGenerator::VerifyAndCreateExprTree(wclause->result,
+                                                    gen_info,
+                                                    &result)) {
+      return false;
+    }
+    conditions.push_back(std::move(condition));
+    results.push_back(std::move(result));
+  }
+
+  std::unique_ptr<ExprTreeGenerator> defresult(nullptr);
+  if (nullptr != case_state->defresult &&
+      !ExprTreeGenerator::VerifyAndCreateExprTree(case_state->defresult,
+                                                  gen_info,
+                                                  &defresult)) {
+    return false;
+  }
+
+  expr_tree->reset(new CaseExprTreeGenerator(expr_state,
+                                             std::move(arg),
+                                             std::move(conditions),
+                                             std::move(results),
+                                             std::move(defresult)));
+  return true;
+}
+
+bool CaseExprTreeGenerator::GenerateCode(GpCodegenUtils* codegen_utils,
+                                         const ExprTreeGeneratorInfo& gen_info,
+                                         llvm::Value** llvm_out_value,
+                                         llvm::Value* const llvm_isnull_ptr) {
+  assert(nullptr != llvm_out_value);
+  assert(nullptr != llvm_isnull_ptr);
+  assert(nullptr != gen_info.econtext);
+  *llvm_out_value = nullptr;
+  auto irb = codegen_utils->ir_builder();
+
+  llvm::Value* llvm_case_datum_ptr = codegen_utils->GetConstant(
+      &gen_info.econtext->caseValue_datum);
+  llvm::Value* llvm_case_isnull_ptr = codegen_utils->GetConstant(
+      &gen_info.econtext->caseValue_isNull);
+  llvm::Value* llvm_save_datum = nullptr;
+  llvm::Value* llvm_save_isnull = nullptr;
+
+  if (nullptr != arg_) {
+    // Save the value of any enclosing CASE, and store ours
+    llvm_save_datum = irb->CreateLoad(llvm_case_datum_ptr);
+    llvm_save_isnull = irb->CreateLoad(llvm_case_isnull_ptr);
+    llvm::Value* llvm_arg = nullptr;
+    llvm::Value* llvm_arg_isnull = nullptr;
+    if (!GenerateArgumentCode(codegen_utils, gen_info, arg_.get(),
+                              &llvm_arg, &llvm_arg_isnull)) {
+      return false;
+    }
+    irb->CreateStore(llvm_arg, llvm_case_datum_ptr);
+    irb->CreateStore(llvm_arg_isnull, llvm_case_isnull_ptr);
+  }
+
+  llvm::BasicBlock* done_block = codegen_utils->CreateBasicBlock(
+      "case_done_block", gen_info.llvm_main_func);
+  std::vector<std::pair<llvm::Value*, llvm::BasicBlock*>> llvm_results;
+
+  for (size_t i = 0; i < conditions_.size(); ++i) {
+    llvm::Value* llvm_condition = nullptr;
+    llvm::Value* llvm_condition_isnull = nullptr;
+    if (!GenerateArgumentCode(codegen_utils, gen_info, conditions_[i].get(),
+                              &llvm_condition, &llvm_condition_isnull)) {
+      return false;
+    }
+    // A NULL condition is not considered true
+    llvm::Value* llvm_condition_is_true = irb->CreateAnd(
+        irb->CreateNot(llvm_condition_isnull),
+        irb->CreateICmpNE(llvm_condition,
+                          codegen_utils->GetConstant<Datum>(0)));
+
+    llvm::BasicBlock* result_block = codegen_utils->CreateBasicBlock(
+        "case_when_result_block", gen_info.llvm_main_func);
+    llvm::BasicBlock* next_block = codegen_utils->CreateBasicBlock(
+        "case_next_when_block", gen_info.llvm_main_func);
+    irb->CreateCondBr(llvm_condition_is_true, result_block /* true */,
+                      next_block /* false */);
+
+    irb->SetInsertPoint(result_block);
+    if (nullptr != arg_) {
+      irb->CreateStore(llvm_save_datum, llvm_case_datum_ptr);
+      irb->CreateStore(llvm_save_isnull, llvm_case_isnull_ptr);
+    }
+    llvm::Value* llvm_result = nullptr;
+    if (!results_[i]->GenerateCode(codegen_utils, gen_info, &llvm_result,
+                                   llvm_isnull_ptr)) {
+      return false;
+    }
+    llvm_results.push_back(std::make_pair(llvm_result,
+                                          irb->GetInsertBlock()));
+    irb->CreateBr(done_block);
+
+    irb->SetInsertPoint(next_block);
+  }
+
+  // No WHEN condition was true
+  if (nullptr != arg_) {
+    irb->CreateStore(llvm_save_datum, llvm_case_datum_ptr);
+    irb->CreateStore(llvm_save_isnull, llvm_case_isnull_ptr);
+  }
+  llvm::Value* llvm_defresult = nullptr;
+  if (nullptr != defresult_) {
+    if (!defresult_->GenerateCode(codegen_utils, gen_info, &llvm_defresult,
+                                  llvm_isnull_ptr)) {
+      return false;
+    }
+  } else {
+    irb->CreateStore(codegen_utils->GetConstant<bool>(true), llvm_isnull_ptr);
+    llvm_defresult = codegen_utils->GetConstant<Datum>(0);
+  }
+  llvm_results.push_back(std::make_pair(llvm_defresult,
+                                        irb->GetInsertBlock()));
+  irb->CreateBr(done_block);
+
+  irb->SetInsertPoint(done_block);
+  llvm::PHINode* llvm_out_phinode = irb->CreatePHI(
+      codegen_utils->GetType<Datum>(), llvm_results.size());
+  for (auto& llvm_result : llvm_results) {
+    llvm_out_phinode->addIncoming(llvm_result.first, llvm_result.second);
+  }
+  *llvm_out_value = llvm_out_phinode;
+  return true;
+}
@@ -11,14 +11,16 @@
 //---------------------------------------------------------------------------
 #include "codegen/codegen_interface.h"
 
+#include <assert.h>
 #include <string>
 
-using gpcodegen::CodegenInterface;
+#include "codegen/codegen_manager.h"
 
-// Initalization of unique counter
-unsigned CodegenInterface::unique_counter_ = 0;
+using gpcodegen::CodegenInterface;
 
 std::string CodegenInterface::GenerateUniqueName(
+    CodegenManager* manager,
     const std::string& orig_func_name) {
-  return orig_func_name + std::to_string(unique_counter_++);
+  assert(nullptr != manager);
+  return orig_func_name + std::to_string(manager->GetNextUniqueId());
 }
@@ -10,29 +10,78 @@
 //
 //---------------------------------------------------------------------------
 #include <assert.h>
+#include <atomic>  // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
 #include <iosfwd>
 #include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <string>
+#include <system_error>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
 #include "llvm/Support/raw_ostream.h"
 
 #include "codegen/codegen_interface.h"
 #include "codegen/codegen_manager.h"
+#include "codegen/codegen_object_cache.h"
 #include "codegen/codegen_wrapper.h"
 #include "codegen/utils/codegen_utils.h"
 #include "codegen/utils/gp_codegen_utils.h"
 
 extern "C" {
 #include "postgres.h"  // NOLINT(build/include)
+#include "storage/ipc.h"
 #include "utils/guc.h"
 }
 
 using gpcodegen::CodegenManager;
 
-CodegenManager::CodegenManager(const std::string& module_name) {
+namespace {
+
+// Number of background compilations that have not finished yet. The backend
+// waits for them before exiting, so that LLVM's global state is not torn down
+// under a running compilation.
+std::mutex in_flight_mutex;
+std::condition_variable in_flight_done;
+int in_flight_count = 0;
+bool wait_at_exit_registered = false;
+
+void WaitForBackgroundCompilations(int code, Datum arg) {
+  std::unique_lock<std::mutex> lock(in_flight_mutex);
+  in_flight_done.wait(lock, [] { return 0 == in_flight_count; });
+}
+
+}  // namespace
+
+CodegenManager::CodegenManager(const std::string& module_name,
+                               double estimated_rows)
+    : should_generate_code_(estimated_rows < 0 ||
+                            estimated_rows >= codegen_min_rows),
+      optimization_level_(codegen_optimization_level),
+      unique_counter_(0),
+      cache_hit_count_(0),
+      cache_miss_count_(0) {
   module_name_ = module_name;
   codegen_utils_.reset(new gpcodegen::GpCodegenUtils(module_name));
+
+  // Compilation time pays off over enough rows at any optimization level
+  if (codegen_aggressive_rows > 0 &&
+      estimated_rows >= codegen_aggressive_rows &&
+      optimization_level_ < CODEGEN_OPTIMIZATION_LEVEL_AGGRESSIVE) {
+    optimization_level_ = CODEGEN_OPTIMIZATION_LEVEL_AGGRESSIVE;
+  }
+}
+
+CodegenManager::~CodegenManager() {
+  if (compilation_thread_.joinable()) {
+    if (CompilationStatus::kRunning == compilation_status_->load()) {
+      // The thread holds its own references to what it uses
+      compilation_thread_.detach();
+    } else {
+      compilation_thread_.join();
+    }
+  }
 }
 
 bool CodegenManager::EnrollCodeGenerator(
@@ -77,22 +126,117 @@ unsigned int CodegenManager::PrepareGeneratedFunctions() {
   STATIC_ASSERT_OPTIMIZATION_LEVEL(kAggressive,
                                    CODEGEN_OPTIMIZATION_LEVEL_AGGRESSIVE);
 
-  // Call GpCodegenUtils to compile entire module
-  bool compilation_status = codegen_utils_->PrepareForExecution(
-      gpcodegen::GpCodegenUtils::OptimizationLevel(codegen_optimization_level),
-      true);
+  // Key the module by its IR, so that the object compiled for an identical
+  // module of an earlier query can be reused
+  if (gpcodegen::CodegenObjectCache::IsEnabled()) {
+    object_cache_.reset(new gpcodegen::CodegenObjectCache());
+    gpcodegen::CodegenObjectCache::SetModuleKey(codegen_utils_->module(),
+                                                optimization_level_);
+  }
 
-  if (!compilation_status) {
+  if (codegen_async_compile && StartBackgroundCompilation()) {
+    return success_count;
+  }
+
+  if (!CompileModule(codegen_utils_.get(), object_cache_.get(),
+                     optimization_level_)) {
     return success_count;
   }
+  return SetToGeneratedFunctions();
+}
+
+bool CodegenManager::PollGeneratedFunctions() {
+  if (!compilation_thread_.joinable()) {
+    return false;
+  }
+  CompilationStatus status =
+      compilation_status_->load(std::memory_order_acquire);
+  if (CompilationStatus::kRunning == status) {
+    return true;
+  }
+  compilation_thread_.join();
+  if (CompilationStatus::kSucceeded == status) {
+    SetToGeneratedFunctions();
+  }
+  return false;
+}
+
+bool CodegenManager::CompileModule(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    gpcodegen::CodegenObjectCache* object_cache,
+    int optimization_level) {
+  // Call GpCodegenUtils to compile entire module
+  bool compilation_status = codegen_utils->PrepareForExecution(
+      gpcodegen::GpCodegenUtils::OptimizationLevel(optimization_level),
+      true,
+      object_cache);
+  if (!compilation_status) {
+    return false;
+  }
+  codegen_utils->CompileForExecution();
+  return true;
+}
+
+bool CodegenManager::StartBackgroundCompilation() {
+  if (!wait_at_exit_registered) {
+    on_proc_exit(WaitForBackgroundCompilations, 0);
+    wait_at_exit_registered = true;
+  }
+
+  compilation_status_ = std::make_shared<std::atomic<CompilationStatus>>(
+      CompilationStatus::kRunning);
+  {
+    std::lock_guard<std::mutex> guard(in_flight_mutex);
+    in_flight_count++;
+  }
+
+  // Settings are read here, as the thread must not look at GUCs
+  int optimization_level = optimization_level_;
+  std::shared_ptr<gpcodegen::GpCodegenUtils> codegen_utils = codegen_utils_;
+  std::shared_ptr<gpcodegen::CodegenObjectCache> object_cache = object_cache_;
+  std::shared_ptr<std::atomic<CompilationStatus>> status =
+      compilation_status_;
+  try {
+    compilation_thread_ = std::thread(
+        [codegen_utils, object_cache, status, optimization_level]() mutable {
+      // Leave the backend's signals to the main thread
+      gp_set_thread_sigmasks();
+      bool compiled = CompileModule(codegen_utils.get(), object_cache.get(),
+                                    optimization_level);
+      // Drop our references first, so that the module is freed before the
+      // backend may exit if the manager is already gone.
+      codegen_utils.reset();
+      object_cache.reset();
+      status->store(compiled ? CompilationStatus::kSucceeded
+                             : CompilationStatus::kFailed,
+                    std::memory_order_release);
+      std::lock_guard<std::mutex> guard(in_flight_mutex);
+      in_flight_count--;
+      in_flight_done.notify_all();
+    });
+  } catch (const std::system_error&) {
+    std::lock_guard<std::mutex> guard(in_flight_mutex);
+    in_flight_count--;
+    return false;
+  }
+  return true;
+}
 
+unsigned int CodegenManager::SetToGeneratedFunctions() {
   // On successful compilation, go through all generator and swap
   // the pointer so compiled function get called
+  unsigned int success_count = 0;
   gpcodegen::GpCodegenUtils* codegen_utils = codegen_utils_.get();
   for (std::unique_ptr<CodegenInterface>& generator :
       enrolled_code_generators_) {
     success_count += generator->SetToGenerated(codegen_utils);
   }
+
+  // The ExecutionEngine looked up the cache while compiling
+  if (nullptr != object_cache_) {
+    cache_hit_count_ = object_cache_->hit_count();
+    cache_miss_count_ = object_cache_->miss_count();
+  }
   return success_count;
 }
 
@@ -116,7 +260,7 @@ void CodegenManager::AccumulateExplainString() {
   // This is called only when EXPLAIN CODEGEN. Because we don't want to compile
   // at this time, we need to call CodegenUtils::Optimize to "optimize" LLVM IR.
   codegen_utils_->Optimize(gpcodegen::CodegenUtils::OptimizationLevel(
-                               codegen_optimization_level),
+                               optimization_level_),
                            gpcodegen::CodegenUtils::SizeLevel::kNormal,
                            false);
   llvm::raw_string_ostream out(explain_string_);
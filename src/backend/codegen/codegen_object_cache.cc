@@ -0,0 +1,223 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    codegen_object_cache.cc
+//
+//  @doc:
+//    Implementation of the cache of compiled objects of generated modules
+//
+//---------------------------------------------------------------------------
+#include "codegen/codegen_object_cache.h"
+
+#include <assert.h>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <system_error>  // NOLINT(build/c++11)
+#include <utility>
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "utils/guc.h"
+}
+
+using gpcodegen::CodegenObjectCache;
+
+constexpr char CodegenObjectCache::kModuleKeyPrefix[];
+
+namespace {
+
+bool IsOnDiskCacheEnabled() {
+  return nullptr != codegen_object_cache_directory &&
+      '\0' != codegen_object_cache_directory[0];
+}
+
+}  // namespace
+
+CodegenObjectCache::CodegenObjectCache()
+    : max_entries_(codegen_object_cache_size > 0 ?
+                   codegen_object_cache_size : 0),
+      directory_(IsOnDiskCacheEnabled() ? codegen_object_cache_directory : ""),
+      hit_count_(0),
+      miss_count_(0) {
+}
+
+bool CodegenObjectCache::IsEnabled() {
+  return codegen_object_cache_size > 0 || IsOnDiskCacheEnabled();
+}
+
+CodegenObjectCache::SharedObjects* CodegenObjectCache::GetSharedObjects() {
+  static SharedObjects* shared_objects = new SharedObjects();
+  return shared_objects;
+}
+
+void CodegenObjectCache::SetModuleKey(llvm::Module* module, int opt_level) {
+  assert(nullptr != module);
+
+  // The module identifier is derived from the plan node, and should not keep
+  // identical modules of different nodes apart.
+  module->setModuleIdentifier("");
+  std::string module_ir;
+  llvm::raw_string_ostream out(module_ir);
+  module->print(out, nullptr);
+  out.flush();
+
+  llvm::MD5 hash;
+  hash.update(LLVM_VERSION_STRING);
+  hash.update(llvm::sys::getHostCPUName());
+  hash.update(std::to_string(opt_level));
+  hash.update(module_ir);
+  llvm::MD5::MD5Result result;
+  hash.final(result);
+  llvm::SmallString<32> key;
+  llvm::MD5::stringifyResult(result, key);
+
+  module->setModuleIdentifier(std::string(kModuleKeyPrefix) + key.str().str());
+}
+
+std::string CodegenObjectCache::GetModuleKey(const llvm::Module* module) {
+  const std::string& identifier = module->getModuleIdentifier();
+  if (0 != identifier.compare(0, sizeof(kModuleKeyPrefix) - 1,
+                              kModuleKeyPrefix)) {
+    return "";
+  }
+  return identifier;
+}
+
+std::string CodegenObjectCache::GetObjectFilePath(
+    const std::string& key) const {
+  if (directory_.empty()) {
+    return "";
+  }
+  return directory_ + "/" + key + ".o";
+}
+
+void CodegenObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                              llvm::MemoryBufferRef object) {
+  std::string key = GetModuleKey(module);
+  if (key.empty()) {
+    return;
+  }
+
+  if (max_entries_ > 0) {
+    SharedObjects* shared = GetSharedObjects();
+    std::lock_guard<std::mutex> guard(shared->mutex);
+    InsertInMemory(shared, key, llvm::MemoryBuffer::getMemBufferCopy(
+        object.getBuffer(), object.getBufferIdentifier()));
+  }
+  WriteToDisk(key, object.getBuffer());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> CodegenObjectCache::getObject(
+    const llvm::Module* module) {
+  std::string key = GetModuleKey(module);
+  if (key.empty()) {
+    return nullptr;
+  }
+
+  SharedObjects* shared = GetSharedObjects();
+  if (max_entries_ > 0) {
+    std::lock_guard<std::mutex> guard(shared->mutex);
+    auto it = shared->objects.find(key);
+    if (it != shared->objects.end()) {
+      // Move to the front of the LRU list
+      shared->lru_keys.splice(shared->lru_keys.begin(), shared->lru_keys,
+                              it->second.second);
+      hit_count_++;
+      // The ExecutionEngine takes ownership of what we return
+      return llvm::MemoryBuffer::getMemBufferCopy(
+          it->second.first->getBuffer(),
+          it->second.first->getBufferIdentifier());
+    }
+  }
+
+  std::string path = GetObjectFilePath(key);
+  if (!path.empty()) {
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> object =
+        llvm::MemoryBuffer::getFile(path);
+    if (object) {
+      hit_count_++;
+      if (max_entries_ > 0) {
+        std::lock_guard<std::mutex> guard(shared->mutex);
+        InsertInMemory(shared, key, llvm::MemoryBuffer::getMemBufferCopy(
+            (*object)->getBuffer(), (*object)->getBufferIdentifier()));
+      }
+      return std::move(*object);
+    }
+  }
+
+  miss_count_++;
+  return nullptr;
+}
+
+void CodegenObjectCache::InsertInMemory(
+    SharedObjects* shared,
+    const std::string& key,
+    std::unique_ptr<llvm::MemoryBuffer> object) const {
+  assert(max_entries_ > 0);
+
+  auto it = shared->objects.find(key);
+  if (it != shared->objects.end()) {
+    shared->lru_keys.splice(shared->lru_keys.begin(), shared->lru_keys,
+                            it->second.second);
+    it->second.first = std::move(object);
+    return;
+  }
+
+  shared->lru_keys.push_front(key);
+  shared->objects.emplace(key, std::make_pair(std::move(object),
+                                              shared->lru_keys.begin()));
+
+  // The size may have been lowered since the last insertion
+  while (shared->lru_keys.size() > max_entries_) {
+    shared->objects.erase(shared->lru_keys.back());
+    shared->lru_keys.pop_back();
+  }
+}
+
+void CodegenObjectCache::WriteToDisk(const std::string& key,
+                                     llvm::StringRef object) const {
+  std::string path = GetObjectFilePath(key);
+  if (path.empty() || llvm::sys::fs::exists(path)) {
+    return;
+  }
+
+  // The on-disk cache is best effort: on any failure the object is simply
+  // not saved, and will be compiled again next time. Several backends, or
+  // several threads of one backend, may be writing the same object, so each
+  // writes to a temporary file of its own.
+  int fd = -1;
+  llvm::SmallString<128> temp_path;
+  std::error_code error = llvm::sys::fs::createUniqueFile(
+      path + ".%%%%%%", fd, temp_path);
+  if (error) {
+    return;
+  }
+  {
+    llvm::raw_fd_ostream out(fd, true /* shouldClose */);
+    out << object;
+    out.close();
+    if (out.has_error()) {
+      out.clear_error();
+      error = std::make_error_code(std::errc::io_error);
+    }
+  }
+  if (!error) {
+    error = llvm::sys::fs::rename(temp_path, path);
+  }
+  if (error) {
+    llvm::sys::fs::remove(temp_path);
+  }
+}
@@ -20,6 +20,9 @@
 #include "codegen/base_codegen.h"
 #include "codegen/codegen_manager.h"
 #include "codegen/exec_eval_expr_codegen.h"
+#include "codegen/eval_hash_key_codegen.h"
+#include "codegen/exec_hash_get_hash_value_codegen.h"
+#include "codegen/exec_scan_hash_bucket_codegen.h"
 #include "codegen/exec_variable_list_codegen.h"
 #include "codegen/expr_tree_generator.h"
 #include "codegen/utils/gp_codegen_utils.h"
@@ -28,12 +31,16 @@
 extern "C" {
 #include "lib/stringinfo.h"
 #include "postgres.h"  // NOLINT(build/include)
+#include "utils/builtins.h"
 }
 
 using gpcodegen::CodegenManager;
 using gpcodegen::BaseCodegen;
 using gpcodegen::ExecVariableListCodegen;
 using gpcodegen::ExecEvalExprCodegen;
+using gpcodegen::EvalHashKeyCodegen;
+using gpcodegen::ExecHashGetHashValueCodegen;
+using gpcodegen::ExecScanHashBucketCodegen;
 using gpcodegen::AdvanceAggregatesCodegen;
 
 // Current code generator manager that oversees all code generators
@@ -45,11 +52,12 @@ unsigned int InitCodegen() {
   return gpcodegen::GpCodegenUtils::InitializeGlobal();
 }
 
-void* CodeGeneratorManagerCreate(const char* module_name) {
+void* CodeGeneratorManagerCreate(const char* module_name,
+                                 double estimated_rows) {
   if (!codegen) {
     return nullptr;
   }
-  return new CodegenManager(module_name);
+  return new CodegenManager(module_name, estimated_rows);
 }
 
 unsigned int CodeGeneratorManagerGenerateCode(void* manager) {
@@ -66,6 +74,13 @@ unsigned int CodeGeneratorManagerPrepareGeneratedFunctions(void* manager) {
   return static_cast<CodegenManager*>(manager)->PrepareGeneratedFunctions();
 }
 
+bool CodeGeneratorManagerPollGeneratedFunctions(void* manager) {
+  if (!codegen || nullptr == manager) {
+    return false;
+  }
+  return static_cast<CodegenManager*>(manager)->PollGeneratedFunctions();
+}
+
 unsigned int CodeGeneratorManagerNotifyParameterChange(void* manager) {
   // parameter change notification is not supported yet
   assert(false);
@@ -91,6 +106,20 @@ char* CodeGeneratorManagerGetExplainString(void* manager) {
   return return_string->data;
 }
 
+unsigned int CodeGeneratorManagerGetCacheHitCount(void* manager) {
+  if (!codegen || nullptr == manager) {
+    return 0;
+  }
+  return static_cast<CodegenManager*>(manager)->GetCacheHitCount();
+}
+
+unsigned int CodeGeneratorManagerGetCacheMissCount(void* manager) {
+  if (!codegen || nullptr == manager) {
+    return 0;
+  }
+  return static_cast<CodegenManager*>(manager)->GetCacheMissCount();
+}
+
 void CodeGeneratorManagerDestroy(void* manager) {
   delete (static_cast<CodegenManager*>(manager));
 }
@@ -122,6 +151,49 @@ VARSIZE_regular(void* ptr) {
   return VARSIZE(ptr);
 }
 
+// Returns true if the varlena can be read in place, i.e. it is neither
+// compressed nor stored out of line.
+static inline bool VarlenaIsPlain(Datum datum) {
+  struct varlena* ptr = reinterpret_cast<struct varlena*>(
+      DatumGetPointer(datum));
+  return !VARATT_IS_EXTERNAL(ptr) && !VARATT_IS_COMPRESSED(ptr);
+}
+
+bool
+texteq_regular(Datum arg0, Datum arg1) {
+  if (!VarlenaIsPlain(arg0) || !VarlenaIsPlain(arg1)) {
+    return DatumGetBool(DirectFunctionCall2(texteq, arg0, arg1));
+  }
+  text* t0 = reinterpret_cast<text*>(DatumGetPointer(arg0));
+  text* t1 = reinterpret_cast<text*>(DatumGetPointer(arg1));
+  size_t len = VARSIZE_ANY_EXHDR(t0);
+  // Like texteq(), equality does not need strcoll(); a bitwise comparison
+  // of the two payloads is enough.
+  return len == VARSIZE_ANY_EXHDR(t1) &&
+      0 == memcmp(VARDATA_ANY(t0), VARDATA_ANY(t1), len);
+}
+
+bool
+bpchareq_regular(Datum arg0, Datum arg1) {
+  if (!VarlenaIsPlain(arg0) || !VarlenaIsPlain(arg1)) {
+    return DatumGetBool(DirectFunctionCall2(bpchareq, arg0, arg1));
+  }
+  BpChar* b0 = reinterpret_cast<BpChar*>(DatumGetPointer(arg0));
+  BpChar* b1 = reinterpret_cast<BpChar*>(DatumGetPointer(arg1));
+  const char* s0 = VARDATA_ANY(b0);
+  const char* s1 = VARDATA_ANY(b1);
+  size_t len0 = VARSIZE_ANY_EXHDR(b0);
+  size_t len1 = VARSIZE_ANY_EXHDR(b1);
+  // Trailing spaces are not significant (see bcTruelen())
+  while (len0 > 0 && s0[len0 - 1] == ' ') {
+    len0--;
+  }
+  while (len1 > 0 && s1[len1 - 1] == ' ') {
+    len1--;
+  }
+  return len0 == len1 && 0 == memcmp(s0, s1, len0);
+}
+
 void* ExecVariableListCodegenEnroll(
     ExecVariableListFn regular_func_ptr,
     ExecVariableListFn* ptr_to_chosen_func_ptr,
@@ -173,3 +245,59 @@ void* AdvanceAggregatesCodegenEnroll(
   return generator;
 }
 
+void* EvalHashKeyCodegenEnroll(
+    EvalHashKeyFn regular_func_ptr,
+    EvalHashKeyFn* ptr_to_chosen_func_ptr,
+    List *hashkeys,
+    List *hashtypes,
+    ExprContext *econtext,
+    PlanState* plan_state) {
+  CodegenManager* manager = static_cast<CodegenManager*>(
+      GetActiveCodeGeneratorManager());
+  EvalHashKeyCodegen* generator =
+      CodegenManager::CreateAndEnrollGenerator<EvalHashKeyCodegen>(
+          manager,
+          regular_func_ptr,
+          ptr_to_chosen_func_ptr,
+          hashkeys,
+          hashtypes,
+          econtext,
+          plan_state);
+  return generator;
+}
+
+void* ExecHashGetHashValueCodegenEnroll(
+    ExecHashGetHashValueFn regular_func_ptr,
+    ExecHashGetHashValueFn* ptr_to_chosen_func_ptr,
+    List *hashkeys,
+    List *hashoperators,
+    bool outer_tuple,
+    ExprContext *econtext) {
+  CodegenManager* manager = static_cast<CodegenManager*>(
+      GetActiveCodeGeneratorManager());
+  ExecHashGetHashValueCodegen* generator =
+      CodegenManager::CreateAndEnrollGenerator<ExecHashGetHashValueCodegen>(
+          manager,
+          regular_func_ptr,
+          ptr_to_chosen_func_ptr,
+          hashkeys,
+          hashoperators,
+          outer_tuple,
+          econtext);
+  return generator;
+}
+
+void* ExecScanHashBucketCodegenEnroll(
+    ExecScanHashBucketFn regular_func_ptr,
+    ExecScanHashBucketFn* ptr_to_chosen_func_ptr,
+    HashJoinState *hjstate) {
+  CodegenManager* manager = static_cast<CodegenManager*>(
+      GetActiveCodeGeneratorManager());
+  ExecScanHashBucketCodegen* generator =
+      CodegenManager::CreateAndEnrollGenerator<ExecScanHashBucketCodegen>(
+          manager,
+          regular_func_ptr,
+          ptr_to_chosen_func_ptr,
+          hjstate);
+  return generator;
+}
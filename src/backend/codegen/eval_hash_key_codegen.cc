@@ -0,0 +1,374 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    eval_hash_key_codegen.cc
+//
+//  @doc:
+//    Generates code for evalHashKey function of redistribute motions.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <stddef.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/eval_hash_key_codegen.h"
+#include "codegen/expr_tree_generator.h"
+#include "codegen/op_expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/utils/utility.h"
+
+#include "llvm/IR/Argument.h"
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "catalog/pg_type.h"
+#include "cdb/cdbhash.h"
+#include "nodes/execnodes.h"
+#include "nodes/pg_list.h"
+#include "utils/elog.h"
+#include "utils/memutils.h"
+#include "nodes/nodes.h"
+}
+
+namespace llvm {
+class BasicBlock;
+class Function;
+class Value;
+}  // namespace llvm
+
+using gpcodegen::EvalHashKeyCodegen;
+
+constexpr char EvalHashKeyCodegen::kEvalHashKeyPrefix[];
+
+EvalHashKeyCodegen::EvalHashKeyCodegen(
+    CodegenManager* manager,
+    EvalHashKeyFn regular_func_ptr,
+    EvalHashKeyFn* ptr_to_regular_func_ptr,
+    List* hashkeys,
+    List* hashtypes,
+    ExprContext* econtext,
+    PlanState* plan_state)
+    : BaseCodegen(manager,
+                  kEvalHashKeyPrefix,
+                  regular_func_ptr, ptr_to_regular_func_ptr),
+      hashkeys_(hashkeys),
+      hashtypes_(hashtypes),
+      plan_state_(plan_state),
+      gen_info_(econtext, nullptr, nullptr, nullptr, 0) {
+}
+
+bool EvalHashKeyCodegen::InitDependencies() {
+  OpExprTreeGenerator::InitializeSupportedFunction();
+  expr_tree_generators_.clear();
+
+  ListCell* l = nullptr;
+  foreach(l, hashkeys_) {
+    ExprState* exprstate = reinterpret_cast<ExprState*>(lfirst(l));
+    std::unique_ptr<ExprTreeGenerator> expr_tree(nullptr);
+    if (nullptr == exprstate ||
+        nullptr == exprstate->expr ||
+        !ExprTreeGenerator::VerifyAndCreateExprTree(
+            exprstate, &gen_info_, &expr_tree)) {
+      // All keys feed the same hash value, so one unsupported key is
+      // enough to fall back to the regular evalHashKey.
+      expr_tree_generators_.clear();
+      return true;
+    }
+    expr_tree_generators_.push_back(std::move(expr_tree));
+  }
+  return true;
+}
+
+llvm::Value* EvalHashKeyCodegen::GenerateFNV1Bytes(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    llvm::Value* llvm_hash,
+    llvm::Value* llvm_value,
+    int num_bytes) {
+  assert(nullptr != llvm_value &&
+         llvm_value->getType()->isIntegerTy(num_bytes * 8));
+  auto irb = codegen_utils->ir_builder();
+  llvm::Value* llvm_prime = codegen_utils->GetConstant<uint32_t>(FNV_32_PRIME);
+
+  // Unrolled version of fnv1_32_buf(&value, num_bytes, hash)
+  for (int i = 0; i < num_bytes; ++i) {
+#ifdef WORDS_BIGENDIAN
+    int shift = (num_bytes - 1 - i) * 8;
+#else
+    int shift = i * 8;
+#endif
+    llvm::Value* llvm_byte = irb->CreateTrunc(
+        irb->CreateLShr(llvm_value, shift),
+        codegen_utils->GetType<uint8_t>());
+    // hval *= FNV_32_PRIME; hval ^= (uint32) *bp++;
+    llvm_hash = irb->CreateXor(
+        irb->CreateMul(llvm_hash, llvm_prime),
+        irb->CreateZExt(llvm_byte, codegen_utils->GetType<uint32_t>()));
+  }
+  return llvm_hash;
+}
+
+llvm::Value* EvalHashKeyCodegen::GenerateHashDatum(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    llvm::Value* llvm_hash,
+    llvm::Value* llvm_datum,
+    Oid type_oid,
+    llvm::Value* llvm_cdbhash) {
+  auto irb = codegen_utils->ir_builder();
+
+  // Mirrors the switch in hashDatum(), which in the generated code is
+  // resolved at generation time.
+  switch (type_oid) {
+    case INT2OID:
+      // Cast to 8 byte before hashing
+      return GenerateFNV1Bytes(
+          codegen_utils, llvm_hash,
+          codegen_utils->CreateCast<int64_t, int16_t>(
+              codegen_utils->CreateDatumToCppTypeCast<int16_t>(llvm_datum)),
+          sizeof(int64));
+    case INT4OID:
+      // Cast to 8 byte before hashing
+      return GenerateFNV1Bytes(
+          codegen_utils, llvm_hash,
+          codegen_utils->CreateCast<int64_t, int32_t>(
+              codegen_utils->CreateDatumToCppTypeCast<int32_t>(llvm_datum)),
+          sizeof(int64));
+    case INT8OID:
+    case TIMESTAMPOID:
+    case TIMESTAMPTZOID:
+    case TIMEOID:
+      // Timestamp and TimeADT are either int64 or double; in both cases the
+      // hashed bytes are the bytes of the Datum.
+      return GenerateFNV1Bytes(codegen_utils, llvm_hash, llvm_datum,
+                               sizeof(int64));
+    case OIDOID:
+    case REGPROCOID:
+    case REGPROCEDUREOID:
+    case REGOPEROID:
+    case REGOPERATOROID:
+    case REGCLASSOID:
+    case REGTYPEOID:
+      // Cast to 8 byte before hashing
+      return GenerateFNV1Bytes(
+          codegen_utils, llvm_hash,
+          codegen_utils->CreateCast<int64_t, uint32_t>(
+              codegen_utils->CreateDatumToCppTypeCast<uint32_t>(llvm_datum)),
+          sizeof(int64));
+    case DATEOID:
+      return GenerateFNV1Bytes(
+          codegen_utils, llvm_hash,
+          codegen_utils->CreateDatumToCppTypeCast<int32_t>(llvm_datum),
+          sizeof(DateADT));
+    case FLOAT4OID: {
+      // Minus zero and zero must hash the same
+      llvm::Value* llvm_f4 =
+          codegen_utils->CreateDatumToCppTypeCast<float>(llvm_datum);
+      llvm::Value* llvm_zero = codegen_utils->GetConstant<float>(0.0);
+      llvm_f4 = irb->CreateSelect(irb->CreateFCmpOEQ(llvm_f4, llvm_zero),
+                                  llvm_zero, llvm_f4);
+      return GenerateFNV1Bytes(
+          codegen_utils, llvm_hash,
+          irb->CreateBitCast(llvm_f4, codegen_utils->GetType<int32_t>()),
+          sizeof(float4));
+    }
+    case FLOAT8OID: {
+      // Minus zero and zero must hash the same
+      llvm::Value* llvm_f8 =
+          codegen_utils->CreateDatumToCppTypeCast<double>(llvm_datum);
+      llvm::Value* llvm_zero = codegen_utils->GetConstant<double>(0.0);
+      llvm_f8 = irb->CreateSelect(irb->CreateFCmpOEQ(llvm_f8, llvm_zero),
+                                  llvm_zero, llvm_f8);
+      return GenerateFNV1Bytes(
+          codegen_utils, llvm_hash,
+          irb->CreateBitCast(llvm_f8, codegen_utils->GetType<int64_t>()),
+          sizeof(float8));
+    }
+    case BOOLOID:
+      return GenerateFNV1Bytes(
+          codegen_utils, llvm_hash,
+          irb->CreateZExt(
+              irb->CreateICmpNE(llvm_datum,
+                                codegen_utils->GetConstant<Datum>(0)),
+              codegen_utils->GetType<uint8_t>()),
+          sizeof(bool));
+    case CHAROID:
+      return GenerateFNV1Bytes(
+          codegen_utils, llvm_hash,
+          codegen_utils->CreateDatumToCppTypeCast<uint8_t>(llvm_datum),
+          sizeof(char));
+    default: {
+      // Variable-width and pass-by-reference types go through cdbhash(),
+      // which works on h->hash.
+      llvm::Function* llvm_cdbhash_func =
+          codegen_utils->GetOrRegisterExternalFunction(cdbhash, "cdbhash");
+      llvm::Value* llvm_hash_ptr = codegen_utils->GetPointerToMember(
+          llvm_cdbhash, &CdbHash::hash);
+      irb->CreateStore(llvm_hash, llvm_hash_ptr);
+      irb->CreateCall(llvm_cdbhash_func, {
+          llvm_cdbhash,
+          llvm_datum,
+          codegen_utils->GetConstant<Oid>(type_oid)});
+      return irb->CreateLoad(llvm_hash_ptr);
+    }
+  }
+}
+
+bool EvalHashKeyCodegen::GenerateEvalHashKey(
+    gpcodegen::GpCodegenUtils* codegen_utils) {
+
+  assert(NULL != codegen_utils);
+  if (nullptr == hashkeys_ ||
+      nullptr == gen_info_.econtext ||
+      expr_tree_generators_.empty() ||
+      expr_tree_generators_.size() !=
+      static_cast<size_t>(list_length(hashtypes_))) {
+    return false;
+  }
+
+  // The slot of the outer plan may change between calls, so we always use
+  // the external slot_getattr()
+  gen_info_.llvm_slot_getattr_func =
+      codegen_utils->GetOrRegisterExternalFunction(slot_getattr_regular,
+                                                   "slot_getattr_regular");
+
+  llvm::Function* eval_hash_key_func = CreateFunction<EvalHashKeyFn>(
+      codegen_utils, GetUniqueFuncName());
+
+  // Function arguments to evalHashKey
+  llvm::Value* llvm_econtext_arg = ArgumentByPosition(eval_hash_key_func, 0);
+  llvm::Value* llvm_cdbhash_arg = ArgumentByPosition(eval_hash_key_func, 3);
+
+  // External functions
+  llvm::Function* llvm_MemoryContextReset =
+      codegen_utils->GetOrRegisterExternalFunction(MemoryContextReset,
+                                                   "MemoryContextReset");
+  llvm::Function* llvm_MemoryContextSwitchTo =
+      codegen_utils->GetOrRegisterExternalFunction(MemoryContextSwitchTo,
+                                                   "MemoryContextSwitchTo");
+  llvm::Function* llvm_cdbhashreduce =
+      codegen_utils->GetOrRegisterExternalFunction(cdbhashreduce,
+                                                   "cdbhashreduce");
+
+  llvm::BasicBlock* llvm_entry_block = codegen_utils->CreateBasicBlock(
+      "entry", eval_hash_key_func);
+  llvm::BasicBlock* llvm_error_block = codegen_utils->CreateBasicBlock(
+      "error_block", eval_hash_key_func);
+
+  gen_info_.llvm_main_func = eval_hash_key_func;
+  gen_info_.llvm_error_block = llvm_error_block;
+
+  auto irb = codegen_utils->ir_builder();
+
+  // Entry block
+  // -----------
+  irb->SetInsertPoint(llvm_entry_block);
+#ifdef CODEGEN_DEBUG
+  EXPAND_CREATE_ELOG(codegen_utils,
+                     DEBUG1,
+                     "Codegen'ed evalHashKey called!");
+#endif
+
+  // ResetExprContext(econtext);
+  // oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+  llvm::Value* llvm_per_tuple_memory = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_econtext_arg, &ExprContext::ecxt_per_tuple_memory));
+  irb->CreateCall(llvm_MemoryContextReset, {llvm_per_tuple_memory});
+  llvm::Value* llvm_old_context = irb->CreateCall(
+      llvm_MemoryContextSwitchTo, {llvm_per_tuple_memory});
+
+  // Allocate all isnull flags upfront in the entry block so that they can be
+  // promoted to registers.
+  std::vector<llvm::Value*> llvm_isnull_ptrs;
+  for (size_t i = 0; i < expr_tree_generators_.size(); ++i) {
+    llvm::Value* llvm_isnull_ptr = irb->CreateAlloca(
+        codegen_utils->GetType<bool>(), nullptr, "isNull");
+    irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+    llvm_isnull_ptrs.push_back(llvm_isnull_ptr);
+  }
+
+  // cdbhashinit(h);
+  llvm::Value* llvm_hash = codegen_utils->GetConstant<uint32_t>(FNV1_32_INIT);
+
+  ListCell* ht = list_head(hashtypes_);
+  for (size_t i = 0; i < expr_tree_generators_.size(); ++i, ht = lnext(ht)) {
+    assert(nullptr != ht);
+    Oid type_oid = lfirst_oid(ht);
+
+    // Get the attribute value of the tuple
+    llvm::Value* llvm_keyval = nullptr;
+    bool is_generated = expr_tree_generators_[i]->GenerateCode(
+        codegen_utils, gen_info_, &llvm_keyval, llvm_isnull_ptrs[i]);
+    if (!is_generated || nullptr == llvm_keyval) {
+      return false;
+    }
+
+    llvm::BasicBlock* llvm_null_block = codegen_utils->CreateBasicBlock(
+        "key_null", eval_hash_key_func);
+    llvm::BasicBlock* llvm_not_null_block = codegen_utils->CreateBasicBlock(
+        "key_not_null", eval_hash_key_func);
+    llvm::BasicBlock* llvm_next_key_block = codegen_utils->CreateBasicBlock(
+        "next_key", eval_hash_key_func);
+    irb->CreateCondBr(irb->CreateLoad(llvm_isnull_ptrs[i]),
+                      llvm_null_block /* true */,
+                      llvm_not_null_block /* false */);
+
+    // cdbhashnull(h);
+    irb->SetInsertPoint(llvm_null_block);
+    llvm::Value* llvm_null_hash = GenerateFNV1Bytes(
+        codegen_utils, llvm_hash,
+        codegen_utils->GetConstant<uint32_t>(NULL_VAL), sizeof(uint32));
+    irb->CreateBr(llvm_next_key_block);
+
+    // cdbhash(h, keyval, typeoid);
+    irb->SetInsertPoint(llvm_not_null_block);
+    llvm::Value* llvm_not_null_hash = GenerateHashDatum(
+        codegen_utils, llvm_hash, llvm_keyval, type_oid, llvm_cdbhash_arg);
+    llvm::BasicBlock* llvm_not_null_last_block = irb->GetInsertBlock();
+    irb->CreateBr(llvm_next_key_block);
+
+    irb->SetInsertPoint(llvm_next_key_block);
+    llvm::PHINode* llvm_hash_phi = irb->CreatePHI(
+        codegen_utils->GetType<uint32_t>(), 2);
+    llvm_hash_phi->addIncoming(llvm_null_hash, llvm_null_block);
+    llvm_hash_phi->addIncoming(llvm_not_null_hash, llvm_not_null_last_block);
+    llvm_hash = llvm_hash_phi;
+  }
+
+  // h->hash = hash;
+  // MemoryContextSwitchTo(oldContext);
+  // return cdbhashreduce(h);
+  irb->CreateStore(llvm_hash, codegen_utils->GetPointerToMember(
+      llvm_cdbhash_arg, &CdbHash::hash));
+  irb->CreateCall(llvm_MemoryContextSwitchTo, {llvm_old_context});
+  irb->CreateRet(irb->CreateCall(llvm_cdbhashreduce, {llvm_cdbhash_arg}));
+
+  // Error block
+  // -----------
+  irb->SetInsertPoint(llvm_error_block);
+  irb->CreateRet(codegen_utils->GetConstant<uint32_t>(0));
+
+  return true;
+}
+
+bool EvalHashKeyCodegen::GenerateCodeInternal(
+    GpCodegenUtils* codegen_utils) {
+  bool isGenerated = GenerateEvalHashKey(codegen_utils);
+
+  if (isGenerated) {
+    elog(DEBUG1, "evalHashKey was generated successfully!");
+    return true;
+  } else {
+    elog(DEBUG1, "evalHashKey generation failed!");
+    return false;
+  }
+}
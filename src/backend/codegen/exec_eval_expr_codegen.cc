@@ -76,15 +76,19 @@ bool ExecEvalExprCodegen::InitDependencies() {
 
 void ExecEvalExprCodegen::PrepareSlotGetAttr() {
   TupleTableSlot* slot = nullptr;
+  bool holds_memtuples = false;
   assert(nullptr != plan_state_);
   switch (nodeTag(plan_state_)) {
     case T_SeqScanState:
     case T_TableScanState:
       // Generate dependent slot_getattr() implementation for the given slot
       if (gen_info_.max_attr > 0) {
-        slot = reinterpret_cast<ScanState*>(plan_state_)
-            ->ss_ScanTupleSlot;
+        ScanState* scan_state = reinterpret_cast<ScanState*>(plan_state_);
+        slot = scan_state->ss_ScanTupleSlot;
         assert(nullptr != slot);
+        // Append-only row tables are read into memtuples; heap tables into
+        // heap tuples and column-oriented tables into virtual tuples.
+        holds_memtuples = TableTypeAppendOnly == scan_state->tableType;
       }
       break;
     case T_AggState:
@@ -100,7 +104,7 @@ void ExecEvalExprCodegen::PrepareSlotGetAttr() {
 
   if (nullptr != slot) {
     slot_getattr_codegen_ = SlotGetAttrCodegen::GetCodegenInstance(
-        manager(), slot, gen_info_.max_attr);
+        manager(), slot, gen_info_.max_attr, holds_memtuples);
   }
 }
 
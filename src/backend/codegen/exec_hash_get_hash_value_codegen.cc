@@ -0,0 +1,367 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    exec_hash_get_hash_value_codegen.cc
+//
+//  @doc:
+//    Generates code for ExecHashGetHashValue function of hash joins.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <stddef.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/exec_hash_get_hash_value_codegen.h"
+#include "codegen/expr_tree_generator.h"
+#include "codegen/op_expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/utils/utility.h"
+
+#include "llvm/IR/Argument.h"
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "nodes/execnodes.h"
+#include "nodes/pg_list.h"
+#include "utils/elog.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "nodes/nodes.h"
+}
+
+namespace llvm {
+class BasicBlock;
+class Function;
+class Value;
+}  // namespace llvm
+
+using gpcodegen::ExecHashGetHashValueCodegen;
+
+constexpr char ExecHashGetHashValueCodegen::kExecHashGetHashValuePrefix[];
+
+ExecHashGetHashValueCodegen::ExecHashGetHashValueCodegen(
+    CodegenManager* manager,
+    ExecHashGetHashValueFn regular_func_ptr,
+    ExecHashGetHashValueFn* ptr_to_regular_func_ptr,
+    List* hashkeys,
+    List* hashoperators,
+    bool outer_tuple,
+    ExprContext* econtext)
+    : BaseCodegen(manager,
+                  kExecHashGetHashValuePrefix,
+                  regular_func_ptr, ptr_to_regular_func_ptr),
+      hashkeys_(hashkeys),
+      hashoperators_(hashoperators),
+      outer_tuple_(outer_tuple),
+      gen_info_(econtext, nullptr, nullptr, nullptr, 0) {
+}
+
+bool ExecHashGetHashValueCodegen::InitDependencies() {
+  OpExprTreeGenerator::InitializeSupportedFunction();
+  expr_tree_generators_.clear();
+  hash_funcs_.clear();
+  hash_strict_.clear();
+
+  if (list_length(hashkeys_) != list_length(hashoperators_)) {
+    return true;
+  }
+
+  ListCell* hk = nullptr;
+  ListCell* ho = nullptr;
+  forboth(hk, hashkeys_, ho, hashoperators_) {
+    ExprState* exprstate = reinterpret_cast<ExprState*>(lfirst(hk));
+    Oid hashop = lfirst_oid(ho);
+    Oid left_hashfn = InvalidOid;
+    Oid right_hashfn = InvalidOid;
+    if (!get_op_hash_functions(hashop, &left_hashfn, &right_hashfn)) {
+      break;
+    }
+    Oid hash_func = outer_tuple_ ? left_hashfn : right_hashfn;
+    std::unique_ptr<ExprTreeGenerator> expr_tree(nullptr);
+    if (!(F_HASHINT2 == hash_func ||
+          F_HASHINT4 == hash_func ||
+          F_HASHINT8 == hash_func ||
+          F_HASHOID == hash_func ||
+          F_HASHENUM == hash_func) ||
+        nullptr == exprstate ||
+        nullptr == exprstate->expr ||
+        !ExprTreeGenerator::VerifyAndCreateExprTree(
+            exprstate, &gen_info_, &expr_tree)) {
+      break;
+    }
+    expr_tree_generators_.push_back(std::move(expr_tree));
+    hash_funcs_.push_back(hash_func);
+    hash_strict_.push_back(op_strict(hashop));
+  }
+
+  if (expr_tree_generators_.size() !=
+      static_cast<size_t>(list_length(hashkeys_))) {
+    // All keys feed the same hash value, so one unsupported key is enough to
+    // fall back to the regular ExecHashGetHashValue.
+    expr_tree_generators_.clear();
+    hash_funcs_.clear();
+    hash_strict_.clear();
+  }
+  return true;
+}
+
+llvm::Value* ExecHashGetHashValueCodegen::GenerateHashUInt32(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    llvm::Value* llvm_key) {
+  assert(nullptr != llvm_key && llvm_key->getType()->isIntegerTy(32));
+  auto irb = codegen_utils->ir_builder();
+
+  auto rot = [&](llvm::Value* x, int k) {
+    return irb->CreateOr(irb->CreateShl(x, k), irb->CreateLShr(x, 32 - k));
+  };
+  // One line of mix(): x -= y; x ^= rot(y, k); y += z;
+  auto mix_step = [&](llvm::Value** x, llvm::Value** y, llvm::Value* z,
+                      int k) {
+    *x = irb->CreateXor(irb->CreateSub(*x, *y), rot(*y, k));
+    *y = irb->CreateAdd(*y, z);
+  };
+
+  // a = 0xdeadbeef + k; b = 0xdeadbeef; c = 3923095 + sizeof(uint32);
+  llvm::Value* a = irb->CreateAdd(
+      codegen_utils->GetConstant<uint32_t>(0xdeadbeef), llvm_key);
+  llvm::Value* b = codegen_utils->GetConstant<uint32_t>(0xdeadbeef);
+  llvm::Value* c = codegen_utils->GetConstant<uint32_t>(
+      3923095 + static_cast<uint32_t>(sizeof(uint32)));
+
+  // mix(a, b, c);
+  mix_step(&a, &c, b, 4);
+  mix_step(&b, &a, c, 6);
+  mix_step(&c, &b, a, 8);
+  mix_step(&a, &c, b, 16);
+  mix_step(&b, &a, c, 19);
+  mix_step(&c, &b, a, 4);
+
+  return c;
+}
+
+llvm::Value* ExecHashGetHashValueCodegen::GenerateHashDatum(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    llvm::Value* llvm_datum,
+    Oid hash_func) {
+  auto irb = codegen_utils->ir_builder();
+
+  switch (hash_func) {
+    case F_HASHINT2:
+      // hash_uint32((int32) PG_GETARG_INT16(0))
+      return GenerateHashUInt32(
+          codegen_utils,
+          codegen_utils->CreateCast<int32_t, int16_t>(
+              codegen_utils->CreateDatumToCppTypeCast<int16_t>(llvm_datum)));
+    case F_HASHINT4:
+      // hash_uint32(PG_GETARG_INT32(0))
+      return GenerateHashUInt32(
+          codegen_utils,
+          codegen_utils->CreateDatumToCppTypeCast<uint32_t>(llvm_datum));
+    case F_HASHINT8: {
+      // lohalf ^= (val >= 0) ? hihalf : ~hihalf; hash_uint32(lohalf)
+      llvm::Value* llvm_val =
+          codegen_utils->CreateDatumToCppTypeCast<int64_t>(llvm_datum);
+      llvm::Value* llvm_lohalf = irb->CreateTrunc(
+          llvm_val, codegen_utils->GetType<uint32_t>());
+      llvm::Value* llvm_hihalf = irb->CreateTrunc(
+          irb->CreateLShr(llvm_val, 32), codegen_utils->GetType<uint32_t>());
+      llvm_hihalf = irb->CreateSelect(
+          irb->CreateICmpSGE(llvm_val, codegen_utils->GetConstant<int64_t>(0)),
+          llvm_hihalf, irb->CreateNot(llvm_hihalf));
+      return GenerateHashUInt32(codegen_utils,
+                                irb->CreateXor(llvm_lohalf, llvm_hihalf));
+    }
+    case F_HASHOID:
+    case F_HASHENUM:
+      // hash_uint32((uint32) PG_GETARG_OID(0))
+      return GenerateHashUInt32(
+          codegen_utils,
+          codegen_utils->CreateDatumToCppTypeCast<uint32_t>(llvm_datum));
+    default:
+      assert(false && "hash function not supported by InitDependencies");
+      return nullptr;
+  }
+}
+
+bool ExecHashGetHashValueCodegen::GenerateExecHashGetHashValue(
+    gpcodegen::GpCodegenUtils* codegen_utils) {
+
+  assert(NULL != codegen_utils);
+  if (nullptr == hashkeys_ ||
+      nullptr == gen_info_.econtext ||
+      expr_tree_generators_.empty()) {
+    return false;
+  }
+
+  // The slot of the child plan may change between calls, so we always use
+  // the external slot_getattr()
+  gen_info_.llvm_slot_getattr_func =
+      codegen_utils->GetOrRegisterExternalFunction(slot_getattr_regular,
+                                                   "slot_getattr_regular");
+
+  llvm::Function* exec_hash_get_hash_value_func =
+      CreateFunction<ExecHashGetHashValueFn>(
+          codegen_utils, GetUniqueFuncName());
+
+  // Function arguments to ExecHashGetHashValue
+  llvm::Value* llvm_econtext_arg =
+      ArgumentByPosition(exec_hash_get_hash_value_func, 2);
+  llvm::Value* llvm_keep_nulls_arg =
+      ArgumentByPosition(exec_hash_get_hash_value_func, 5);
+  llvm::Value* llvm_hashvalue_arg =
+      ArgumentByPosition(exec_hash_get_hash_value_func, 6);
+  llvm::Value* llvm_hashkeys_null_arg =
+      ArgumentByPosition(exec_hash_get_hash_value_func, 7);
+
+  // External functions
+  llvm::Function* llvm_MemoryContextReset =
+      codegen_utils->GetOrRegisterExternalFunction(MemoryContextReset,
+                                                   "MemoryContextReset");
+  llvm::Function* llvm_MemoryContextSwitchTo =
+      codegen_utils->GetOrRegisterExternalFunction(MemoryContextSwitchTo,
+                                                   "MemoryContextSwitchTo");
+
+  llvm::BasicBlock* llvm_entry_block = codegen_utils->CreateBasicBlock(
+      "entry", exec_hash_get_hash_value_func);
+  llvm::BasicBlock* llvm_error_block = codegen_utils->CreateBasicBlock(
+      "error_block", exec_hash_get_hash_value_func);
+
+  gen_info_.llvm_main_func = exec_hash_get_hash_value_func;
+  gen_info_.llvm_error_block = llvm_error_block;
+
+  auto irb = codegen_utils->ir_builder();
+
+  // Entry block
+  // -----------
+  irb->SetInsertPoint(llvm_entry_block);
+#ifdef CODEGEN_DEBUG
+  EXPAND_CREATE_ELOG(codegen_utils,
+                     DEBUG1,
+                     "Codegen'ed ExecHashGetHashValue called!");
+#endif
+
+  // ResetExprContext(econtext);
+  // oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+  llvm::Value* llvm_per_tuple_memory = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_econtext_arg, &ExprContext::ecxt_per_tuple_memory));
+  irb->CreateCall(llvm_MemoryContextReset, {llvm_per_tuple_memory});
+  llvm::Value* llvm_old_context = irb->CreateCall(
+      llvm_MemoryContextSwitchTo, {llvm_per_tuple_memory});
+
+  // Allocate all isnull flags upfront in the entry block so that they can be
+  // promoted to registers.
+  std::vector<llvm::Value*> llvm_isnull_ptrs;
+  for (size_t i = 0; i < expr_tree_generators_.size(); ++i) {
+    llvm::Value* llvm_isnull_ptr = irb->CreateAlloca(
+        codegen_utils->GetType<bool>(), nullptr, "isNull");
+    irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+    llvm_isnull_ptrs.push_back(llvm_isnull_ptr);
+  }
+
+  // uint32 hashkey = 0; bool result = true; *hashkeys_null = true;
+  llvm::Value* llvm_hashkey = codegen_utils->GetConstant<uint32_t>(0);
+  llvm::Value* llvm_result = codegen_utils->GetConstant<bool>(true);
+  llvm::Value* llvm_hashkeys_null = codegen_utils->GetConstant<bool>(true);
+
+  for (size_t i = 0; i < expr_tree_generators_.size(); ++i) {
+    // rotate hashkey left 1 bit at each step
+    llvm_hashkey = irb->CreateOr(irb->CreateShl(llvm_hashkey, 1),
+                                 irb->CreateLShr(llvm_hashkey, 31));
+
+    // Get the join attribute value of the tuple
+    llvm::Value* llvm_keyval = nullptr;
+    bool is_generated = expr_tree_generators_[i]->GenerateCode(
+        codegen_utils, gen_info_, &llvm_keyval, llvm_isnull_ptrs[i]);
+    if (!is_generated || nullptr == llvm_keyval) {
+      return false;
+    }
+
+    llvm::BasicBlock* llvm_null_block = codegen_utils->CreateBasicBlock(
+        "key_null", exec_hash_get_hash_value_func);
+    llvm::BasicBlock* llvm_not_null_block = codegen_utils->CreateBasicBlock(
+        "key_not_null", exec_hash_get_hash_value_func);
+    llvm::BasicBlock* llvm_next_key_block = codegen_utils->CreateBasicBlock(
+        "next_key", exec_hash_get_hash_value_func);
+    irb->CreateCondBr(irb->CreateLoad(llvm_isnull_ptrs[i]),
+                      llvm_null_block /* true */,
+                      llvm_not_null_block /* false */);
+
+    // If the join operator is strict, a NULL key rejects the tuple unless
+    // keep_nulls is set; otherwise the hash value is left unmodified, as if
+    // the hash code of NULL were zero.
+    irb->SetInsertPoint(llvm_null_block);
+    llvm::Value* llvm_null_result = llvm_result;
+    if (hash_strict_[i]) {
+      llvm_null_result = irb->CreateAnd(llvm_result, llvm_keep_nulls_arg);
+    }
+    irb->CreateBr(llvm_next_key_block);
+
+    // if (result) hashkey ^= hash(keyval);
+    irb->SetInsertPoint(llvm_not_null_block);
+    llvm::Value* llvm_not_null_hashkey = irb->CreateSelect(
+        llvm_result,
+        irb->CreateXor(llvm_hashkey, GenerateHashDatum(
+            codegen_utils, llvm_keyval, hash_funcs_[i])),
+        llvm_hashkey);
+    irb->CreateBr(llvm_next_key_block);
+
+    irb->SetInsertPoint(llvm_next_key_block);
+    llvm::PHINode* llvm_hashkey_phi = irb->CreatePHI(
+        codegen_utils->GetType<uint32_t>(), 2);
+    llvm_hashkey_phi->addIncoming(llvm_hashkey, llvm_null_block);
+    llvm_hashkey_phi->addIncoming(llvm_not_null_hashkey, llvm_not_null_block);
+    llvm::PHINode* llvm_result_phi = irb->CreatePHI(
+        codegen_utils->GetType<bool>(), 2);
+    llvm_result_phi->addIncoming(llvm_null_result, llvm_null_block);
+    llvm_result_phi->addIncoming(llvm_result, llvm_not_null_block);
+    llvm::PHINode* llvm_hashkeys_null_phi = irb->CreatePHI(
+        codegen_utils->GetType<bool>(), 2);
+    llvm_hashkeys_null_phi->addIncoming(llvm_hashkeys_null, llvm_null_block);
+    llvm_hashkeys_null_phi->addIncoming(codegen_utils->GetConstant<bool>(false),
+                                        llvm_not_null_block);
+
+    llvm_hashkey = llvm_hashkey_phi;
+    llvm_result = llvm_result_phi;
+    llvm_hashkeys_null = llvm_hashkeys_null_phi;
+  }
+
+  // MemoryContextSwitchTo(oldContext);
+  // *hashvalue = hashkey;
+  // return result;
+  irb->CreateCall(llvm_MemoryContextSwitchTo, {llvm_old_context});
+  irb->CreateStore(llvm_hashkey, llvm_hashvalue_arg);
+  irb->CreateStore(llvm_hashkeys_null, llvm_hashkeys_null_arg);
+  irb->CreateRet(llvm_result);
+
+  // Error block
+  // -----------
+  irb->SetInsertPoint(llvm_error_block);
+  irb->CreateRet(codegen_utils->GetConstant<bool>(false));
+
+  return true;
+}
+
+bool ExecHashGetHashValueCodegen::GenerateCodeInternal(
+    GpCodegenUtils* codegen_utils) {
+  bool isGenerated = GenerateExecHashGetHashValue(codegen_utils);
+
+  if (isGenerated) {
+    elog(DEBUG1, "ExecHashGetHashValue was generated successfully!");
+    return true;
+  } else {
+    elog(DEBUG1, "ExecHashGetHashValue generation failed!");
+    return false;
+  }
+}
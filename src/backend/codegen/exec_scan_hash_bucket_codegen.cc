@@ -0,0 +1,448 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    exec_scan_hash_bucket_codegen.cc
+//
+//  @doc:
+//    Generates code for ExecScanHashBucket function of hash joins.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <stddef.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/exec_scan_hash_bucket_codegen.h"
+#include "codegen/expr_tree_generator.h"
+#include "codegen/op_expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/utils/utility.h"
+
+#include "llvm/IR/Argument.h"
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "access/memtup.h"
+#include "cdb/cdbvars.h"
+#include "executor/hashjoin.h"
+#include "executor/tuptable.h"
+#include "nodes/execnodes.h"
+#include "nodes/pg_list.h"
+#include "nodes/primnodes.h"
+#include "utils/elog.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "nodes/nodes.h"
+}
+
+namespace llvm {
+class BasicBlock;
+class Function;
+class Value;
+}  // namespace llvm
+
+using gpcodegen::ExecScanHashBucketCodegen;
+
+constexpr char ExecScanHashBucketCodegen::kExecScanHashBucketPrefix[];
+
+ExecScanHashBucketCodegen::ExecScanHashBucketCodegen(
+    CodegenManager* manager,
+    ExecScanHashBucketFn regular_func_ptr,
+    ExecScanHashBucketFn* ptr_to_regular_func_ptr,
+    HashJoinState* hjstate)
+    : BaseCodegen(manager,
+                  kExecScanHashBucketPrefix,
+                  regular_func_ptr, ptr_to_regular_func_ptr),
+      hjstate_(hjstate),
+      gen_info_(nullptr == hjstate ? nullptr : hjstate->js.ps.ps_ExprContext,
+                nullptr, nullptr, nullptr, 0) {
+}
+
+bool ExecScanHashBucketCodegen::InitDependencies() {
+  OpExprTreeGenerator::InitializeSupportedFunction();
+  outer_expr_tree_generators_.clear();
+  eq_funcs_.clear();
+  inner_attnums_.clear();
+
+  // IS NOT DISTINCT FROM joins match with hashqualclauses, which are not
+  // strict.
+  if (nullptr == hjstate_ || hjstate_->hj_nonequijoin) {
+    return true;
+  }
+
+  ListCell* l = nullptr;
+  foreach(l, hjstate_->hashclauses) {
+    FuncExprState* fstate = reinterpret_cast<FuncExprState*>(lfirst(l));
+    Expr* expr = fstate->xprstate.expr;
+    if (nullptr == expr || T_OpExpr != nodeTag(expr) ||
+        2 != list_length(fstate->args)) {
+      break;
+    }
+
+    Oid eq_func = get_opcode(reinterpret_cast<OpExpr*>(expr)->opno);
+    if (!(F_INT2EQ == eq_func ||
+          F_INT4EQ == eq_func ||
+          F_INT8EQ == eq_func ||
+          F_OIDEQ == eq_func)) {
+      break;
+    }
+
+    // The inner argument is read straight from the tuples of the hash table,
+    // so it has to be a plain column.
+    ExprState* inner_exprstate =
+        reinterpret_cast<ExprState*>(lsecond(fstate->args));
+    if (nullptr == inner_exprstate ||
+        nullptr == inner_exprstate->expr ||
+        T_Var != nodeTag(inner_exprstate->expr)) {
+      break;
+    }
+    Var* inner_var = reinterpret_cast<Var*>(inner_exprstate->expr);
+    if (INNER != inner_var->varno || inner_var->varattno <= 0) {
+      break;
+    }
+
+    ExprState* outer_exprstate =
+        reinterpret_cast<ExprState*>(linitial(fstate->args));
+    std::unique_ptr<ExprTreeGenerator> expr_tree(nullptr);
+    if (nullptr == outer_exprstate ||
+        nullptr == outer_exprstate->expr ||
+        !ExprTreeGenerator::VerifyAndCreateExprTree(
+            outer_exprstate, &gen_info_, &expr_tree)) {
+      break;
+    }
+
+    outer_expr_tree_generators_.push_back(std::move(expr_tree));
+    eq_funcs_.push_back(eq_func);
+    inner_attnums_.push_back(inner_var->varattno);
+  }
+
+  if (outer_expr_tree_generators_.size() !=
+      static_cast<size_t>(list_length(hjstate_->hashclauses))) {
+    outer_expr_tree_generators_.clear();
+    eq_funcs_.clear();
+    inner_attnums_.clear();
+  }
+  return true;
+}
+
+bool ExecScanHashBucketCodegen::GenerateExecScanHashBucket(
+    gpcodegen::GpCodegenUtils* codegen_utils) {
+
+  assert(NULL != codegen_utils);
+  if (nullptr == hjstate_ ||
+      nullptr == gen_info_.econtext ||
+      outer_expr_tree_generators_.empty()) {
+    return false;
+  }
+
+  // The outer slot may change between calls, so we always use the external
+  // slot_getattr()
+  gen_info_.llvm_slot_getattr_func =
+      codegen_utils->GetOrRegisterExternalFunction(slot_getattr_regular,
+                                                   "slot_getattr_regular");
+
+  llvm::Function* exec_scan_hash_bucket_func =
+      CreateFunction<ExecScanHashBucketFn>(
+          codegen_utils, GetUniqueFuncName());
+
+  // Function arguments to ExecScanHashBucket
+  llvm::Value* llvm_hjstate_arg =
+      ArgumentByPosition(exec_scan_hash_bucket_func, 1);
+  llvm::Value* llvm_econtext_arg =
+      ArgumentByPosition(exec_scan_hash_bucket_func, 2);
+
+  // External functions
+  llvm::Function* llvm_MemoryContextReset =
+      codegen_utils->GetOrRegisterExternalFunction(MemoryContextReset,
+                                                   "MemoryContextReset");
+  llvm::Function* llvm_MemoryContextSwitchTo =
+      codegen_utils->GetOrRegisterExternalFunction(MemoryContextSwitchTo,
+                                                   "MemoryContextSwitchTo");
+  llvm::Function* llvm_memtuple_getattr =
+      codegen_utils->GetOrRegisterExternalFunction(memtuple_getattr,
+                                                   "memtuple_getattr");
+
+  llvm::BasicBlock* llvm_entry_block = codegen_utils->CreateBasicBlock(
+      "entry", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_first_in_bucket_block =
+      codegen_utils->CreateBasicBlock(
+          "first_in_bucket", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_bloom_filter_block = codegen_utils->CreateBasicBlock(
+      "bloom_filter", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_bucket_head_block = codegen_utils->CreateBasicBlock(
+      "bucket_head", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_next_of_current_block =
+      codegen_utils->CreateBasicBlock(
+          "next_of_current", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_loop_block = codegen_utils->CreateBasicBlock(
+      "loop", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_check_hash_block = codegen_utils->CreateBasicBlock(
+      "check_hash", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_match_block = codegen_utils->CreateBasicBlock(
+      "match", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_advance_block = codegen_utils->CreateBasicBlock(
+      "advance", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_no_match_block = codegen_utils->CreateBasicBlock(
+      "no_match", exec_scan_hash_bucket_func);
+  llvm::BasicBlock* llvm_error_block = codegen_utils->CreateBasicBlock(
+      "error_block", exec_scan_hash_bucket_func);
+
+  gen_info_.llvm_main_func = exec_scan_hash_bucket_func;
+  gen_info_.llvm_error_block = llvm_error_block;
+
+  auto irb = codegen_utils->ir_builder();
+
+  // Entry block
+  // -----------
+  irb->SetInsertPoint(llvm_entry_block);
+#ifdef CODEGEN_DEBUG
+  EXPAND_CREATE_ELOG(codegen_utils,
+                     DEBUG1,
+                     "Codegen'ed ExecScanHashBucket called!");
+#endif
+
+  // Allocate all isnull flags upfront in the entry block so that they can be
+  // promoted to registers.
+  std::vector<llvm::Value*> llvm_isnull_ptrs;
+  for (size_t i = 0; i < outer_expr_tree_generators_.size(); ++i) {
+    llvm::Value* llvm_isnull_ptr = irb->CreateAlloca(
+        codegen_utils->GetType<bool>(), nullptr, "isNull");
+    irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+    llvm_isnull_ptrs.push_back(llvm_isnull_ptr);
+  }
+  llvm::Value* llvm_inner_isnull_ptr = irb->CreateAlloca(
+      codegen_utils->GetType<bool>(), nullptr, "inner_isNull");
+
+  // ResetExprContext(econtext);
+  // oldContext = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+  llvm::Value* llvm_per_tuple_memory = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_econtext_arg, &ExprContext::ecxt_per_tuple_memory));
+  irb->CreateCall(llvm_MemoryContextReset, {llvm_per_tuple_memory});
+  llvm::Value* llvm_old_context = irb->CreateCall(
+      llvm_MemoryContextSwitchTo, {llvm_per_tuple_memory});
+
+  // Evaluate the outer keys once for the whole bucket, instead of once per
+  // candidate tuple as ExecQual() does. The hash join operators are strict,
+  // so an outer tuple with a NULL key matches nothing.
+  std::vector<llvm::Value*> llvm_outer_keys;
+  for (size_t i = 0; i < outer_expr_tree_generators_.size(); ++i) {
+    llvm::Value* llvm_keyval = nullptr;
+    bool is_generated = outer_expr_tree_generators_[i]->GenerateCode(
+        codegen_utils, gen_info_, &llvm_keyval, llvm_isnull_ptrs[i]);
+    if (!is_generated || nullptr == llvm_keyval) {
+      return false;
+    }
+    llvm_outer_keys.push_back(llvm_keyval);
+  }
+  irb->CreateCall(llvm_MemoryContextSwitchTo, {llvm_old_context});
+
+  for (size_t i = 0; i < outer_expr_tree_generators_.size(); ++i) {
+    llvm::BasicBlock* llvm_next_key_block = codegen_utils->CreateBasicBlock(
+        "outer_key_not_null", exec_scan_hash_bucket_func);
+    irb->CreateCondBr(irb->CreateLoad(llvm_isnull_ptrs[i]),
+                      llvm_no_match_block /* true */,
+                      llvm_next_key_block /* false */);
+    irb->SetInsertPoint(llvm_next_key_block);
+  }
+
+  // hashvalue = hjstate->hj_CurHashValue;
+  // hashTuple = hjstate->hj_CurTuple;
+  llvm::Value* llvm_hashvalue = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hjstate_arg, &HashJoinState::hj_CurHashValue));
+  llvm::Value* llvm_cur_tuple_ptr = codegen_utils->GetPointerToMember(
+      llvm_hjstate_arg, &HashJoinState::hj_CurTuple);
+  llvm::Value* llvm_cur_tuple = irb->CreateLoad(llvm_cur_tuple_ptr);
+  irb->CreateCondBr(irb->CreateIsNull(llvm_cur_tuple),
+                    llvm_first_in_bucket_block /* true */,
+                    llvm_next_of_current_block /* false */);
+
+  // Start scanning a new bucket
+  // ---------------------------
+  irb->SetInsertPoint(llvm_first_in_bucket_block);
+  llvm::Value* llvm_hashtable = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hjstate_arg, &HashJoinState::hj_HashTable));
+  llvm::Value* llvm_bucketno = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hjstate_arg, &HashJoinState::hj_CurBucketNo));
+  llvm::Value* llvm_bloomfilter = irb->CreateLoad(
+      codegen_utils->GetConstant(&gp_hashjoin_bloomfilter));
+  irb->CreateCondBr(
+      irb->CreateICmpNE(llvm_bloomfilter,
+                        codegen_utils->GetConstant<int>(0)),
+      llvm_bloom_filter_block /* true */,
+      llvm_bucket_head_block /* false */);
+
+  // if bloom filter fails, then no match - don't even bother to scan
+  // (hashtable->bloom[bucketno] & BLOOMVAL(hashvalue)) == 0
+  irb->SetInsertPoint(llvm_bloom_filter_block);
+  llvm::Value* llvm_bloom = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hashtable, &HashJoinTableData::bloom));
+  llvm::Value* llvm_bloom_bits = irb->CreateLoad(
+      irb->CreateInBoundsGEP(llvm_bloom, {llvm_bucketno}));
+  llvm::Value* llvm_bloomval = irb->CreateShl(
+      codegen_utils->GetConstant<uint64_t>(1),
+      irb->CreateZExt(
+          irb->CreateAnd(irb->CreateLShr(llvm_hashvalue, 13), 0x3f),
+          codegen_utils->GetType<uint64_t>()));
+  irb->CreateCondBr(
+      irb->CreateICmpEQ(irb->CreateAnd(llvm_bloom_bits, llvm_bloomval),
+                        codegen_utils->GetConstant<uint64_t>(0)),
+      llvm_no_match_block /* true */,
+      llvm_bucket_head_block /* false */);
+
+  // hashTuple = hashtable->buckets[bucketno];
+  irb->SetInsertPoint(llvm_bucket_head_block);
+  llvm::Value* llvm_buckets = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hashtable, &HashJoinTableData::buckets));
+  llvm::Value* llvm_bucket_head = irb->CreateLoad(
+      irb->CreateInBoundsGEP(llvm_buckets, {llvm_bucketno}));
+  irb->CreateBr(llvm_loop_block);
+
+  // Resume after the last tuple returned from the current bucket
+  // ------------------------------------------------------------
+  // hashTuple = hashTuple->next;
+  irb->SetInsertPoint(llvm_next_of_current_block);
+  llvm::Value* llvm_next_of_current = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_cur_tuple, &HashJoinTupleData::next));
+  irb->CreateBr(llvm_loop_block);
+
+  // Loop over the tuples of the bucket
+  // ----------------------------------
+  irb->SetInsertPoint(llvm_loop_block);
+  llvm::PHINode* llvm_hash_tuple = irb->CreatePHI(
+      codegen_utils->GetType<HashJoinTuple>(), 3, "hashTuple");
+  llvm_hash_tuple->addIncoming(llvm_bucket_head, llvm_bucket_head_block);
+  llvm_hash_tuple->addIncoming(llvm_next_of_current,
+                               llvm_next_of_current_block);
+  irb->CreateCondBr(irb->CreateIsNull(llvm_hash_tuple),
+                    llvm_no_match_block /* true */,
+                    llvm_check_hash_block /* false */);
+
+  // if (hashTuple->hashvalue == hashvalue)
+  irb->SetInsertPoint(llvm_check_hash_block);
+  llvm::Value* llvm_tuple_hashvalue = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hash_tuple, &HashJoinTupleData::hashvalue));
+  llvm::BasicBlock* llvm_compare_keys_block = codegen_utils->CreateBasicBlock(
+      "compare_keys", exec_scan_hash_bucket_func);
+  irb->CreateCondBr(irb->CreateICmpEQ(llvm_tuple_hashvalue, llvm_hashvalue),
+                    llvm_compare_keys_block /* true */,
+                    llvm_advance_block /* false */);
+
+  // Compare the keys with the columns of HJTUPLE_MINTUPLE(hashTuple), in the
+  // binding of hjstate->hj_HashTupleSlot, where ExecQual() would see them.
+  irb->SetInsertPoint(llvm_compare_keys_block);
+  llvm::Value* llvm_mintuple = irb->CreateInBoundsGEP(
+      llvm_hash_tuple,
+      {codegen_utils->GetConstant<int64_t>(HJTUPLE_OVERHEAD)});
+  llvm::Value* llvm_hash_tuple_slot = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hjstate_arg, &HashJoinState::hj_HashTupleSlot));
+  llvm::Value* llvm_mt_bind = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hash_tuple_slot, &TupleTableSlot::tts_mt_bind));
+  for (size_t i = 0; i < outer_expr_tree_generators_.size(); ++i) {
+    llvm::Value* llvm_inner_key = irb->CreateCall(
+        llvm_memtuple_getattr, {
+            llvm_mintuple,
+            llvm_mt_bind,
+            codegen_utils->GetConstant<int32_t>(inner_attnums_[i]),
+            llvm_inner_isnull_ptr});
+
+    llvm::Value* llvm_outer_key = llvm_outer_keys[i];
+    switch (eq_funcs_[i]) {
+      case F_INT2EQ:
+        llvm_outer_key =
+            codegen_utils->CreateDatumToCppTypeCast<int16_t>(llvm_outer_key);
+        llvm_inner_key =
+            codegen_utils->CreateDatumToCppTypeCast<int16_t>(llvm_inner_key);
+        break;
+      case F_INT4EQ:
+      case F_OIDEQ:
+        llvm_outer_key =
+            codegen_utils->CreateDatumToCppTypeCast<int32_t>(llvm_outer_key);
+        llvm_inner_key =
+            codegen_utils->CreateDatumToCppTypeCast<int32_t>(llvm_inner_key);
+        break;
+      case F_INT8EQ:
+        break;
+      default:
+        assert(false && "equality function not supported by InitDependencies");
+        return false;
+    }
+
+    llvm::BasicBlock* llvm_next_key_block = codegen_utils->CreateBasicBlock(
+        "next_key", exec_scan_hash_bucket_func);
+    irb->CreateCondBr(
+        irb->CreateAnd(
+            irb->CreateNot(irb->CreateLoad(llvm_inner_isnull_ptr)),
+            irb->CreateICmpEQ(llvm_outer_key, llvm_inner_key)),
+        llvm_next_key_block /* true */,
+        llvm_advance_block /* false */);
+    irb->SetInsertPoint(llvm_next_key_block);
+  }
+  irb->CreateBr(llvm_match_block);
+
+  // hjstate->hj_CurTuple = hashTuple;
+  // return hashTuple;
+  //
+  // Unlike the regular version, we don't store the tuple in
+  // hj_HashTupleSlot: ExecHashJoin() does that itself for the tuples we
+  // return.
+  irb->SetInsertPoint(llvm_match_block);
+  irb->CreateStore(llvm_hash_tuple, llvm_cur_tuple_ptr);
+  irb->CreateRet(llvm_hash_tuple);
+
+  // hashTuple = hashTuple->next;
+  irb->SetInsertPoint(llvm_advance_block);
+  llvm::Value* llvm_next_tuple = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_hash_tuple, &HashJoinTupleData::next));
+  llvm_hash_tuple->addIncoming(llvm_next_tuple, llvm_advance_block);
+  irb->CreateBr(llvm_loop_block);
+
+  // No match
+  // --------
+  irb->SetInsertPoint(llvm_no_match_block);
+  irb->CreateRet(llvm::ConstantPointerNull::get(
+      static_cast<llvm::PointerType*>(
+          codegen_utils->GetType<HashJoinTuple>())));
+
+  // Error block
+  // -----------
+  irb->SetInsertPoint(llvm_error_block);
+  irb->CreateRet(llvm::ConstantPointerNull::get(
+      static_cast<llvm::PointerType*>(
+          codegen_utils->GetType<HashJoinTuple>())));
+
+  return true;
+}
+
+bool ExecScanHashBucketCodegen::GenerateCodeInternal(
+    GpCodegenUtils* codegen_utils) {
+  bool isGenerated = GenerateExecScanHashBucket(codegen_utils);
+
+  if (isGenerated) {
+    elog(DEBUG1, "ExecScanHashBucket was generated successfully!");
+    return true;
+  } else {
+    elog(DEBUG1, "ExecScanHashBucket generation failed!");
+    return false;
+  }
+}
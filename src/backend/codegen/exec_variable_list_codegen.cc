@@ -75,8 +75,9 @@ bool ExecVariableListCodegen::InitDependencies() {
   max_attr_ = *std::max_element(
       proj_info_->pi_varNumbers,
       proj_info_->pi_varNumbers + list_length(proj_info_->pi_targetlist));
+  // ExecVariableList is only enrolled for heap table scans
   slot_getattr_codegen_ = SlotGetAttrCodegen::GetCodegenInstance(
-      manager(), slot_, max_attr_);
+      manager(), slot_, max_attr_, false /* holds_memtuples */);
   return true;
 }
 
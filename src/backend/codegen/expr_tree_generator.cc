@@ -12,11 +12,18 @@
 #include <cassert>
 #include <memory>
 
+#include "codegen/bool_expr_tree_generator.h"
+#include "codegen/case_expr_tree_generator.h"
+#include "codegen/case_test_expr_tree_generator.h"
 #include "codegen/const_expr_tree_generator.h"
 #include "codegen/expr_tree_generator.h"
+#include "codegen/null_test_expr_tree_generator.h"
 #include "codegen/op_expr_tree_generator.h"
+#include "codegen/scalar_array_op_expr_tree_generator.h"
 #include "codegen/var_expr_tree_generator.h"
 
+#include "llvm/IR/IRBuilder.h"
+
 extern "C" {
 #include "postgres.h"  // NOLINT(build/include)
 #include "nodes/execnodes.h"
@@ -25,6 +32,7 @@ extern "C" {
 }
 
 using gpcodegen::ExprTreeGenerator;
+using gpcodegen::GpCodegenUtils;
 
 bool ExprTreeGenerator::VerifyAndCreateExprTree(
     const ExprState* expr_state,
@@ -35,7 +43,11 @@ bool ExprTreeGenerator::VerifyAndCreateExprTree(
          nullptr != expr_tree);
 
   if (!(IsA(expr_state, FuncExprState) ||
-      IsA(expr_state, ExprState))) {
+      IsA(expr_state, ExprState) ||
+      IsA(expr_state, BoolExprState) ||
+      IsA(expr_state, CaseExprState) ||
+      IsA(expr_state, NullTestState) ||
+      IsA(expr_state, ScalarArrayOpExprState))) {
     elog(DEBUG1, "Input expression state type (%d) is not supported",
          expr_state->type);
     return false;
@@ -58,6 +70,32 @@ bool ExprTreeGenerator::VerifyAndCreateExprTree(
           expr_state, gen_info, expr_tree);
       break;
     }
+    case T_BoolExpr: {
+      supported_expr_tree = BoolExprTreeGenerator::VerifyAndCreateExprTree(
+          expr_state, gen_info, expr_tree);
+      break;
+    }
+    case T_CaseExpr: {
+      supported_expr_tree = CaseExprTreeGenerator::VerifyAndCreateExprTree(
+          expr_state, gen_info, expr_tree);
+      break;
+    }
+    case T_CaseTestExpr: {
+      supported_expr_tree = CaseTestExprTreeGenerator::VerifyAndCreateExprTree(
+          expr_state, gen_info, expr_tree);
+      break;
+    }
+    case T_NullTest: {
+      supported_expr_tree = NullTestExprTreeGenerator::VerifyAndCreateExprTree(
+          expr_state, gen_info, expr_tree);
+      break;
+    }
+    case T_ScalarArrayOpExpr: {
+      supported_expr_tree =
+          ScalarArrayOpExprTreeGenerator::VerifyAndCreateExprTree(
+              expr_state, gen_info, expr_tree);
+      break;
+    }
     default : {
       supported_expr_tree = false;
       elog(DEBUG1, "Unsupported expression tree %d found",
@@ -68,3 +106,27 @@ bool ExprTreeGenerator::VerifyAndCreateExprTree(
          (supported_expr_tree && nullptr != expr_tree->get()));
   return supported_expr_tree;
 }
+
+bool ExprTreeGenerator::GenerateArgumentCode(
+    GpCodegenUtils* codegen_utils,
+    const ExprTreeGeneratorInfo& gen_info,
+    ExprTreeGenerator* argument,
+    llvm::Value** llvm_out_value,
+    llvm::Value** llvm_out_isnull) {
+  assert(nullptr != argument &&
+         nullptr != llvm_out_value &&
+         nullptr != llvm_out_isnull);
+  auto irb = codegen_utils->ir_builder();
+  llvm::Value* llvm_isnull_ptr = irb->CreateAlloca(
+      codegen_utils->GetType<bool>(), nullptr, "isNull");
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+  if (!argument->GenerateCode(codegen_utils,
+                              gen_info,
+                              llvm_out_value,
+                              llvm_isnull_ptr)) {
+    return false;
+  }
+  assert(nullptr != *llvm_out_value);
+  *llvm_out_isnull = irb->CreateLoad(llvm_isnull_ptr);
+  return true;
+}
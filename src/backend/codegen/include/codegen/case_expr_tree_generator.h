@@ -0,0 +1,82 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    case_expr_tree_generator.h
+//
+//  @doc:
+//    Object that generate code for CASE expressions.
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_CASE_EXPR_TREE_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_CASE_EXPR_TREE_GENERATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "codegen/expr_tree_generator.h"
+
+#include "llvm/IR/Value.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Object that generate code for CASE expressions, with or without a
+ *        tested value.
+ **/
+class CaseExprTreeGenerator : public ExprTreeGenerator {
+ public:
+  static bool VerifyAndCreateExprTree(
+      const ExprState* expr_state,
+      ExprTreeGeneratorInfo* gen_info,
+      std::unique_ptr<ExprTreeGenerator>* expr_tree);
+
+  /**
+   * @note Same as ExecEvalCase(): the WHEN conditions are evaluated in order,
+   * and only the result of the first one that is true (not false or NULL) is
+   * evaluated. The tested value, if any, is stored in the ExprContext for the
+   * CaseTestExpr placeholders of the conditions, and the previous one is
+   * restored before evaluating the result.
+   **/
+  bool GenerateCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                    const ExprTreeGeneratorInfo& gen_info,
+                    llvm::Value** llvm_out_value,
+                    llvm::Value* const llvm_isnull_ptr) final;
+
+ protected:
+  /**
+   * @brief Constructor.
+   *
+   * @param expr_state  Expression state
+   * @param arg         Tested value, or nullptr
+   * @param conditions  WHEN conditions
+   * @param results     Results of the WHEN clauses
+   * @param defresult   ELSE result, or nullptr
+   **/
+  CaseExprTreeGenerator(
+      const ExprState* expr_state,
+      std::unique_ptr<ExprTreeGenerator> arg,
+      std::vector<
+          std::unique_ptr<
+              ExprTreeGenerator>>&& conditions,  // NOLINT(build/c++11)
+      std::vector<
+          std::unique_ptr<
+              ExprTreeGenerator>>&& results,  // NOLINT(build/c++11)
+      std::unique_ptr<ExprTreeGenerator> defresult);
+
+ private:
+  std::unique_ptr<ExprTreeGenerator> arg_;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> conditions_;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> results_;
+  std::unique_ptr<ExprTreeGenerator> defresult_;
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_CASE_EXPR_TREE_GENERATOR_H_
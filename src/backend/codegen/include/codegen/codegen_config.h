@@ -21,6 +21,9 @@ extern bool codegen_exec_variable_list;
 extern bool codegen_slot_getattr;
 extern bool codegen_exec_eval_expr;
 extern bool codegen_advance_aggregate;
+extern bool codegen_eval_hash_key;
+extern bool codegen_memtuple_deform;
+extern bool codegen_hash_join;
 // TODO(shardikar): Retire this GUC after performing experiments to find the
 // tradeoff of codegen-ing slot_getattr() (potentially by measuring the
 // difference in the number of instructions) when one of the first few
@@ -39,6 +42,10 @@ class ExecVariableListCodegen;
 class SlotGetAttrCodegen;
 class ExecEvalExprCodegen;
 class AdvanceAggregatesCodegen;
+class EvalHashKeyCodegen;
+class MemTupleDeformGenerator;
+class ExecHashGetHashValueCodegen;
+class ExecScanHashBucketCodegen;
 
 class CodegenConfig {
  public:
@@ -73,6 +80,26 @@ inline bool CodegenConfig::IsGeneratorEnabled<AdvanceAggregatesCodegen>() {
   return codegen_advance_aggregate;
 }
 
+template<>
+inline bool CodegenConfig::IsGeneratorEnabled<EvalHashKeyCodegen>() {
+  return codegen_eval_hash_key;
+}
+
+template<>
+inline bool CodegenConfig::IsGeneratorEnabled<MemTupleDeformGenerator>() {
+  return codegen_memtuple_deform;
+}
+
+template<>
+inline bool CodegenConfig::IsGeneratorEnabled<ExecHashGetHashValueCodegen>() {
+  return codegen_hash_join;
+}
+
+template<>
+inline bool CodegenConfig::IsGeneratorEnabled<ExecScanHashBucketCodegen>() {
+  return codegen_hash_join;
+}
+
 
 /** @} */
 
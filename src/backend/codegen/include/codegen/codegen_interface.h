@@ -23,6 +23,7 @@ namespace gpcodegen {
 
 // Forward declaration
 class GpCodegenUtils;
+class CodegenManager;
 
 /**
  * @brief Interface for all code generators.
@@ -97,15 +98,18 @@ class CodegenInterface {
    * @brief	Utility function to construct a unique function name from the
    * 			original function name by appending a numeric suffix.
    *
+   * @note  Names are unique within the module of the given manager. Since the
+   *        suffix does not depend on how many generators other managers
+   *        created before, identical plans produce identical modules, which
+   *        is what allows the compiled objects to be cached.
+   *
+   * @param manager         Manager whose module the function will live in.
    * @param orig_func_name	Function name that needs to be made unique.
    * @return 	Unique string for given input string.
    *
    **/
-  static std::string GenerateUniqueName(const std::string& orig_func_name);
-
- private:
-  // Unique counter for all instances of Codegen Interface.
-  static unsigned unique_counter_;
+  static std::string GenerateUniqueName(CodegenManager* manager,
+                                        const std::string& orig_func_name);
 };
 
 /** @} */
@@ -13,7 +13,9 @@
 #ifndef GPCODEGEN_CODEGEN_MANAGER_H_  // NOLINT(build/header_guard)
 #define GPCODEGEN_CODEGEN_MANAGER_H_
 
+#include <atomic>  // NOLINT(build/c++11)
 #include <memory>
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 #include <string>
 
@@ -33,6 +35,9 @@ class GpCodegenUtils;
 // Forward declaration of a CodegenInterface that will be managed by manager
 class CodegenInterface;
 
+// Forward declaration of the cache of compiled modules
+class CodegenObjectCache;
+
 /**
  * @brief Object that manages all code gen.
  **/
@@ -43,10 +48,20 @@ class CodegenManager {
    *
    * @param module_name A human-readable name for the module that this
    *        CodegenManager will manage.
+   * @param estimated_rows Number of rows the plan node is expected to
+   *        process, or a negative number if unknown. Nodes expected to
+   *        process fewer than codegen_min_rows rows do not generate code, and
+   *        nodes expected to process at least codegen_aggressive_rows rows
+   *        are compiled with the aggressive optimization level.
    **/
-  explicit CodegenManager(const std::string& module_name);
+  explicit CodegenManager(const std::string& module_name,
+                          double estimated_rows = -1);
 
-  ~CodegenManager() = default;
+  /**
+   * @brief Destructor. If the module is still being compiled in the
+   *        background, the compilation is left to finish on its own.
+   **/
+  ~CodegenManager();
 
   /**
    * @brief Template function to facilitate enroll for any type of
@@ -89,6 +104,8 @@ class CodegenManager {
         // called. This happens e.g during gpinitsystem.
         (nullptr != manager) &&
         codegen &&  // if codegen guc is false
+        // if the node is not expected to process enough rows
+        manager->ShouldGenerateCode() &&
         // if generator is disabled
         CodegenConfig::IsGeneratorEnabled<ClassType>();
     if (!can_enroll) {
@@ -108,6 +125,22 @@ class CodegenManager {
     return generator;
   }
 
+  /**
+   * @return false if the plan node is expected to process too few rows to
+   *         make up for the cost of generating and compiling code.
+   **/
+  bool ShouldGenerateCode() const {
+    return should_generate_code_;
+  }
+
+  /**
+   * @return The optimization level to compile the module with, as one of the
+   *         CODEGEN_OPTIMIZATION_LEVEL_* values.
+   **/
+  int optimization_level() const {
+    return optimization_level_;
+  }
+
   /**
    * @brief Enroll a code generator with manager
    *
@@ -132,11 +165,27 @@ class CodegenManager {
    * @brief Compile all the generated functions. On success,
    *        a pointer to the generated method becomes available to the caller.
    *
+   * If codegen_async_compile is set, the module is instead compiled on a
+   * background thread, and callers keep using the regular functions until
+   * PollGeneratedFunctions() finds the compilation finished.
+   *
    * @return The number of enrolled codegen that successully generated code
-   *         and 0 on failure
+   *         and 0 on failure, or when compiling in the background.
    **/
   unsigned int PrepareGeneratedFunctions();
 
+  /**
+   * @brief Switch callers to the generated functions if the background
+   *        compilation started by PrepareGeneratedFunctions() has finished.
+   *
+   * @note The function pointers are only ever swapped from the thread that
+   *       runs the query, at a point chosen by the caller where none of them
+   *       is being called.
+   *
+   * @return true while the compilation is still running.
+   **/
+  bool PollGeneratedFunctions();
+
   /**
    * @brief 	Notifies the manager of a parameter change.
    *
@@ -172,18 +221,94 @@ class CodegenManager {
    */
   const std::string& GetExplainString();
 
+  /**
+   * @return A number that is unique among the generators of this manager,
+   *         used to name their generated functions.
+   **/
+  unsigned GetNextUniqueId() {
+    return unique_counter_++;
+  }
+
+  /**
+   * @return Number of compiled objects that PrepareGeneratedFunctions() found
+   *         in the CodegenObjectCache.
+   **/
+  size_t GetCacheHitCount() const {
+    return cache_hit_count_;
+  }
+
+  /**
+   * @return Number of objects that PrepareGeneratedFunctions() had to compile
+   *         because they were not in the CodegenObjectCache.
+   **/
+  size_t GetCacheMissCount() const {
+    return cache_miss_count_;
+  }
+
  private:
-  // GpCodegenUtils provides a facade to LLVM subsystem.
-  std::unique_ptr<gpcodegen::GpCodegenUtils> codegen_utils_;
+  enum class CompilationStatus {
+    kRunning,
+    kSucceeded,
+    kFailed
+  };
+
+  /**
+   * @brief Compile the module of codegen_utils with the given settings.
+   *
+   * @note May run on a background thread, so it must not call into the
+   *       backend.
+   *
+   * @return true on successful compilation.
+   **/
+  static bool CompileModule(gpcodegen::GpCodegenUtils* codegen_utils,
+                            gpcodegen::CodegenObjectCache* object_cache,
+                            int optimization_level);
+
+  /**
+   * @brief Start compiling the module on a background thread.
+   *
+   * @return false if the thread could not be started.
+   **/
+  bool StartBackgroundCompilation();
+
+  /**
+   * @brief Swap in the compiled functions of all the enrolled generators, and
+   *        record the cache statistics of the compilation.
+   *
+   * @return The number of generators switched to the generated function.
+   **/
+  unsigned int SetToGeneratedFunctions();
+
+  // GpCodegenUtils provides a facade to LLVM subsystem. Shared with the
+  // background compilation, which may outlive the manager.
+  std::shared_ptr<gpcodegen::GpCodegenUtils> codegen_utils_;
+
+  // Cache of compiled modules used to compile codegen_utils_, if enabled
+  std::shared_ptr<gpcodegen::CodegenObjectCache> object_cache_;
+
+  // Status of the background compilation, set by the compilation thread
+  std::shared_ptr<std::atomic<CompilationStatus>> compilation_status_;
+  std::thread compilation_thread_;
 
   std::string module_name_;
 
+  // Decided from the estimated rows of the plan node
+  bool should_generate_code_;
+  int optimization_level_;
+
   // List of all enrolled code generators.
   std::vector<std::unique_ptr<CodegenInterface>> enrolled_code_generators_;
 
   // Holds the dumped IR of all underlying modules for EXPLAIN CODEGEN queries
   std::string explain_string_;
 
+  // Used to give deterministic names to generated functions
+  unsigned unique_counter_;
+
+  // Lookups in the CodegenObjectCache during PrepareGeneratedFunctions()
+  size_t cache_hit_count_;
+  size_t cache_miss_count_;
+
   DISALLOW_COPY_AND_ASSIGN(CodegenManager);
 };
 
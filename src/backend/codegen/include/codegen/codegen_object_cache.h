@@ -0,0 +1,180 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    codegen_object_cache.h
+//
+//  @doc:
+//    Cache of compiled objects of generated modules
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_CODEGEN_OBJECT_CACHE_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_CODEGEN_OBJECT_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "codegen/utils/macros.h"
+
+namespace llvm {
+class Module;
+}  // namespace llvm
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Cache of the machine code compiled for generated modules.
+ *
+ * Modules are keyed by a fingerprint of their IR, the optimization level and
+ * the host CPU. Generated code refers to plan state and to external functions
+ * only through named symbols (see CodegenUtils::GetConstant() and
+ * CodegenUtils::GetOrRegisterExternalFunction()), which the ExecutionEngine
+ * binds to the current addresses when it loads an object. A compiled object
+ * can therefore be reused by any later module with the same IR, skipping
+ * LLVM's code generation entirely.
+ *
+ * Objects are kept in memory for the whole backend, up to
+ * codegen_object_cache_size entries in LRU order, and optionally written to
+ * codegen_object_cache_directory so that they are shared across backends.
+ *
+ * Each CodegenManager uses its own CodegenObjectCache, which counts the hits
+ * and misses of that manager only. The objects themselves are shared by all
+ * instances, and guarded by a mutex since modules may be compiled on
+ * background threads. For the same reason no method but the constructor may
+ * call into the backend (elog, palloc, GUCs).
+ **/
+class CodegenObjectCache : public llvm::ObjectCache {
+ public:
+  /**
+   * @brief Constructor. Takes a snapshot of the cache settings, and must be
+   *        called from the backend's main thread.
+   **/
+  CodegenObjectCache();
+
+  ~CodegenObjectCache() override = default;
+
+  /**
+   * @return true if either the in-memory or the on-disk cache is enabled.
+   **/
+  static bool IsEnabled();
+
+  /**
+   * @brief Compute the fingerprint of the given module and record it as the
+   *        module's identifier, so that the cache recognizes the module when
+   *        the ExecutionEngine compiles it.
+   *
+   * @note Must be called after the module is fully generated, and before it
+   *       is handed over to the ExecutionEngine.
+   *
+   * @param module    Module to fingerprint.
+   * @param opt_level Optimization level the module will be compiled with.
+   **/
+  static void SetModuleKey(llvm::Module* module, int opt_level);
+
+  /**
+   * @brief Called by the ExecutionEngine after compiling a module.
+   **/
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+
+  /**
+   * @brief Called by the ExecutionEngine before compiling a module.
+   *
+   * @return A copy of the cached object for the module, or nullptr to make
+   *         the ExecutionEngine compile it.
+   **/
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+  /**
+   * @return Number of lookups that found a compiled object.
+   **/
+  std::size_t hit_count() const {
+    return hit_count_;
+  }
+
+  /**
+   * @return Number of lookups that had to compile the module.
+   **/
+  std::size_t miss_count() const {
+    return miss_count_;
+  }
+
+ private:
+  // Compiled objects shared by all the instances
+  struct SharedObjects {
+    std::mutex mutex;
+    // Keys in LRU order, most recently used first
+    std::list<std::string> lru_keys;
+    // key -> (object, position in lru_keys)
+    std::unordered_map<std::string,
+                       std::pair<std::unique_ptr<llvm::MemoryBuffer>,
+                                 std::list<std::string>::iterator>> objects;
+  };
+
+  /**
+   * @return The objects shared by all instances. They are never destroyed,
+   *         so that a compilation still running at backend exit cannot
+   *         observe them being torn down.
+   **/
+  static SharedObjects* GetSharedObjects();
+
+  /**
+   * @return The key of the module, or an empty string if the module was not
+   *         given a key with SetModuleKey().
+   **/
+  static std::string GetModuleKey(const llvm::Module* module);
+
+  /**
+   * @return Path of the object file for the given key in the on-disk cache,
+   *         or an empty string if the on-disk cache is disabled.
+   **/
+  std::string GetObjectFilePath(const std::string& key) const;
+
+  /**
+   * @brief Add an object to the in-memory cache, evicting the least
+   *        recently used ones beyond max_entries_.
+   *
+   * @note The caller must hold the mutex of shared.
+   **/
+  void InsertInMemory(SharedObjects* shared,
+                      const std::string& key,
+                      std::unique_ptr<llvm::MemoryBuffer> object) const;
+
+  /**
+   * @brief Write an object to the on-disk cache. Other backends may look up
+   *        the same file concurrently, so the object is written to a
+   *        temporary file first, which is then renamed into place.
+   **/
+  void WriteToDisk(const std::string& key, llvm::StringRef object) const;
+
+  // Settings at the time the instance was created
+  const std::size_t max_entries_;
+  const std::string directory_;
+
+  std::size_t hit_count_;
+  std::size_t miss_count_;
+
+  static constexpr char kModuleKeyPrefix[] = "gpcodegen_object_";
+
+  DISALLOW_COPY_AND_ASSIGN(CodegenObjectCache);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+
+#endif  // GPCODEGEN_CODEGEN_OBJECT_CACHE_H_
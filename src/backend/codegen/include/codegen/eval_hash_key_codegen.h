@@ -0,0 +1,134 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    eval_hash_key_codegen.h
+//
+//  @doc:
+//    Headers for evalHashKey codegen.
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPCODEGEN_EVAL_HASH_KEY_CODEGEN_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_EVAL_HASH_KEY_CODEGEN_H_
+
+#include <memory>
+#include <vector>
+
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/expr_tree_generator.h"
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+class EvalHashKeyCodegen: public BaseCodegen<EvalHashKeyFn> {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * @param regular_func_ptr        Regular version of the target function.
+   * @param ptr_to_chosen_func_ptr  Reference to the function pointer that the
+   *                                caller will call.
+   * @param hashkeys                List of ExprStates of the hash keys.
+   * @param hashtypes               List of type Oids of the hash keys.
+   * @param econtext                The ExprContext to use for generating code.
+   * @param plan_state              The Motion node that owns the hash keys.
+   *
+   * @note 	The ptr_to_chosen_func_ptr can refer to either the generated
+   *        function or the corresponding regular version.
+   *
+   **/
+  explicit EvalHashKeyCodegen(CodegenManager* manager,
+                              EvalHashKeyFn regular_func_ptr,
+                              EvalHashKeyFn* ptr_to_regular_func_ptr,
+                              List* hashkeys,
+                              List* hashtypes,
+                              ExprContext* econtext,
+                              PlanState* plan_state);
+
+  virtual ~EvalHashKeyCodegen() = default;
+
+  bool InitDependencies() override;
+
+ protected:
+  /**
+   * @brief Generate code for hash key evaluation.
+   *
+   * @param codegen_utils
+   *
+   * @return true on successful generation; false otherwise.
+   *
+   * @note Evaluates every hash key with the expression tree generators and
+   * hashes it according to the key's type, which is known at generation time.
+   * For fixed-width types the FNV-1 loop of fnv1_32_buf() is fully unrolled
+   * over the bytes of the value; other types call cdbhash().
+   *
+   */
+  bool GenerateCodeInternal(gpcodegen::GpCodegenUtils* codegen_utils) final;
+
+ private:
+  List* hashkeys_;
+  List* hashtypes_;
+  PlanState* plan_state_;
+
+  ExprTreeGeneratorInfo gen_info_;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> expr_tree_generators_;
+
+  static constexpr char kEvalHashKeyPrefix[] = "evalHashKey";
+
+  /**
+   * @brief Generates the whole evalHashKey function.
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @return true on successful generation.
+   **/
+  bool GenerateEvalHashKey(gpcodegen::GpCodegenUtils* codegen_utils);
+
+  /**
+   * @brief Generates the hashing of one non-NULL key value.
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @param llvm_hash     Hash value so far.
+   * @param llvm_datum    The key value as a Datum.
+   * @param type_oid      The type of the key.
+   * @param llvm_cdbhash  Pointer to the CdbHash, for calls to cdbhash().
+   *
+   * @return The new hash value.
+   **/
+  llvm::Value* GenerateHashDatum(gpcodegen::GpCodegenUtils* codegen_utils,
+                                 llvm::Value* llvm_hash,
+                                 llvm::Value* llvm_datum,
+                                 Oid type_oid,
+                                 llvm::Value* llvm_cdbhash);
+
+  /**
+   * @brief Generates the FNV-1 hashing of the bytes of an integer value,
+   *        in the order in which they are laid out in memory.
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @param llvm_hash     Hash value so far.
+   * @param llvm_value    Integer value whose bytes are hashed.
+   * @param num_bytes     Number of bytes of llvm_value to hash.
+   *
+   * @return The new hash value.
+   **/
+  static llvm::Value* GenerateFNV1Bytes(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      llvm::Value* llvm_hash,
+      llvm::Value* llvm_value,
+      int num_bytes);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_EVAL_HASH_KEY_CODEGEN_H_
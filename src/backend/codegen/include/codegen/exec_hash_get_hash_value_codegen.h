@@ -0,0 +1,133 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    exec_hash_get_hash_value_codegen.h
+//
+//  @doc:
+//    Headers for ExecHashGetHashValue codegen.
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPCODEGEN_EXEC_HASH_GET_HASH_VALUE_CODEGEN_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_EXEC_HASH_GET_HASH_VALUE_CODEGEN_H_
+
+#include <memory>
+#include <vector>
+
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/expr_tree_generator.h"
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+class ExecHashGetHashValueCodegen: public BaseCodegen<ExecHashGetHashValueFn> {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * @param regular_func_ptr        Regular version of the target function.
+   * @param ptr_to_chosen_func_ptr  Reference to the function pointer that the
+   *                                caller will call.
+   * @param hashkeys                List of ExprStates of the hash keys.
+   * @param hashoperators           List of Oids of the hash join operators.
+   * @param outer_tuple             true if the keys are the ones of the outer
+   *                                side of the join; false for the inner side.
+   * @param econtext                The ExprContext to use for generating code.
+   *
+   * @note 	The ptr_to_chosen_func_ptr can refer to either the generated
+   *        function or the corresponding regular version.
+   *
+   **/
+  explicit ExecHashGetHashValueCodegen(
+      CodegenManager* manager,
+      ExecHashGetHashValueFn regular_func_ptr,
+      ExecHashGetHashValueFn* ptr_to_regular_func_ptr,
+      List* hashkeys,
+      List* hashoperators,
+      bool outer_tuple,
+      ExprContext* econtext);
+
+  virtual ~ExecHashGetHashValueCodegen() = default;
+
+  bool InitDependencies() override;
+
+ protected:
+  /**
+   * @brief Generate code for computing the hash value of a tuple.
+   *
+   * @param codegen_utils
+   *
+   * @return true on successful generation; false otherwise.
+   *
+   * @note Evaluates every hash key with the expression tree generators and
+   * hashes it with an inlined copy of the key type's hash function, which is
+   * known at generation time. Only the hash functions of integer-like types,
+   * which all reduce to hash_uint32(), are supported.
+   *
+   */
+  bool GenerateCodeInternal(gpcodegen::GpCodegenUtils* codegen_utils) final;
+
+ private:
+  List* hashkeys_;
+  List* hashoperators_;
+  bool outer_tuple_;
+
+  // Per key: the hash function and the strictness of the join operator, as
+  // looked up by ExecHashTableCreate()
+  std::vector<Oid> hash_funcs_;
+  std::vector<bool> hash_strict_;
+
+  ExprTreeGeneratorInfo gen_info_;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> expr_tree_generators_;
+
+  static constexpr char kExecHashGetHashValuePrefix[] = "ExecHashGetHashValue";
+
+  /**
+   * @brief Generates the whole ExecHashGetHashValue function.
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @return true on successful generation.
+   **/
+  bool GenerateExecHashGetHashValue(gpcodegen::GpCodegenUtils* codegen_utils);
+
+  /**
+   * @brief Generates the hashing of one non-NULL key value.
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @param llvm_datum    The key value as a Datum.
+   * @param hash_func     The Oid of the hash function of the key.
+   *
+   * @return The hash value of the key.
+   **/
+  static llvm::Value* GenerateHashDatum(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      llvm::Value* llvm_datum,
+      Oid hash_func);
+
+  /**
+   * @brief Generates the equivalent of hash_uint32().
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @param llvm_key      uint32 value to hash.
+   *
+   * @return The hash value.
+   **/
+  static llvm::Value* GenerateHashUInt32(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      llvm::Value* llvm_key);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_EXEC_HASH_GET_HASH_VALUE_CODEGEN_H_
@@ -0,0 +1,97 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    exec_scan_hash_bucket_codegen.h
+//
+//  @doc:
+//    Headers for ExecScanHashBucket codegen.
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPCODEGEN_EXEC_SCAN_HASH_BUCKET_CODEGEN_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_EXEC_SCAN_HASH_BUCKET_CODEGEN_H_
+
+#include <memory>
+#include <vector>
+
+#include "codegen/base_codegen.h"
+#include "codegen/codegen_wrapper.h"
+#include "codegen/expr_tree_generator.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+class ExecScanHashBucketCodegen: public BaseCodegen<ExecScanHashBucketFn> {
+ public:
+  /**
+   * @brief Constructor
+   *
+   * @param regular_func_ptr        Regular version of the target function.
+   * @param ptr_to_chosen_func_ptr  Reference to the function pointer that the
+   *                                caller will call.
+   * @param hjstate                 The HashJoin node whose buckets are scanned.
+   *
+   * @note 	The ptr_to_chosen_func_ptr can refer to either the generated
+   *        function or the corresponding regular version.
+   *
+   **/
+  explicit ExecScanHashBucketCodegen(
+      CodegenManager* manager,
+      ExecScanHashBucketFn regular_func_ptr,
+      ExecScanHashBucketFn* ptr_to_regular_func_ptr,
+      HashJoinState* hjstate);
+
+  virtual ~ExecScanHashBucketCodegen() = default;
+
+  bool InitDependencies() override;
+
+ protected:
+  /**
+   * @brief Generate code for scanning a hash bucket for matches to the
+   *        current outer tuple.
+   *
+   * @param codegen_utils
+   *
+   * @return true on successful generation; false otherwise.
+   *
+   * @note The outer key values are evaluated once per call with the
+   * expression tree generators. The bloom filter check, the walk of the
+   * bucket chain and the comparison of the keys with the attributes of each
+   * candidate tuple are then done in one loop, without storing the candidate
+   * in a slot and calling ExecQual(). Only equality of integer-like types
+   * between an outer expression and an inner column is supported.
+   *
+   */
+  bool GenerateCodeInternal(gpcodegen::GpCodegenUtils* codegen_utils) final;
+
+ private:
+  HashJoinState* hjstate_;
+
+  // Per hash clause: the equality function and the attribute number of the
+  // inner column
+  std::vector<Oid> eq_funcs_;
+  std::vector<int> inner_attnums_;
+
+  ExprTreeGeneratorInfo gen_info_;
+  std::vector<std::unique_ptr<ExprTreeGenerator>> outer_expr_tree_generators_;
+
+  static constexpr char kExecScanHashBucketPrefix[] = "ExecScanHashBucket";
+
+  /**
+   * @brief Generates the whole ExecScanHashBucket function.
+   *
+   * @param codegen_utils Utility to ease the code generation process.
+   * @return true on successful generation.
+   **/
+  bool GenerateExecScanHashBucket(gpcodegen::GpCodegenUtils* codegen_utils);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_EXEC_SCAN_HASH_BUCKET_CODEGEN_H_
@@ -39,7 +39,12 @@ namespace gpcodegen {
 enum class ExprTreeNodeType {
   kConst = 0,
   kVar = 1,
-  kOperator = 2
+  kOperator = 2,
+  kBool = 3,
+  kCase = 4,
+  kCaseTest = 5,
+  kNullTest = 6,
+  kScalarArrayOp = 7
 };
 
 /**
@@ -139,6 +144,25 @@ class ExprTreeGenerator {
                     ExprTreeNodeType node_type) :
                       expr_state_(expr_state) {}
 
+  /**
+   * @brief Generate the code for an argument of the expression, with a NULL
+   *        flag of its own.
+   *
+   * @param codegen_utils   Utility to easy code generation.
+   * @param gen_info        Information needed for generating the expression
+   *                        tree.
+   * @param argument        ExprTreeGenerator of the argument.
+   * @param llvm_out_value  Store the argument's value as a Datum.
+   * @param llvm_out_isnull Store the argument's NULL flag as a bool.
+   *
+   * @return true when it generated successfully otherwise it return false.
+   **/
+  static bool GenerateArgumentCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                                   const ExprTreeGeneratorInfo& gen_info,
+                                   ExprTreeGenerator* argument,
+                                   llvm::Value** llvm_out_value,
+                                   llvm::Value** llvm_out_isnull);
+
  private:
   const ExprState* expr_state_;
   DISALLOW_COPY_AND_ASSIGN(ExprTreeGenerator);
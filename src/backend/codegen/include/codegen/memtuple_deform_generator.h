@@ -0,0 +1,102 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    memtuple_deform_generator.h
+//
+//  @doc:
+//    Generates code to deform MemTuples of append-optimized tables
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPCODEGEN_MEMTUPLE_DEFORM_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_MEMTUPLE_DEFORM_GENERATOR_H_
+
+#include <string>
+#include <vector>
+
+#include "codegen/utils/gp_codegen_utils.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "access/memtup.h"
+}
+
+namespace llvm {
+class Function;
+class Value;
+}  // namespace llvm
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Signature of the generated function: deforms the first max_attr
+ *        attributes of mtup into values and isnull.
+ **/
+typedef void (*MemTupleDeformFn) (MemTuple mtup, Datum* values, bool* isnull);
+
+/**
+ * @brief Class with static member functions to generate a specialized
+ *        memtuple_deform() for a given MemTupleBinding.
+ *
+ * The offset and length of each attribute are taken from the binding and
+ * become constants in the generated code. When the tuple has no NULLs every
+ * attribute is read from a fixed offset. Otherwise the space saved by NULL
+ * attributes is accumulated in physical order, instead of summing up the
+ * null_saves_aligned table for every attribute as memtuple_getattr() does.
+ **/
+class MemTupleDeformGenerator {
+ public:
+  /**
+   * @brief Generate a MemTupleDeformFn for the given binding.
+   *
+   * @param codegen_utils Utility for easy code generation.
+   * @param func_name     Name of the function to create.
+   * @param pbind         Binding of the tuples that will be deformed.
+   * @param max_attr      Deform attributes up to this one.
+   *
+   * @return The generated function on success, nullptr otherwise. On failure
+   *         the partially generated function is removed from the module.
+   **/
+  static llvm::Function* GenerateMemTupleDeform(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      const std::string& func_name,
+      MemTupleBinding* pbind,
+      int max_attr);
+
+ private:
+  /**
+   * @brief Generate the deforming of all the attributes using one of the
+   *        column bindings (small or large tuples) of pbind.
+   *
+   * @param codegen_utils Utility for easy code generation.
+   * @param pbind         Binding of the tuples that will be deformed.
+   * @param colbind       Column binding (pbind->bind or pbind->large_bind).
+   * @param max_attr      Deform attributes up to this one.
+   * @param has_nulls     Whether to generate the path for tuples with NULLs.
+   * @param llvm_mtup     The tuple being deformed.
+   * @param llvm_values   Output array of Datums.
+   * @param llvm_isnull   Output array of isnull flags.
+   *
+   * @return true on successful generation.
+   **/
+  static bool GenerateColumnsDeform(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      MemTupleBinding* pbind,
+      MemTupleBindingCols* colbind,
+      int max_attr,
+      bool has_nulls,
+      llvm::Value* llvm_mtup,
+      llvm::Value* llvm_values,
+      llvm::Value* llvm_isnull);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_MEMTUPLE_DEFORM_GENERATOR_H_
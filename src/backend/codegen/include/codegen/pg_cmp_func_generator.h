@@ -0,0 +1,240 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    pg_cmp_func_generator.h
+//
+//  @doc:
+//    Class with Static member functions to generate code for =, <>, <, <=, >
+//    and >= operators
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_PG_CMP_FUNC_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_PG_CMP_FUNC_GENERATOR_H_
+
+#include <type_traits>
+
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/pg_func_generator_interface.h"
+
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Value.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+namespace gpcodegen_CmpOp_detail {
+
+// CmpOpMaker has various template specializations to handle comparisons of
+// different C++ types. The specialized versions have a static method per
+// comparison operator that takes two 'llvm::Value's of CmpType and returns
+// an i1 'llvm::Value' holding the result.
+template <typename CmpType, typename Enable = void>
+class CmpOpMaker {};
+
+// Partial specialization for integral types. bool is compared unsigned, so
+// that false < true like in boollt().
+template <typename IntType>
+class CmpOpMaker<
+IntType,
+typename std::enable_if<std::is_integral<IntType>::value>::type> {
+ public:
+  static llvm::Value* EQ(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return irb->CreateICmpEQ(lhs, rhs);
+  }
+
+  static llvm::Value* NE(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return irb->CreateICmpNE(lhs, rhs);
+  }
+
+  static llvm::Value* LT(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return std::is_signed<IntType>::value ?
+        irb->CreateICmpSLT(lhs, rhs) : irb->CreateICmpULT(lhs, rhs);
+  }
+
+  static llvm::Value* LE(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return std::is_signed<IntType>::value ?
+        irb->CreateICmpSLE(lhs, rhs) : irb->CreateICmpULE(lhs, rhs);
+  }
+
+  static llvm::Value* GT(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return std::is_signed<IntType>::value ?
+        irb->CreateICmpSGT(lhs, rhs) : irb->CreateICmpUGT(lhs, rhs);
+  }
+
+  static llvm::Value* GE(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return std::is_signed<IntType>::value ?
+        irb->CreateICmpSGE(lhs, rhs) : irb->CreateICmpUGE(lhs, rhs);
+  }
+};
+
+// Partial specialization for floating point types. It follows the semantics
+// of float4_cmp_internal() / float8_cmp_internal(): all NaNs are equal to
+// each other and larger than any non-NaN value.
+template <typename FloatType>
+class CmpOpMaker<
+FloatType,
+typename std::enable_if<std::is_floating_point<FloatType>::value>::type> {
+ public:
+  static llvm::Value* EQ(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    // (lhs == rhs) || (isnan(lhs) && isnan(rhs))
+    return irb->CreateOr(
+        irb->CreateFCmpOEQ(lhs, rhs),
+        irb->CreateAnd(irb->CreateFCmpUNO(lhs, lhs),
+                       irb->CreateFCmpUNO(rhs, rhs)));
+  }
+
+  static llvm::Value* NE(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return irb->CreateNot(EQ(irb, lhs, rhs));
+  }
+
+  static llvm::Value* GT(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    // (lhs > rhs) || (isnan(lhs) && !isnan(rhs))
+    return irb->CreateOr(
+        irb->CreateFCmpOGT(lhs, rhs),
+        irb->CreateAnd(irb->CreateFCmpUNO(lhs, lhs),
+                       irb->CreateFCmpORD(rhs, rhs)));
+  }
+
+  static llvm::Value* GE(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    // (lhs >= rhs) || isnan(lhs)
+    return irb->CreateOr(
+        irb->CreateFCmpOGE(lhs, rhs),
+        irb->CreateFCmpUNO(lhs, lhs));
+  }
+
+  static llvm::Value* LT(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return irb->CreateNot(GE(irb, lhs, rhs));
+  }
+
+  static llvm::Value* LE(llvm::IRBuilder<>* irb,
+                         llvm::Value* lhs, llvm::Value* rhs) {
+    return irb->CreateNot(GT(irb, lhs, rhs));
+  }
+};
+}  // namespace gpcodegen_CmpOp_detail
+
+using gpcodegen_CmpOp_detail::CmpOpMaker;
+
+/**
+ * @brief Class with Static member functions to generate code for comparison
+ *        operators, including the cross-type ones (e.g. int48lt, float84eq).
+ *
+ * @tparam CmpType  Type both arguments are promoted to before comparing
+ * @tparam Arg0     First argument's type
+ * @tparam Arg1     Second argument's type
+ **/
+template <typename CmpType, typename Arg0, typename Arg1>
+class PGCmpFuncGenerator {
+  using CGCmpOpFunc = llvm::Value* (*)(llvm::IRBuilder<>* irb,
+                                       llvm::Value* lhs, llvm::Value* rhs);
+
+ public:
+  /**
+   * @brief Create instructions for arg0 = arg1
+   *
+   * @param codegen_utils     Utility for easy code generation.
+   * @param pg_func_info      Details for pgfunc generation
+   * @param llvm_out_value    Store location for the result
+   *
+   * @return true if generation was successful otherwise return false
+   **/
+  static bool EQ(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return CmpOp(codegen_utils, &CmpOpMaker<CmpType>::EQ,
+                 pg_func_info, llvm_out_value);
+  }
+
+  /**
+   * @brief Create instructions for arg0 <> arg1
+   **/
+  static bool NE(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return CmpOp(codegen_utils, &CmpOpMaker<CmpType>::NE,
+                 pg_func_info, llvm_out_value);
+  }
+
+  /**
+   * @brief Create instructions for arg0 < arg1
+   **/
+  static bool LT(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return CmpOp(codegen_utils, &CmpOpMaker<CmpType>::LT,
+                 pg_func_info, llvm_out_value);
+  }
+
+  /**
+   * @brief Create instructions for arg0 <= arg1
+   **/
+  static bool LE(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return CmpOp(codegen_utils, &CmpOpMaker<CmpType>::LE,
+                 pg_func_info, llvm_out_value);
+  }
+
+  /**
+   * @brief Create instructions for arg0 > arg1
+   **/
+  static bool GT(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return CmpOp(codegen_utils, &CmpOpMaker<CmpType>::GT,
+                 pg_func_info, llvm_out_value);
+  }
+
+  /**
+   * @brief Create instructions for arg0 >= arg1
+   **/
+  static bool GE(gpcodegen::GpCodegenUtils* codegen_utils,
+                 const PGFuncGeneratorInfo& pg_func_info,
+                 llvm::Value** llvm_out_value) {
+    return CmpOp(codegen_utils, &CmpOpMaker<CmpType>::GE,
+                 pg_func_info, llvm_out_value);
+  }
+
+ private:
+  static bool CmpOp(gpcodegen::GpCodegenUtils* codegen_utils,
+                    CGCmpOpFunc cmp_op_func,
+                    const PGFuncGeneratorInfo& pg_func_info,
+                    llvm::Value** llvm_out_value) {
+    assert(nullptr != codegen_utils);
+    assert(nullptr != llvm_out_value);
+    assert(pg_func_info.llvm_args.size() == 2);
+
+    // Promote both arguments to the common type, e.g. int24lt compares
+    // (int32) arg0 < arg1 and float48lt compares (float8) arg0 < arg1.
+    llvm::Value* casted_arg0 =
+        codegen_utils->CreateCast<CmpType, Arg0>(pg_func_info.llvm_args[0]);
+    llvm::Value* casted_arg1 =
+        codegen_utils->CreateCast<CmpType, Arg1>(pg_func_info.llvm_args[1]);
+
+    *llvm_out_value = cmp_op_func(codegen_utils->ir_builder(),
+                                  casted_arg0,
+                                  casted_arg1);
+    return true;
+  }
+};
+
+/** @} */
+}  // namespace gpcodegen
+
+#endif  // GPCODEGEN_PG_CMP_FUNC_GENERATOR_H_
@@ -60,7 +60,68 @@ class PGDateFuncGenerator {
       const PGFuncGeneratorInfo& pg_func_info,
       llvm::Value** llvm_out_value);
 
+  /**
+   * @brief Create instructions for date_eq_timestamp function
+   **/
+  static bool DateEQTimestamp(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      const PGFuncGeneratorInfo& pg_func_info,
+      llvm::Value** llvm_out_value);
+
+  /**
+   * @brief Create instructions for date_ne_timestamp function
+   **/
+  static bool DateNETimestamp(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      const PGFuncGeneratorInfo& pg_func_info,
+      llvm::Value** llvm_out_value);
+
+  /**
+   * @brief Create instructions for date_lt_timestamp function
+   **/
+  static bool DateLTTimestamp(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      const PGFuncGeneratorInfo& pg_func_info,
+      llvm::Value** llvm_out_value);
+
+  /**
+   * @brief Create instructions for date_gt_timestamp function
+   **/
+  static bool DateGTTimestamp(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      const PGFuncGeneratorInfo& pg_func_info,
+      llvm::Value** llvm_out_value);
+
+  /**
+   * @brief Create instructions for date_ge_timestamp function
+   **/
+  static bool DateGETimestamp(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      const PGFuncGeneratorInfo& pg_func_info,
+      llvm::Value** llvm_out_value);
+
  private:
+  // Type of the CmpOpMaker member that compares two timestamps
+  using CGCmpOpFunc = llvm::Value* (*)(llvm::IRBuilder<>* irb,
+                                       llvm::Value* lhs, llvm::Value* rhs);
+
+  /**
+   * @brief Promote the date argument to timestamp and compare it with the
+   *        timestamp argument using the given comparison.
+   *
+   * @param codegen_utils     Utility to easy code generation.
+   * @param pg_func_info      Details for pgfunc generation
+   * @param cmp_op_func       Comparison to apply on the two timestamps
+   * @param llvm_out_value    Store the results of function
+   *
+   * @return true if generation was successful otherwise return false
+   **/
+  static bool DateCmpTimestamp(
+      gpcodegen::GpCodegenUtils* codegen_utils,
+      const PGFuncGeneratorInfo& pg_func_info,
+      CGCmpOpFunc cmp_op_func,
+      llvm::Value** llvm_out_value);
+
   /**
    * @brief Internal routines for promoting date to timestamp and timestamp
    *        with time zone (see date2timestamp).
@@ -538,7 +538,7 @@ class PGGenericFuncGenerator : public  PGFuncGeneratorInterface {
 
  private:
   int pg_func_oid_;
-  const std::string& pg_func_name_;
+  std::string pg_func_name_;
   PGFuncGeneratorFn func_ptr_;
   PGCheckNullFuncGeneratorFn check_null_func_ptr_;
   bool is_strict_;
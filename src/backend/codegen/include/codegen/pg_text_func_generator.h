@@ -0,0 +1,78 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    pg_text_func_generator.h
+//
+//  @doc:
+//    Class with Static member functions to generate code for text and bpchar
+//    equality operators
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_PG_TEXT_FUNC_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_PG_TEXT_FUNC_GENERATOR_H_
+
+#include "codegen/pg_func_generator_interface.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/Value.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+class GpCodegenUtils;
+struct PGFuncGeneratorInfo;
+
+/**
+ * @brief Class with Static member functions to generate code for text and
+ *        bpchar equality operators.
+ *
+ * The generated code calls texteq_regular() / bpchareq_regular(), which
+ * compare in-line, uncompressed values with memcmp and only go through the
+ * fmgr version of the operator when the values need to be detoasted.
+ **/
+class PGTextFuncGenerator {
+ public:
+  /**
+   * @brief Create instructions for texteq function
+   *
+   * @param codegen_utils     Utility for easy code generation.
+   * @param pg_func_info      Details for pgfunc generation
+   * @param llvm_out_value    Store location for the result
+   *
+   * @return true if generation was successful otherwise return false
+   **/
+  static bool TextEQ(gpcodegen::GpCodegenUtils* codegen_utils,
+                     const PGFuncGeneratorInfo& pg_func_info,
+                     llvm::Value** llvm_out_value);
+
+  /**
+   * @brief Create instructions for textne function
+   **/
+  static bool TextNE(gpcodegen::GpCodegenUtils* codegen_utils,
+                     const PGFuncGeneratorInfo& pg_func_info,
+                     llvm::Value** llvm_out_value);
+
+  /**
+   * @brief Create instructions for bpchareq function
+   **/
+  static bool BpcharEQ(gpcodegen::GpCodegenUtils* codegen_utils,
+                       const PGFuncGeneratorInfo& pg_func_info,
+                       llvm::Value** llvm_out_value);
+
+  /**
+   * @brief Create instructions for bpcharne function
+   **/
+  static bool BpcharNE(gpcodegen::GpCodegenUtils* codegen_utils,
+                       const PGFuncGeneratorInfo& pg_func_info,
+                       llvm::Value** llvm_out_value);
+};
+
+/** @} */
+}  // namespace gpcodegen
+
+#endif  // GPCODEGEN_PG_TEXT_FUNC_GENERATOR_H_
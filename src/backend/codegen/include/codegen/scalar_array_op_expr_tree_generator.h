@@ -0,0 +1,108 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    scalar_array_op_expr_tree_generator.h
+//
+//  @doc:
+//    Object that generate code for "scalar op ANY/ALL (array)" expressions.
+//
+//---------------------------------------------------------------------------
+#ifndef GPCODEGEN_SCALAR_ARRAY_OP_EXPR_TREE_GENERATOR_H_  // NOLINT(build/header_guard)
+#define GPCODEGEN_SCALAR_ARRAY_OP_EXPR_TREE_GENERATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "codegen/expr_tree_generator.h"
+
+#include "llvm/IR/Value.h"
+
+namespace gpcodegen {
+
+/** \addtogroup gpcodegen
+ *  @{
+ */
+
+/**
+ * @brief Object that generate code for "scalar op ANY/ALL (array)"
+ *        expressions, e.g. IN-lists.
+ *
+ * @note Only arrays that are constants of a by-value element type are
+ * supported. The elements are embedded in the generated code.
+ **/
+class ScalarArrayOpExprTreeGenerator : public ExprTreeGenerator {
+ public:
+  static bool VerifyAndCreateExprTree(
+      const ExprState* expr_state,
+      ExprTreeGeneratorInfo* gen_info,
+      std::unique_ptr<ExprTreeGenerator>* expr_tree);
+
+  /**
+   * @note Equality tests of an integer-like scalar against ANY element (and
+   * inequality tests against ALL elements) are generated as a single switch
+   * instruction, which LLVM lowers to a jump table or a binary search
+   * over the sorted elements. Other operators are evaluated element by
+   * element, stopping at the first element that decides the result.
+   **/
+  bool GenerateCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                    const ExprTreeGeneratorInfo& gen_info,
+                    llvm::Value** llvm_out_value,
+                    llvm::Value* const llvm_isnull_ptr) final;
+
+ protected:
+  /**
+   * @brief Constructor.
+   *
+   * @param expr_state Expression state
+   * @param scalar     The scalar argument as ExprTreeGenerator
+   * @param elements   The non-null elements of the array
+   * @param has_null   True if the array contains a null element
+   **/
+  ScalarArrayOpExprTreeGenerator(
+      const ExprState* expr_state,
+      std::unique_ptr<ExprTreeGenerator> scalar,
+      std::vector<Datum>&& elements,  // NOLINT(build/c++11)
+      bool has_null);
+
+ private:
+  // Maximum number of elements for which the operator is evaluated element
+  // by element
+  static constexpr size_t kMaxUnrolledArrayElements = 64;
+
+  std::unique_ptr<ExprTreeGenerator> scalar_;
+  std::vector<Datum> elements_;
+  bool has_null_;
+
+  /**
+   * @brief Returns the width in bits of the operands if the operator can be
+   *        generated as a switch instruction; 0 otherwise.
+   **/
+  static unsigned GetSwitchWidth(Oid opfuncid, bool use_or);
+
+  /**
+   * @brief Generates a switch on the scalar that jumps to match_block when it
+   *        equals one of the elements.
+   **/
+  void GenerateSwitchCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                          llvm::Value* llvm_scalar,
+                          unsigned width,
+                          llvm::BasicBlock* match_block,
+                          llvm::BasicBlock* no_match_block);
+
+  /**
+   * @brief Generates one call of the operator per element. It jumps to
+   *        match_block at the first element that decides the result.
+   **/
+  bool GenerateUnrolledCode(gpcodegen::GpCodegenUtils* codegen_utils,
+                            const ExprTreeGeneratorInfo& gen_info,
+                            llvm::Value* llvm_scalar,
+                            llvm::BasicBlock* match_block,
+                            llvm::BasicBlock* no_match_block);
+};
+
+/** @} */
+
+}  // namespace gpcodegen
+#endif  // GPCODEGEN_SCALAR_ARRAY_OP_EXPR_TREE_GENERATOR_H_
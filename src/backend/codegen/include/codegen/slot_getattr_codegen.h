@@ -41,10 +41,11 @@ class SlotGetAttrCodegen : public BaseCodegen<SlotGetAttrFn> {
    * @brief Request code generation for the codepath slot_getattr >
    * _slot_getsomeattr > slot_deform_tuple for the given slot and max_attr
    *
-   * @param codegen_utils Utilities for easy code generation
-   * @param slot          Use the TupleDesc from this slot to generate
-   * @param max_attr      Generate slot deformation up to this many attributes
-   * @param out_func      Return the llvm::Function that will be generated
+   * @param codegen_utils   Utilities for easy code generation
+   * @param slot            Use the TupleDesc from this slot to generate
+   * @param max_attr        Generate slot deformation up to this many attributes
+   * @param holds_memtuples Whether the slot is filled with memtuples, i.e. it
+   *                        is the scan slot of an append-only row table scan
    *
    * @note This method does not actually do any code generation, but simply
    * caches the information necessary for code generation when
@@ -56,7 +57,8 @@ class SlotGetAttrCodegen : public BaseCodegen<SlotGetAttrFn> {
   static SlotGetAttrCodegen* GetCodegenInstance(
       gpcodegen::CodegenManager* manager,
       TupleTableSlot* slot,
-      int max_attr);
+      int max_attr,
+      bool holds_memtuples);
 
   virtual ~SlotGetAttrCodegen();
 
@@ -103,11 +105,13 @@ class SlotGetAttrCodegen : public BaseCodegen<SlotGetAttrFn> {
    */
   SlotGetAttrCodegen(gpcodegen::CodegenManager* manager,
                      TupleTableSlot* slot,
-                     int max_attr)
+                     int max_attr,
+                     bool holds_memtuples)
   : BaseCodegen(
       manager, kSlotGetAttrPrefix, slot_getattr_regular, &dummy_func_),
     slot_(slot),
     max_attr_(max_attr),
+    holds_memtuples_(holds_memtuples),
     llvm_function_(nullptr) {
   }
 
@@ -147,6 +151,8 @@ class SlotGetAttrCodegen : public BaseCodegen<SlotGetAttrFn> {
   TupleTableSlot* slot_;
   // Max attribute to deform to
   int max_attr_;
+  // Whether to generate the deformation of memtuples
+  bool holds_memtuples_;
   // Primary function to be generated and populated
   llvm::Function* llvm_function_;
   // A dummy function pointer that can be swapped by the BaseCodegen
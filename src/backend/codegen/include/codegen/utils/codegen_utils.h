@@ -464,11 +464,25 @@ class CodegenUtils {
    *        code at the expense of increased compilation time.
    * @param optimize_for_host_cpu If true, LLVM will optimize generated machine
    *        code for the specific CPU model we are running on.
+   * @param object_cache If not NULL, the ExecutionEngine looks up compiled
+   *        objects of the Module in this cache before compiling it, and
+   *        stores the objects it compiles in it.
    * @return true if an ExecutionEngine was set up successfully, false if some
    *         error occured.
    **/
   bool PrepareForExecution(const OptimizationLevel cpu_opt_level,
-                           const bool optimize_for_host_cpu);
+                           const bool optimize_for_host_cpu,
+                           llvm::ObjectCache* object_cache = nullptr);
+
+  /**
+   * @brief Compile all the code prepared for execution to machine code now,
+   *        instead of on the first call to GetUntypedFunctionPointer().
+   *
+   * @note PrepareForExecution() should be called before calling this method.
+   *       This is the only method, besides PrepareForExecution(), that may
+   *       be called from a thread other than the one that generated the code.
+   **/
+  void CompileForExecution();
 
   /**
    * @brief Get a pointer to the compiled machine-code version of a function
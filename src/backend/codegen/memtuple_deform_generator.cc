@@ -0,0 +1,322 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    memtuple_deform_generator.cc
+//
+//  @doc:
+//    Generates code to deform MemTuples of append-optimized tables
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <stddef.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "codegen/memtuple_deform_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+#include "codegen/utils/utility.h"
+
+#include "llvm/IR/Constant.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "access/memtup.h"
+#include "access/tupdesc.h"
+#include "catalog/pg_attribute.h"
+#include "utils/elog.h"
+}
+
+namespace llvm {
+class BasicBlock;
+}  // namespace llvm
+
+using gpcodegen::MemTupleDeformGenerator;
+
+llvm::Function* MemTupleDeformGenerator::GenerateMemTupleDeform(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const std::string& func_name,
+    MemTupleBinding* pbind,
+    int max_attr) {
+  assert(nullptr != codegen_utils);
+
+  if (nullptr == pbind ||
+      nullptr == pbind->tupdesc ||
+      max_attr <= 0 ||
+      max_attr > pbind->tupdesc->natts) {
+    return nullptr;
+  }
+
+  auto irb = codegen_utils->ir_builder();
+  llvm::Function* deform_func =
+      codegen_utils->CreateFunction<MemTupleDeformFn>(func_name);
+
+  llvm::Value* llvm_mtup = ArgumentByPosition(deform_func, 0);
+  llvm::Value* llvm_values = ArgumentByPosition(deform_func, 1);
+  llvm::Value* llvm_isnull = ArgumentByPosition(deform_func, 2);
+
+  llvm::BasicBlock* entry_block = codegen_utils->CreateBasicBlock(
+      "entry", deform_func);
+  llvm::BasicBlock* small_tuple_block = codegen_utils->CreateBasicBlock(
+      "small_tuple", deform_func);
+  llvm::BasicBlock* large_tuple_block = codegen_utils->CreateBasicBlock(
+      "large_tuple", deform_func);
+  llvm::BasicBlock* small_no_nulls_block = codegen_utils->CreateBasicBlock(
+      "small_tuple_no_nulls", deform_func);
+  llvm::BasicBlock* small_has_nulls_block = codegen_utils->CreateBasicBlock(
+      "small_tuple_has_nulls", deform_func);
+  llvm::BasicBlock* large_no_nulls_block = codegen_utils->CreateBasicBlock(
+      "large_tuple_no_nulls", deform_func);
+  llvm::BasicBlock* large_has_nulls_block = codegen_utils->CreateBasicBlock(
+      "large_tuple_has_nulls", deform_func);
+
+  // Entry block
+  // -----------
+  irb->SetInsertPoint(entry_block);
+  llvm::Value* llvm_mt_len = irb->CreateLoad(
+      codegen_utils->GetPointerToMember(
+          llvm_mtup, &MemTupleData::PRIVATE_mt_len));
+  // memtuple_get_hasnull(mtup, pbind)
+  llvm::Value* llvm_hasnull = irb->CreateICmpNE(
+      irb->CreateAnd(llvm_mt_len,
+                     codegen_utils->GetConstant<uint32>(MEMTUP_HASNULL)),
+      codegen_utils->GetConstant<uint32>(0));
+  // memtuple_get_islarge(mtup, pbind)
+  llvm::Value* llvm_islarge = irb->CreateICmpNE(
+      irb->CreateAnd(llvm_mt_len,
+                     codegen_utils->GetConstant<uint32>(MEMTUP_LARGETUP)),
+      codegen_utils->GetConstant<uint32>(0));
+  irb->CreateCondBr(llvm_islarge,
+                    large_tuple_block /* true */,
+                    small_tuple_block /* false */);
+
+  irb->SetInsertPoint(small_tuple_block);
+  irb->CreateCondBr(llvm_hasnull,
+                    small_has_nulls_block /* true */,
+                    small_no_nulls_block /* false */);
+
+  irb->SetInsertPoint(large_tuple_block);
+  irb->CreateCondBr(llvm_hasnull,
+                    large_has_nulls_block /* true */,
+                    large_no_nulls_block /* false */);
+
+  struct {
+    llvm::BasicBlock* block;
+    MemTupleBindingCols* colbind;
+    bool has_nulls;
+  } variants[] = {
+      {small_no_nulls_block, &pbind->bind, false},
+      {small_has_nulls_block, &pbind->bind, true},
+      {large_no_nulls_block, &pbind->large_bind, false},
+      {large_has_nulls_block, &pbind->large_bind, true},
+  };
+
+  for (const auto& variant : variants) {
+    irb->SetInsertPoint(variant.block);
+    if (!GenerateColumnsDeform(codegen_utils, pbind, variant.colbind,
+                               max_attr, variant.has_nulls,
+                               llvm_mtup, llvm_values, llvm_isnull)) {
+      deform_func->eraseFromParent();
+      return nullptr;
+    }
+    irb->CreateRetVoid();
+  }
+
+  return deform_func;
+}
+
+bool MemTupleDeformGenerator::GenerateColumnsDeform(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    MemTupleBinding* pbind,
+    MemTupleBindingCols* colbind,
+    int max_attr,
+    bool has_nulls,
+    llvm::Value* llvm_mtup,
+    llvm::Value* llvm_values,
+    llvm::Value* llvm_isnull) {
+  auto irb = codegen_utils->ir_builder();
+  TupleDesc tupdesc = pbind->tupdesc;
+  MemTupleAttrBinding* bindings = colbind->bindings;
+
+  // Attributes are laid out in the order of their alignment, not in logical
+  // order. Walk them in physical order so that the space saved by NULLs is
+  // accumulated once.
+  std::vector<int> physical_order(tupdesc->natts);
+  for (int i = 0; i < tupdesc->natts; ++i) {
+    physical_order[i] = i;
+  }
+  std::sort(physical_order.begin(), physical_order.end(),
+            [bindings](int a, int b) {
+              return bindings[a].offset < bindings[b].offset;
+            });
+
+  // char *start = (char *) mtup + (hasnull ? pbind->null_bitmap_extra_size : 0);
+  int start_offset = has_nulls ? pbind->null_bitmap_extra_size : 0;
+  // unsigned char *nullp = memtuple_get_nullp(mtup, pbind);
+  int nullp_offset = offsetof(MemTupleData, PRIVATE_mt_bits) +
+      (mtbind_has_oid(pbind) ? sizeof(Oid) : 0);
+
+  // Space saved by the NULL attributes that physically precede the current
+  // one, i.e. compute_null_save() using null_saves_aligned.
+  llvm::Value* llvm_null_save = codegen_utils->GetConstant<int32>(0);
+
+  // Index of the last physical column that is needed: either because it is
+  // deformed, or because it precedes a deformed column.
+  int last_needed = -1;
+  for (int p = 0; p < tupdesc->natts; ++p) {
+    if (physical_order[p] < max_attr) {
+      last_needed = p;
+    }
+  }
+
+  for (int p = 0; p <= last_needed; ++p) {
+    int attnum = physical_order[p];
+    MemTupleAttrBinding* attrbind = &bindings[attnum];
+    Form_pg_attribute attr = tupdesc->attrs[attnum];
+    bool deform_attr = attnum < max_attr;
+
+    llvm::Value* llvm_attr_isnull = codegen_utils->GetConstant<bool>(false);
+    if (has_nulls && !attr->attnotnull) {
+      // nullp[attrbind->null_byte] & attrbind->null_mask
+      llvm::Value* llvm_null_byte = irb->CreateLoad(irb->CreateInBoundsGEP(
+          llvm_mtup,
+          {codegen_utils->GetConstant<int32>(
+              nullp_offset + attrbind->null_byte)}));
+      llvm_attr_isnull = irb->CreateICmpNE(
+          irb->CreateAnd(llvm_null_byte,
+                         codegen_utils->GetConstant<uint8>(
+                             attrbind->null_mask)),
+          codegen_utils->GetConstant<uint8>(0),
+          "isnull_" + std::to_string(attnum));
+    }
+
+    if (deform_attr) {
+      llvm::BasicBlock* next_attribute_block = nullptr;
+      if (has_nulls && !attr->attnotnull) {
+        llvm::Function* deform_func = irb->GetInsertBlock()->getParent();
+        llvm::BasicBlock* is_null_block = codegen_utils->CreateBasicBlock(
+            "is_null_block_" + std::to_string(attnum), deform_func);
+        llvm::BasicBlock* is_not_null_block = codegen_utils->CreateBasicBlock(
+            "is_not_null_block_" + std::to_string(attnum), deform_func);
+        next_attribute_block = codegen_utils->CreateBasicBlock(
+            "attribute_block_" + std::to_string(attnum + 1), deform_func);
+        irb->CreateCondBr(llvm_attr_isnull,
+                          is_null_block /* true */,
+                          is_not_null_block /* false */);
+
+        // values[attnum] = (Datum) 0; isnull[attnum] = true;
+        irb->SetInsertPoint(is_null_block);
+        irb->CreateStore(codegen_utils->GetConstant<Datum>(0),
+                         irb->CreateInBoundsGEP(
+                             llvm_values,
+                             {codegen_utils->GetConstant(attnum)}));
+        irb->CreateStore(codegen_utils->GetConstant<bool>(true),
+                         irb->CreateInBoundsGEP(
+                             llvm_isnull,
+                             {codegen_utils->GetConstant(attnum)}));
+        irb->CreateBr(next_attribute_block);
+
+        irb->SetInsertPoint(is_not_null_block);
+      }
+
+      // Attribute pointer: start + attrbind->offset - null_save
+      llvm::Value* llvm_attr_ptr = irb->CreateInBoundsGEP(
+          llvm_mtup,
+          {irb->CreateSub(
+              codegen_utils->GetConstant<int32>(
+                  start_offset + attrbind->offset),
+              llvm_null_save)});
+
+      llvm::Value* llvm_datum = nullptr;
+      switch (attrbind->flag) {
+        case MTB_ByVal_Native: {
+          llvm::Value* llvm_colval = nullptr;
+          switch (attrbind->len) {
+            case sizeof(int8):
+              llvm_colval = irb->CreateLoad(llvm_attr_ptr);
+              break;
+            case sizeof(int16):
+              llvm_colval = irb->CreateLoad(irb->CreateBitCast(
+                  llvm_attr_ptr, codegen_utils->GetType<int16*>()));
+              break;
+            case sizeof(int32):
+              llvm_colval = irb->CreateLoad(irb->CreateBitCast(
+                  llvm_attr_ptr, codegen_utils->GetType<int32*>()));
+              break;
+            case sizeof(Datum):
+              llvm_colval = irb->CreateLoad(irb->CreateBitCast(
+                  llvm_attr_ptr, codegen_utils->GetType<int64*>()));
+              break;
+            default:
+              elog(DEBUG1, "Unsupported length %d of by-value attribute %d",
+                   attrbind->len, attnum + 1);
+              return false;
+          }
+          llvm_datum = irb->CreateZExt(llvm_colval,
+                                       codegen_utils->GetType<Datum>());
+          break;
+        }
+        case MTB_ByVal_Ptr:
+          // Fixed length, passed by reference: the Datum points in the tuple
+          llvm_datum = irb->CreatePtrToInt(llvm_attr_ptr,
+                                           codegen_utils->GetType<Datum>());
+          break;
+        case MTB_ByRef:
+        case MTB_ByRef_CStr: {
+          // The fixed length area holds the offset of the data from start
+          llvm::Value* llvm_varoffset = nullptr;
+          if (2 == attrbind->len) {
+            llvm_varoffset = irb->CreateLoad(irb->CreateBitCast(
+                llvm_attr_ptr, codegen_utils->GetType<uint16*>()));
+          } else {
+            assert(4 == attrbind->len);
+            llvm_varoffset = irb->CreateLoad(irb->CreateBitCast(
+                llvm_attr_ptr, codegen_utils->GetType<uint32*>()));
+          }
+          llvm::Value* llvm_data_ptr = irb->CreateInBoundsGEP(
+              llvm_mtup,
+              {irb->CreateAdd(
+                  codegen_utils->GetConstant<int64>(start_offset),
+                  irb->CreateZExt(llvm_varoffset,
+                                  codegen_utils->GetType<int64>()))});
+          llvm_datum = irb->CreatePtrToInt(llvm_data_ptr,
+                                           codegen_utils->GetType<Datum>());
+          break;
+        }
+        default:
+          elog(DEBUG1, "Unsupported memtuple binding flag %d of attribute %d",
+               attrbind->flag, attnum + 1);
+          return false;
+      }
+
+      // values[attnum] = fetchatt(attr, attr_data_ptr); isnull[attnum] = false;
+      irb->CreateStore(llvm_datum, irb->CreateInBoundsGEP(
+          llvm_values, {codegen_utils->GetConstant(attnum)}));
+      irb->CreateStore(codegen_utils->GetConstant<bool>(false),
+                       irb->CreateInBoundsGEP(
+                           llvm_isnull, {codegen_utils->GetConstant(attnum)}));
+
+      if (nullptr != next_attribute_block) {
+        irb->CreateBr(next_attribute_block);
+        irb->SetInsertPoint(next_attribute_block);
+      }
+    }
+
+    // null_save += isnull ? attrbind->len_aligned : 0;
+    if (has_nulls && !attr->attnotnull && p < last_needed) {
+      llvm_null_save = irb->CreateAdd(
+          llvm_null_save,
+          irb->CreateSelect(
+              llvm_attr_isnull,
+              codegen_utils->GetConstant<int32>(attrbind->len_aligned),
+              codegen_utils->GetConstant<int32>(0)));
+    }
+  }
+
+  return true;
+}
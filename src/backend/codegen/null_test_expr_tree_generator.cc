@@ -0,0 +1,108 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    null_test_expr_tree_generator.cc
+//
+//  @doc:
+//    Object that generate code for IS NULL and IS NOT NULL expressions.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <memory>
+#include <utility>
+
+#include "codegen/expr_tree_generator.h"
+#include "codegen/null_test_expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "nodes/execnodes.h"
+#include "utils/elog.h"
+#include "nodes/nodes.h"
+#include "nodes/primnodes.h"
+}
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+using gpcodegen::NullTestExprTreeGenerator;
+using gpcodegen::ExprTreeGenerator;
+using gpcodegen::GpCodegenUtils;
+
+NullTestExprTreeGenerator::NullTestExprTreeGenerator(
+    const ExprState* expr_state,
+    std::unique_ptr<ExprTreeGenerator> argument)
+    :  ExprTreeGenerator(expr_state, ExprTreeNodeType::kNullTest),
+       argument_(std::move(argument)) {
+}
+
+bool NullTestExprTreeGenerator::VerifyAndCreateExprTree(
+    const ExprState* expr_state,
+    ExprTreeGeneratorInfo* gen_info,
+    std::unique_ptr<ExprTreeGenerator>* expr_tree) {
+  assert(nullptr != expr_state &&
+         nullptr != expr_state->expr &&
+         T_NullTest == nodeTag(expr_state->expr) &&
+         nullptr != expr_tree);
+
+  expr_tree->reset(nullptr);
+  const NullTestState* nstate =
+      reinterpret_cast<const NullTestState*>(expr_state);
+  if (nstate->argisrow) {
+    elog(DEBUG1, "Unsupported NullTest on a row value.");
+    return false;
+  }
+  assert(nullptr != nstate->arg);
+
+  std::unique_ptr<ExprTreeGenerator> argument(nullptr);
+  if (!ExprTreeGenerator::VerifyAndCreateExprTree(nstate->arg,
+                                                  gen_info,
+                                                  &argument)) {
+    return false;
+  }
+  expr_tree->reset(new NullTestExprTreeGenerator(expr_state,
+                                                 std::move(argument)));
+  return true;
+}
+
+bool NullTestExprTreeGenerator::GenerateCode(
+    GpCodegenUtils* codegen_utils,
+    const ExprTreeGeneratorInfo& gen_info,
+    llvm::Value** llvm_out_value,
+    llvm::Value* const llvm_isnull_ptr) {
+  assert(nullptr != llvm_out_value);
+  assert(nullptr != llvm_isnull_ptr);
+  *llvm_out_value = nullptr;
+  NullTest* null_test = reinterpret_cast<NullTest*>(expr_state()->expr);
+  auto irb = codegen_utils->ir_builder();
+
+  llvm::Value* llvm_arg = nullptr;
+  llvm::Value* llvm_arg_isnull = nullptr;
+  if (!GenerateArgumentCode(codegen_utils, gen_info, argument_.get(),
+                            &llvm_arg, &llvm_arg_isnull)) {
+    return false;
+  }
+
+  // The result of a NullTest is never NULL
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+  switch (null_test->nulltesttype) {
+    case IS_NULL:
+      *llvm_out_value = codegen_utils->CreateCppTypeToDatumCast(
+          llvm_arg_isnull);
+      return true;
+    case IS_NOT_NULL:
+      *llvm_out_value = codegen_utils->CreateCppTypeToDatumCast(
+          irb->CreateNot(llvm_arg_isnull));
+      return true;
+    default:
+      elog(WARNING, "Unrecognized nulltesttype: %d.",
+           null_test->nulltesttype);
+      return false;
+  }
+}
@@ -24,8 +24,10 @@
 #include "codegen/pg_func_generator_interface.h"
 #include "codegen/utils/gp_codegen_utils.h"
 #include "codegen/pg_arith_func_generator.h"
+#include "codegen/pg_cmp_func_generator.h"
 #include "codegen/pg_date_func_generator.h"
 #include "codegen/pg_numeric_func_generator.h"
+#include "codegen/pg_text_func_generator.h"
 
 #include "llvm/IR/IRBuilder.h"
 
@@ -49,8 +51,76 @@ using gpcodegen::GpCodegenUtils;
 using gpcodegen::PGFuncGeneratorInterface;
 using gpcodegen::PGFuncGeneratorFn;
 using gpcodegen::CodeGenFuncMap;
-using llvm::IRBuilder;
+using gpcodegen::PGArithFuncGenerator;
+using gpcodegen::PGCmpFuncGenerator;
+using gpcodegen::PGDateFuncGenerator;
+using gpcodegen::PGGenericFuncGenerator;
+using gpcodegen::PGTextFuncGenerator;
+
+
+namespace {
+
+// A row of the tables below: pg_proc oid and name of a built-in function
+struct PGFuncEntry {
+  unsigned int oid;
+  const char* name;
+};
+
+// Columns of a comparison table: eq, ne, lt, le, gt, ge
+constexpr int kCmpFuncTableWidth = 6;
+// Columns of an arithmetic table: pl, mi, mul
+constexpr int kArithFuncTableWidth = 3;
+
+/**
+ * @brief Register the strict comparison operators eq, ne, lt, le, gt and ge
+ *        for the argument types (Arg0, Arg1). Both arguments are promoted to
+ *        CmpType before comparing.
+ **/
+template <typename CmpType, typename Arg0, typename Arg1>
+void RegisterCmpFunctions(
+    CodeGenFuncMap* func_map,
+    const PGFuncEntry (&entries)[kCmpFuncTableWidth]) {
+  using CmpGenerator = PGCmpFuncGenerator<CmpType, Arg0, Arg1>;
+  const PGFuncGeneratorFn generators[kCmpFuncTableWidth] = {
+      &CmpGenerator::EQ, &CmpGenerator::NE,
+      &CmpGenerator::LT, &CmpGenerator::LE,
+      &CmpGenerator::GT, &CmpGenerator::GE };
+  for (int i = 0; i < kCmpFuncTableWidth; ++i) {
+    (*func_map)[entries[i].oid] = std::unique_ptr<PGFuncGeneratorInterface>(
+        new PGGenericFuncGenerator<bool, Arg0, Arg1>(
+            entries[i].oid,
+            entries[i].name,
+            generators[i],
+            nullptr,
+            true));
+  }
+}
+
+/**
+ * @brief Register the strict arithmetic operators pl, mi and mul with
+ *        overflow checks for the argument types (Arg0, Arg1).
+ **/
+template <typename rtype, typename Arg0, typename Arg1>
+void RegisterArithFunctions(
+    CodeGenFuncMap* func_map,
+    const PGFuncEntry (&entries)[kArithFuncTableWidth]) {
+  using ArithGenerator = PGArithFuncGenerator<rtype, Arg0, Arg1>;
+  const PGFuncGeneratorFn generators[kArithFuncTableWidth] = {
+      &ArithGenerator::AddWithOverflow,
+      &ArithGenerator::SubWithOverflow,
+      &ArithGenerator::MulWithOverflow };
+  for (int i = 0; i < kArithFuncTableWidth; ++i) {
+    (*func_map)[entries[i].oid] = std::unique_ptr<PGFuncGeneratorInterface>(
+        new PGGenericFuncGenerator<rtype, Arg0, Arg1>(
+            entries[i].oid,
+            entries[i].name,
+            generators[i],
+            nullptr,
+            true));
+  }
+}
 
+}  // namespace
 
 CodeGenFuncMap
 OpExprTreeGenerator::supported_function_;
@@ -58,28 +128,122 @@ OpExprTreeGenerator::supported_function_;
 void OpExprTreeGenerator::InitializeSupportedFunction() {
   if (!supported_function_.empty()) { return; }
 
-  supported_function_[141] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<int32_t, int32_t, int32_t>(
-          141,
-          "int4mul",
-          &PGArithFuncGenerator<int32_t, int32_t, int32_t>::MulWithOverflow,
-          nullptr,
-          true));
-
-  supported_function_[149] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGIRBuilderFuncGenerator<bool, int32_t, int32_t>(
-          149,
-          "int4le",
-          &IRBuilder<>::CreateICmpSLE,
-          true));
+  // Comparison operators, see pg_proc.h
+  // ----------------------------------------------------------------------
+  RegisterCmpFunctions<int16_t, int16_t, int16_t>(&supported_function_, {
+      {63, "int2eq"}, {145, "int2ne"}, {64, "int2lt"},
+      {148, "int2le"}, {146, "int2gt"}, {151, "int2ge"} });
+  RegisterCmpFunctions<int32_t, int32_t, int32_t>(&supported_function_, {
+      {65, "int4eq"}, {144, "int4ne"}, {66, "int4lt"},
+      {149, "int4le"}, {147, "int4gt"}, {150, "int4ge"} });
+  RegisterCmpFunctions<int64_t, int64_t, int64_t>(&supported_function_, {
+      {467, "int8eq"}, {468, "int8ne"}, {469, "int8lt"},
+      {471, "int8le"}, {470, "int8gt"}, {472, "int8ge"} });
+  RegisterCmpFunctions<int32_t, int16_t, int32_t>(&supported_function_, {
+      {158, "int24eq"}, {164, "int24ne"}, {160, "int24lt"},
+      {166, "int24le"}, {162, "int24gt"}, {168, "int24ge"} });
+  RegisterCmpFunctions<int32_t, int32_t, int16_t>(&supported_function_, {
+      {159, "int42eq"}, {165, "int42ne"}, {161, "int42lt"},
+      {167, "int42le"}, {163, "int42gt"}, {169, "int42ge"} });
+  RegisterCmpFunctions<int64_t, int32_t, int64_t>(&supported_function_, {
+      {852, "int48eq"}, {853, "int48ne"}, {854, "int48lt"},
+      {856, "int48le"}, {855, "int48gt"}, {857, "int48ge"} });
+  RegisterCmpFunctions<int64_t, int64_t, int32_t>(&supported_function_, {
+      {474, "int84eq"}, {475, "int84ne"}, {476, "int84lt"},
+      {478, "int84le"}, {477, "int84gt"}, {479, "int84ge"} });
+  RegisterCmpFunctions<int64_t, int16_t, int64_t>(&supported_function_, {
+      {1850, "int28eq"}, {1851, "int28ne"}, {1852, "int28lt"},
+      {1854, "int28le"}, {1853, "int28gt"}, {1855, "int28ge"} });
+  RegisterCmpFunctions<int64_t, int64_t, int16_t>(&supported_function_, {
+      {1856, "int82eq"}, {1857, "int82ne"}, {1858, "int82lt"},
+      {1860, "int82le"}, {1859, "int82gt"}, {1861, "int82ge"} });
+  RegisterCmpFunctions<float, float, float>(&supported_function_, {
+      {287, "float4eq"}, {288, "float4ne"}, {289, "float4lt"},
+      {290, "float4le"}, {291, "float4gt"}, {292, "float4ge"} });
+  RegisterCmpFunctions<float8, float8, float8>(&supported_function_, {
+      {293, "float8eq"}, {294, "float8ne"}, {295, "float8lt"},
+      {296, "float8le"}, {297, "float8gt"}, {298, "float8ge"} });
+  RegisterCmpFunctions<float8, float, float8>(&supported_function_, {
+      {299, "float48eq"}, {300, "float48ne"}, {301, "float48lt"},
+      {302, "float48le"}, {303, "float48gt"}, {304, "float48ge"} });
+  RegisterCmpFunctions<float8, float8, float>(&supported_function_, {
+      {305, "float84eq"}, {306, "float84ne"}, {307, "float84lt"},
+      {308, "float84le"}, {309, "float84gt"}, {310, "float84ge"} });
+  // DateADT is int32
+  RegisterCmpFunctions<int32_t, int32_t, int32_t>(&supported_function_, {
+      {1086, "date_eq"}, {1091, "date_ne"}, {1087, "date_lt"},
+      {1088, "date_le"}, {1089, "date_gt"}, {1090, "date_ge"} });
+#ifdef HAVE_INT64_TIMESTAMP
+  RegisterCmpFunctions<int64_t, int64_t, int64_t>(&supported_function_, {
+      {2052, "timestamp_eq"}, {2053, "timestamp_ne"}, {2054, "timestamp_lt"},
+      {2055, "timestamp_le"}, {2057, "timestamp_gt"}, {2056, "timestamp_ge"} });
+#endif
+  RegisterCmpFunctions<bool, bool, bool>(&supported_function_, {
+      {60, "booleq"}, {84, "boolne"}, {56, "boollt"},
+      {1691, "boolle"}, {57, "boolgt"}, {1692, "boolge"} });
+
+  // Arithmetic operators. The result type is the wider of the two argument
+  // types. float4 arithmetic (float4pl etc.) is not supported because
+  // ArithOpMaker has no float specialization.
+  // ----------------------------------------------------------------------
+  RegisterArithFunctions<int16_t, int16_t, int16_t>(&supported_function_, {
+      {176, "int2pl"}, {180, "int2mi"}, {152, "int2mul"} });
+  RegisterArithFunctions<int32_t, int32_t, int32_t>(&supported_function_, {
+      {177, "int4pl"}, {181, "int4mi"}, {141, "int4mul"} });
+  RegisterArithFunctions<int64_t, int64_t, int64_t>(&supported_function_, {
+      {463, "int8pl"}, {464, "int8mi"}, {465, "int8mul"} });
+  RegisterArithFunctions<int32_t, int16_t, int32_t>(&supported_function_, {
+      {178, "int24pl"}, {182, "int24mi"}, {170, "int24mul"} });
+  RegisterArithFunctions<int32_t, int32_t, int16_t>(&supported_function_, {
+      {179, "int42pl"}, {183, "int42mi"}, {171, "int42mul"} });
+  RegisterArithFunctions<int64_t, int32_t, int64_t>(&supported_function_, {
+      {1278, "int48pl"}, {1279, "int48mi"}, {1280, "int48mul"} });
+  RegisterArithFunctions<int64_t, int64_t, int32_t>(&supported_function_, {
+      {1274, "int84pl"}, {1275, "int84mi"}, {1276, "int84mul"} });
+  RegisterArithFunctions<float8, float8, float8>(&supported_function_, {
+      {218, "float8pl"}, {219, "float8mi"}, {216, "float8mul"} });
+  RegisterArithFunctions<float8, float, float8>(&supported_function_, {
+      {281, "float48pl"}, {282, "float48mi"}, {279, "float48mul"} });
+  RegisterArithFunctions<float8, float8, float>(&supported_function_, {
+      {285, "float84pl"}, {286, "float84mi"}, {283, "float84mul"} });
+
+  // Date vs. timestamp comparison operators
+  // ----------------------------------------------------------------------
+  const std::pair<PGFuncEntry, PGFuncGeneratorFn> date_timestamp_funcs[] = {
+      {{2340, "date_eq_timestamp"}, &PGDateFuncGenerator::DateEQTimestamp},
+      {{2343, "date_ne_timestamp"}, &PGDateFuncGenerator::DateNETimestamp},
+      {{2338, "date_lt_timestamp"}, &PGDateFuncGenerator::DateLTTimestamp},
+      {{2339, "date_le_timestamp"}, &PGDateFuncGenerator::DateLETimestamp},
+      {{2341, "date_gt_timestamp"}, &PGDateFuncGenerator::DateGTTimestamp},
+      {{2342, "date_ge_timestamp"}, &PGDateFuncGenerator::DateGETimestamp} };
+  for (const auto& func : date_timestamp_funcs) {
+    supported_function_[func.first.oid] =
+        std::unique_ptr<PGFuncGeneratorInterface>(
+            new PGGenericFuncGenerator<bool, int32_t, int64_t>(
+                func.first.oid,
+                func.first.name,
+                func.second,
+                nullptr,
+                true));
+  }
 
-  supported_function_[177] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<int32_t, int32_t, int32_t>(
-          177,
-          "int4pl",
-          &PGArithFuncGenerator<int32_t, int32_t, int32_t>::AddWithOverflow,
-          nullptr,
-          true));
+  // Text and bpchar equality. Values are passed as Datums (pointers).
+  // ----------------------------------------------------------------------
+  const std::pair<PGFuncEntry, PGFuncGeneratorFn> text_funcs[] = {
+      {{67, "texteq"}, &PGTextFuncGenerator::TextEQ},
+      {{157, "textne"}, &PGTextFuncGenerator::TextNE},
+      {{1048, "bpchareq"}, &PGTextFuncGenerator::BpcharEQ},
+      {{1053, "bpcharne"}, &PGTextFuncGenerator::BpcharNE} };
+  for (const auto& func : text_funcs) {
+    supported_function_[func.first.oid] =
+        std::unique_ptr<PGFuncGeneratorInterface>(
+            new PGGenericFuncGenerator<bool, Datum, Datum>(
+                func.first.oid,
+                func.first.name,
+                func.second,
+                nullptr,
+                true));
+  }
 
   // int4_sum is not a strict function. It checks if there are NULL arguments
   // and performs actions accordingly.
@@ -92,22 +256,6 @@ void OpExprTreeGenerator::InitializeSupportedFunction() {
           CreateArgumentNullChecks,
           false));
 
-  supported_function_[181] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<int32_t, int32_t, int32_t>(
-          181,
-          "int4mi",
-          &PGArithFuncGenerator<int32_t, int32_t, int32_t>::SubWithOverflow,
-          nullptr,
-          true));
-
-  supported_function_[463] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<int64_t, int64_t, int64_t>(
-          463,
-          "int8pl",
-          &PGArithFuncGenerator<int64_t, int64_t, int64_t>::AddWithOverflow,
-          nullptr,
-          true));
-
   supported_function_[1219] = std::unique_ptr<PGFuncGeneratorInterface>(
       new PGGenericFuncGenerator<int64_t, int64_t>(
           1219,
@@ -125,43 +273,6 @@ void OpExprTreeGenerator::InitializeSupportedFunction() {
           nullptr,
           false));
 
-  supported_function_[216] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<float8, float8, float8>(
-          216,
-          "float8mul",
-          &PGArithFuncGenerator<float8, float8, float8>::MulWithOverflow,
-          nullptr,
-          true));
-
-  supported_function_[218] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<float8, float8, float8>(
-          218,
-          "float8pl",
-          &PGArithFuncGenerator<float8, float8, float8>::AddWithOverflow,
-          nullptr,
-          true));
-
-  supported_function_[219] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<float8, float8, float8>(
-          219,
-          "float8mi",
-          &PGArithFuncGenerator<float8, float8, float8>::SubWithOverflow,
-          nullptr,
-          true));
-
-  supported_function_[1088] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGIRBuilderFuncGenerator<bool, int32_t, int32_t>(
-          1088, "date_le", &IRBuilder<>::CreateICmpSLE,
-          true));
-
-  supported_function_[2339] = std::unique_ptr<PGFuncGeneratorInterface>(
-      new PGGenericFuncGenerator<bool, int32_t, int64_t>(
-          2339,
-          "date_le_timestamp",
-          &PGDateFuncGenerator::DateLETimestamp,
-          nullptr,
-          true));
-
   supported_function_[1963] = std::unique_ptr<PGFuncGeneratorInterface>(
       new PGGenericFuncGenerator<void*, void*, int32>(
           1963,
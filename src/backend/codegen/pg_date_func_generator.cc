@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "codegen/pg_arith_func_generator.h"
+#include "codegen/pg_cmp_func_generator.h"
 #include "codegen/pg_date_func_generator.h"
 #include "codegen/pg_func_generator_interface.h"
 #include "codegen/utils/gp_codegen_utils.h"
@@ -30,6 +31,7 @@ extern "C" {
 #include "utils/timestamp.h"
 }
 
+using gpcodegen::CmpOpMaker;
 using gpcodegen::GpCodegenUtils;
 using gpcodegen::PGDateFuncGenerator;
 using gpcodegen::PGFuncGeneratorInfo;
@@ -38,17 +40,66 @@ bool PGDateFuncGenerator::DateLETimestamp(
     gpcodegen::GpCodegenUtils* codegen_utils,
     const PGFuncGeneratorInfo& pg_func_info,
     llvm::Value** llvm_out_value) {
+  return DateCmpTimestamp(codegen_utils, pg_func_info,
+                          &CmpOpMaker<int64_t>::LE, llvm_out_value);
+}
+
+bool PGDateFuncGenerator::DateEQTimestamp(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  return DateCmpTimestamp(codegen_utils, pg_func_info,
+                          &CmpOpMaker<int64_t>::EQ, llvm_out_value);
+}
+
+bool PGDateFuncGenerator::DateNETimestamp(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  return DateCmpTimestamp(codegen_utils, pg_func_info,
+                          &CmpOpMaker<int64_t>::NE, llvm_out_value);
+}
+
+bool PGDateFuncGenerator::DateLTTimestamp(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  return DateCmpTimestamp(codegen_utils, pg_func_info,
+                          &CmpOpMaker<int64_t>::LT, llvm_out_value);
+}
+
+bool PGDateFuncGenerator::DateGTTimestamp(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  return DateCmpTimestamp(codegen_utils, pg_func_info,
+                          &CmpOpMaker<int64_t>::GT, llvm_out_value);
+}
+
+bool PGDateFuncGenerator::DateGETimestamp(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  return DateCmpTimestamp(codegen_utils, pg_func_info,
+                          &CmpOpMaker<int64_t>::GE, llvm_out_value);
+}
+
+bool PGDateFuncGenerator::DateCmpTimestamp(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    CGCmpOpFunc cmp_op_func,
+    llvm::Value** llvm_out_value) {
 
   llvm::IRBuilder<>* irb = codegen_utils->ir_builder();
 
+  // timestamp_cmp_internal {{{
+#ifdef HAVE_INT64_TIMESTAMP
   // llvm_args[0] is of date type
   llvm::Value* llvm_arg0_Timestamp = GenerateDate2Timestamp(
       codegen_utils, pg_func_info);
 
-  // timestamp_cmp_internal {{{
-#ifdef HAVE_INT64_TIMESTAMP
   *llvm_out_value =
-      irb->CreateICmpSLE(llvm_arg0_Timestamp, pg_func_info.llvm_args[1]);
+      cmp_op_func(irb, llvm_arg0_Timestamp, pg_func_info.llvm_args[1]);
 #else
   // TODO(nikos): We do not support NaNs.
   elog(DEBUG1, "Timestamp != int_64: NaNs are not supported.");
@@ -0,0 +1,83 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    pg_text_func_generator.cc
+//
+//  @doc:
+//    Class with Static member functions to generate code for text and bpchar
+//    equality operators
+//
+//---------------------------------------------------------------------------
+
+#include <assert.h>
+
+#include "codegen/codegen_wrapper.h"
+#include "codegen/pg_text_func_generator.h"
+#include "codegen/pg_func_generator_interface.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Value.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "c.h"  // NOLINT(build/include)
+}
+
+using gpcodegen::GpCodegenUtils;
+using gpcodegen::PGTextFuncGenerator;
+using gpcodegen::PGFuncGeneratorInfo;
+
+bool PGTextFuncGenerator::TextEQ(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  assert(nullptr != codegen_utils);
+  assert(pg_func_info.llvm_args.size() == 2);
+  llvm::Function* llvm_texteq_regular = codegen_utils->
+      GetOrRegisterExternalFunction(texteq_regular, "texteq_regular");
+  *llvm_out_value = codegen_utils->ir_builder()->CreateCall(
+      llvm_texteq_regular,
+      {pg_func_info.llvm_args[0], pg_func_info.llvm_args[1]});
+  return true;
+}
+
+bool PGTextFuncGenerator::TextNE(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  llvm::Value* llvm_eq = nullptr;
+  if (!TextEQ(codegen_utils, pg_func_info, &llvm_eq)) {
+    return false;
+  }
+  *llvm_out_value = codegen_utils->ir_builder()->CreateNot(llvm_eq);
+  return true;
+}
+
+bool PGTextFuncGenerator::BpcharEQ(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  assert(nullptr != codegen_utils);
+  assert(pg_func_info.llvm_args.size() == 2);
+  llvm::Function* llvm_bpchareq_regular = codegen_utils->
+      GetOrRegisterExternalFunction(bpchareq_regular, "bpchareq_regular");
+  *llvm_out_value = codegen_utils->ir_builder()->CreateCall(
+      llvm_bpchareq_regular,
+      {pg_func_info.llvm_args[0], pg_func_info.llvm_args[1]});
+  return true;
+}
+
+bool PGTextFuncGenerator::BpcharNE(
+    gpcodegen::GpCodegenUtils* codegen_utils,
+    const PGFuncGeneratorInfo& pg_func_info,
+    llvm::Value** llvm_out_value) {
+  llvm::Value* llvm_eq = nullptr;
+  if (!BpcharEQ(codegen_utils, pg_func_info, &llvm_eq)) {
+    return false;
+  }
+  *llvm_out_value = codegen_utils->ir_builder()->CreateNot(llvm_eq);
+  return true;
+}
@@ -0,0 +1,345 @@
+//---------------------------------------------------------------------------
+//  Greenplum Database
+//  Copyright (C) 2016 Pivotal Software, Inc.
+//
+//  @filename:
+//    scalar_array_op_expr_tree_generator.cc
+//
+//  @doc:
+//    Object that generate code for "scalar op ANY/ALL (array)" expressions.
+//
+//---------------------------------------------------------------------------
+#include <assert.h>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "codegen/expr_tree_generator.h"
+#include "codegen/op_expr_tree_generator.h"
+#include "codegen/pg_func_generator_interface.h"
+#include "codegen/scalar_array_op_expr_tree_generator.h"
+#include "codegen/utils/gp_codegen_utils.h"
+
+#include "llvm/IR/IRBuilder.h"
+
+extern "C" {
+#include "postgres.h"  // NOLINT(build/include)
+#include "nodes/execnodes.h"
+#include "utils/elog.h"
+#include "nodes/nodes.h"
+#include "nodes/pg_list.h"
+#include "nodes/primnodes.h"
+#include "utils/array.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+}
+
+namespace llvm {
+class Value;
+}  // namespace llvm
+
+using gpcodegen::ScalarArrayOpExprTreeGenerator;
+using gpcodegen::ExprTreeGenerator;
+using gpcodegen::GpCodegenUtils;
+using gpcodegen::OpExprTreeGenerator;
+using gpcodegen::PGFuncGeneratorInfo;
+using gpcodegen::PGFuncGeneratorInterface;
+
+constexpr size_t ScalarArrayOpExprTreeGenerator::kMaxUnrolledArrayElements;
+
+ScalarArrayOpExprTreeGenerator::ScalarArrayOpExprTreeGenerator(
+    const ExprState* expr_state,
+    std::unique_ptr<ExprTreeGenerator> scalar,
+    std::vector<Datum>&& elements,  // NOLINT(build/c++11)
+    bool has_null)
+    :  ExprTreeGenerator(expr_state, ExprTreeNodeType::kScalarArrayOp),
+       scalar_(std::move(scalar)),
+       elements_(std::move(elements)),
+       has_null_(has_null) {
+}
+
+unsigned ScalarArrayOpExprTreeGenerator::GetSwitchWidth(Oid opfuncid,
+                                                        bool use_or) {
+  // "x = ANY (...)" matches on equality, and so does "x <> ALL (...)", whose
+  // result is decided by the first element equal to x.
+  switch (opfuncid) {
+    case F_INT2EQ:
+      return use_or ? 16 : 0;
+    case F_INT2NE:
+      return use_or ? 0 : 16;
+    case F_INT4EQ:
+    case F_DATE_EQ:
+      return use_or ? 32 : 0;
+    case F_INT4NE:
+    case F_DATE_NE:
+      return use_or ? 0 : 32;
+    case F_INT8EQ:
+      return use_or ? 64 : 0;
+    case F_INT8NE:
+      return use_or ? 0 : 64;
+    default:
+      return 0;
+  }
+}
+
+bool ScalarArrayOpExprTreeGenerator::VerifyAndCreateExprTree(
+    const ExprState* expr_state,
+    ExprTreeGeneratorInfo* gen_info,
+    std::unique_ptr<ExprTreeGenerator>* expr_tree) {
+  assert(nullptr != expr_state &&
+         nullptr != expr_state->expr &&
+         T_ScalarArrayOpExpr == nodeTag(expr_state->expr) &&
+         nullptr != expr_tree);
+
+  expr_tree->reset(nullptr);
+  ScalarArrayOpExpr* saop_expr =
+      reinterpret_cast<ScalarArrayOpExpr*>(expr_state->expr);
+  const ScalarArrayOpExprState* saop_state =
+      reinterpret_cast<const ScalarArrayOpExprState*>(expr_state);
+
+  PGFuncGeneratorInterface* pg_func_gen =
+      OpExprTreeGenerator::GetPGFuncGenerator(saop_expr->opfuncid);
+  if (nullptr == pg_func_gen ||
+      !pg_func_gen->IsStrict() ||
+      2 != pg_func_gen->GetTotalArgCount()) {
+    elog(DEBUG1, "Unsupported operator %d in ScalarArrayOpExpr.",
+         saop_expr->opfuncid);
+    return false;
+  }
+
+  List* arguments = saop_state->fxprstate.args;
+  assert(2 == list_length(arguments));
+  ExprState* scalar_state = reinterpret_cast<ExprState*>(linitial(arguments));
+  ExprState* array_state = reinterpret_cast<ExprState*>(lsecond(arguments));
+  assert(nullptr != scalar_state && nullptr != array_state);
+
+  // The elements are embedded in the generated code, so the array has to be
+  // known at generation time
+  if (!IsA(array_state->expr, Const) ||
+      reinterpret_cast<Const*>(array_state->expr)->constisnull) {
+    elog(DEBUG1, "Unsupported non-constant array in ScalarArrayOpExpr.");
+    return false;
+  }
+
+  ArrayType* array = DatumGetArrayTypeP(
+      reinterpret_cast<Const*>(array_state->expr)->constvalue);
+  int nitems = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+  if (static_cast<size_t>(nitems) > kMaxUnrolledArrayElements &&
+      0 == GetSwitchWidth(saop_expr->opfuncid, saop_expr->useOr)) {
+    elog(DEBUG1, "Unsupported array of %d elements for operator %d in "
+         "ScalarArrayOpExpr.", nitems, saop_expr->opfuncid);
+    return false;
+  }
+
+  int16 typlen;
+  bool typbyval;
+  char typalign;
+  get_typlenbyvalalign(ARR_ELEMTYPE(array), &typlen, &typbyval, &typalign);
+  if (!typbyval) {
+    elog(DEBUG1, "Unsupported array element type %d in ScalarArrayOpExpr.",
+         ARR_ELEMTYPE(array));
+    return false;
+  }
+
+  Datum* values = nullptr;
+  bool* nulls = nullptr;
+  int nelems = 0;
+  deconstruct_array(array, ARR_ELEMTYPE(array), typlen, typbyval, typalign,
+                    &values, &nulls, &nelems);
+  std::vector<Datum> elements;
+  bool has_null = false;
+  for (int i = 0; i < nelems; ++i) {
+    if (nulls[i]) {
+      has_null = true;
+    } else {
+      elements.push_back(values[i]);
+    }
+  }
+  pfree(values);
+  pfree(nulls);
+
+  std::unique_ptr<ExprTreeGenerator> scalar(nullptr);
+  if (!ExprTreeGenerator::VerifyAndCreateExprTree(scalar_state,
+                                                  gen_info,
+                                                  &scalar)) {
+    return false;
+  }
+
+  expr_tree->reset(new ScalarArrayOpExprTreeGenerator(expr_state,
+                                                      std::move(scalar),
+                                                      std::move(elements),
+                                                      has_null));
+  return true;
+}
+
+void ScalarArrayOpExprTreeGenerator::GenerateSwitchCode(
+    GpCodegenUtils* codegen_utils,
+    llvm::Value* llvm_scalar,
+    unsigned width,
+    llvm::BasicBlock* match_block,
+    llvm::BasicBlock* no_match_block) {
+  auto irb = codegen_utils->ir_builder();
+  llvm::IntegerType* llvm_int_type = irb->getIntNTy(width);
+  const uint64_t mask = (64 == width) ?
+      ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << width) - 1;
+
+  // The datums of the elements may differ beyond the width of the type, so
+  // compare truncated values. Duplicate cases are not allowed in a switch.
+  std::set<uint64_t> cases;
+  for (Datum element : elements_) {
+    cases.insert(static_cast<uint64_t>(element) & mask);
+  }
+
+  llvm::SwitchInst* llvm_switch = irb->CreateSwitch(
+      irb->CreateTrunc(llvm_scalar, llvm_int_type),
+      no_match_block,
+      cases.size());
+  for (uint64_t value : cases) {
+    llvm_switch->addCase(llvm::ConstantInt::get(llvm_int_type, value),
+                         match_block);
+  }
+}
+
+bool ScalarArrayOpExprTreeGenerator::GenerateUnrolledCode(
+    GpCodegenUtils* codegen_utils,
+    const ExprTreeGeneratorInfo& gen_info,
+    llvm::Value* llvm_scalar,
+    llvm::BasicBlock* match_block,
+    llvm::BasicBlock* no_match_block) {
+  ScalarArrayOpExpr* saop_expr =
+      reinterpret_cast<ScalarArrayOpExpr*>(expr_state()->expr);
+  PGFuncGeneratorInterface* pg_func_gen =
+      OpExprTreeGenerator::GetPGFuncGenerator(saop_expr->opfuncid);
+  if (nullptr == pg_func_gen) {
+    elog(WARNING, "Unsupported operator %d.", saop_expr->opfuncid);
+    return false;
+  }
+  auto irb = codegen_utils->ir_builder();
+
+  // Neither the scalar nor the elements are null at this point, so the
+  // operator never returns null
+  llvm::Value* llvm_op_isnull_ptr = irb->CreateAlloca(
+      codegen_utils->GetType<bool>(), nullptr, "isNull");
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false),
+                   llvm_op_isnull_ptr);
+  std::vector<llvm::Value*> llvm_arguments_isNull = {
+      codegen_utils->GetConstant<bool>(false),
+      codegen_utils->GetConstant<bool>(false) };
+
+  for (Datum element : elements_) {
+    std::vector<llvm::Value*> llvm_arguments = {
+        llvm_scalar,
+        codegen_utils->GetConstant<Datum>(element) };
+    PGFuncGeneratorInfo pg_func_info(gen_info.llvm_main_func,
+                                     gen_info.llvm_error_block,
+                                     llvm_arguments,
+                                     llvm_arguments_isNull);
+    llvm::Value* llvm_op_value = nullptr;
+    if (!pg_func_gen->GenerateCode(codegen_utils,
+                                   pg_func_info,
+                                   &llvm_op_value,
+                                   llvm_op_isnull_ptr)) {
+      return false;
+    }
+    llvm::Value* llvm_op_is_true = irb->CreateICmpNE(
+        codegen_utils->CreateCppTypeToDatumCast(llvm_op_value),
+        codegen_utils->GetConstant<Datum>(0));
+
+    llvm::BasicBlock* next_block = codegen_utils->CreateBasicBlock(
+        "scalar_array_op_next_element_block", gen_info.llvm_main_func);
+    if (saop_expr->useOr) {
+      irb->CreateCondBr(llvm_op_is_true, match_block, next_block);
+    } else {
+      irb->CreateCondBr(llvm_op_is_true, next_block, match_block);
+    }
+    irb->SetInsertPoint(next_block);
+  }
+  irb->CreateBr(no_match_block);
+  return true;
+}
+
+bool ScalarArrayOpExprTreeGenerator::GenerateCode(
+    GpCodegenUtils* codegen_utils,
+    const ExprTreeGeneratorInfo& gen_info,
+    llvm::Value** llvm_out_value,
+    llvm::Value* const llvm_isnull_ptr) {
+  assert(nullptr != llvm_out_value);
+  assert(nullptr != llvm_isnull_ptr);
+  *llvm_out_value = nullptr;
+  ScalarArrayOpExpr* saop_expr =
+      reinterpret_cast<ScalarArrayOpExpr*>(expr_state()->expr);
+  const bool use_or = saop_expr->useOr;
+  auto irb = codegen_utils->ir_builder();
+
+  // As in ExecEvalScalarArrayOp(), an empty array yields false for ANY and
+  // true for ALL, even if the scalar is null
+  if (elements_.empty() && !has_null_) {
+    irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+    *llvm_out_value = codegen_utils->GetConstant<Datum>(BoolGetDatum(!use_or));
+    return true;
+  }
+
+  llvm::Value* llvm_scalar = nullptr;
+  llvm::Value* llvm_scalar_isnull = nullptr;
+  if (!GenerateArgumentCode(codegen_utils, gen_info, scalar_.get(),
+                            &llvm_scalar, &llvm_scalar_isnull)) {
+    return false;
+  }
+
+  llvm::BasicBlock* scalar_null_block = codegen_utils->CreateBasicBlock(
+      "scalar_array_op_scalar_null_block", gen_info.llvm_main_func);
+  llvm::BasicBlock* scalar_not_null_block = codegen_utils->CreateBasicBlock(
+      "scalar_array_op_scalar_not_null_block", gen_info.llvm_main_func);
+  // Reached when an element decides the result: true for ANY, false for ALL
+  llvm::BasicBlock* match_block = codegen_utils->CreateBasicBlock(
+      "scalar_array_op_match_block", gen_info.llvm_main_func);
+  llvm::BasicBlock* no_match_block = codegen_utils->CreateBasicBlock(
+      "scalar_array_op_no_match_block", gen_info.llvm_main_func);
+  llvm::BasicBlock* done_block = codegen_utils->CreateBasicBlock(
+      "scalar_array_op_done_block", gen_info.llvm_main_func);
+
+  // The operator is strict, so a null scalar gives a null result
+  irb->CreateCondBr(llvm_scalar_isnull, scalar_null_block,
+                    scalar_not_null_block);
+
+  irb->SetInsertPoint(scalar_not_null_block);
+  unsigned width = GetSwitchWidth(saop_expr->opfuncid, use_or);
+  if (0 != width) {
+    GenerateSwitchCode(codegen_utils, llvm_scalar, width,
+                       match_block, no_match_block);
+  } else if (!GenerateUnrolledCode(codegen_utils, gen_info, llvm_scalar,
+                                   match_block, no_match_block)) {
+    return false;
+  }
+
+  irb->SetInsertPoint(scalar_null_block);
+  irb->CreateStore(codegen_utils->GetConstant<bool>(true), llvm_isnull_ptr);
+  irb->CreateBr(done_block);
+
+  irb->SetInsertPoint(match_block);
+  irb->CreateStore(codegen_utils->GetConstant<bool>(false), llvm_isnull_ptr);
+  irb->CreateBr(done_block);
+
+  // No element decided the result. If the array contains a null, the result
+  // is null.
+  irb->SetInsertPoint(no_match_block);
+  irb->CreateStore(codegen_utils->GetConstant<bool>(has_null_),
+                   llvm_isnull_ptr);
+  irb->CreateBr(done_block);
+
+  irb->SetInsertPoint(done_block);
+  llvm::PHINode* llvm_out_phinode = irb->CreatePHI(
+      codegen_utils->GetType<Datum>(), 3);
+  llvm_out_phinode->addIncoming(codegen_utils->GetConstant<Datum>(0),
+                                scalar_null_block);
+  llvm_out_phinode->addIncoming(
+      codegen_utils->GetConstant<Datum>(BoolGetDatum(use_or)), match_block);
+  llvm_out_phinode->addIncoming(
+      codegen_utils->GetConstant<Datum>(
+          has_null_ ? static_cast<Datum>(0) : BoolGetDatum(!use_or)),
+      no_match_block);
+  *llvm_out_value = llvm_out_phinode;
+  return true;
+}
@@ -17,6 +17,7 @@
 #include "codegen/codegen_wrapper.h"
 #include "codegen/codegen_config.h"
 #include "codegen/codegen_manager.h"
+#include "codegen/memtuple_deform_generator.h"
 #include "codegen/slot_getattr_codegen.h"
 #include "codegen/utils/gp_codegen_utils.h"
 #include "codegen/utils/utility.h"
@@ -59,7 +60,8 @@ std::unordered_map<
 SlotGetAttrCodegen* SlotGetAttrCodegen::GetCodegenInstance(
     gpcodegen::CodegenManager* manager,
     TupleTableSlot *slot,
-    int max_attr) {
+    int max_attr,
+    bool holds_memtuples) {
 
   // TODO(krajaraman, frahman) : Refactor so creation happens through
   // CodegenManager::CreateAndEnrollGenerator. In that case, we don't
@@ -80,7 +82,8 @@ SlotGetAttrCodegen* SlotGetAttrCodegen::GetCodegenInstance(
     // TODO(krajaraman, frahman) : Refactor so creation happens through
     // CodegenManager::CreateAndEnrollGenerator.
     // For a slot we haven't see before, create and add a new object
-    generator = new SlotGetAttrCodegen(manager, slot, max_attr);
+    generator = new SlotGetAttrCodegen(manager, slot, max_attr,
+                                       holds_memtuples);
     codegen_cache_by_manager[manager].insert(std::make_pair(slot, generator));
     // Enroll this in the manager so that it can take ownership
     manager->EnrollCodeGenerator(CodegenFuncLifespan_Parameter_Invariant,
@@ -124,9 +127,9 @@ bool SlotGetAttrCodegen::GenerateCodeInternal(
     return true;
   }
 
-  // Give the function a human readable name
+  // Give the function a human readable name. The slot's address is left out
+  // on purpose, so that identical plans produce identical modules.
   std::string function_name = GetUniqueFuncName() + "_" +
-      std::to_string(reinterpret_cast<uint64_t>(slot_)) + "_" +
       std::to_string(max_attr_);
   llvm::Function* function = CreateFunction<SlotGetAttrFn>(codegen_utils,
                                                            function_name);
@@ -155,6 +158,24 @@ bool SlotGetAttrCodegen::GenerateSlotGetAttr(
   // So looks like we're going to generate code
   auto irb = codegen_utils->ir_builder();
 
+  // If the slot holds memtuples, deform them with fixed offsets taken from
+  // the slot's binding instead of calling memtuple_getattr() per attribute.
+  // Every slot has a binding, so only do this for the slots that are known
+  // to be filled with memtuples.
+  llvm::Function* llvm_memtuple_deform = nullptr;
+  if (CodegenConfig::IsGeneratorEnabled<MemTupleDeformGenerator>() &&
+      holds_memtuples_ &&
+      nullptr != slot->tts_mt_bind) {
+    llvm_memtuple_deform = MemTupleDeformGenerator::GenerateMemTupleDeform(
+        codegen_utils,
+        slot_getattr_func->getName().str() + "_memtuple_deform",
+        slot->tts_mt_bind,
+        max_attr);
+    if (nullptr == llvm_memtuple_deform) {
+      elog(DEBUG1, "memtuple_deform generation failed!");
+    }
+  }
+
   // BasicBlock of function entry.
   llvm::BasicBlock* entry_block = codegen_utils->CreateBasicBlock(
       "entry", slot_getattr_func);
@@ -295,6 +316,40 @@ bool SlotGetAttrCodegen::GenerateSlotGetAttr(
   // --------------
 
   irb->SetInsertPoint(memtuple_block);
+  if (nullptr != llvm_memtuple_deform) {
+    llvm::BasicBlock* memtuple_deform_block = codegen_utils->CreateBasicBlock(
+        "memtuple_deform", slot_getattr_func);
+    llvm::BasicBlock* memtuple_getattr_block = codegen_utils->CreateBasicBlock(
+        "memtuple_getattr", slot_getattr_func);
+
+    // The generated deform is only valid for the binding it was generated
+    // for, slot->tts_mt_bind == pbind
+    irb->CreateCondBr(
+        irb->CreateICmpEQ(llvm_slot_tts_mt_bind,
+                          codegen_utils->GetConstant(slot->tts_mt_bind)),
+        memtuple_deform_block /* true */,
+        memtuple_getattr_block /* false */);
+
+    // Memtuple deform block
+    // ---------------------
+    // Same as slot_getsomeattrs() on a memtuple, with fixed offsets.
+    irb->SetInsertPoint(memtuple_deform_block);
+    irb->CreateCall(llvm_memtuple_deform, {
+        llvm_slot_PRIVATE_tts_memtuple,
+        llvm_slot_PRIVATE_tts_values,
+        llvm_slot_PRIVATE_tts_isnull});
+    // TupSetVirtualTuple(slot);
+    irb->CreateStore(
+        irb->CreateOr(
+            irb->CreateLoad(llvm_slot_PRIVATE_tts_flags_ptr),
+            codegen_utils->GetConstant<int>(TTS_VIRTUAL)),
+        llvm_slot_PRIVATE_tts_flags_ptr);
+    // slot->PRIVATE_tts_nvalid = max_attr;
+    irb->CreateStore(llvm_max_attr, llvm_slot_PRIVATE_tts_nvalid_ptr);
+    irb->CreateBr(return_block);
+
+    irb->SetInsertPoint(memtuple_getattr_block);
+  }
   // return memtuple_getattr(slot->PRIVATE_tts_memtuple,
   //    slot->tts_mt_bind, attnum, isnull);
   llvm::Value* llvm_memtuple_ret = irb->CreateCall(llvm_memtuple_getattr, {
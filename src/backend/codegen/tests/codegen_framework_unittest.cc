@@ -63,6 +63,9 @@ extern "C" {
 #include "codegen/base_codegen.h"
 
 extern bool codegen_validate_functions;
+extern int codegen_optimization_level;
+extern int codegen_min_rows;
+extern int codegen_aggressive_rows;
 using gpcodegen::GpCodegenUtils;
 namespace gpcodegen {
 
@@ -403,8 +406,8 @@ TEST_F(CodegenManagerTest, TestGetters) {
 
   EXPECT_EQ(SumCodeGenerator::kAddFuncNamePrefix,
             code_gen->GetOrigFuncName());
-  // Static unique_counter will be zero to begin with.
-  // So uniqueFuncName return with suffix zero.
+  // Unique names are numbered per manager, and this is the first generator
+  // of a new manager. So uniqueFuncName return with suffix zero.
   EXPECT_EQ(SumCodeGenerator::kAddFuncNamePrefix + std::to_string(0),
             code_gen->GetUniqueFuncName());
   ASSERT_TRUE(manager_->EnrollCodeGenerator(
@@ -420,6 +423,39 @@ TEST_F(CodegenManagerTest, EnrollCodeGeneratorTest) {
   EXPECT_EQ(1, manager_->GetEnrollmentCount());
 }
 
+TEST_F(CodegenManagerTest, EstimatedRowsTest) {
+  int old_optimization_level = codegen_optimization_level;
+  int old_min_rows = codegen_min_rows;
+  int old_aggressive_rows = codegen_aggressive_rows;
+  codegen_optimization_level = CODEGEN_OPTIMIZATION_LEVEL_DEFAULT;
+  codegen_min_rows = 100;
+  codegen_aggressive_rows = 1000;
+
+  // Unknown estimates always generate code
+  CodegenManager unknown_rows_manager("UnknownRows");
+  EXPECT_TRUE(unknown_rows_manager.ShouldGenerateCode());
+  EXPECT_EQ(CODEGEN_OPTIMIZATION_LEVEL_DEFAULT,
+            unknown_rows_manager.optimization_level());
+
+  // Too few rows to be worth generating code
+  CodegenManager few_rows_manager("FewRows", 10);
+  EXPECT_FALSE(few_rows_manager.ShouldGenerateCode());
+
+  CodegenManager many_rows_manager("ManyRows", 100);
+  EXPECT_TRUE(many_rows_manager.ShouldGenerateCode());
+  EXPECT_EQ(CODEGEN_OPTIMIZATION_LEVEL_DEFAULT,
+            many_rows_manager.optimization_level());
+
+  CodegenManager lots_of_rows_manager("LotsOfRows", 1000);
+  EXPECT_TRUE(lots_of_rows_manager.ShouldGenerateCode());
+  EXPECT_EQ(CODEGEN_OPTIMIZATION_LEVEL_AGGRESSIVE,
+            lots_of_rows_manager.optimization_level());
+
+  codegen_optimization_level = old_optimization_level;
+  codegen_min_rows = old_min_rows;
+  codegen_aggressive_rows = old_aggressive_rows;
+}
+
 TEST_F(CodegenManagerTest, GenerateCodeTest) {
   // With no generator it should return false
   EXPECT_EQ(0, manager_->GenerateCode());
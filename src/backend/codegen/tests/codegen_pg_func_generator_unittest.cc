@@ -63,6 +63,7 @@ extern "C" {
 #include "codegen/base_codegen.h"
 #include "codegen/pg_func_generator.h"
 #include "codegen/pg_arith_func_generator.h"
+#include "codegen/pg_cmp_func_generator.h"
 
 
 namespace gpcodegen {
@@ -377,6 +378,101 @@ TEST_F(CodegenPGFuncGeneratorTest, PGGenericFuncGeneratorOneArgTest) {
   EXPECT_EQ(3, fn(2));
 }
 
+// Helper method that generates a function calling the given comparison
+// generator on its two arguments.
+template <typename Arg0, typename Arg1>
+void GenerateCmpFunction(gpcodegen::GpCodegenUtils* codegen_utils,
+                         const char* fn_name,
+                         PGFuncGeneratorFn cmp_generator) {
+  using CmpFn = bool (*) (Arg0, Arg1);
+  llvm::Function* cmp_fn = codegen_utils->CreateFunction<CmpFn>(fn_name);
+  llvm::BasicBlock* main_block =
+      codegen_utils->CreateBasicBlock("main", cmp_fn);
+  llvm::BasicBlock* error_block =
+      codegen_utils->CreateBasicBlock("error", cmp_fn);
+
+  auto irb = codegen_utils->ir_builder();
+  irb->SetInsertPoint(main_block);
+  llvm::Value* result = nullptr;
+  std::vector<llvm::Value*> args = {
+      ArgumentByPosition(cmp_fn, 0),
+      ArgumentByPosition(cmp_fn, 1)};
+  PGFuncGeneratorInfo pg_gen_info(cmp_fn, error_block, args, {});
+  EXPECT_TRUE(cmp_generator(codegen_utils, pg_gen_info, &result));
+  irb->CreateRet(result);
+
+  irb->SetInsertPoint(error_block);
+  irb->CreateRet(codegen_utils->GetConstant<bool>(false));
+
+  EXPECT_FALSE(llvm::verifyFunction(*cmp_fn));
+}
+
+// Test PGCmpFuncGenerator with cross-type integer arguments
+TEST_F(CodegenPGFuncGeneratorTest, PGCmpFuncGeneratorCrossTypeIntTest) {
+  using CmpFn = bool (*) (int32_t, int64_t);
+
+  GenerateCmpFunction<int32_t, int64_t>(
+      codegen_utils_.get(), "int48lt_fn",
+      &PGCmpFuncGenerator<int64_t, int32_t, int64_t>::LT);
+  GenerateCmpFunction<int32_t, int64_t>(
+      codegen_utils_.get(), "int48eq_fn",
+      &PGCmpFuncGenerator<int64_t, int32_t, int64_t>::EQ);
+  EXPECT_FALSE(llvm::verifyModule(*codegen_utils_->module()));
+
+  EXPECT_TRUE(codegen_utils_->PrepareForExecution(
+      CodegenUtils::OptimizationLevel::kNone,
+      true));
+
+  CmpFn lt_fn = codegen_utils_->GetFunctionPointer<CmpFn>("int48lt_fn");
+  CmpFn eq_fn = codegen_utils_->GetFunctionPointer<CmpFn>("int48eq_fn");
+
+  EXPECT_TRUE(lt_fn(-1, 0));
+  EXPECT_TRUE(lt_fn(2, 1L << 40));
+  EXPECT_FALSE(lt_fn(2, -(1L << 40)));
+  EXPECT_FALSE(lt_fn(3, 3));
+  EXPECT_TRUE(eq_fn(-7, -7));
+  EXPECT_FALSE(eq_fn(0, 1L << 32));
+}
+
+// Test that PGCmpFuncGenerator treats NaNs like float8_cmp_internal: NaNs are
+// equal to each other and larger than any other value.
+TEST_F(CodegenPGFuncGeneratorTest, PGCmpFuncGeneratorFloatNaNTest) {
+  using CmpFn = bool (*) (double, double);
+
+  GenerateCmpFunction<double, double>(
+      codegen_utils_.get(), "float8eq_fn",
+      &PGCmpFuncGenerator<double, double, double>::EQ);
+  GenerateCmpFunction<double, double>(
+      codegen_utils_.get(), "float8lt_fn",
+      &PGCmpFuncGenerator<double, double, double>::LT);
+  GenerateCmpFunction<double, double>(
+      codegen_utils_.get(), "float8ge_fn",
+      &PGCmpFuncGenerator<double, double, double>::GE);
+  EXPECT_FALSE(llvm::verifyModule(*codegen_utils_->module()));
+
+  EXPECT_TRUE(codegen_utils_->PrepareForExecution(
+      CodegenUtils::OptimizationLevel::kNone,
+      true));
+
+  CmpFn eq_fn = codegen_utils_->GetFunctionPointer<CmpFn>("float8eq_fn");
+  CmpFn lt_fn = codegen_utils_->GetFunctionPointer<CmpFn>("float8lt_fn");
+  CmpFn ge_fn = codegen_utils_->GetFunctionPointer<CmpFn>("float8ge_fn");
+
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  double inf = std::numeric_limits<double>::infinity();
+
+  EXPECT_TRUE(eq_fn(1.5, 1.5));
+  EXPECT_TRUE(eq_fn(nan, nan));
+  EXPECT_FALSE(eq_fn(nan, 1.0));
+  EXPECT_TRUE(lt_fn(1.0, 2.0));
+  EXPECT_TRUE(lt_fn(inf, nan));
+  EXPECT_FALSE(lt_fn(nan, inf));
+  EXPECT_FALSE(lt_fn(nan, nan));
+  EXPECT_TRUE(ge_fn(nan, nan));
+  EXPECT_TRUE(ge_fn(nan, 0.0));
+  EXPECT_FALSE(ge_fn(0.0, nan));
+}
+
 }  // namespace gpcodegen
 
 
@@ -226,7 +226,8 @@ bool CodegenUtils::Optimize(const OptimizationLevel generic_opt_level,
 }
 
 bool CodegenUtils::PrepareForExecution(const OptimizationLevel cpu_opt_level,
-                                        const bool optimize_for_host_cpu) {
+                                        const bool optimize_for_host_cpu,
+                                        llvm::ObjectCache* object_cache) {
   if (engine_.get() != nullptr) {
     // This method was already called successfully.
     return false;
@@ -249,6 +250,10 @@ bool CodegenUtils::PrepareForExecution(const OptimizationLevel cpu_opt_level,
     return false;
   }
 
+  if (object_cache != nullptr) {
+    engine_->setObjectCache(object_cache);
+  }
+
   // Add auxiliary modules generated by companion tools to the ExecutionEngine.
   for (std::unique_ptr<llvm::Module>& auxiliary_module : auxiliary_modules_) {
     engine_->addModule(std::move(auxiliary_module));
@@ -288,6 +293,12 @@ bool CodegenUtils::PrepareForExecution(const OptimizationLevel cpu_opt_level,
   return true;
 }
 
+void CodegenUtils::CompileForExecution() {
+  if (engine_.get() != nullptr) {
+    engine_->finalizeObject();
+  }
+}
+
 void CodegenUtils::PrintUnderlyingModules(llvm::raw_ostream& out) {
   // Print the main module
   out << "==== MAIN MODULE ====" << "\n";
@@ -26,6 +26,7 @@
 #include "nodes/pg_list.h"
 #include "nodes/print.h"
 #include "optimizer/clauses.h"
+#include "optimizer/optstats.h"
 #include "optimizer/planner.h"
 #include "optimizer/var.h"
 #include "parser/parsetree.h"
@@ -683,6 +684,20 @@ ExplainOnePlan(PlannedStmt *plannedstmt, ParamListInfo params,
 			appendStringInfo(&buf, "PQO version %s\n", OptVersion());
     	}
     }
+
+	if (queryDesc->plannedstmt->planFromCache)
+		appendStringInfo(&buf, "Optimizer plan cache: hit\n");
+	else if (queryDesc->plannedstmt->planGen == PLANGEN_OPTIMIZER)
+	{
+		/* the time varies from run to run, like the total runtime */
+		if (stmt->analyze)
+			appendStringInfo(&buf, "Optimization time: %.3f ms\n",
+							 queryDesc->plannedstmt->optimizerTime);
+		if (queryDesc->plannedstmt->optimizerBudgetExceeded)
+			appendStringInfo(&buf, "Optimizer time budget exceeded: best plan found so far\n");
+		if (stmt->verbose && queryDesc->plannedstmt->optimizerStats)
+			AppendOptimizerStats(&buf, queryDesc->plannedstmt->optimizerStats);
+	}
 #endif
 
     /*
@@ -193,6 +193,56 @@ setSubplanSliceId(SubPlan *subplan, EState *estate)
 }
 
 
+/*
+ * ExecCodegenEstimatedRows
+ *	 Estimate how many rows a plan node processes, to decide whether it is
+ *	 worth generating code for it.
+ *
+ * Generated code runs on the node's input as well as on its output (e.g. the
+ * quals of a scan, or the transition functions of an aggregate), so take the
+ * larger of the node's and its children's estimates.
+ */
+#ifdef USE_CODEGEN
+static double
+ExecCodegenEstimatedRows(Plan *node)
+{
+	double		rows = node->plan_rows;
+
+	if (node->lefttree)
+		rows = Max(rows, node->lefttree->plan_rows);
+	if (node->righttree)
+		rows = Max(rows, node->righttree->plan_rows);
+
+	return rows;
+}
+#endif
+
+/*
+ * ExecPollGeneratedCode
+ *	 Switch the node to its generated code once the compilation started by
+ *	 ExecInitNode has finished, and record how it used the codegen cache.
+ *
+ * This is called between tuples, when none of the node's function pointers
+ * are in use.
+ */
+static inline void
+ExecPollGeneratedCode(PlanState *node)
+{
+	if (!node->CodegenPending)
+		return;
+
+	node->CodegenPending =
+		CodeGeneratorManagerPollGeneratedFunctions(node->CodegenManager);
+
+	if (!node->CodegenPending && node->instrument)
+	{
+		node->instrument->codegenCacheHits =
+			CodeGeneratorManagerGetCacheHitCount(node->CodegenManager);
+		node->instrument->codegenCacheMisses =
+			CodeGeneratorManagerGetCacheMissCount(node->CodegenManager);
+	}
+}
+
 /* ------------------------------------------------------------------------
  *		ExecInitNode
  *
@@ -229,7 +279,8 @@ ExecInitNode(Plan *node, EState *estate, int eflags)
 	StringInfo	codegenManagerName = makeStringInfo();
 
 	appendStringInfo(codegenManagerName, "%s-%d-%d", "execProcnode", node->plan_node_id, node->type);
-	void	   *CodegenManager = CodeGeneratorManagerCreate(codegenManagerName->data);
+	void	   *CodegenManager = CodeGeneratorManagerCreate(codegenManagerName->data,
+															ExecCodegenEstimatedRows(node));
 
 	START_CODE_GENERATOR_MANAGER(CodegenManager);
 	{
@@ -545,6 +596,30 @@ ExecInitNode(Plan *node, EState *estate, int eflags)
 			{
 			result = (PlanState *) ExecInitHashJoin((HashJoin *) node,
 													estate, eflags);
+			/*
+			 * Enroll hash value computation of both sides, and the bucket
+			 * scan, in codegen_manager. The hash keys of the inner side
+			 * are only known once the HashJoin node is initialized, so we
+			 * enroll them here rather than under T_Hash.
+			 */
+#ifdef USE_CODEGEN
+			if (NULL != result)
+			{
+			  HashJoinState *hjstate = (HashJoinState *) result;
+			  HashState *hashstate = (HashState *) innerPlanState(hjstate);
+			  enroll_ExecHashGetHashValue_codegen(ExecHashGetHashValue,
+			        &hashstate->ExecHashGetHashValue_gen_info.ExecHashGetHashValue_fn,
+			        hashstate, hashstate->hashkeys, hjstate->hj_HashOperators,
+			        false, hashstate->ps.ps_ExprContext);
+			  enroll_ExecHashGetHashValue_codegen(ExecHashGetHashValue,
+			        &hjstate->ExecHashGetHashValue_gen_info.ExecHashGetHashValue_fn,
+			        hjstate, hjstate->hj_OuterHashKeys, hjstate->hj_HashOperators,
+			        true, hjstate->js.ps.ps_ExprContext);
+			  enroll_ExecScanHashBucket_codegen(ExecScanHashBucket,
+			        &hjstate->ExecScanHashBucket_gen_info.ExecScanHashBucket_fn,
+			        hjstate);
+			}
+#endif
 			}
 			END_MEMORY_ACCOUNT();
 			break;
@@ -676,6 +751,22 @@ ExecInitNode(Plan *node, EState *estate, int eflags)
 			{
 			result = (PlanState *) ExecInitMotion((Motion *) node,
 												  estate, eflags);
+			/*
+			 * Enroll hash key evaluation of redistribute motion senders
+			 * in codegen_manager
+			 */
+			if (NULL != result)
+			{
+			  MotionState *motionstate = (MotionState *) result;
+			  Motion	 *motion = (Motion *) node;
+			  if (motionstate->mstype == MOTIONSTATE_SEND &&
+			      motion->motionType == MOTIONTYPE_HASH)
+			  {
+			    enroll_EvalHashKey_codegen(evalHashKey,
+			          &motionstate->EvalHashKey_gen_info.EvalHashKey_fn,
+			          motionstate, motion->hashDataTypes);
+			  }
+			}
 			}
 			END_MEMORY_ACCOUNT();
 			break;
@@ -805,6 +896,8 @@ ExecInitNode(Plan *node, EState *estate, int eflags)
 			if (!isExplainCodegenOnMaster)
 			{
 				(void) CodeGeneratorManagerPrepareGeneratedFunctions(CodegenManager);
+				result->CodegenPending = true;
+				ExecPollGeneratedCode(result);
 			}
 		}
 	}
@@ -955,6 +1048,8 @@ ExecProcNode(PlanState *node)
 
 	CHECK_FOR_INTERRUPTS();
 
+	ExecPollGeneratedCode(node);
+
 	/*
 	 * Even if we are requested to finish query, Motion has to do its work
 	 * to tell End of Stream message to upper slice.  He will probably get
@@ -1210,6 +1305,8 @@ MultiExecProcNode(PlanState *node)
 
 	Assert(NULL != node->plan);
 
+	ExecPollGeneratedCode(node);
+
 	START_MEMORY_ACCOUNT(node->plan->memoryAccountId);
 	{
 		PG_TRACE5(execprocnode__enter, Gp_segment, currentSliceId, nodeTag(node), node->plan->plan_node_id, node->plan->plan_parent_node_id);
@@ -27,6 +27,8 @@ InstrAlloc(int n)
 
 	/* we don't need to do any initialization except zero 'em */
 	instr->numPartScanned = 0;
+	instr->codegenCacheHits = 0;
+	instr->codegenCacheMisses = 0;
 
 	return instr;
 }
@@ -26,6 +26,7 @@
 #include <limits.h>
 
 #include "access/hash.h"
+#include "codegen/codegen_wrapper.h"
 #include "commands/tablespace.h"
 #include "executor/execdebug.h"
 #include "executor/hashjoin.h"
@@ -130,8 +131,9 @@ MultiExecHash(HashState *node)
 		econtext->ecxt_innertuple = slot;
 		bool hashkeys_null = false;
 
-		if (ExecHashGetHashValue(node, hashtable, econtext, hashkeys, false,
-								 node->hs_keepnull, &hashvalue, &hashkeys_null))
+		if (call_ExecHashGetHashValue(node, node, hashtable, econtext, hashkeys,
+									  false, node->hs_keepnull, &hashvalue,
+									  &hashkeys_null))
 		{
 			ExecHashTableInsert(node, hashtable, slot, hashvalue);
 		}
@@ -16,6 +16,7 @@
 
 #include "postgres.h"
 
+#include "codegen/codegen_wrapper.h"
 #include "executor/executor.h"
 #include "executor/hashjoin.h"
 #include "executor/instrument.h"	/* Instrumentation */
@@ -345,7 +346,7 @@ ExecHashJoin(HashJoinState *node)
 				break;		/* loop around for a new outer tuple */
 			}
 
-			curtuple = ExecScanHashBucket(hashNode, node, econtext);
+			curtuple = call_ExecScanHashBucket(hashNode, node, econtext);
 			if (curtuple == NULL)
 				break;			/* out of matches */
 
@@ -727,12 +728,12 @@ ExecHashJoinOuterGetTuple(PlanState *outerNode,
 					(hjstate->js.jointype == JOIN_LASJ) ||
 					(hjstate->js.jointype == JOIN_LASJ_NOTIN) ||
 					hjstate->hj_nonequijoin;
-			if (ExecHashGetHashValue(hashState, hashtable, econtext,
-									 hjstate->hj_OuterHashKeys,
-									 true,		/* outer tuple */
-									 keep_nulls,
-									 hashvalue,
-									 &hashkeys_null))
+			if (call_ExecHashGetHashValue(hjstate, hashState, hashtable, econtext,
+										  hjstate->hj_OuterHashKeys,
+										  true,		/* outer tuple */
+										  keep_nulls,
+										  hashvalue,
+										  &hashkeys_null))
 			{
 				/* remember outer relation is not empty for possible rescan */
 				hjstate->hj_OuterNotEmpty = true;
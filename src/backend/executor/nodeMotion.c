@@ -17,6 +17,7 @@
 #include "cdb/cdbutil.h"
 #include "cdb/cdbvars.h"
 #include "cdb/cdbhash.h"
+#include "codegen/codegen_wrapper.h"
 #include "executor/executor.h"
 #include "executor/execdebug.h"
 #include "executor/nodeMotion.h"
@@ -113,7 +114,6 @@ static void execMotionSortedReceiverFirstTime(MotionState * node);
 
 static int
 CdbMergeComparator(void *lhs, void *rhs, void *context);
-static uint32 evalHashKey(ExprContext *econtext, List *hashkeys, List *hashtypes, CdbHash * h);
 
 static void doSendEndOfStream(Motion * motion, MotionState * node);
 static void doSendTuple(Motion * motion, MotionState * node, TupleTableSlot *outerTupleSlot);
@@ -1534,7 +1534,7 @@ doSendTuple(Motion * motion, MotionState * node, TupleTableSlot *outerTupleSlot)
 
 		Assert(node->cdbhash->numsegs == motion->numOutputSegs);
 		
-		hval = evalHashKey(econtext, node->hashExpr,
+		hval = call_EvalHashKey(node, econtext, node->hashExpr,
 				motion->hashDataTypes, node->cdbhash);
 
 		Assert(hval < getgpsegmentCount() && "redistribute destination outside segment array");
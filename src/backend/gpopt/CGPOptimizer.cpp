@@ -15,6 +15,7 @@
 
 #include "gpopt/CGPOptimizer.h"
 #include "gpopt/utils/COptTasks.h"
+#include "gpopt/gpdbwrappers.h"
 
 // the following headers are needed to reference optimizer library initializers
 #include "naucrates/init.h"
@@ -127,9 +128,17 @@ CGPOptimizer::InitGPOPT ()
 {
   // Use GPORCA's default allocators
   struct gpos_init_params params = { NULL, NULL };
+
+  // the worker threads that gpos starts leave the backend's signals to it
+  gpdb::BlockThreadSignals(true);
   gpos_init(&params);
+  gpdb::BlockThreadSignals(false);
+
   gpdxl_init();
   gpopt_init();
+
+  // only this thread may call into GPDB, not the optimizer's worker threads
+  gpdb::SetBackendThread();
 }
 
 //---------------------------------------------------------------------------
@@ -30,8 +30,23 @@
 
 #include "gpopt/gpdbwrappers.h"
 
+#include <pthread.h>
+
+// GPDB functions are not thread-safe, and may only be called from the thread
+// of the backend. When optimizing with several worker threads, calls from the
+// other threads are refused, and recorded so that the optimization can be
+// retried serially.
+static bool gpdb_backend_thread_set = false;
+static pthread_t gpdb_backend_thread;
+static volatile bool gpdb_call_refused = false;
+
 #define GP_WRAP_START	\
 	sigjmp_buf local_sigjmp_buf;	\
+	if (gpdb_backend_thread_set && !pthread_equal(pthread_self(), gpdb_backend_thread))	\
+	{	\
+		gpdb_call_refused = true;	\
+		GPOS_RAISE(gpdxl::ExmaGPDB, gpdxl::ExmiGPDBError);	\
+	}	\
 	{	\
 		CAutoExceptionStack aes((void **) &PG_exception_stack, (void**) &error_context_stack);	\
 		if (0 == sigsetjmp(local_sigjmp_buf, 0))	\
@@ -48,6 +63,57 @@
 
 using namespace gpos;
 
+// Partition metadata of a partitioned table: its logical indexes and its part
+// constraints. Building either reads the catalog entries of every leaf
+// partition, and the relcache translator asks for them for the table and
+// again for every index on it. While partition metadata caching is on, for
+// the duration of an optimization, they are built once per root.
+typedef struct PartMetadataEntry
+{
+	Oid			rootOid;		/* hash key */
+	bool		fLogicalIndexes;
+	LogicalIndexes *plgidx;
+	bool		fPartConstraints;
+	Node	   *pnodePartCnstr;
+	List	   *plDefaultLevels;
+} PartMetadataEntry;
+
+// memory context of the partition metadata cache, NULL when caching is off
+static MemoryContext part_metadata_context = NULL;
+static HTAB *part_metadata_cache = NULL;
+
+// Return the cache entry of a partitioned table, creating it if needed
+static PartMetadataEntry *
+part_metadata_entry(Oid rootOid)
+{
+	bool		found;
+	PartMetadataEntry *entry;
+
+	if (NULL == part_metadata_cache)
+	{
+		HASHCTL		ctl;
+
+		MemSet(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(Oid);
+		ctl.entrysize = sizeof(PartMetadataEntry);
+		ctl.hash = oid_hash;
+		ctl.hcxt = part_metadata_context;
+		part_metadata_cache = hash_create("ORCA partition metadata", 64, &ctl,
+										  HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT);
+	}
+
+	entry = (PartMetadataEntry *) hash_search(part_metadata_cache, &rootOid, HASH_ENTER, &found);
+	if (!found)
+	{
+		entry->fLogicalIndexes = false;
+		entry->plgidx = NULL;
+		entry->fPartConstraints = false;
+		entry->pnodePartCnstr = NULL;
+		entry->plDefaultLevels = NIL;
+	}
+	return entry;
+}
+
 bool
 gpdb::FBoolFromDatum
 	(
@@ -997,7 +1063,31 @@ gpdb::PnodePartConstraintRel
 	GP_WRAP_START;
 	{
 		/* catalog tables: pg_partition, pg_partition_rule, pg_constraint */
-		return get_relation_part_constraints(oidRel, pplDefaultLevels);
+		if (NULL == part_metadata_context)
+		{
+			return get_relation_part_constraints(oidRel, pplDefaultLevels);
+		}
+
+		PartMetadataEntry *entry = part_metadata_entry(oidRel);
+		if (!entry->fPartConstraints)
+		{
+			MemoryContext oldcxt = MemoryContextSwitchTo(part_metadata_context);
+			PG_TRY();
+			{
+				entry->plDefaultLevels = NIL;
+				entry->pnodePartCnstr = get_relation_part_constraints(oidRel, &entry->plDefaultLevels);
+			}
+			PG_CATCH();
+			{
+				MemoryContextSwitchTo(oldcxt);
+				PG_RE_THROW();
+			}
+			PG_END_TRY();
+			MemoryContextSwitchTo(oldcxt);
+			entry->fPartConstraints = true;
+		}
+		*pplDefaultLevels = entry->plDefaultLevels;
+		return entry->pnodePartCnstr;
 	}
 	GP_WRAP_END;
 	return NULL;
@@ -2319,7 +2409,29 @@ gpdb::Plgidx
 	GP_WRAP_START;
 	{
 		/* catalog tables: pg_partition, pg_partition_rule, pg_index */
-		return BuildLogicalIndexInfo(oid);
+		if (NULL == part_metadata_context)
+		{
+			return BuildLogicalIndexInfo(oid);
+		}
+
+		PartMetadataEntry *entry = part_metadata_entry(oid);
+		if (!entry->fLogicalIndexes)
+		{
+			MemoryContext oldcxt = MemoryContextSwitchTo(part_metadata_context);
+			PG_TRY();
+			{
+				entry->plgidx = BuildLogicalIndexInfo(oid);
+			}
+			PG_CATCH();
+			{
+				MemoryContextSwitchTo(oldcxt);
+				PG_RE_THROW();
+			}
+			PG_END_TRY();
+			MemoryContextSwitchTo(oldcxt);
+			entry->fLogicalIndexes = true;
+		}
+		return entry->plgidx;
 	}
 	GP_WRAP_END;
 	return NULL;
@@ -2837,16 +2949,25 @@ gpdb::UlLeafPartitions
 }
 
 /*
- * To detect changes to catalog tables that require resetting the Metadata
+ * To detect changes to catalog tables that require invalidating the Metadata
  * Cache, we use the normal PostgreSQL catalog cache invalidation mechanism.
  * We register a callback to a cache on all the catalog tables that contain
  * information that's contained in the ORCA metadata cache.
-
- * There is no fine-grained mechanism in the metadata cache for invalidating
- * individual entries ATM, so we just blow the whole cache whenever anything
- * changes. The callback simply increments a counter. Whenever we start
- * planning a query, we check the counter to see if it has changed since the
- * last planned query, and reset the whole cache if it has.
+ *
+ * Every object loaded into the metadata cache is recorded in a registry,
+ * together with its kind and the relation it belongs to (see MDCacheEntry).
+ * The callbacks only remember what changed: the relcache callback remembers
+ * the relation, and a syscache callback remembers the kinds of objects that
+ * are built from that catalog table, since it is not told which object
+ * changed. Whenever we start planning a query, the matching entries are
+ * removed from the registry and evicted from the metadata cache. Objects of
+ * other kinds, and objects of other relations, stay cached. The catalog
+ * caches and the kinds built from them are listed in mdsharedcache.c, which
+ * invalidates the shared metadata cache on the sending side, once per change.
+ *
+ * The whole cache is still reset when a relcache invalidation is not for a
+ * specific relation (e.g. after a shared invalidation queue overflow), or
+ * when too many relations have been invalidated between two queries.
  *
  * To make sure we've covered all catalog tables that contain information
  * that's stored in the metadata cache, there are "catalog tables: xxx"
@@ -2855,91 +2976,97 @@ gpdb::UlLeafPartitions
  * anything fetched via the wrapper functions in this file can end up in the
  * metadata cache and hence need to have an invalidation callback registered.
  */
-static bool mdcache_invalidation_counter_registered = false;
-static int64 mdcache_invalidation_counter = 0;
-static int64 last_mdcache_invalidation_counter = 0;
+#define MDCACHE_MAX_INVALIDATED_RELIDS	256
+
+static bool mdcache_invalidation_callbacks_registered = false;
+static bool mdcache_needs_reset = false;
+static int	mdcache_invalidated_kinds = 0;
+static Oid	mdcache_invalidated_relids[MDCACHE_MAX_INVALIDATED_RELIDS];
+static int	mdcache_num_invalidated_relids = 0;
+
+/* registry of the objects in the metadata cache, keyed by MDCacheEntry */
+static HTAB *mdcache_entries = NULL;
 
 static void
-mdsyscache_invalidation_counter_callback(Datum arg, int cacheid,  ItemPointer tuplePtr)
+mdsyscache_invalidation_callback(Datum arg, int cacheid,  ItemPointer tuplePtr)
 {
-	mdcache_invalidation_counter++;
+	int			i;
+
+	for (i = 0; i < MDCacheNumSyscaches; i++)
+	{
+		if (MDCacheSyscaches[i].cacheid == cacheid)
+			mdcache_invalidated_kinds |= MDCacheSyscaches[i].kinds;
+	}
 }
 
 static void
-mdrelcache_invalidation_counter_callback(Datum arg, Oid relid)
+mdrelcache_invalidation_callback(Datum arg, Oid relid)
 {
-	mdcache_invalidation_counter++;
+	int			i;
+
+	if (!OidIsValid(relid))
+	{
+		/* all relations have been invalidated */
+		mdcache_needs_reset = true;
+		return;
+	}
+
+	for (i = 0; i < mdcache_num_invalidated_relids; i++)
+	{
+		if (mdcache_invalidated_relids[i] == relid)
+			return;
+	}
+
+	if (mdcache_num_invalidated_relids >= MDCACHE_MAX_INVALIDATED_RELIDS)
+	{
+		mdcache_needs_reset = true;
+		return;
+	}
+	mdcache_invalidated_relids[mdcache_num_invalidated_relids++] = relid;
 }
 
 static void
 register_mdcache_invalidation_callbacks(void)
 {
-	/* These are all the catalog tables that we care about. */
-	int			metadata_caches[] = {
-		AGGFNOID,			/* pg_aggregate */
-		AMOPOPID,			/* pg_amop */
-		CASTSOURCETARGET,	/* pg_cast */
-		CONSTROID,			/* pg_constraint */
-		OPEROID,			/* pg_operator */
-		OPFAMILYOID,		/* pg_opfamily */
-		PARTOID,			/* pg_partition */
-		PARTRULEOID,		/* pg_partition_rule */
-		STATRELATT,			/* pg_statistics */
-		TYPEOID,			/* pg_type */
-		PROCOID,			/* pg_proc */
-
-		/*
-		 * lookup_type_cache() will also access pg_opclass, via GetDefaultOpClass(),
-		 * but there is no syscache for it. Postgres doesn't seem to worry about
-		 * invalidating the type cache on updates to pg_opclass, so we don't
-		 * worry about that either.
-		 */
-		/* pg_opclass */
-
-		/*
-		 * Information from the following catalogs are included in the
-		 * relcache, and any updates will generate relcache invalidation
-		 * event. We'll catch the relcache invalidation event and don't need
-		 * to register a catcache callback for them.
-		 */
-		/* pg_class */
-		/* pg_index */
-		/* pg_trigger */
-
-		/*
-		 * pg_exttable is only updated when a new external table is dropped/created,
-		 * which will trigger a relcache invalidation event.
-		 */
-		/* pg_exttable */
-
-		/*
-		 * XXX: no syscache on pg_inherits. Is that OK? For any partitioning
-		 * changes, I think there will also be updates on pg_partition and/or
-		 * pg_partition_rules.
-		 */
-		/* pg_inherits */
-
-		/*
-		 * We assume that gp_segment_config will not change on the fly in a way that
-		 * would affect ORCA
-		 */
-		/* gp_segment_config */
-	};
-	unsigned int i;
-
-	for (i = 0; i < lengthof(metadata_caches); i++)
-	{
-		CacheRegisterSyscacheCallback(metadata_caches[i],
-									  &mdsyscache_invalidation_counter_callback,
+	int			i;
+
+	if (mdcache_invalidation_callbacks_registered)
+		return;
+	mdcache_invalidation_callbacks_registered = true;
+
+	for (i = 0; i < MDCacheNumSyscaches; i++)
+	{
+		CacheRegisterSyscacheCallback(MDCacheSyscaches[i].cacheid,
+									  &mdsyscache_invalidation_callback,
 									  (Datum) 0);
 	}
 
 	/* also register the relcache callback */
-	CacheRegisterRelcacheCallback(&mdrelcache_invalidation_counter_callback,
+	CacheRegisterRelcacheCallback(&mdrelcache_invalidation_callback,
 								  (Datum) 0);
 }
 
-// Has there been any catalog changes since last call?
+static bool
+mdcache_entry_invalidated(const MDCacheEntry *entry)
+{
+	int			i;
+
+	if (0 != (entry->kind & mdcache_invalidated_kinds))
+		return true;
+
+	if (!OidIsValid(entry->relid))
+		return false;
+
+	for (i = 0; i < mdcache_num_invalidated_relids; i++)
+	{
+		if (mdcache_invalidated_relids[i] == entry->relid)
+			return true;
+	}
+	return false;
+}
+
+// Has there been any catalog changes since last call that require resetting
+// the whole metadata cache?
 bool
 gpdb::FMDCacheNeedsReset
 		(
@@ -2948,16 +3075,21 @@ gpdb::FMDCacheNeedsReset
 {
 	GP_WRAP_START;
 	{
-		if (!mdcache_invalidation_counter_registered)
-		{
-			register_mdcache_invalidation_callbacks();
-			mdcache_invalidation_counter_registered = true;
-		}
-		if (last_mdcache_invalidation_counter == mdcache_invalidation_counter)
+		register_mdcache_invalidation_callbacks();
+		if (!mdcache_needs_reset)
 			return false;
 		else
 		{
-			last_mdcache_invalidation_counter = mdcache_invalidation_counter;
+			mdcache_needs_reset = false;
+			mdcache_invalidated_kinds = 0;
+			mdcache_num_invalidated_relids = 0;
+
+			/* the cache is emptied, so is the registry */
+			if (NULL != mdcache_entries)
+			{
+				hash_destroy(mdcache_entries);
+				mdcache_entries = NULL;
+			}
 			return true;
 		}
 	}
@@ -2966,4 +3098,222 @@ gpdb::FMDCacheNeedsReset
 	return true;
 }
 
+// Remove the entries that have been invalidated since the last call from the
+// registry of metadata cache objects, and return them
+List *
+gpdb::PlMDCacheInvalidatedEntries
+		(
+			void
+		)
+{
+	GP_WRAP_START;
+	{
+		List	   *entries = NIL;
+
+		if (NULL != mdcache_entries &&
+			(0 != mdcache_invalidated_kinds || 0 < mdcache_num_invalidated_relids))
+		{
+			HASH_SEQ_STATUS status;
+			MDCacheEntry *entry;
+
+			hash_seq_init(&status, mdcache_entries);
+			while (NULL != (entry = (MDCacheEntry *) hash_seq_search(&status)))
+			{
+				if (mdcache_entry_invalidated(entry))
+				{
+					MDCacheEntry *copy = (MDCacheEntry *) palloc(sizeof(MDCacheEntry));
+
+					*copy = *entry;
+					entries = lappend(entries, copy);
+
+					/* removing the current entry is safe during a scan */
+					hash_search(mdcache_entries, entry, HASH_REMOVE, NULL);
+				}
+			}
+		}
+
+		mdcache_invalidated_kinds = 0;
+		mdcache_num_invalidated_relids = 0;
+		return entries;
+	}
+	GP_WRAP_END;
+
+	return NIL;
+}
+
+// Is the metadata cache shared by all backends?
+bool
+gpdb::FMDSharedCacheEnabled
+		(
+			void
+		)
+{
+	return MDSharedCache_IsEnabled();
+}
+
+// Current invalidation generation of the shared metadata cache
+uint32
+gpdb::UlMDSharedCacheGeneration
+		(
+			void
+		)
+{
+	return MDSharedCache_GetGeneration();
+}
+
+// Look up a serialized object in the shared metadata cache
+char *
+gpdb::SzMDSharedCacheLookup
+		(
+			MDCacheEntry *pentry
+		)
+{
+	GP_WRAP_START;
+	{
+		return MDSharedCache_Lookup(pentry);
+	}
+	GP_WRAP_END;
+
+	return NULL;
+}
+
+// Share a serialized object through the shared metadata cache
+void
+gpdb::MDSharedCacheInsert
+		(
+			const MDCacheEntry *pentry,
+			const char *szObject,
+			uint32 ulGeneration
+		)
+{
+	GP_WRAP_START;
+	{
+		MDSharedCache_Insert(pentry, szObject, ulGeneration);
+		return;
+	}
+	GP_WRAP_END;
+}
+
+// Record an object loaded into the metadata cache
+void
+gpdb::MDCacheRecordEntry
+		(
+			const MDCacheEntry *pentry
+		)
+{
+	GP_WRAP_START;
+	{
+		if (NULL == mdcache_entries)
+		{
+			HASHCTL		ctl;
+
+			MemSet(&ctl, 0, sizeof(ctl));
+			ctl.keysize = sizeof(MDCacheEntry);
+			ctl.entrysize = sizeof(MDCacheEntry);
+			ctl.hash = tag_hash;
+			mdcache_entries = hash_create("ORCA metadata cache entries", 256, &ctl,
+										  HASH_ELEM | HASH_FUNCTION);
+		}
+		hash_search(mdcache_entries, pentry, HASH_ENTER, NULL);
+		return;
+	}
+	GP_WRAP_END;
+}
+
+// Record the calling thread as the only one allowed to call GPDB functions
+void
+gpdb::SetBackendThread
+		(
+			void
+		)
+{
+	gpdb_backend_thread = pthread_self();
+	gpdb_backend_thread_set = true;
+}
+
+// Has a GPDB function been called from another thread since the last call?
+bool
+gpdb::FCallFromWorkerRefused
+		(
+			void
+		)
+{
+	bool fRefused = gpdb_call_refused;
+	gpdb_call_refused = false;
+
+	return fRefused;
+}
+
+// Block the backend's signals in the calling thread, or unblock them again,
+// so that the worker threads started in between leave them to the backend
+void
+gpdb::BlockThreadSignals
+		(
+			bool fBlock
+		)
+{
+	gp_block_thread_signals(fBlock);
+}
+
+// Limit on active statements of the resource queue of the current role, or
+// -1 if the number of active statements is not limited
+int
+gpdb::IResQueueActiveStatementsLimit
+		(
+			void
+		)
+{
+	GP_WRAP_START;
+	{
+		return GetResQueueActiveStatementsLimit();
+	}
+	GP_WRAP_END;
+
+	return -1;
+}
+
+// Start caching the partition metadata of partitioned tables. Results of
+// Plgidx and PnodePartConstraintRel are then owned by the cache, and must not
+// be freed by the caller.
+void
+gpdb::BeginPartMetadataCaching
+		(
+			void
+		)
+{
+	GP_WRAP_START;
+	{
+		if (NULL == part_metadata_context)
+		{
+			part_metadata_context = AllocSetContextCreate(TopMemoryContext,
+														  "ORCA partition metadata",
+														  ALLOCSET_DEFAULT_MINSIZE,
+														  ALLOCSET_DEFAULT_INITSIZE,
+														  ALLOCSET_DEFAULT_MAXSIZE);
+		}
+		return;
+	}
+	GP_WRAP_END;
+}
+
+// Stop caching partition metadata, and drop the cached results
+void
+gpdb::EndPartMetadataCaching
+		(
+			void
+		)
+{
+	GP_WRAP_START;
+	{
+		if (NULL != part_metadata_context)
+		{
+			MemoryContextDelete(part_metadata_context);
+			part_metadata_context = NULL;
+			part_metadata_cache = NULL;
+		}
+		return;
+	}
+	GP_WRAP_END;
+}
+
 // EOF
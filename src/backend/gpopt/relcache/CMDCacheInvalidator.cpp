@@ -0,0 +1,294 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2016 Pivotal Software, Inc.
+//
+//	@filename:
+//		CMDCacheInvalidator.cpp
+//
+//	@doc:
+//		Implementation of the per-object invalidation of the metadata cache
+//
+//	@test:
+//
+//
+//---------------------------------------------------------------------------
+
+#include "postgres.h"
+#include "nodes/pg_list.h"
+
+#include "gpopt/relcache/CMDCacheInvalidator.h"
+#include "gpopt/mdcache/CMDAccessor.h"
+#include "gpopt/mdcache/CMDCache.h"
+#include "gpopt/mdcache/CMDKey.h"
+#include "gpopt/gpdbwrappers.h"
+
+#include "gpos/memory/CCacheAccessor.h"
+
+#include "naucrates/md/CMDIdGPDB.h"
+#include "naucrates/md/CMDIdRelStats.h"
+#include "naucrates/md/CMDIdColStats.h"
+#include "naucrates/md/CMDIdCast.h"
+#include "naucrates/md/CMDIdScCmp.h"
+#include "naucrates/md/IMDCheckConstraint.h"
+#include "naucrates/md/IMDTrigger.h"
+
+using namespace gpos;
+using namespace gpmd;
+using namespace gpopt;
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCacheInvalidator::FInitEntry
+//
+//	@doc:
+//		Initialize the identity of the entry describing the object with the
+//		given mdid. Returns false if the object is not loaded from the relcache.
+//
+//---------------------------------------------------------------------------
+BOOL
+CMDCacheInvalidator::FInitEntry
+	(
+	const IMDId *pmdid,
+	MDCacheEntry *pentry
+	)
+{
+	GPOS_ASSERT(NULL != pmdid);
+	GPOS_ASSERT(NULL != pentry);
+
+	pentry->mdidtype = pmdid->Emdidt();
+	pentry->oids[0] = InvalidOid;
+	pentry->oids[1] = InvalidOid;
+	pentry->aux = 0;
+	pentry->kind = 0;
+	pentry->relid = InvalidOid;
+
+	switch (pmdid->Emdidt())
+	{
+		case IMDId::EmdidGPDB:
+			pentry->oids[0] = CMDIdGPDB::PmdidConvert(const_cast<IMDId *>(pmdid))->OidObjectId();
+			return true;
+
+		case IMDId::EmdidRelStats:
+			pentry->oids[0] = CMDIdGPDB::PmdidConvert(CMDIdRelStats::PmdidConvert(const_cast<IMDId *>(pmdid))->PmdidRel())->OidObjectId();
+			return true;
+
+		case IMDId::EmdidColStats:
+		{
+			CMDIdColStats *pmdidColStats = CMDIdColStats::PmdidConvert(const_cast<IMDId *>(pmdid));
+			pentry->oids[0] = CMDIdGPDB::PmdidConvert(pmdidColStats->PmdidRel())->OidObjectId();
+			pentry->aux = pmdidColStats->UlPos();
+			return true;
+		}
+
+		case IMDId::EmdidCastFunc:
+		{
+			CMDIdCast *pmdidCast = CMDIdCast::PmdidConvert(const_cast<IMDId *>(pmdid));
+			pentry->oids[0] = CMDIdGPDB::PmdidConvert(pmdidCast->PmdidSrc())->OidObjectId();
+			pentry->oids[1] = CMDIdGPDB::PmdidConvert(pmdidCast->PmdidDest())->OidObjectId();
+			return true;
+		}
+
+		case IMDId::EmdidScCmp:
+		{
+			CMDIdScCmp *pmdidScCmp = CMDIdScCmp::PmdidConvert(const_cast<IMDId *>(pmdid));
+			pentry->oids[0] = CMDIdGPDB::PmdidConvert(pmdidScCmp->PmdidLeft())->OidObjectId();
+			pentry->oids[1] = CMDIdGPDB::PmdidConvert(pmdidScCmp->PmdidRight())->OidObjectId();
+			pentry->aux = pmdidScCmp->Ecmpt();
+			return true;
+		}
+
+		default:
+			// not loaded from the relcache
+			return false;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCacheInvalidator::SetObjectKind
+//
+//	@doc:
+//		Fill in the kind of the object, and the relation it belongs to, which
+//		determine the catalog changes that invalidate it
+//
+//---------------------------------------------------------------------------
+void
+CMDCacheInvalidator::SetObjectKind
+	(
+	const IMDCacheObject *pimdobj,
+	MDCacheEntry *pentry
+	)
+{
+	GPOS_ASSERT(NULL != pimdobj);
+	GPOS_ASSERT(NULL != pentry);
+
+	switch (pimdobj->Emdt())
+	{
+		case IMDCacheObject::EmdtRel:
+			pentry->kind = MDCACHE_RELATION;
+			pentry->relid = pentry->oids[0];
+			break;
+
+		case IMDCacheObject::EmdtInd:
+			pentry->kind = MDCACHE_INDEX;
+			pentry->relid = pentry->oids[0];
+			break;
+
+		case IMDCacheObject::EmdtType:
+			pentry->kind = MDCACHE_TYPE;
+			break;
+
+		case IMDCacheObject::EmdtOp:
+			pentry->kind = MDCACHE_OPERATOR;
+			break;
+
+		case IMDCacheObject::EmdtFunc:
+			pentry->kind = MDCACHE_FUNCTION;
+			break;
+
+		case IMDCacheObject::EmdtAgg:
+			pentry->kind = MDCACHE_AGGREGATE;
+			break;
+
+		case IMDCacheObject::EmdtTrigger:
+			// pg_trigger changes come as relcache invalidations of the relation
+			pentry->kind = MDCACHE_TRIGGER;
+			pentry->relid = CMDIdGPDB::PmdidConvert(dynamic_cast<const IMDTrigger *>(pimdobj)->PmdidRel())->OidObjectId();
+			break;
+
+		case IMDCacheObject::EmdtCheckConstraint:
+			pentry->kind = MDCACHE_CHECK_CONSTRAINT;
+			pentry->relid = CMDIdGPDB::PmdidConvert(dynamic_cast<const IMDCheckConstraint *>(pimdobj)->PmdidRel())->OidObjectId();
+			break;
+
+		case IMDCacheObject::EmdtRelStats:
+			pentry->kind = MDCACHE_REL_STATS;
+			pentry->relid = pentry->oids[0];
+			break;
+
+		case IMDCacheObject::EmdtColStats:
+			pentry->kind = MDCACHE_COL_STATS;
+			pentry->relid = pentry->oids[0];
+			break;
+
+		case IMDCacheObject::EmdtCastFunc:
+			pentry->kind = MDCACHE_CAST;
+			break;
+
+		case IMDCacheObject::EmdtScCmp:
+			pentry->kind = MDCACHE_SCALAR_CMP;
+			break;
+
+		default:
+			GPOS_ASSERT(!"Unexpected metadata object type");
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCacheInvalidator::RecordObject
+//
+//	@doc:
+//		Record an object loaded from the relcache, so that it can be evicted
+//		when the catalog tables it was built from change
+//
+//---------------------------------------------------------------------------
+void
+CMDCacheInvalidator::RecordObject
+	(
+	const MDCacheEntry *pentry
+	)
+{
+	GPOS_ASSERT(NULL != pentry);
+
+	gpdb::MDCacheRecordEntry(pentry);
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCacheInvalidator::PmdidCacheKey
+//
+//	@doc:
+//		Rebuild the mdid used as the cache key of a recorded entry
+//
+//---------------------------------------------------------------------------
+IMDId *
+CMDCacheInvalidator::PmdidCacheKey
+	(
+	IMemoryPool *pmp,
+	const MDCacheEntry *pentry
+	)
+{
+	switch (pentry->mdidtype)
+	{
+		case IMDId::EmdidGPDB:
+			return GPOS_NEW(pmp) CMDIdGPDB(pentry->oids[0]);
+
+		case IMDId::EmdidRelStats:
+			return GPOS_NEW(pmp) CMDIdRelStats(GPOS_NEW(pmp) CMDIdGPDB(pentry->oids[0]));
+
+		case IMDId::EmdidColStats:
+			return GPOS_NEW(pmp) CMDIdColStats(GPOS_NEW(pmp) CMDIdGPDB(pentry->oids[0]), pentry->aux);
+
+		case IMDId::EmdidCastFunc:
+			return GPOS_NEW(pmp) CMDIdCast(GPOS_NEW(pmp) CMDIdGPDB(pentry->oids[0]), GPOS_NEW(pmp) CMDIdGPDB(pentry->oids[1]));
+
+		case IMDId::EmdidScCmp:
+			return GPOS_NEW(pmp) CMDIdScCmp
+						(
+						GPOS_NEW(pmp) CMDIdGPDB(pentry->oids[0]),
+						GPOS_NEW(pmp) CMDIdGPDB(pentry->oids[1]),
+						(IMDType::ECmpType) pentry->aux
+						);
+
+		default:
+			GPOS_ASSERT(!"Unexpected mdid type");
+			return NULL;
+	}
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CMDCacheInvalidator::EvictInvalidatedObjects
+//
+//	@doc:
+//		Evict the objects whose catalog entries have changed since the last
+//		call from the metadata cache. Other objects stay cached.
+//
+//---------------------------------------------------------------------------
+void
+CMDCacheInvalidator::EvictInvalidatedObjects
+	(
+	IMemoryPool *pmp
+	)
+{
+	GPOS_ASSERT(CMDCache::FInitialized());
+
+	List *plEntries = gpdb::PlMDCacheInvalidatedEntries();
+
+	ListCell *plc = NULL;
+	ForEach (plc, plEntries)
+	{
+		MDCacheEntry *pentry = (MDCacheEntry *) lfirst(plc);
+		IMDId *pmdid = PmdidCacheKey(pmp, pentry);
+		if (NULL == pmdid)
+		{
+			continue;
+		}
+
+		{
+			// the entry is deleted once the last accessor releases it
+			CMDKey mdkey(pmdid);
+			CCacheAccessor<IMDCacheObject*, CMDKey*> cacheacc(CMDCache::Pcache());
+			if (NULL != cacheacc.PtLookup(&mdkey))
+			{
+				cacheacc.MarkForDeletion();
+			}
+		}
+		pmdid->Release();
+	}
+
+	gpdb::FreeListDeep(plEntries);
+}
+
+// EOF
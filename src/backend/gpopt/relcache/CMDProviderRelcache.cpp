@@ -16,13 +16,18 @@
 
 #include "postgres.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
+#include "gpopt/relcache/CMDCacheInvalidator.h"
 #include "gpopt/translate/CTranslatorRelcacheToDXL.h"
+#include "gpopt/translate/CTranslatorUtils.h"
+#include "gpopt/gpdbwrappers.h"
 #include "gpopt/mdcache/CMDAccessor.h"
 
 #include "naucrates/dxl/CDXLUtils.h"
 
 #include "naucrates/exception.h"
 
+#include "gpos/common/CWallClock.h"
+
 using namespace gpos;
 using namespace gpdxl;
 using namespace gpmd;
@@ -40,7 +45,10 @@ CMDProviderRelcache::CMDProviderRelcache
 	IMemoryPool *pmp
 	)
 	:
-	m_pmp(pmp)
+	m_pmp(pmp),
+	m_ulTranslated(0),
+	m_ulSharedHits(0),
+	m_ullFetchUs(0)
 {
 	GPOS_ASSERT(NULL != m_pmp);
 }
@@ -62,15 +70,56 @@ CMDProviderRelcache::PstrObject
 	)
 	const
 {
+	CWallClock clock;
+	MDCacheEntry entry;
+	BOOL fShared = gpdb::FMDSharedCacheEnabled() && CMDCacheInvalidator::FInitEntry(pmdid, &entry);
+	uint32 ulGeneration = 0;
+
+	if (fShared)
+	{
+		// another backend may have translated the object already
+		CHAR *sz = gpdb::SzMDSharedCacheLookup(&entry);
+		if (NULL != sz)
+		{
+			CWStringDynamic *pstr = CDXLUtils::PstrFromSz(m_pmp, sz);
+			gpdb::GPDBFree(sz);
+
+			CMDCacheInvalidator::RecordObject(&entry);
+
+			m_ulSharedHits++;
+			m_ullFetchUs += clock.UlElapsedUS();
+			return pstr;
+		}
+
+		// taken before reading the catalog, see MDSharedCache_Insert
+		ulGeneration = gpdb::UlMDSharedCacheGeneration();
+	}
+
 	IMDCacheObject *pimdobj = CTranslatorRelcacheToDXL::Pimdobj(pmp, pmda, pmdid);
 
 	GPOS_ASSERT(NULL != pimdobj);
 
+	// the object ends up in the metadata cache, remember it for invalidation
+	if (fShared || CMDCacheInvalidator::FInitEntry(pmdid, &entry))
+	{
+		CMDCacheInvalidator::SetObjectKind(pimdobj, &entry);
+		CMDCacheInvalidator::RecordObject(&entry);
+	}
+
 	CWStringDynamic *pstr = CDXLUtils::PstrSerializeMDObj(m_pmp, pimdobj, true /*fSerializeHeaders*/, false /*findent*/);
 
 	// cleanup DXL object
 	pimdobj->Release();
 
+	if (fShared)
+	{
+		CHAR *sz = CTranslatorUtils::SzFromWsz(pstr->Wsz());
+		gpdb::MDSharedCacheInsert(&entry, sz, ulGeneration);
+		gpdb::GPDBFree(sz);
+	}
+
+	m_ulTranslated++;
+	m_ullFetchUs += clock.UlElapsedUS();
 	return pstr;
 }
 
@@ -21,6 +21,7 @@
 #include "nodes/plannodes.h"
 
 #include "gpopt/translate/CContextDXLToPlStmt.h"
+#include "gpopt/translate/CTranslatorUtils.h"
 #include "gpopt/gpdbwrappers.h"
 #include "gpos/base.h"
 using namespace gpdxl;
@@ -53,11 +54,20 @@ CContextDXLToPlStmt::CContextDXLToPlStmt
 	m_pplSubPlan(plSubPlan),
 	m_ulResultRelation(0),
 	m_pintocl(NULL),
-	m_pdistrpolicy(NULL)
+	m_pdistrpolicy(NULL),
+	m_fProfile(false),
+	m_ullProfileUs(0)
 {
 	m_phmuldxltrctxSharedScan = GPOS_NEW(m_pmp) HMUlDxltrctx(m_pmp);
 	m_phmulcteconsumerinfo = GPOS_NEW(m_pmp) HMUlCTEConsumerInfo(m_pmp);
 	m_pdrgpulNumSelectors = GPOS_NEW(m_pmp) DrgPul(m_pmp);
+
+	for (ULONG ul = 0; ul < EdxlopSentinel; ul++)
+	{
+		m_rgullProfileUs[ul] = 0;
+		m_rgulProfileCount[ul] = 0;
+		m_rgpstrProfileOpName[ul] = NULL;
+	}
 }
 
 //---------------------------------------------------------------------------
@@ -406,4 +416,62 @@ CContextDXLToPlStmt::AddSharedScanTranslationContext
 	GPOS_ASSERT(fInserted);
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CContextDXLToPlStmt::RecordProfile
+//
+//	@doc:
+//		Record the translation of a DXL operator, which took ullElapsedUs,
+//		of which ullChildrenUs were recorded for its children
+//
+//---------------------------------------------------------------------------
+void
+CContextDXLToPlStmt::RecordProfile
+	(
+	const CDXLOperator *pdxlop,
+	ULLONG ullElapsedUs,
+	ULLONG ullChildrenUs
+	)
+{
+	GPOS_ASSERT(m_fProfile);
+
+	ULONG ulOpId = (ULONG) pdxlop->Edxlop();
+	GPOS_ASSERT(EdxlopSentinel > ulOpId);
+
+	ULLONG ullSelfUs = (ullElapsedUs > ullChildrenUs) ? ullElapsedUs - ullChildrenUs : 0;
+	m_rgullProfileUs[ulOpId] += ullSelfUs;
+	m_rgulProfileCount[ulOpId]++;
+	m_rgpstrProfileOpName[ulOpId] = pdxlop->PstrOpName();
+	m_ullProfileUs += ullSelfUs;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CContextDXLToPlStmt::PrintProfile
+//
+//	@doc:
+//		Log the number of translated operators of each kind and the time
+//		spent translating them
+//
+//---------------------------------------------------------------------------
+void
+CContextDXLToPlStmt::PrintProfile() const
+{
+	GPOS_ASSERT(m_fProfile);
+
+	elog(LOG, "[OPT]: DXL to PlStmt translation time: %.3f ms", m_ullProfileUs / 1000.0);
+
+	for (ULONG ul = 0; ul < EdxlopSentinel; ul++)
+	{
+		if (0 == m_rgulProfileCount[ul])
+		{
+			continue;
+		}
+
+		CHAR *szOpName = CTranslatorUtils::SzFromWsz(m_rgpstrProfileOpName[ul]->Wsz());
+		elog(LOG, "[OPT]:   %s: %u operators, %.3f ms", szOpName, m_rgulProfileCount[ul], m_rgullProfileUs[ul] / 1000.0);
+		gpdb::GPDBFree(szOpName);
+	}
+}
+
 // EOF
@@ -18,6 +18,13 @@
 using namespace gpdxl;
 using namespace gpos;
 
+// minimum number of slots of the array of target entries
+#define GPDXL_TRCTX_MIN_SLOTS 64
+
+// maximum number of slots of the array of target entries per mapping; when
+// the ColIds are sparser, the mappings are kept in a hash map
+#define GPDXL_TRCTX_SLOTS_PER_ENTRY 4
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CDXLTranslateContext::CDXLTranslateContext
@@ -33,10 +40,13 @@ CDXLTranslateContext::CDXLTranslateContext
 	)
 	:
 	m_pmp(pmp),
+	m_rgpte(NULL),
+	m_ulColIdFirst(0),
+	m_ulSlots(0),
+	m_ulEntries(0),
+	m_phmulte(NULL),
 	m_fChildAggNode(fChildAggNode)
 {
-	// initialize hash table
-	m_phmulte = GPOS_NEW(m_pmp) HMUlTe(m_pmp);
 	m_phmcolparam = GPOS_NEW(m_pmp) HMColParam(m_pmp);
 }
 
@@ -45,7 +55,8 @@ CDXLTranslateContext::CDXLTranslateContext
 //		CDXLTranslateContext::CDXLTranslateContext
 //
 //	@doc:
-//		Ctor
+//		Ctor. The params hashmap of the parent context is shared, and only
+//		copied when a mapping is inserted in either context
 //
 //---------------------------------------------------------------------------
 CDXLTranslateContext::CDXLTranslateContext
@@ -56,11 +67,16 @@ CDXLTranslateContext::CDXLTranslateContext
 	)
 	:
 	m_pmp(pmp),
+	m_rgpte(NULL),
+	m_ulColIdFirst(0),
+	m_ulSlots(0),
+	m_ulEntries(0),
+	m_phmulte(NULL),
+	m_phmcolparam(phmOriginal),
 	m_fChildAggNode(fChildAggNode)
 {
-	m_phmulte = GPOS_NEW(m_pmp) HMUlTe(m_pmp);
-	m_phmcolparam = GPOS_NEW(m_pmp) HMColParam(m_pmp);
-	CopyParamHashmap(phmOriginal);
+	GPOS_ASSERT(NULL != phmOriginal);
+	m_phmcolparam->AddRef();
 }
 
 //---------------------------------------------------------------------------
@@ -73,7 +89,8 @@ CDXLTranslateContext::CDXLTranslateContext
 //---------------------------------------------------------------------------
 CDXLTranslateContext::~CDXLTranslateContext()
 {
-	m_phmulte->Release();
+	GPOS_DELETE_ARRAY(m_rgpte);
+	CRefCount::SafeRelease(m_phmulte);
 	m_phmcolparam->Release();
 }
 
@@ -133,7 +150,17 @@ CDXLTranslateContext::Pte
 	)
 	const
 {
-	return m_phmulte->PtLookup(&ulColId);
+	if (NULL != m_phmulte)
+	{
+		return m_phmulte->PtLookup(&ulColId);
+	}
+
+	if (ulColId < m_ulColIdFirst || ulColId - m_ulColIdFirst >= m_ulSlots)
+	{
+		return NULL;
+	}
+
+	return m_rgpte[ulColId - m_ulColIdFirst];
 }
 
 //---------------------------------------------------------------------------
@@ -169,6 +196,23 @@ CDXLTranslateContext::InsertMapping
 	TargetEntry *pte
 	)
 {
+	if (NULL == m_phmulte)
+	{
+		GrowMapping(ulColId);
+	}
+
+	if (NULL == m_phmulte)
+	{
+		// like the hash map, keep the first mapping of a ColId
+		TargetEntry **ppte = &m_rgpte[ulColId - m_ulColIdFirst];
+		if (NULL == *ppte)
+		{
+			*ppte = pte;
+			m_ulEntries++;
+		}
+		return;
+	}
+
 	// copy key
 	ULONG *pulKey = GPOS_NEW(m_pmp) ULONG(ulColId);
 
@@ -181,6 +225,106 @@ CDXLTranslateContext::InsertMapping
 	}
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLTranslateContext::GrowMapping
+//
+//	@doc:
+//		Make the array of target entries cover the given ColId, growing it
+//		geometrically. Switch to the hash map if the array would be too
+//		sparse.
+//
+//---------------------------------------------------------------------------
+void
+CDXLTranslateContext::GrowMapping
+	(
+	ULONG ulColId
+	)
+{
+	GPOS_ASSERT(NULL == m_phmulte);
+
+	if (0 < m_ulSlots && m_ulColIdFirst <= ulColId && ulColId - m_ulColIdFirst < m_ulSlots)
+	{
+		return;
+	}
+
+	// range of ColIds the array must cover
+	ULONG ulFirst = ulColId;
+	ULONG ulEnd = ulColId + 1;
+	if (0 < m_ulSlots)
+	{
+		ulFirst = (ulColId < m_ulColIdFirst) ? ulColId : m_ulColIdFirst;
+		ulEnd = (ulEnd < m_ulColIdFirst + m_ulSlots) ? m_ulColIdFirst + m_ulSlots : ulEnd;
+	}
+
+	const ULONG ulMaxSlots = GPDXL_TRCTX_SLOTS_PER_ENTRY * (m_ulEntries + 1) + GPDXL_TRCTX_MIN_SLOTS;
+	const ULONG ulNeeded = ulEnd - ulFirst;
+	if (ulNeeded > ulMaxSlots)
+	{
+		SwitchToHashMap();
+		return;
+	}
+
+	// double the array, within the density limit
+	ULONG ulSlots = 2 * m_ulSlots;
+	if (ulSlots > ulMaxSlots)
+	{
+		ulSlots = ulMaxSlots;
+	}
+	if (ulSlots < ulNeeded)
+	{
+		ulSlots = ulNeeded;
+	}
+	if (ulSlots < GPDXL_TRCTX_MIN_SLOTS)
+	{
+		ulSlots = GPDXL_TRCTX_MIN_SLOTS;
+	}
+
+	TargetEntry **rgpte = GPOS_NEW_ARRAY(m_pmp, TargetEntry *, ulSlots);
+	for (ULONG ul = 0; ul < ulSlots; ul++)
+	{
+		rgpte[ul] = NULL;
+	}
+
+	for (ULONG ul = 0; ul < m_ulSlots; ul++)
+	{
+		rgpte[m_ulColIdFirst - ulFirst + ul] = m_rgpte[ul];
+	}
+
+	GPOS_DELETE_ARRAY(m_rgpte);
+	m_rgpte = rgpte;
+	m_ulColIdFirst = ulFirst;
+	m_ulSlots = ulSlots;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		CDXLTranslateContext::SwitchToHashMap
+//
+//	@doc:
+//		Move the (col id, target entry) mappings from the array to the hash map
+//
+//---------------------------------------------------------------------------
+void
+CDXLTranslateContext::SwitchToHashMap()
+{
+	GPOS_ASSERT(NULL == m_phmulte);
+
+	m_phmulte = GPOS_NEW(m_pmp) HMUlTe(m_pmp);
+	for (ULONG ul = 0; ul < m_ulSlots; ul++)
+	{
+		if (NULL != m_rgpte[ul])
+		{
+			ULONG *pulKey = GPOS_NEW(m_pmp) ULONG(m_ulColIdFirst + ul);
+			(void) m_phmulte->FInsert(pulKey, m_rgpte[ul]);
+		}
+	}
+
+	GPOS_DELETE_ARRAY(m_rgpte);
+	m_rgpte = NULL;
+	m_ulSlots = 0;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		CDXLTranslateContext::FInsertParamMapping
@@ -196,6 +340,15 @@ CDXLTranslateContext::FInsertParamMapping
 	CMappingElementColIdParamId *pmecolidparamid
 	)
 {
+	// stop sharing the params hashmap with the parent or child contexts
+	if (1 < m_phmcolparam->UlRefCount())
+	{
+		HMColParam *phmShared = m_phmcolparam;
+		m_phmcolparam = GPOS_NEW(m_pmp) HMColParam(m_pmp);
+		CopyParamHashmap(phmShared);
+		phmShared->Release();
+	}
+
 	// copy key
 	ULONG *pulKey = GPOS_NEW(m_pmp) ULONG(ulColId);
 
@@ -26,6 +26,7 @@
 #include "utils/lsyscache.h"
 #include "utils/uri.h"
 #include "gpos/base.h"
+#include "gpos/common/CWallClock.h"
 
 #include "gpopt/mdcache/CMDAccessor.h"
 #include "gpopt/translate/CTranslatorDXLToPlStmt.h"
@@ -330,7 +331,18 @@ CTranslatorDXLToPlStmt::PplFromDXL
 		GPOS_RAISE(gpdxl::ExmaDXL, gpdxl::ExmiDXL2PlStmtConversion, pdxln->Pdxlop()->PstrOpName()->Wsz());
 	}
 
-	return (this->* pf)(pdxln, pdxltrctxOut, pplanParent, pdrgpdxltrctxPrevSiblings);
+	if (!m_pctxdxltoplstmt->FProfile())
+	{
+		return (this->* pf)(pdxln, pdxltrctxOut, pplanParent, pdrgpdxltrctxPrevSiblings);
+	}
+
+	// the time recorded for the children is not attributed to this operator
+	ULLONG ullProfileUs = m_pctxdxltoplstmt->UllProfileUs();
+	CWallClock clock;
+	Plan *pplan = (this->* pf)(pdxln, pdxltrctxOut, pplanParent, pdrgpdxltrctxPrevSiblings);
+	m_pctxdxltoplstmt->RecordProfile(pdxlop, clock.UlElapsedUS(), m_pctxdxltoplstmt->UllProfileUs() - ullProfileUs);
+
+	return pplan;
 }
 
 //---------------------------------------------------------------------------
@@ -345,9 +345,8 @@ CTranslatorRelcacheToDXL::PlIndexOidsPartTable
 		LogicalIndexInfo *pidxinfo = (plgidx->logicalIndexInfo)[ul];
 		plOids = gpdb::PlAppendOid(plOids, pidxinfo->logicalIndexOid);
 	}
-	
-	gpdb::GPDBFree(plgidx);
-	
+
+	// the logical indexes may be owned by the partition metadata cache, do not free them
 	return plOids;
 }
 
@@ -661,8 +660,31 @@ CTranslatorRelcacheToDXL::Pdrgpmdcol
 	)
 {
 	DrgPmdcol *pdrgpmdcol = GPOS_NEW(pmp) DrgPmdcol(pmp);
+	const ULONG ulAttrs = (ULONG) rel->rd_att->natts;
 
-	for (ULONG ul = 0;  ul < (ULONG) rel->rd_att->natts; ul++)
+	// index the column defaults by attno, instead of scanning them for every
+	// column of a wide table
+	const char **rgszDefaults = GPOS_NEW_ARRAY(pmp, const char *, ulAttrs);
+	for (ULONG ul = 0; ul < ulAttrs; ul++)
+	{
+		rgszDefaults[ul] = NULL;
+	}
+
+	if (NULL != rel->rd_att->constr)
+	{
+		AttrDefault *defval = rel->rd_att->constr->defval;
+		for (ULONG ul = 0; ul < (ULONG) rel->rd_att->constr->num_defval; ul++)
+		{
+			AttrNumber attno = defval[ul].adnum;
+			GPOS_ASSERT(0 < attno && attno <= (AttrNumber) ulAttrs);
+			if (NULL == rgszDefaults[attno - 1])
+			{
+				rgszDefaults[attno - 1] = defval[ul].adbin;
+			}
+		}
+	}
+
+	for (ULONG ul = 0;  ul < ulAttrs; ul++)
 	{
 		Form_pg_attribute att = rel->rd_att->attrs[ul];
 		CMDName *pmdnameCol = CDXLUtils::PmdnameFromSz(pmp, NameStr(att->attname));
@@ -672,7 +694,7 @@ CTranslatorRelcacheToDXL::Pdrgpmdcol
 		
 		if (!att->attisdropped)
 		{
-			pdxlnDefault = PdxlnDefaultColumnValue(pmp, pmda, rel->rd_att, att->attnum);
+			pdxlnDefault = PdxlnDefaultColumnValue(pmp, pmda, rel->rd_att, att->attnum, rgszDefaults[ul]);
 		}
 
 		ULONG ulColLen = ULONG_MAX;
@@ -696,6 +718,8 @@ CTranslatorRelcacheToDXL::Pdrgpmdcol
 		pdrgpmdcol->Append(pmdcol);
 	}
 
+	GPOS_DELETE_ARRAY(rgszDefaults);
+
 	// add system columns
 	if (FHasSystemColumns(rel->rd_rel->relkind))
 	{
@@ -721,29 +745,19 @@ CTranslatorRelcacheToDXL::PdxlnDefaultColumnValue
 	IMemoryPool *pmp,
 	CMDAccessor *pmda,
 	TupleDesc rd_att,
-	AttrNumber attno
+	AttrNumber attno,
+	const char *szDefault
 	)
 {
 	GPOS_ASSERT(attno > 0);
 
 	Node *pnode = NULL;
 
-	// Scan to see if relation has a default for this column
-	if (NULL != rd_att->constr && 0 < rd_att->constr->num_defval)
+	if (NULL != szDefault)
 	{
-		AttrDefault *defval = rd_att->constr->defval;
-		INT	iNumDef = rd_att->constr->num_defval;
-
-		GPOS_ASSERT(NULL != defval);
-		for (ULONG ulCounter = 0; ulCounter < (ULONG) iNumDef; ulCounter++)
-		{
-			if (attno == defval[ulCounter].adnum)
-			{
-				// found it, convert string representation to node tree.
-				pnode = gpdb::Pnode(defval[ulCounter].adbin);
-				break;
-			}
-		}
+		// the relation has a default for this column, convert string
+		// representation to node tree.
+		pnode = gpdb::Pnode(const_cast<char *>(szDefault));
 	}
 
 	if (NULL == pnode)
@@ -992,10 +1006,10 @@ CTranslatorRelcacheToDXL::Pmdindex
 
 			IMDIndex *pmdindex = PmdindexPartTable(pmp, pmda, pmdidIndex, pmdrel, plgidx);
 
-			// cleanup
+			// cleanup; the logical indexes may be owned by the partition
+			// metadata cache, do not free them
 			pmdidRel->Release();
 	
-			gpdb::GPDBFree(plgidx);
 			gpdb::CloseRelation(relIndex);
 
 			return pmdindex;
@@ -2245,11 +2259,8 @@ CTranslatorRelcacheToDXL::PimdobjColStats
 
 		if (!pmdcol->FDropped())
 		{
-			CMDIdGPDB *pmdidAttType = GPOS_NEW(pmp) CMDIdGPDB(oidAttType);
-			IMDType *pmdtype = Pmdtype(pmp, pmdidAttType);
-			dWidth = CStatisticsUtils::DDefaultColumnWidth(pmdtype);
-			pmdtype->Release();
-			pmdidAttType->Release();
+			// the type is most likely in the metadata cache already
+			dWidth = CStatisticsUtils::DDefaultColumnWidth(pmda->Pmdtype(pmdcol->PmdidType()));
 		}
 
 		return CDXLColStats::PdxlcolstatsDummy(pmp, pmdidColStats, pmdnameCol, dWidth);
@@ -2324,16 +2335,21 @@ CTranslatorRelcacheToDXL::PimdobjColStats
 		dMCFSum = dMCFSum + CDouble(pdrgfMCVFrequencies[i]);
 	}
 
-	// get histogram datums from pg_statistic entry
-	(void) gpdb::FGetAttrStatsSlot
-			(
-					heaptupleStats,
-					oidAttType,
-					-1,
-					STATISTIC_KIND_HISTOGRAM,
-					InvalidOid,
-					&pdrgdatumHistValues, &iNumHistValues,
-					NULL, NULL);
+	// get histogram datums from pg_statistic entry, unless the MCVs and NULLs
+	// leave nothing for the histogram to describe, in which case it would be
+	// discarded by PdrgpdxlbucketTransformStats anyway
+	if (CStatistics::DEpsilon < CDouble(1.0) - dNullFrequency - dMCFSum)
+	{
+		(void) gpdb::FGetAttrStatsSlot
+				(
+						heaptupleStats,
+						oidAttType,
+						-1,
+						STATISTIC_KIND_HISTOGRAM,
+						InvalidOid,
+						&pdrgdatumHistValues, &iNumHistValues,
+						NULL, NULL);
+	}
 
 	// transform all the bits and pieces from pg_statistic
 	// to a single bucket structure
@@ -2341,7 +2357,7 @@ CTranslatorRelcacheToDXL::PimdobjColStats
 			PdrgpdxlbucketTransformStats
 					(
 					pmp,
-					oidAttType,
+					pmda->Pmdtype(pmdcol->PmdidType()),
 					dDistinct,
 					dNullFrequency,
 					pdrgdatumMCVValues,
@@ -2645,7 +2661,7 @@ DrgPdxlbucket *
 CTranslatorRelcacheToDXL::PdrgpdxlbucketTransformStats
 	(
 	IMemoryPool *pmp,
-	OID oidAttType,
+	const IMDType *pmdtype,
 	CDouble dDistinct,
 	CDouble dNullFreq,
 	const Datum *pdrgdatumMCVValues,
@@ -2655,8 +2671,7 @@ CTranslatorRelcacheToDXL::PdrgpdxlbucketTransformStats
 	ULONG ulNumHistValues
 	)
 {
-	CMDIdGPDB *pmdidAttType = GPOS_NEW(pmp) CMDIdGPDB(oidAttType);
-	IMDType *pmdtype = Pmdtype(pmp, pmdidAttType);
+	GPOS_ASSERT(NULL != pmdtype);
 
 	// translate MCVs to Orca histogram. Create an empty histogram if there are no MCVs.
 	CHistogram *phistGPDBMCV = PhistTransformGPDBMCV
@@ -2724,8 +2739,6 @@ CTranslatorRelcacheToDXL::PdrgpdxlbucketTransformStats
 	}
 
 	// cleanup
-	pmdidAttType->Release();
-	pmdtype->Release();
 	GPOS_DELETE(phistGPDBMCV);
 
 	if (NULL != phistGPDBHist)
@@ -2816,13 +2829,16 @@ CTranslatorRelcacheToDXL::PhistTransformGPDBHist
 	const ULONG ulBuckets = ulNumHistValues - 1;
 	// create buckets
 	DrgPbucket *pdrgppbucket = GPOS_NEW(pmp) DrgPbucket(pmp);
+
+	// every bound but the first and last one is shared by two adjacent
+	// buckets, translate it only once
+	IDatum *pdatumMax = CTranslatorScalarToDXL::Pdatum(pmp, pmdtype, false /* fNull */, pdrgdatumHistValues[0]);
 	for (ULONG ul = 0; ul < ulBuckets; ul++)
 	{
-		Datum datumMin = pdrgdatumHistValues[ul];
-		IDatum *pdatumMin = CTranslatorScalarToDXL::Pdatum(pmp, pmdtype, false /* fNull */, datumMin);
+		IDatum *pdatumMin = pdatumMax;
 
 		Datum datumMax = pdrgdatumHistValues[ul + 1];
-		IDatum *pdatumMax = CTranslatorScalarToDXL::Pdatum(pmp, pmdtype, false /* fNull */, datumMax);
+		pdatumMax = CTranslatorScalarToDXL::Pdatum(pmp, pmdtype, false /* fNull */, datumMax);
 
 		BOOL fLowerClosed = true; // GPDB histograms assumes lower bound to be closed
 		BOOL fUpperClosed = false; // GPDB histograms assumes upper bound to be open
@@ -2832,6 +2848,9 @@ CTranslatorRelcacheToDXL::PhistTransformGPDBHist
 			fUpperClosed = true;
 		}
 
+		// the upper bound is also the lower bound of the next bucket
+		pdatumMax->AddRef();
+
 		CBucket *pbucket = GPOS_NEW(pmp) CBucket
 									(
 									GPOS_NEW(pmp) CPoint(pdatumMin),
@@ -2845,6 +2864,8 @@ CTranslatorRelcacheToDXL::PhistTransformGPDBHist
 
 		if (!pdatumMin->FStatsComparable(pdatumMin) || !pdatumMin->FStatsLessThan(pdatumMax))
 		{
+			pdatumMax->Release();
+
 			// if less than operation is not supported on this datum,
 			// or the translated histogram does not conform to GPDB sort order (e.g. text column in Linux platform),
 			// then no point building a histogram. return an empty histogram
@@ -2857,6 +2878,9 @@ CTranslatorRelcacheToDXL::PhistTransformGPDBHist
 		}
 	}
 
+	// release the reference kept for the bucket after the last one
+	pdatumMax->Release();
+
 	CHistogram *phist = GPOS_NEW(pmp) CHistogram(pdrgppbucket);
 	return phist;
 }
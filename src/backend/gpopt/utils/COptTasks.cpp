@@ -17,6 +17,7 @@
 #include "gpopt/utils/CConstExprEvaluatorProxy.h"
 #include "gpopt/utils/COptTasks.h"
 #include "gpopt/relcache/CMDProviderRelcache.h"
+#include "gpopt/relcache/CMDCacheInvalidator.h"
 #include "gpopt/config/CConfigParamMapping.h"
 #include "gpopt/translate/CTranslatorDXLToExpr.h"
 #include "gpopt/translate/CTranslatorExprToDXL.h"
@@ -37,10 +38,13 @@
 
 #include "gpos/_api.h"
 #include "gpos/common/CAutoP.h"
+#include "gpos/common/CAutoRef.h"
+#include "gpos/common/CWallClock.h"
 #include "gpos/io/COstreamFile.h"
 #include "gpos/io/COstreamString.h"
 #include "gpos/memory/CAutoMemoryPool.h"
 #include "gpos/task/CAutoTraceFlag.h"
+#include "gpos/task/CWorkerPoolManager.h"
 #include "gpos/common/CAutoP.h"
 
 #include "gpopt/translate/CTranslatorDXLToExpr.h"
@@ -140,7 +144,9 @@ SOptContext::SOptContext()
 	m_fGeneratePlStmt(false),
 	m_fSerializePlanDXL(false),
 	m_fUnexpectedFailure(false),
-	m_szErrorMsg(NULL)
+	m_szErrorMsg(NULL),
+	m_ulWorkers(1),
+	m_fRetrySerially(false)
 {}
 
 //---------------------------------------------------------------------------
@@ -699,10 +705,22 @@ COptTasks::Pplstmt
 							&plRTable,
 							&plSubplans
 							);
-	
+
+	if (optimizer_print_translation_stats)
+	{
+		ctxdxltoplstmt.EnableProfile();
+	}
+
 	// translate DXL -> PlannedStmt
 	CTranslatorDXLToPlStmt trdxltoplstmt(pmp, pmda, &ctxdxltoplstmt, gpdb::UlSegmentCountGP());
-	return trdxltoplstmt.PplstmtFromDXL(pdxln, canSetTag);
+	PlannedStmt *pplstmt = trdxltoplstmt.PplstmtFromDXL(pdxln, canSetTag);
+
+	if (optimizer_print_translation_stats)
+	{
+		ctxdxltoplstmt.PrintProfile();
+	}
+
+	return pplstmt;
 }
 
 
@@ -753,6 +771,55 @@ COptTasks::PdrgPssLoad
 	return pdrgpss;
 }
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::PdrgPssTimeBudget
+//
+//	@doc:
+//		Create a search strategy of a single stage with all xforms, which
+//		ends when the given time budget (in ms) is exhausted
+//
+//---------------------------------------------------------------------------
+DrgPss *
+COptTasks::PdrgPssTimeBudget
+	(
+	IMemoryPool *pmp,
+	ULONG ulTimeBudget
+	)
+{
+	CXformSet *pxfs = GPOS_NEW(pmp) CXformSet(pmp);
+	pxfs->Union(CXformFactory::Pxff()->PxfsExploration());
+	pxfs->Union(CXformFactory::Pxff()->PxfsImplementation());
+
+	DrgPss *pdrgpss = GPOS_NEW(pmp) DrgPss(pmp);
+	pdrgpss->Append(GPOS_NEW(pmp) CSearchStage(pxfs, ulTimeBudget));
+
+	return pdrgpss;
+}
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::RecordPhase
+//
+//	@doc:
+//		Record the elapsed time of an optimization phase, and the memory
+//		allocated from the optimization's memory pool at its end
+//
+//---------------------------------------------------------------------------
+void
+COptTasks::RecordPhase
+	(
+	IMemoryPool *pmp,
+	OptimizerPhaseStats *pphase,
+	ULONG ulElapsedUs
+	)
+{
+	pphase->time_ms = ulElapsedUs / 1000.0;
+	pphase->memory_kb = (int64) (pmp->UllTotalAllocatedSize() / 1024);
+	pphase->shared_cache_hits = -1;
+	pphase->cache_misses = -1;
+}
+
 //---------------------------------------------------------------------------
 //	@function:
 //		COptTasks::PoconfCreate
@@ -981,14 +1048,18 @@ COptTasks::PvOptimizeTask
 	AUTO_MEM_POOL(amp);
 	IMemoryPool *pmp = amp.Pmp();
 
-	// Does the metadatacache need to be reset?
+	// Does the whole metadatacache need to be reset?
 	//
 	// On the first call, before the cache has been initialized, we
 	// don't care about the return value of FMDCacheNeedsReset(). But
 	// we need to call it anyway, to give it a chance to initialize
-	// the invalidation mechanism.
+	// the invalidation mechanism. Otherwise, if no reset is needed, only
+	// the invalidated objects are evicted.
 	bool reset_mdcache = gpdb::FMDCacheNeedsReset();
 
+	// a new or emptied cache is missing the metadata of the query
+	BOOL fColdMDCache = !CMDCache::FInitialized() || reset_mdcache;
+
 	// initialize metadata cache, or purge if needed, or change size if requested
 	if (!CMDCache::FInitialized())
 	{
@@ -1000,14 +1071,25 @@ COptTasks::PvOptimizeTask
 		CMDCache::Reset();
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
 	}
-	else if (CMDCache::ULLGetCacheQuota() != (ULLONG) optimizer_mdcache_size * 1024L)
+	else
 	{
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		// evict only the objects whose catalog entries have changed
+		CMDCacheInvalidator::EvictInvalidatedObjects(pmp);
+
+		if (CMDCache::ULLGetCacheQuota() != (ULLONG) optimizer_mdcache_size * 1024L)
+		{
+			CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		}
 	}
 
 
-	// load search strategy
+	// load search strategy, or stop the default search at the time budget
 	DrgPss *pdrgpss = PdrgPssLoad(pmp, optimizer_search_strategy_path);
+	BOOL fTimeBudget = (NULL == pdrgpss && 0 < optimizer_time_budget);
+	if (fTimeBudget)
+	{
+		pdrgpss = PdrgPssTimeBudget(pmp, (ULONG) optimizer_time_budget);
+	}
 
 	CBitSet *pbsTraceFlags = NULL;
 	CBitSet *pbsEnabled = NULL;
@@ -1017,8 +1099,17 @@ COptTasks::PvOptimizeTask
 	DrgPmdid *pdrgmdidCol = NULL;
 	HMMDIdMDId *phmmdidRel = NULL;
 
+	OptimizerStats stats;
+	memset(&stats, 0, sizeof(stats));
+
+	// size of the worker pool before the optimization, to restore it after
+	ULONG ulWorkersMaxOld = CWorkerPoolManager::Pwpm()->UlWorkersMax();
+
 	GPOS_TRY
 	{
+		// build the partition metadata of each partitioned table only once
+		gpdb::BeginPartMetadataCaching();
+
 		// set trace flags
 		pbsTraceFlags = CConfigParamMapping::PbsPack(pmp, CXform::ExfSentinel);
 		SetTraceflags(pmp, pbsTraceFlags, &pbsEnabled, &pbsDisabled);
@@ -1044,6 +1135,7 @@ COptTasks::PvOptimizeTask
 				ulSegmentsForCosting = ulSegments;
 			}
 
+			CWallClock clockPhase;
 			CAutoP<CTranslatorQueryToDXL> ptrquerytodxl;
 			ptrquerytodxl = CTranslatorQueryToDXL::PtrquerytodxlInstance
 							(
@@ -1066,11 +1158,38 @@ COptTasks::PvOptimizeTask
 			DrgPdxln *pdrgpdxlnQueryOutput = ptrquerytodxl->PdrgpdxlnQueryOutput();
 			DrgPdxln *pdrgpdxlnCTE = ptrquerytodxl->PdrgpdxlnCTE();
 			GPOS_ASSERT(NULL != pdrgpdxlnQueryOutput);
+			RecordPhase(pmp, &stats.phases[OPT_PHASE_QUERY_TO_DXL], clockPhase.UlElapsedUS());
 
 			BOOL fMasterOnly = !optimizer_enable_motions ||
 						(!optimizer_enable_motions_masteronly_queries && !ptrquerytodxl->FHasDistributedTables());
 			CAutoTraceFlag atf(EopttraceDisableMotions, fMasterOnly);
 
+			// Worker threads cannot call GPDB, so metadata they miss in the
+			// cache makes the optimization start over serially. When the
+			// query's own objects were not all cached, the search would very
+			// likely miss others, so optimize serially from the start.
+			if (fColdMDCache || 0 < pmdpRelcache->UlTranslated() + pmdpRelcache->UlSharedHits())
+			{
+				poctx->m_ulWorkers = 1;
+			}
+
+			// run exploration and implementation jobs on several workers
+			CAutoTraceFlag atfParallel(EopttraceParallel, 1 < poctx->m_ulWorkers);
+			if (ulWorkersMaxOld < poctx->m_ulWorkers)
+			{
+				SetWorkersMax(poctx->m_ulWorkers);
+			}
+
+			// the engine releases the search stages; keep the budget stage to
+			// ask it whether the search timed out
+			CAutoRef<DrgPss> ptrpdrgpssBudget;
+			if (fTimeBudget)
+			{
+				pdrgpss->AddRef();
+				ptrpdrgpssBudget = pdrgpss;
+			}
+
+			CWallClock clock;
 			pdxlnPlan = COptimizer::PdxlnOptimize
 									(
 									pmp,
@@ -1086,6 +1205,17 @@ COptTasks::PvOptimizeTask
 									pocconf
 									);
 
+			// the search stage ends at the time budget with the best plan found
+			// so far; the stage's own timer is what the engine checked
+			RecordPhase(pmp, &stats.phases[OPT_PHASE_SEARCH], clock.UlElapsedUS());
+			double dOptimizationTime = stats.phases[OPT_PHASE_SEARCH].time_ms;
+			BOOL fBudgetExceeded = fTimeBudget && (*ptrpdrgpssBudget.Pt())[0]->FTimedOut();
+			if (optimizer_print_optimization_stats)
+			{
+				elog(LOG, "[OPT]: Optimization time: %.3f ms%s", dOptimizationTime,
+					 fBudgetExceeded ? ", time budget exceeded" : "");
+			}
+
 			if (poctx->m_fSerializePlanDXL)
 			{
 				// serialize DXL to xml
@@ -1099,7 +1229,27 @@ COptTasks::PvOptimizeTask
 			{
 				// always use poctx->m_pquery->canSetTag as the ptrquerytodxl->Pquery() is a mutated Query object
 				// that may not have the correct canSetTag
+				clockPhase.Restart();
 				poctx->m_pplstmt = (PlannedStmt *) gpdb::PvCopyObject(Pplstmt(pmp, &mda, pdxlnPlan, poctx->m_pquery->canSetTag));
+				poctx->m_pplstmt->optimizerTime = dOptimizationTime;
+				poctx->m_pplstmt->optimizerBudgetExceeded = fBudgetExceeded;
+				RecordPhase(pmp, &stats.phases[OPT_PHASE_DXL_TO_PLSTMT], clockPhase.UlElapsedUS());
+			}
+
+			// metadata is fetched during the other phases; objects missing
+			// from the shared cache are translated from the catalog
+			OptimizerPhaseStats *pphaseMD = &stats.phases[OPT_PHASE_METADATA];
+			pphaseMD->time_ms = pmdpRelcache->UllFetchUs() / 1000.0;
+			pphaseMD->memory_kb = -1;
+			pphaseMD->shared_cache_hits = pmdpRelcache->UlSharedHits();
+			pphaseMD->cache_misses = pmdpRelcache->UlTranslated();
+
+			stats.valid = true;
+			optimizer_last_stats = stats;
+			if (NULL != poctx->m_pplstmt)
+			{
+				poctx->m_pplstmt->optimizerStats = (OptimizerStats *) gpdb::GPDBAlloc(sizeof(OptimizerStats));
+				*poctx->m_pplstmt->optimizerStats = stats;
 			}
 
 			CStatisticsConfig *pstatsconf = pocconf->Pstatsconf();
@@ -1127,9 +1277,22 @@ COptTasks::PvOptimizeTask
 		CRefCount::SafeRelease(pbsDisabled);
 		CRefCount::SafeRelease(pbsTraceFlags);
 		CRefCount::SafeRelease(pdxlnPlan);
-		CMDCache::Shutdown();
+		gpdb::EndPartMetadataCaching();
+		SetWorkersMax(ulWorkersMaxOld);
 
-		if (GPOS_MATCH_EX(ex, gpdxl::ExmaGPDB, gpdxl::ExmiGPDBError))
+		// a worker thread missed an object in the metadata cache; GPDB was not
+		// called, so the cache can be kept for the serial retry
+		poctx->m_fRetrySerially = 1 < poctx->m_ulWorkers && gpdb::FCallFromWorkerRefused();
+		if (!poctx->m_fRetrySerially)
+		{
+			CMDCache::Shutdown();
+		}
+
+		if (poctx->m_fRetrySerially)
+		{
+			elog(DEBUG1, "Metadata needed by an optimizer worker thread. Retrying serially.");
+		}
+		else if (GPOS_MATCH_EX(ex, gpdxl::ExmaGPDB, gpdxl::ExmiGPDBError))
 		{
 			elog(DEBUG1, "GPDB Exception. Please check log for more information.");
 		}
@@ -1151,6 +1314,8 @@ COptTasks::PvOptimizeTask
 	CRefCount::SafeRelease(pbsEnabled);
 	CRefCount::SafeRelease(pbsDisabled);
 	CRefCount::SafeRelease(pbsTraceFlags);
+	gpdb::EndPartMetadataCaching();
+	SetWorkersMax(ulWorkersMaxOld);
 	if (!optimizer_metadata_caching)
 	{
 		CMDCache::Shutdown();
@@ -1160,6 +1325,124 @@ COptTasks::PvOptimizeTask
 }
 
 
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::UlParallelWorkers
+//
+//	@doc:
+//		Number of worker threads to optimize a query with: the value of
+//		optimizer_parallel_workers, limited by the number of cores. When the
+//		resource queue limits the number of active statements, the cores are
+//		shared among them.
+//
+//---------------------------------------------------------------------------
+ULONG
+COptTasks::UlParallelWorkers()
+{
+	if (1 >= optimizer_parallel_workers)
+	{
+		return 1;
+	}
+
+	ULONG ulWorkers = (ULONG) optimizer_parallel_workers;
+
+	LONG lCores = sysconf(_SC_NPROCESSORS_ONLN);
+	if (0 < lCores)
+	{
+		INT iActiveStatements = gpdb::IResQueueActiveStatementsLimit();
+		if (0 < iActiveStatements)
+		{
+			lCores = lCores / iActiveStatements;
+		}
+
+		ULONG ulCores = (0 < lCores) ? (ULONG) lCores : 1;
+		if (ulCores < ulWorkers)
+		{
+			ulWorkers = ulCores;
+		}
+	}
+
+	return ulWorkers;
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::SetWorkersMax
+//
+//	@doc:
+//		Resize the gpos worker pool. The worker threads it starts inherit the
+//		signal mask of this thread, so the backend's signals are blocked
+//		meanwhile, and are left to the backend thread as in the dispatcher
+//		and interconnect threads.
+//
+//---------------------------------------------------------------------------
+void
+COptTasks::SetWorkersMax
+	(
+	ULONG ulWorkersMax
+	)
+{
+	CWorkerPoolManager *pwpm = CWorkerPoolManager::Pwpm();
+	if (ulWorkersMax == pwpm->UlWorkersMax())
+	{
+		return;
+	}
+
+	gpdb::BlockThreadSignals(true);
+	pwpm->SetWorkersMax(ulWorkersMax);
+	gpdb::BlockThreadSignals(false);
+}
+
+
+//---------------------------------------------------------------------------
+//	@function:
+//		COptTasks::ExecuteOptimizeTask
+//
+//	@doc:
+//		Execute the optimization task with the configured number of worker
+//		threads. GPDB functions may only be called from the thread of the
+//		backend; if a worker thread needs metadata that is not in the
+//		metadata cache, the optimization is retried serially. Queries whose
+//		metadata is not cached yet are optimized serially to begin with.
+//
+//---------------------------------------------------------------------------
+void
+COptTasks::ExecuteOptimizeTask
+	(
+	SOptContext *poctx
+	)
+{
+	Assert(poctx);
+
+	poctx->m_ulWorkers = UlParallelWorkers();
+	poctx->m_fRetrySerially = false;
+
+	// forget refused calls from a previous optimization
+	(void) gpdb::FCallFromWorkerRefused();
+
+	GPOS_TRY
+	{
+		Execute(&PvOptimizeTask, poctx);
+	}
+	GPOS_CATCH_EX(ex)
+	{
+		if (!poctx->m_fRetrySerially)
+		{
+			GPOS_RETHROW(ex);
+		}
+	}
+	GPOS_CATCH_END;
+
+	if (poctx->m_fRetrySerially)
+	{
+		poctx->m_ulWorkers = 1;
+		poctx->m_fRetrySerially = false;
+		Execute(&PvOptimizeTask, poctx);
+	}
+}
+
+
 //---------------------------------------------------------------------------
 //	@function:
 //		COptTasks::PrintMissingStatsWarning
@@ -1553,12 +1836,13 @@ COptTasks::PvEvalExprFromDXLTask
 	CDXLNode *pdxlnResult = NULL;
 	BOOL fReleaseCache = false;
 
-	// Does the metadatacache need to be reset?
+	// Does the whole metadatacache need to be reset?
 	//
 	// On the first call, before the cache has been initialized, we
 	// don't care about the return value of FMDCacheNeedsReset(). But
 	// we need to call it anyway, to give it a chance to initialize
-	// the invalidation mechanism.
+	// the invalidation mechanism. Otherwise, if no reset is needed, only
+	// the invalidated objects are evicted.
 	bool reset_mdcache = gpdb::FMDCacheNeedsReset();
 
 	// initialize metadata cache, or purge if needed, or change size if requested
@@ -1573,9 +1857,15 @@ COptTasks::PvEvalExprFromDXLTask
 		CMDCache::Reset();
 		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
 	}
-	else if (CMDCache::ULLGetCacheQuota() != (ULLONG) optimizer_mdcache_size * 1024L)
+	else
 	{
-		CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		// evict only the objects whose catalog entries have changed
+		CMDCacheInvalidator::EvictInvalidatedObjects(pmp);
+
+		if (CMDCache::ULLGetCacheQuota() != (ULLONG) optimizer_mdcache_size * 1024L)
+		{
+			CMDCache::SetCacheQuota(optimizer_mdcache_size * 1024L);
+		}
 	}
 
 	GPOS_TRY
@@ -1650,7 +1940,7 @@ COptTasks::SzOptimize
 	SOptContext octx;
 	octx.m_pquery = pquery;
 	octx.m_fSerializePlanDXL = true;
-	Execute(&PvOptimizeTask, &octx);
+	ExecuteOptimizeTask(&octx);
 
 	// clean up context
 	octx.Free(octx.epinQuery, octx.epinPlanDXL);
@@ -1682,7 +1972,7 @@ COptTasks::PplstmtOptimize
 	octx->m_fGeneratePlStmt= true;
 	GPOS_TRY
 	{
-		Execute(&PvOptimizeTask, octx);
+		ExecuteOptimizeTask(octx);
 	}
 	GPOS_CATCH_EX(ex)
 	{
@@ -29,6 +29,7 @@
 #include "nodes/plannodes.h"
 #include "nodes/execnodes.h" /* CdbProcess, Slice, and SliceTable. */
 #include "nodes/relation.h"
+#include "optimizer/optstats.h"
 #include "utils/datum.h"
 #include "cdb/cdbgang.h"
 #include "nodes/nodeFuncs.h"
@@ -132,6 +133,16 @@ _copyPlannedStmt(PlannedStmt *from)
 	else
 		newnode->intoPolicy = NULL;
 
+	COPY_SCALAR_FIELD(planFromCache);
+	COPY_SCALAR_FIELD(optimizerTime);
+	COPY_SCALAR_FIELD(optimizerBudgetExceeded);
+
+	if (from->optimizerStats)
+	{
+		COPY_POINTER_FIELD(optimizerStats, sizeof(OptimizerStats));
+	}
+	else
+		newnode->optimizerStats = NULL;
 	COPY_SCALAR_FIELD(query_mem);
 
 	return newnode;
@@ -43,6 +43,7 @@
 #include "parser/parse_oper.h"
 #include "parser/parsetree.h"
 #include "utils/lsyscache.h"
+#include "utils/plancache.h"
 #include "utils/selfuncs.h"
 #include "utils/syscache.h"
 
@@ -184,6 +185,7 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	List	   *invalItems;
 	ListCell   *lc;
 	ListCell   *lp;
+	char	   *plancacheKey;
 
 	/*
 	 * Initialize a dummy PlannerGlobal struct. ORCA doesn't use it, but the
@@ -220,6 +222,14 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	 */
 	pqueryCopy = preprocess_query_optimizer(glob, pqueryCopy, boundParams);
 
+	/*
+	 * If ORCA has optimized the same Query before, and nothing it depends on
+	 * has changed since, reuse the plan. It has been post-processed already.
+	 */
+	result = OptimizerPlanCacheLookup(pqueryCopy, &plancacheKey);
+	if (result)
+		return result;
+
 	/* Ok, invoke ORCA. */
 	result = PplstmtOptimize(pqueryCopy, &fUnexpectedFailure);
 
@@ -324,6 +334,8 @@ optimize_query(Query *parse, ParamListInfo boundParams)
 	result->relationOids = glob->relationOids;
 	result->invalItems = glob->invalItems;
 
+	OptimizerPlanCacheStore(plancacheKey, result);
+
 	return result;
 }
 #endif
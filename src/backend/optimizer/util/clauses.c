@@ -3779,47 +3779,161 @@ sql_inline_error_callback(void *arg)
 			   NameStr(funcform->proname));
 }
 
+/*
+ * is_function_call_over_consts: is expr a plain function call on constants?
+ *
+ * Recognizes a non-set-returning FuncExpr or OpExpr whose arguments are all
+ * Consts, and returns the function to call and its arguments.
+ */
+static bool
+is_function_call_over_consts(Expr *expr, Oid *funcid, List **args)
+{
+	ListCell   *lc;
+
+	if (IsA(expr, FuncExpr))
+	{
+		FuncExpr   *funcexpr = (FuncExpr *) expr;
+
+		if (funcexpr->funcretset)
+			return false;
+		*funcid = funcexpr->funcid;
+		*args = funcexpr->args;
+	}
+	else if (IsA(expr, OpExpr))
+	{
+		OpExpr	   *opexpr = (OpExpr *) expr;
+
+		if (opexpr->opretset)
+			return false;
+		set_opfuncid(opexpr);
+		*funcid = opexpr->opfuncid;
+		*args = opexpr->args;
+	}
+	else
+		return false;
+
+	if (list_length(*args) > FUNC_MAX_ARGS)
+		return false;
+
+	foreach(lc, *args)
+	{
+		if (!IsA(lfirst(lc), Const))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * evaluate_function_directly: call a function on constant arguments
+ *
+ * Does what the executor does for a FuncExpr or OpExpr whose arguments are
+ * Consts -- check the execute privilege, look the function up and call it,
+ * skipping strict functions on NULL input -- without preparing the
+ * expression for execution. Memory is allocated in CurrentMemoryContext.
+ */
+static void
+evaluate_function_directly(Expr *expr, Oid funcid, List *args,
+						   Datum *result, bool *isNull)
+{
+	AclResult	aclresult;
+	FmgrInfo	flinfo;
+	FunctionCallInfoData fcinfo;
+	ListCell   *lc;
+	int			i;
+
+	aclresult = pg_proc_aclcheck(funcid, GetUserId(), ACL_EXECUTE);
+	if (aclresult != ACLCHECK_OK)
+		aclcheck_error(aclresult, ACL_KIND_PROC, get_func_name(funcid));
+
+	fmgr_info(funcid, &flinfo);
+	flinfo.fn_expr = (Node *) expr;
+	Assert(!flinfo.fn_retset);
+
+	InitFunctionCallInfoData(fcinfo, &flinfo, list_length(args), NULL, NULL);
+
+	i = 0;
+	foreach(lc, args)
+	{
+		Const	   *arg = (Const *) lfirst(lc);
+
+		/* a strict function is not called on NULL input */
+		if (arg->constisnull && flinfo.fn_strict)
+		{
+			*result = (Datum) 0;
+			*isNull = true;
+			return;
+		}
+		fcinfo.arg[i] = arg->constvalue;
+		fcinfo.argnull[i] = arg->constisnull;
+		i++;
+	}
+
+	*result = FunctionCallInvoke(&fcinfo);
+	*isNull = fcinfo.isnull;
+}
+
 /*
  * evaluate_expr: pre-evaluate a constant expression
  *
  * We use the executor's routine ExecEvalExpr() to avoid duplication of
  * code and ensure we get the same result as the executor would get.
+ * Function and operator calls on Consts, which are most of what gets
+ * folded, are instead called directly in a scratch memory context, which
+ * is much cheaper than setting up an EState.
  */
 Expr *
 evaluate_expr(Expr *expr, Oid result_type, int32 result_typmod)
 {
-	EState	   *estate;
-	ExprState  *exprstate;
+	EState	   *estate = NULL;
+	MemoryContext evalcontext = NULL;
 	MemoryContext oldcontext;
+	Oid			funcid;
+	List	   *args;
 	Datum		const_val;
 	bool		const_is_null;
 	int16		resultTypLen;
 	bool		resultTypByVal;
 
-	/*
-	 * To use the executor, we need an EState.
-	 */
-	estate = CreateExecutorState();
+	if (is_function_call_over_consts(expr, &funcid, &args))
+	{
+		evalcontext = AllocSetContextCreate(CurrentMemoryContext,
+											"evaluate_expr",
+											ALLOCSET_SMALL_MINSIZE,
+											ALLOCSET_SMALL_INITSIZE,
+											ALLOCSET_SMALL_MAXSIZE);
+		oldcontext = MemoryContextSwitchTo(evalcontext);
+
+		evaluate_function_directly(expr, funcid, args,
+								   &const_val, &const_is_null);
+	}
+	else
+	{
+		ExprState  *exprstate;
 
-	/* We can use the estate's working context to avoid memory leaks. */
-	oldcontext = MemoryContextSwitchTo(estate->es_query_cxt);
+		/*
+		 * To use the executor, we need an EState.
+		 */
+		estate = CreateExecutorState();
 
-	/*
-	 * Prepare expr for execution.
-	 */
-	exprstate = ExecPrepareExpr(expr, estate);
+		/* We can use the estate's working context to avoid memory leaks. */
+		oldcontext = MemoryContextSwitchTo(estate->es_query_cxt);
 
-	/*
-	 * And evaluate it.
-	 *
-	 * It is OK to use a default econtext because none of the ExecEvalExpr()
-	 * code used in this situation will use econtext.  That might seem
-	 * fortuitous, but it's not so unreasonable --- a constant expression does
-	 * not depend on context, by definition, n'est ce pas?
-	 */
-	const_val = ExecEvalExprSwitchContext(exprstate,
-										  GetPerTupleExprContext(estate),
-										  &const_is_null, NULL);
+		/*
+		 * Prepare expr for execution and evaluate it.
+		 *
+		 * It is OK to use a default econtext because none of the
+		 * ExecEvalExpr() code used in this situation will use econtext.
+		 * That might seem fortuitous, but it's not so unreasonable --- a
+		 * constant expression does not depend on context, by definition,
+		 * n'est ce pas?
+		 */
+		exprstate = ExecPrepareExpr(expr, estate);
+
+		const_val = ExecEvalExprSwitchContext(exprstate,
+											  GetPerTupleExprContext(estate),
+											  &const_is_null, NULL);
+	}
 
 	/* Get info needed about result datatype */
 	get_typlenbyval(result_type, &resultTypLen, &resultTypByVal);
@@ -3843,7 +3957,10 @@ evaluate_expr(Expr *expr, Oid result_type, int32 result_typmod)
 	}
 
 	/* Release all the junk we just created */
-	FreeExecutorState(estate);
+	if (estate != NULL)
+		FreeExecutorState(estate);
+	else
+		MemoryContextDelete(evalcontext);
 
 	/*
 	 * Make the constant result node.
@@ -150,6 +150,7 @@
 #include "cdb/cdbgang.h"                /* cdbgang_parse_gpqeid_params */
 #include "cdb/cdbtm.h"
 #include "cdb/cdbvars.h"
+#include "cdb/ic_shmring.h"
 
 #include "cdb/cdbfilerep.h"
 
@@ -1292,6 +1293,7 @@ PostmasterMain(int argc, char *argv[])
 	 * Postgres processes running in this directory, so this should be safe.
 	 */
 	RemovePgTempFiles();
+	ICShmRingRemoveOrphans();
 
 	/*
 	 * Establish input sockets.
@@ -2198,6 +2200,7 @@ BeginResetOfPostmasterAfterChildrenAreShutDown(void)
 	 * Postgres processes running in this directory, so this should be safe.
 	 */
 	RemovePgTempFiles();
+	ICShmRingRemoveOrphans();
 
 	if (primaryMirrorPostmasterResetShouldRestartPeer())
 	{
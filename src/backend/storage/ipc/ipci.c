@@ -66,6 +66,8 @@
 #include "postmaster/backoff.h"
 #include "cdb/memquota.h"
 #include "executor/spi.h"
+#include "utils/mdsharedcache.h"
+#include "cdb/ic_shmring.h"
 #include "utils/workfile_mgr.h"
 #include "utils/session_state.h"
 
@@ -137,6 +139,8 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 		size = add_size(size, BufferShmemSize());
 		size = add_size(size, LockShmemSize());
 		size = add_size(size, workfile_mgr_shmem_size());
+		size = add_size(size, MDSharedCache_ShmemSize());
+		size = add_size(size, ICShmRingShmemSize());
 		if (Gp_role == GP_ROLE_DISPATCH)
 		{
 			size = add_size(size, AppendOnlyWriterShmemSize());
@@ -411,6 +415,8 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
 	BTreeShmemInit();
 	SyncScanShmemInit();
 	workfile_mgr_cache_init();
+	MDSharedCache_ShmemInit();
+	ICShmRingShmemInit();
 
 #ifdef EXEC_BACKEND
 
@@ -3736,6 +3736,26 @@ ProcessInterrupts(const char* filename, int lineno)
 #endif   /* USE_TEST_UTILS */
 }
 
+#ifndef WIN32
+/*
+ * The signals that our threads leave to the main thread
+ */
+static void
+gp_thread_sigset(sigset_t *sigs)
+{
+	sigemptyset(sigs);
+
+	/* make our thread ignore these signals (which should allow that
+	 * they be delivered to the main thread) */
+	sigaddset(sigs, SIGHUP);
+	sigaddset(sigs, SIGINT);
+	sigaddset(sigs, SIGTERM);
+	sigaddset(sigs, SIGALRM);
+	sigaddset(sigs, SIGUSR1);
+	sigaddset(sigs, SIGUSR2);
+}
+#endif
+
 /*
  * Set up the thread signal mask, we don't want to run our signal handlers
  * in our threads (gang-create, dispatch or interconnect threads)
@@ -3752,16 +3772,7 @@ gp_set_thread_sigmasks(void)
 		return;
 	}
 
-	sigemptyset(&sigs);
-
-	/* make our thread ignore these signals (which should allow that
-	 * they be delivered to the main thread) */
-	sigaddset(&sigs, SIGHUP);
-	sigaddset(&sigs, SIGINT);
-	sigaddset(&sigs, SIGTERM);
-	sigaddset(&sigs, SIGALRM);
-	sigaddset(&sigs, SIGUSR1);
-	sigaddset(&sigs, SIGUSR2);
+	gp_thread_sigset(&sigs);
 
 	pthread_sigmask(SIG_BLOCK, &sigs, NULL);
 #endif
@@ -3769,6 +3780,23 @@ gp_set_thread_sigmasks(void)
 	return;
 }
 
+/*
+ * Block the signals of gp_set_thread_sigmasks() in the main thread, or
+ * unblock them again. Threads started in between inherit the mask; this is
+ * for threads that a library starts for us, like the optimizer's workers.
+ */
+void
+gp_block_thread_signals(bool block)
+{
+#ifndef WIN32
+	sigset_t sigs;
+
+	gp_thread_sigset(&sigs);
+
+	pthread_sigmask(block ? SIG_BLOCK : SIG_UNBLOCK, &sigs, NULL);
+#endif
+}
+
 /*
  * IA64-specific code to fetch the AR.BSP register for stack depth checks.
  *
@@ -8,14 +8,28 @@
  *
  * gp_opt_version: This function wraps LibraryVersion. 
  *
+ * gp_opt_stats: This function returns the statistics of the last query
+ * optimized by ORCA in this backend, one row per optimization phase.
+ *
  * Copyright(c) 2012 - present, EMC/Greenplum
  */
 
 #include "postgres.h"
 
 #include "funcapi.h"
+#include "optimizer/optstats.h"
 #include "utils/builtins.h"
 
+/* Statistics of the last query optimized in this backend, set by COptTasks */
+OptimizerStats optimizer_last_stats;
+
+static const char *const optimizer_phase_names[OPT_PHASE_COUNT] = {
+	"Query to DXL",
+	"Metadata",
+	"Search",
+	"DXL to PlannedStmt"
+};
+
 extern Datum EnableXform(PG_FUNCTION_ARGS);
 
 /*
@@ -60,3 +74,103 @@ gp_opt_version(PG_FUNCTION_ARGS __attribute__((unused)))
 	return CStringGetTextDatum("Server has been compiled without ORCA");
 #endif
 }
+
+/*
+ * Returns the display name of an optimization phase.
+ */
+const char *
+OptimizerPhaseName(OptimizerPhase phase)
+{
+	Assert(phase >= 0 && phase < OPT_PHASE_COUNT);
+
+	return optimizer_phase_names[phase];
+}
+
+/*
+ * Appends one line per optimization phase to buf, for EXPLAIN.
+ */
+void
+AppendOptimizerStats(StringInfo buf, const OptimizerStats *stats)
+{
+	int			i;
+
+	Assert(NULL != stats);
+
+	for (i = 0; i < OPT_PHASE_COUNT; i++)
+	{
+		const OptimizerPhaseStats *phase = &stats->phases[i];
+
+		appendStringInfo(buf, "Optimizer phase %s: %.3f ms",
+						 OptimizerPhaseName((OptimizerPhase) i), phase->time_ms);
+		if (phase->memory_kb >= 0)
+			appendStringInfo(buf, ", memory " INT64_FORMAT "kB", phase->memory_kb);
+		if (phase->shared_cache_hits >= 0)
+			appendStringInfo(buf, ", shared cache hits " INT64_FORMAT " misses " INT64_FORMAT,
+							 phase->shared_cache_hits, phase->cache_misses);
+		appendStringInfoChar(buf, '\n');
+	}
+}
+
+/*
+ * Returns the statistics of the last query optimized by ORCA in this backend,
+ * one row per optimization phase. Returns no rows if no query has been
+ * optimized by ORCA yet.
+ */
+Datum
+gp_opt_stats(PG_FUNCTION_ARGS)
+{
+	FuncCallContext *funcctx;
+	OptimizerStats *stats;
+
+	if (SRF_IS_FIRSTCALL())
+	{
+		MemoryContext oldcontext;
+		TupleDesc	tupdesc;
+
+		funcctx = SRF_FIRSTCALL_INIT();
+		oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+		tupdesc = CreateTemplateTupleDesc(5, false);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 1, "phase", TEXTOID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 2, "time_ms", FLOAT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 3, "memory_kb", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 4, "shared_cache_hits", INT8OID, -1, 0);
+		TupleDescInitEntry(tupdesc, (AttrNumber) 5, "cache_misses", INT8OID, -1, 0);
+		funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+		/* take a copy, the function may be called from a query ORCA optimizes */
+		stats = (OptimizerStats *) palloc(sizeof(OptimizerStats));
+		*stats = optimizer_last_stats;
+		funcctx->user_fctx = stats;
+		funcctx->max_calls = stats->valid ? OPT_PHASE_COUNT : 0;
+
+		MemoryContextSwitchTo(oldcontext);
+	}
+
+	funcctx = SRF_PERCALL_SETUP();
+	stats = (OptimizerStats *) funcctx->user_fctx;
+
+	if (funcctx->call_cntr < funcctx->max_calls)
+	{
+		const OptimizerPhaseStats *phase = &stats->phases[funcctx->call_cntr];
+		Datum		values[5];
+		bool		nulls[5];
+		HeapTuple	tuple;
+
+		MemSet(nulls, false, sizeof(nulls));
+
+		values[0] = CStringGetTextDatum(OptimizerPhaseName((OptimizerPhase) funcctx->call_cntr));
+		values[1] = Float8GetDatum(phase->time_ms);
+		values[2] = Int64GetDatum(phase->memory_kb);
+		nulls[2] = phase->memory_kb < 0;
+		values[3] = Int64GetDatum(phase->shared_cache_hits);
+		nulls[3] = phase->shared_cache_hits < 0;
+		values[4] = Int64GetDatum(phase->cache_misses);
+		nulls[4] = phase->cache_misses < 0;
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+
+	SRF_RETURN_DONE(funcctx);
+}
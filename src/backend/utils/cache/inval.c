@@ -90,11 +90,13 @@
 #include "access/xact.h"
 #include "catalog/catalog.h"
 #include "catalog/gp_policy.h"
+#include "catalog/pg_statistic.h"
 #include "cdb/cdbvars.h"
 #include "miscadmin.h"
 #include "storage/sinval.h"
 #include "storage/smgr.h"
 #include "utils/inval.h"
+#include "utils/mdsharedcache.h"
 #include "utils/memutils.h"
 #include "utils/relcache.h"
 #include "utils/simex.h"
@@ -606,6 +608,21 @@ InvalidateSystemCaches(void)
 	}
 }
 
+/*
+ * SendInvalidationMessages
+ *		Send invalidation messages to the shared invalidation message queue.
+ *
+ * The optimizer's shared metadata cache is invalidated here too, rather than
+ * by every backend that receives the messages, so that each change is
+ * applied to it once.
+ */
+static void
+SendInvalidationMessages(const SharedInvalidationMessage *msgs, int n)
+{
+	SendSharedInvalidMessages(msgs, n);
+	MDSharedCache_InvalidateMessages(msgs, n);
+}
+
 /*
  * PrepareForTupleInvalidation
  *		Detect whether invalidation of this tuple implies invalidation
@@ -706,6 +723,18 @@ PrepareForTupleInvalidation(Relation relation, HeapTuple tuple)
 		relationId = gptup->localoid;
 		databaseId = MyDatabaseId;
 	}
+	else if (tupleRelId == StatisticRelationId)
+	{
+		Form_pg_statistic stattup = (Form_pg_statistic) GETSTRUCT(tuple);
+
+		/*
+		 * The relcache doesn't hold statistics, but the optimizer's metadata
+		 * caches do. A relcache inval lets them drop the statistics of this
+		 * relation only, rather than the statistics of every relation.
+		 */
+		relationId = stattup->starelid;
+		databaseId = MyDatabaseId;
+	}
 	else if (tupleRelId == IndexRelationId)
 	{
 		Form_pg_index indextup = (Form_pg_index) GETSTRUCT(tuple);
@@ -913,7 +942,7 @@ inval_twophase_postcommit(TransactionId xid, uint16 info,
 		case TWOPHASE_INFO_MSG:
 			msg = (SharedInvalidationMessage *) recdata;
 			Assert(len == sizeof(SharedInvalidationMessage));
-			SendSharedInvalidMessages(msg, 1);
+			SendInvalidationMessages(msg, 1);
 			break;
 		case TWOPHASE_INFO_FILE_BEFORE:
 			RelationCacheInitFilePreInvalidate();
@@ -972,7 +1001,7 @@ AtEOXact_Inval(bool isCommit)
 								   &transInvalInfo->CurrentCmdInvalidMsgs);
 
 		ProcessInvalidationMessageMulti(&transInvalInfo->PriorCmdInvalidMsgs,
-										SendSharedInvalidMessages);
+										SendInvalidationMessages);
 
 		if (transInvalInfo->RelcacheInitFileInval)
 			RelationCacheInitFilePostInvalidate();
@@ -1164,7 +1193,7 @@ EndNonTransactionalInvalidation(void)
 	ProcessInvalidationMessages(&transInvalInfo->CurrentCmdInvalidMsgs,
 								LocalExecuteInvalidationMessage);
 	ProcessInvalidationMessageMulti(&transInvalInfo->CurrentCmdInvalidMsgs,
-									SendSharedInvalidMessages);
+									SendInvalidationMessages);
 
 	/* Clean up and release memory */
 	for (chunk = transInvalInfo->CurrentCmdInvalidMsgs.cclist;
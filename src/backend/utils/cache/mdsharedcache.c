@@ -0,0 +1,538 @@
+/*-------------------------------------------------------------------------
+ *
+ * mdsharedcache.c
+ *	  A cache of ORCA metadata objects shared by all backends.
+ *
+ * Every backend has its own ORCA metadata cache (CMDCache), which is filled
+ * by translating catalog entries to DXL in CMDProviderRelcache. With many
+ * concurrent sessions, the same objects, and most notably the same column
+ * statistics, are translated over and over. This cache keeps the serialized
+ * DXL of translated objects in shared memory, so that a backend only has to
+ * parse an object that another backend has already translated.
+ *
+ * The cache is built on the generic shared cache (sharedcache.c). Entries
+ * have a fixed size of optimizer_mdcache_shared_entry_size; larger objects
+ * are not shared. When the cache is full, unpinned entries are evicted in a
+ * round-robin fashion.
+ *
+ * Entries are invalidated by relation and by object kind, like the
+ * per-backend cache. Every catalog change is applied once, by the backend
+ * that made it, when it sends its invalidation messages to the other
+ * backends (see MDSharedCache_InvalidateMessages). The backends that receive
+ * the messages only invalidate their own cache. Changes to pg_statistic send
+ * a relcache invalidation of the relation, so statistics are invalidated by
+ * relation rather than all at once.
+ *
+ * Invalidation does not scan the cache. Every invalidation takes a new
+ * generation number, and records it as the last invalidation of the object
+ * kinds and of the relations it covers; relations are hashed to a fixed
+ * number of slots. An entry remembers the generation at which the
+ * translation of its object started, and is stale if its kind or its
+ * relation has been invalidated since then. Stale entries are removed when
+ * they are found by a lookup, or evicted like any other unused entry. Since
+ * the check is done on every lookup, an object translated from catalog
+ * entries that were invalidated while the translation was running is never
+ * returned, however its insertion interleaves with the invalidation.
+ *
+ * Objects read by a transaction that has modified the catalog may not be
+ * visible to others yet, and what others have cached may not be what this
+ * transaction sees, so such transactions don't use the cache at all.
+ *
+ * The cache only exists on the master, where ORCA runs.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/transam.h"
+#include "access/xact.h"
+#include "cdb/cdbvars.h"
+#include "port/atomics.h"
+#include "storage/shmem.h"
+#include "utils/guc.h"
+#include "utils/mdsharedcache.h"
+#include "utils/sharedcache.h"
+#include "utils/syscache.h"
+
+/* Number of slots that relations are hashed to for invalidation */
+#define MDSHAREDCACHE_REL_SLOTS		1024
+
+/* Number of relations invalidated at once by MDSharedCache_InvalidateMessages */
+#define MDSHAREDCACHE_INVAL_BATCH	64
+
+/* Is generation a newer than generation b? */
+#define MDSHAREDCACHE_GEN_NEWER(a, b)	((int32) ((a) - (b)) > 0)
+
+/* Shared control information */
+typedef struct MDSharedCacheCtl
+{
+	/* Incremented by every invalidation */
+	pg_atomic_uint32 generation;
+
+	/* Generation of the last invalidation of each object kind */
+	pg_atomic_uint32 kindGeneration[MDCACHE_NUM_KINDS];
+
+	/* Generation of the last invalidation of the relations in each slot */
+	pg_atomic_uint32 relGeneration[MDSHAREDCACHE_REL_SLOTS];
+
+	/* Index of the next entry to consider for eviction */
+	pg_atomic_uint32 evictionHand;
+} MDSharedCacheCtl;
+
+/* Payload of a shared cache entry */
+typedef struct MDSharedCacheEntry
+{
+	/* Object descriptor. The key of the entry is at the start of it */
+	MDCacheEntry desc;
+
+	/* Generation at which the translation of the object started */
+	uint32		generation;
+
+	/* Length of the serialized object, including the terminating zero */
+	int			len;
+
+	/* Serialized DXL of the object */
+	char		data[1];
+} MDSharedCacheEntry;
+
+/*
+ * These are all the catalog tables that we care about, with the kinds of
+ * metadata cache objects that are built from them.
+ */
+const MDCacheSyscache MDCacheSyscaches[] =
+{
+	/* pg_aggregate */
+	{AGGFNOID, MDCACHE_AGGREGATE},
+	/* pg_amop */
+	{AMOPOPID, MDCACHE_TYPE | MDCACHE_OPERATOR | MDCACHE_SCALAR_CMP | MDCACHE_INDEX},
+	/* pg_cast */
+	{CASTSOURCETARGET, MDCACHE_CAST},
+	/* pg_constraint */
+	{CONSTROID, MDCACHE_RELATION | MDCACHE_CHECK_CONSTRAINT},
+	/* pg_operator */
+	{OPEROID, MDCACHE_OPERATOR | MDCACHE_SCALAR_CMP},
+	/* pg_opfamily */
+	{OPFAMILYOID, MDCACHE_TYPE | MDCACHE_OPERATOR | MDCACHE_SCALAR_CMP | MDCACHE_INDEX},
+	/* pg_partition */
+	{PARTOID, MDCACHE_RELATION | MDCACHE_INDEX | MDCACHE_REL_STATS | MDCACHE_COL_STATS},
+	/* pg_partition_rule */
+	{PARTRULEOID, MDCACHE_RELATION | MDCACHE_INDEX | MDCACHE_REL_STATS | MDCACHE_COL_STATS},
+	/* pg_type */
+	{TYPEOID, MDCACHE_TYPE},
+	/* pg_proc */
+	{PROCOID, MDCACHE_FUNCTION | MDCACHE_AGGREGATE | MDCACHE_CAST | MDCACHE_TRIGGER},
+
+	/*
+	 * lookup_type_cache() will also access pg_opclass, via GetDefaultOpClass(),
+	 * but there is no syscache for it. Postgres doesn't seem to worry about
+	 * invalidating the type cache on updates to pg_opclass, so we don't
+	 * worry about that either.
+	 */
+	/* pg_opclass */
+
+	/*
+	 * Information from the following catalogs are included in the
+	 * relcache, and any updates will generate relcache invalidation
+	 * event. We'll catch the relcache invalidation event and don't need
+	 * to register a catcache callback for them.
+	 */
+	/* pg_class */
+	/* pg_index */
+	/* pg_trigger */
+
+	/*
+	 * pg_statistic is not in the relcache, but its updates generate a
+	 * relcache invalidation event of the relation too (see
+	 * PrepareForTupleInvalidation), so that only the statistics of that
+	 * relation are invalidated.
+	 */
+	/* pg_statistic */
+
+	/*
+	 * pg_exttable is only updated when a new external table is dropped/created,
+	 * which will trigger a relcache invalidation event.
+	 */
+	/* pg_exttable */
+
+	/*
+	 * XXX: no syscache on pg_inherits. Is that OK? For any partitioning
+	 * changes, I think there will also be updates on pg_partition and/or
+	 * pg_partition_rules.
+	 */
+	/* pg_inherits */
+
+	/*
+	 * We assume that gp_segment_config will not change on the fly in a way that
+	 * would affect ORCA
+	 */
+	/* gp_segment_config */
+};
+
+
+const int	MDCacheNumSyscaches = lengthof(MDCacheSyscaches);
+
+static Cache *mdsharedcache = NULL;
+static MDSharedCacheCtl *mdsharedcacheCtl = NULL;
+
+static Size
+MDSharedCache_EntrySize(void)
+{
+	return offsetof(MDSharedCacheEntry, data) + optimizer_mdcache_shared_entry_size * 1024L;
+}
+
+static bool
+MDSharedCache_IsConfigured(void)
+{
+	return Gp_role == GP_ROLE_DISPATCH && 0 < optimizer_mdcache_shared_entries;
+}
+
+/*
+ * Nothing to clean up when an entry is removed, the payload is self-contained
+ */
+static void
+MDSharedCache_CleanupEntry(const void *resource)
+{
+}
+
+/*
+ * Can this transaction use the cache?
+ *
+ * A transaction that has modified the catalog has an xid, and so does one
+ * with pending invalidations.
+ */
+static bool
+MDSharedCache_IsUsable(void)
+{
+	return InvalidTransactionId == GetTopTransactionIdIfAny();
+}
+
+/*
+ * Slot of a relation in relGeneration
+ */
+static int
+MDSharedCache_RelSlot(Oid relid)
+{
+	return relid % MDSHAREDCACHE_REL_SLOTS;
+}
+
+/*
+ * Is an object of the given kind and relation, translated starting at the
+ * given generation, still current?
+ */
+static bool
+MDSharedCache_IsCurrent(int kind, Oid relid, uint32 generation)
+{
+	int			i;
+
+	for (i = 0; i < MDCACHE_NUM_KINDS; i++)
+	{
+		if (0 != (kind & (1 << i)) &&
+			MDSHAREDCACHE_GEN_NEWER(pg_atomic_read_u32(&mdsharedcacheCtl->kindGeneration[i]),
+									generation))
+			return false;
+	}
+
+	if (OidIsValid(relid) &&
+		MDSHAREDCACHE_GEN_NEWER(pg_atomic_read_u32(&mdsharedcacheCtl->relGeneration[MDSharedCache_RelSlot(relid)]),
+								generation))
+		return false;
+
+	return true;
+}
+
+/*
+ * Record an invalidation at the given generation, unless a newer one has
+ * been recorded already
+ */
+static void
+MDSharedCache_RecordInvalidation(pg_atomic_uint32 *lastGeneration, uint32 generation)
+{
+	uint32		old = pg_atomic_read_u32(lastGeneration);
+
+	while (MDSHAREDCACHE_GEN_NEWER(generation, old))
+	{
+		if (pg_atomic_compare_exchange_u32(lastGeneration, &old, generation))
+			break;
+	}
+}
+
+/*
+ * Match function for eviction: any entry that nobody uses
+ */
+static bool
+MDSharedCache_MatchUnused(const CacheEntry *entry, const void *param)
+{
+	return 0 == entry->pinCount;
+}
+
+/*
+ * Compute the size of shared memory for the metadata shared cache
+ */
+Size
+MDSharedCache_ShmemSize(void)
+{
+	Size		size = 0;
+
+	if (!MDSharedCache_IsConfigured())
+		return 0;
+
+	size = add_size(size, MAXALIGN(sizeof(MDSharedCacheCtl)));
+	size = add_size(size, Cache_SharedMemSize(optimizer_mdcache_shared_entries,
+											  MDSharedCache_EntrySize()));
+	return size;
+}
+
+/*
+ * Initialize the metadata shared cache in shared memory, or attach to it
+ */
+void
+MDSharedCache_ShmemInit(void)
+{
+	CacheCtl	cacheCtl;
+	bool		found = false;
+
+	if (!MDSharedCache_IsConfigured())
+		return;
+
+	mdsharedcacheCtl = (MDSharedCacheCtl *)
+		ShmemInitStruct("ORCA Metadata Shared Cache Control", sizeof(MDSharedCacheCtl), &found);
+	if (!found)
+	{
+		int			i;
+
+		pg_atomic_init_u32(&mdsharedcacheCtl->generation, 0);
+		for (i = 0; i < MDCACHE_NUM_KINDS; i++)
+			pg_atomic_init_u32(&mdsharedcacheCtl->kindGeneration[i], 0);
+		for (i = 0; i < MDSHAREDCACHE_REL_SLOTS; i++)
+			pg_atomic_init_u32(&mdsharedcacheCtl->relGeneration[i], 0);
+		pg_atomic_init_u32(&mdsharedcacheCtl->evictionHand, 0);
+	}
+
+	MemSet(&cacheCtl, 0, sizeof(CacheCtl));
+
+	cacheCtl.maxSize = optimizer_mdcache_shared_entries;
+	cacheCtl.cacheName = "ORCA Metadata Shared Cache";
+	cacheCtl.entrySize = MDSharedCache_EntrySize();
+	cacheCtl.keySize = MDCACHE_ENTRY_KEY_SIZE;
+	cacheCtl.keyOffset = GPDB_OFFSET(MDSharedCacheEntry, desc);
+
+	cacheCtl.hash = tag_hash;
+	cacheCtl.keyCopy = (HashCopyFunc) memcpy;
+	cacheCtl.match = (HashCompareFunc) memcmp;
+	cacheCtl.cleanupEntry = MDSharedCache_CleanupEntry;
+	cacheCtl.populateEntry = NULL;
+
+	cacheCtl.baseLWLockId = FirstMDSharedCacheLock;
+	cacheCtl.numPartitions = NUM_MDSHAREDCACHE_PARTITIONS;
+
+	mdsharedcache = Cache_Create(&cacheCtl);
+	Assert(NULL != mdsharedcache);
+}
+
+/*
+ * Is the metadata shared cache available in this process?
+ */
+bool
+MDSharedCache_IsEnabled(void)
+{
+	return NULL != mdsharedcache;
+}
+
+/*
+ * Returns the current invalidation generation. Callers take it before
+ * translating an object, and pass it to MDSharedCache_Insert.
+ */
+uint32
+MDSharedCache_GetGeneration(void)
+{
+	Assert(NULL != mdsharedcacheCtl);
+
+	return pg_atomic_read_u32(&mdsharedcacheCtl->generation);
+}
+
+/*
+ * Look up an object by the key in desc.
+ *
+ * Returns a palloc'd copy of the serialized object, and fills in the kind
+ * and relation of the object in desc, or returns NULL if the object is not
+ * cached, or if this transaction can't use the cache. A stale entry found
+ * on the way is removed.
+ */
+char *
+MDSharedCache_Lookup(MDCacheEntry *desc)
+{
+	CacheEntry *entry;
+	MDSharedCacheEntry *mdentry;
+	char	   *data = NULL;
+
+	Assert(NULL != mdsharedcache);
+	Assert(NULL != desc);
+
+	if (!MDSharedCache_IsUsable())
+		return NULL;
+
+	entry = Cache_Lookup(mdsharedcache, desc);
+	if (NULL == entry)
+		return NULL;
+
+	/* Cached entries are immutable, no need to lock while copying */
+	mdentry = (MDSharedCacheEntry *) CACHE_ENTRY_PAYLOAD(entry);
+
+	if (!MDSharedCache_IsCurrent(mdentry->desc.kind, mdentry->desc.relid,
+								 mdentry->generation))
+	{
+		Cache_Remove(mdsharedcache, entry);
+		Cache_Release(mdsharedcache, entry);
+		return NULL;
+	}
+
+	PG_TRY();
+	{
+		data = (char *) palloc(mdentry->len);
+		memcpy(data, mdentry->data, mdentry->len);
+		desc->kind = mdentry->desc.kind;
+		desc->relid = mdentry->desc.relid;
+	}
+	PG_CATCH();
+	{
+		Cache_Release(mdsharedcache, entry);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	Cache_Release(mdsharedcache, entry);
+
+	return data;
+}
+
+/*
+ * Insert a serialized object in the cache.
+ *
+ * The insertion is silently skipped if the object does not fit in an entry,
+ * if no entry can be freed, if this transaction can't use the cache, or if
+ * the object has been invalidated since generation was taken. An
+ * invalidation that happens after this check is caught by the lookups.
+ */
+void
+MDSharedCache_Insert(const MDCacheEntry *desc, const char *data, uint32 generation)
+{
+	CacheEntry *entry;
+	MDSharedCacheEntry *mdentry;
+	Size		len;
+
+	Assert(NULL != mdsharedcache);
+	Assert(NULL != desc);
+	Assert(NULL != data);
+
+	len = strlen(data) + 1;
+	if (len > (Size) optimizer_mdcache_shared_entry_size * 1024L)
+		return;
+
+	/* The object may have been translated from stale catalog entries */
+	if (!MDSharedCache_IsUsable() ||
+		!MDSharedCache_IsCurrent(desc->kind, desc->relid, generation))
+		return;
+
+	entry = Cache_AcquireEntry(mdsharedcache, NULL /* populate_param */);
+	if (NULL == entry)
+	{
+		/* The cache is full. Evict an unused entry, and try again */
+		uint32		startIdx = pg_atomic_fetch_add_u32(&mdsharedcacheCtl->evictionHand, 1);
+
+		if (0 == Cache_RemoveMatching(mdsharedcache, MDSharedCache_MatchUnused, NULL,
+									  startIdx % optimizer_mdcache_shared_entries, 1 /* maxEntries */))
+			return;
+
+		entry = Cache_AcquireEntry(mdsharedcache, NULL /* populate_param */);
+		if (NULL == entry)
+			return;
+	}
+
+	/* Acquired entries are not visible to other clients yet */
+	mdentry = (MDSharedCacheEntry *) CACHE_ENTRY_PAYLOAD(entry);
+	mdentry->desc = *desc;
+	mdentry->generation = generation;
+	mdentry->len = len;
+	memcpy(mdentry->data, data, len);
+	entry->size = len;
+
+	Cache_Insert(mdsharedcache, entry);
+	Cache_Release(mdsharedcache, entry);
+}
+
+/*
+ * Invalidate the objects of the given kinds, and those belonging to the
+ * given relations
+ */
+static void
+MDSharedCache_Invalidate(int kinds, const Oid *relids, int nrelids)
+{
+	uint32		generation;
+	int			i;
+
+	if (0 == kinds && 0 == nrelids)
+		return;
+
+	generation = pg_atomic_add_fetch_u32(&mdsharedcacheCtl->generation, 1);
+
+	for (i = 0; i < MDCACHE_NUM_KINDS; i++)
+	{
+		if (0 != (kinds & (1 << i)))
+			MDSharedCache_RecordInvalidation(&mdsharedcacheCtl->kindGeneration[i],
+											 generation);
+	}
+
+	for (i = 0; i < nrelids; i++)
+		MDSharedCache_RecordInvalidation(&mdsharedcacheCtl->relGeneration[MDSharedCache_RelSlot(relids[i])],
+										 generation);
+}
+
+/*
+ * Invalidate the objects affected by invalidation messages that this backend
+ * is sending out.
+ *
+ * This is called by the sender only, after its changes have become visible,
+ * so every change is applied once, however many backends receive the
+ * messages. All the messages take a single generation, unless they name more
+ * relations than fit in a batch.
+ */
+void
+MDSharedCache_InvalidateMessages(const SharedInvalidationMessage *msgs, int n)
+{
+	Oid			relids[MDSHAREDCACHE_INVAL_BATCH];
+	int			nrelids = 0;
+	int			kinds = 0;
+	int			i;
+	int			j;
+
+	if (NULL == mdsharedcache)
+		return;
+
+	for (i = 0; i < n; i++)
+	{
+		const SharedInvalidationMessage *msg = &msgs[i];
+
+		if (msg->id >= 0)
+		{
+			for (j = 0; j < MDCacheNumSyscaches; j++)
+			{
+				if (MDCacheSyscaches[j].cacheid == msg->id)
+					kinds |= MDCacheSyscaches[j].kinds;
+			}
+		}
+		else if (msg->id == SHAREDINVALRELCACHE_ID)
+		{
+			if (nrelids == MDSHAREDCACHE_INVAL_BATCH)
+			{
+				MDSharedCache_Invalidate(kinds, relids, nrelids);
+				kinds = 0;
+				nrelids = 0;
+			}
+			relids[nrelids++] = msg->rc.relId;
+		}
+	}
+
+	MDSharedCache_Invalidate(kinds, relids, nrelids);
+}
@@ -30,6 +30,13 @@
  * just to invalidate all plans.  We expect updates on those catalogs to
  * be infrequent enough that more-detailed tracking is not worth the effort.
  *
+ * GPDB: Plans produced by ORCA are additionally cached by the Query they
+ * were optimized from, so that repeated executions of the same query, and
+ * of prepared statements that are replanned with their parameter values,
+ * skip the optimizer.  These plans are invalidated by the same events as
+ * cached plans, and also when statistics are updated or any configuration
+ * parameter changes.  See OptimizerPlanCacheLookup().
+ *
  *
  * Portions Copyright (c) 1996-2008, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -42,8 +49,11 @@
 #include "postgres.h"
 
 #include "utils/plancache.h"
+#include "access/hash.h"
 #include "access/transam.h"
+#include "catalog/gp_policy.h"
 #include "catalog/namespace.h"
+#include "cdb/cdbvars.h"
 #include "executor/executor.h"
 #include "executor/spi.h"
 #include "nodes/nodeFuncs.h"
@@ -53,6 +63,7 @@
 #include "tcop/pquery.h"
 #include "tcop/tcopprot.h"
 #include "tcop/utility.h"
+#include "utils/guc.h"
 #include "utils/inval.h"
 #include "utils/memutils.h"
 #include "utils/resowner.h"
@@ -61,6 +72,24 @@
 
 static List *cached_plans_list = NIL;
 
+/*
+ * A plan produced by ORCA, cached by the Query it was optimized from.
+ * The entry and the plan live in the context of the entry.
+ */
+typedef struct OptimizerCachedPlan
+{
+	char	   *key;			/* see OptimizerPlanCacheKey() */
+	uint32		keyhash;		/* hash of key */
+	uint32		gucChangeCount; /* GUCChangeCount when the plan was made */
+	int			segmentCount;	/* number of segments the plan is for */
+	bool		dead;			/* if true, do not use */
+	PlannedStmt *stmt;			/* the plan */
+	MemoryContext context;		/* context containing this entry */
+} OptimizerCachedPlan;
+
+/* Cached ORCA plans, most recently used first */
+static List *optimizer_cached_plans_list = NIL;
+
 static void StoreCachedPlan(CachedPlanSource *plansource, List *stmt_list,
 				MemoryContext plan_context);
 static void AcquireExecutorLocks(List *stmt_list, bool acquire);
@@ -72,6 +101,13 @@ static bool plan_list_is_transient(List *stmt_list);
 static void PlanCacheRelCallback(Datum arg, Oid relid);
 static void PlanCacheFuncCallback(Datum arg, int cacheid, ItemPointer tuplePtr);
 static void PlanCacheSysCallback(Datum arg, int cacheid, ItemPointer tuplePtr);
+static void PlanCacheStatsCallback(Datum arg, int cacheid, ItemPointer tuplePtr);
+static bool plannedstmt_depends_on_rel(PlannedStmt *plannedstmt, Oid relid);
+static bool plannedstmt_depends_on_item(PlannedStmt *plannedstmt, int cacheid,
+							ItemPointer tuplePtr);
+static void ResetOptimizerPlanCache(void);
+static char *OptimizerPlanCacheKey(Query *query);
+static void DropOptimizerCachedPlans(int keep);
 
 
 /*
@@ -87,6 +123,7 @@ InitPlanCache(void)
 	CacheRegisterSyscacheCallback(NAMESPACEOID, PlanCacheSysCallback, (Datum) 0);
 	CacheRegisterSyscacheCallback(OPEROID, PlanCacheSysCallback, (Datum) 0);
 	CacheRegisterSyscacheCallback(AMOPOPID, PlanCacheSysCallback, (Datum) 0);
+	CacheRegisterSyscacheCallback(STATRELATT, PlanCacheStatsCallback, (Datum) 0);
 }
 
 /*
@@ -1010,8 +1047,7 @@ PlanCacheRelCallback(Datum arg, Oid relid)
 				Assert(!IsA(plannedstmt, Query));
 				if (!IsA(plannedstmt, PlannedStmt))
 					continue;	/* Ignore utility statements */
-				if ((relid == InvalidOid) ? plannedstmt->relationOids != NIL :
-					list_member_oid(plannedstmt->relationOids, relid))
+				if (plannedstmt_depends_on_rel(plannedstmt, relid))
 				{
 					/* Invalidate the plan! */
 					plan->dead = true;
@@ -1027,6 +1063,14 @@ PlanCacheRelCallback(Datum arg, Oid relid)
 				plan->dead = true;
 		}
 	}
+
+	foreach(lc1, optimizer_cached_plans_list)
+	{
+		OptimizerCachedPlan *oplan = (OptimizerCachedPlan *) lfirst(lc1);
+
+		if (!oplan->dead && plannedstmt_depends_on_rel(oplan->stmt, relid))
+			oplan->dead = true;
+	}
 }
 
 /*
@@ -1060,27 +1104,16 @@ PlanCacheFuncCallback(Datum arg, int cacheid, ItemPointer tuplePtr)
 			foreach(lc2, plan->stmt_list)
 			{
 				PlannedStmt *plannedstmt = (PlannedStmt *) lfirst(lc2);
-				ListCell   *lc3;
 
 				Assert(!IsA(plannedstmt, Query));
 				if (!IsA(plannedstmt, PlannedStmt))
 					continue;	/* Ignore utility statements */
-				foreach(lc3, plannedstmt->invalItems)
+				if (plannedstmt_depends_on_item(plannedstmt, cacheid, tuplePtr))
 				{
-					PlanInvalItem *item = (PlanInvalItem *) lfirst(lc3);
-
-					if (item->cacheId != cacheid)
-						continue;
-					if (tuplePtr == NULL ||
-						ItemPointerEquals(tuplePtr, &item->tupleId))
-					{
-						/* Invalidate the plan! */
-						plan->dead = true;
-						break;		/* out of invalItems scan */
-					}
-				}
-				if (plan->dead)
+					/* Invalidate the plan! */
+					plan->dead = true;
 					break;		/* out of stmt_list scan */
+				}
 			}
 		}
 		else
@@ -1104,6 +1137,15 @@ PlanCacheFuncCallback(Datum arg, int cacheid, ItemPointer tuplePtr)
 			}
 		}
 	}
+
+	foreach(lc1, optimizer_cached_plans_list)
+	{
+		OptimizerCachedPlan *oplan = (OptimizerCachedPlan *) lfirst(lc1);
+
+		if (!oplan->dead &&
+			plannedstmt_depends_on_item(oplan->stmt, cacheid, tuplePtr))
+			oplan->dead = true;
+	}
 }
 
 /*
@@ -1118,6 +1160,56 @@ PlanCacheSysCallback(Datum arg, int cacheid, ItemPointer tuplePtr)
 	ResetPlanCache();
 }
 
+/*
+ * PlanCacheStatsCallback
+ *		Syscache inval callback function for STATRELATT cache
+ *
+ * Cached ORCA plans are costed with the statistics at the time they were
+ * made. pg_statistic entries don't identify their relation in the inval
+ * message, so just invalidate all of them.
+ */
+static void
+PlanCacheStatsCallback(Datum arg, int cacheid, ItemPointer tuplePtr)
+{
+	ResetOptimizerPlanCache();
+}
+
+/*
+ * Does the plan depend on the given rel, or on any rel at all if
+ * relid == InvalidOid?
+ */
+static bool
+plannedstmt_depends_on_rel(PlannedStmt *plannedstmt, Oid relid)
+{
+	if (relid == InvalidOid)
+		return plannedstmt->relationOids != NIL;
+
+	return list_member_oid(plannedstmt->relationOids, relid);
+}
+
+/*
+ * Does the plan depend on the given catalog entry, or on any member of the
+ * cache if tuplePtr == NULL?
+ */
+static bool
+plannedstmt_depends_on_item(PlannedStmt *plannedstmt, int cacheid,
+							ItemPointer tuplePtr)
+{
+	ListCell   *lc;
+
+	foreach(lc, plannedstmt->invalItems)
+	{
+		PlanInvalItem *item = (PlanInvalItem *) lfirst(lc);
+
+		if (item->cacheId != cacheid)
+			continue;
+		if (tuplePtr == NULL ||
+			ItemPointerEquals(tuplePtr, &item->tupleId))
+			return true;
+	}
+	return false;
+}
+
 /*
  * ResetPlanCache: drop all cached plans.
  */
@@ -1134,4 +1226,199 @@ ResetPlanCache(void)
 		if (plan)
 			plan->dead = true;
 	}
+
+	ResetOptimizerPlanCache();
+}
+
+/*
+ * ResetOptimizerPlanCache: drop all cached ORCA plans.
+ */
+static void
+ResetOptimizerPlanCache(void)
+{
+	ListCell   *lc;
+
+	foreach(lc, optimizer_cached_plans_list)
+	{
+		OptimizerCachedPlan *oplan = (OptimizerCachedPlan *) lfirst(lc);
+
+		oplan->dead = true;
+	}
+}
+
+/*
+ * Free the dead cached ORCA plans, and the least recently used ones beyond
+ * the first 'keep'.
+ *
+ * Inval callbacks only mark the plans dead, they are freed here.
+ */
+static void
+DropOptimizerCachedPlans(int keep)
+{
+	ListCell   *lc;
+	ListCell   *prev = NULL;
+	ListCell   *next;
+	int			nkept = 0;
+
+	for (lc = list_head(optimizer_cached_plans_list); lc != NULL; lc = next)
+	{
+		OptimizerCachedPlan *oplan = (OptimizerCachedPlan *) lfirst(lc);
+
+		next = lnext(lc);
+
+		if (!oplan->dead && nkept < keep)
+		{
+			nkept++;
+			prev = lc;
+			continue;
+		}
+
+		optimizer_cached_plans_list =
+			list_delete_cell(optimizer_cached_plans_list, lc, prev);
+		MemoryContextDelete(oplan->context);
+	}
+}
+
+/*
+ * OptimizerPlanCacheKey: build the cache key of a Query.
+ *
+ * This is the nodeToString() of the Query, followed by its intoPolicy.
+ * _outQuery() doesn't serialize the policy, but it determines the
+ * distribution of the target table of CREATE TABLE AS and SELECT INTO, so
+ * statements that differ only in their DISTRIBUTED BY clause must not share
+ * a plan.
+ */
+static char *
+OptimizerPlanCacheKey(Query *query)
+{
+	StringInfoData buf;
+	GpPolicy   *policy = query->intoPolicy;
+	char	   *str;
+	int			i;
+
+	str = nodeToString(query);
+	if (policy == NULL)
+		return str;
+
+	initStringInfo(&buf);
+	appendStringInfoString(&buf, str);
+	pfree(str);
+
+	appendStringInfo(&buf, " :intoPolicy %d %d", (int) policy->ptype,
+					 policy->nattrs);
+	for (i = 0; i < policy->nattrs; i++)
+		appendStringInfo(&buf, " %d", (int) policy->attrs[i]);
+
+	return buf.data;
+}
+
+/*
+ * OptimizerPlanCacheLookup: find a cached ORCA plan for a Query.
+ *
+ * 'query' is the Query as it is handed to ORCA, after constant folding.
+ * Optimizing equal Query trees with the same catalog contents, statistics
+ * and configuration produces the same plan, so we can reuse it.  (ORCA's
+ * own normalization of the Query is a function of these, too.)
+ *
+ * Returns a copy of the cached plan in the current memory context, or NULL.
+ * In both cases, *key is set to the key of the Query, to be passed to
+ * OptimizerPlanCacheStore() after optimizing, or to NULL if the cache is
+ * disabled.
+ */
+PlannedStmt *
+OptimizerPlanCacheLookup(Query *query, char **key)
+{
+	ListCell   *lc;
+	uint32		keyhash;
+	MemoryContext oldcxt;
+
+	*key = NULL;
+
+	if (optimizer_plan_cache_size <= 0)
+	{
+		DropOptimizerCachedPlans(0);
+		return NULL;
+	}
+
+	*key = OptimizerPlanCacheKey(query);
+	keyhash = DatumGetUInt32(hash_any((const unsigned char *) *key, strlen(*key)));
+
+	foreach(lc, optimizer_cached_plans_list)
+	{
+		OptimizerCachedPlan *oplan = (OptimizerCachedPlan *) lfirst(lc);
+		PlannedStmt *result;
+
+		if (oplan->dead)
+			continue;
+
+		/* plans depend on the settings, and on the size of the cluster */
+		if (oplan->gucChangeCount != GUCChangeCount ||
+			oplan->segmentCount != getgpsegmentCount())
+		{
+			oplan->dead = true;
+			continue;
+		}
+
+		if (oplan->keyhash != keyhash || strcmp(oplan->key, *key) != 0)
+			continue;
+
+		/* Found it. Move it to the front, it's the most recently used now. */
+		oldcxt = MemoryContextSwitchTo(CacheMemoryContext);
+		optimizer_cached_plans_list =
+			lcons(oplan, list_delete_ptr(optimizer_cached_plans_list, oplan));
+		MemoryContextSwitchTo(oldcxt);
+
+		result = (PlannedStmt *) copyObject(oplan->stmt);
+		result->planFromCache = true;
+		return result;
+	}
+
+	return NULL;
+}
+
+/*
+ * OptimizerPlanCacheStore: cache a plan produced by ORCA.
+ *
+ * 'key' is as returned by OptimizerPlanCacheLookup().
+ */
+void
+OptimizerPlanCacheStore(char *key, PlannedStmt *stmt)
+{
+	MemoryContext plan_context;
+	MemoryContext oldcxt;
+	OptimizerCachedPlan *oplan;
+
+	Assert(IsA(stmt, PlannedStmt));
+
+	if (key == NULL || optimizer_plan_cache_size <= 0)
+		return;
+
+	/* Plans that must be redone when TransactionXmin changes are not reused */
+	if (stmt->transientPlan)
+		return;
+
+	/* Make room for the new plan */
+	DropOptimizerCachedPlans(optimizer_plan_cache_size - 1);
+
+	plan_context = AllocSetContextCreate(CacheMemoryContext,
+										 "OptimizerCachedPlan",
+										 ALLOCSET_SMALL_MINSIZE,
+										 ALLOCSET_SMALL_INITSIZE,
+										 ALLOCSET_DEFAULT_MAXSIZE);
+
+	oldcxt = MemoryContextSwitchTo(plan_context);
+
+	oplan = (OptimizerCachedPlan *) palloc(sizeof(OptimizerCachedPlan));
+	oplan->key = pstrdup(key);
+	oplan->keyhash = DatumGetUInt32(hash_any((const unsigned char *) key, strlen(key)));
+	oplan->gucChangeCount = GUCChangeCount;
+	oplan->segmentCount = getgpsegmentCount();
+	oplan->dead = false;
+	oplan->stmt = (PlannedStmt *) copyObject(stmt);
+	oplan->context = plan_context;
+
+	MemoryContextSwitchTo(CacheMemoryContext);
+	optimizer_cached_plans_list = lcons(oplan, optimizer_cached_plans_list);
+
+	MemoryContextSwitchTo(oldcxt);
 }
@@ -635,6 +635,155 @@ Cache_Insert(Cache *cache, CacheEntry *entry)
 			&cacheStats->maxTimeInsert);
 }
 
+/*
+ * Look up a cached entry with the given key.
+ *
+ * The entry found is pinned and registered for cleanup. The client must
+ * release it with Cache_Release when done. Entries marked for deletion are
+ * not returned.
+ *
+ * Returns NULL if no entry matches the key.
+ */
+CacheEntry *
+Cache_Lookup(Cache *cache, const void *key)
+{
+	Assert(NULL != cache);
+	Assert(NULL != key);
+
+	Cache_Stats *cacheStats = &cache->cacheHdr->cacheStats;
+	Cache_AddPerfCounter(&cacheStats->noLookups, 1 /* delta */);
+
+	uint32 hashvalue = cache->hash(key, cache->cacheHdr->keySize);
+
+	volatile CacheAnchor *anchor = SyncHTLookup(cache->syncHashtable, &hashvalue);
+	if (NULL == anchor)
+	{
+		return NULL;
+	}
+
+	CacheEntry *foundEntry = NULL;
+
+	/* Acquire anchor lock to walk the chain */
+	SpinLockAcquire(&anchor->spinlock);
+
+	CacheEntry *crtEntry = anchor->firstEntry;
+	while (NULL != crtEntry)
+	{
+		if (CACHE_ENTRY_CACHED == crtEntry->state)
+		{
+			Cache_AddPerfCounter(&cacheStats->noCompares, 1 /* delta */);
+
+			void *entryKey = (char *) CACHE_ENTRY_PAYLOAD(crtEntry) + cache->cacheHdr->keyOffset;
+			if (0 == cache->match(key, entryKey, cache->cacheHdr->keySize))
+			{
+				Cache_EntryAddRef(cache, crtEntry);
+				foundEntry = crtEntry;
+				break;
+			}
+		}
+		crtEntry = crtEntry->nextEntry;
+	}
+
+	SpinLockRelease(&anchor->spinlock);
+
+	SyncHTRelease(cache->syncHashtable, (void *) anchor);
+
+	if (NULL != foundEntry)
+	{
+		Cache_RegisterCleanup(cache, foundEntry, true /* isCachedEntry */);
+		Cache_AddPerfCounter(&cacheStats->noCacheHits, 1 /* delta */);
+	}
+
+	return foundEntry;
+}
+
+/*
+ * Mark for removal the cached entries for which the match function returns
+ * true.
+ *
+ * The entry array is scanned starting at index startIdx, and the scan stops
+ * after maxEntries entries have been removed (0 means no limit). An entry
+ * that is in use by other clients is physically removed once they all
+ * release it.
+ *
+ * The match function is called with the anchor of the entry locked, so the
+ * entry header and payload are stable, but it must not block.
+ *
+ * Returns the number of entries removed.
+ */
+uint32
+Cache_RemoveMatching(Cache *cache, Cache_ClientMatchFunc match, const void *param,
+		uint32 startIdx, uint32 maxEntries)
+{
+	Assert(NULL != cache);
+	Assert(NULL != match);
+
+	CacheHdr *cacheHdr = cache->cacheHdr;
+	uint32 nRemoved = 0;
+	uint32 i = 0;
+
+	for (i = 0; i < cacheHdr->nEntries; i++)
+	{
+		CacheEntry *entry = Cache_GetEntryByIndex(cacheHdr, (startIdx + i) % cacheHdr->nEntries);
+
+		/* Unsynchronized check, repeated below while holding the anchor lock */
+		if (CACHE_ENTRY_CACHED != entry->state)
+		{
+			continue;
+		}
+
+		uint32 hashvalue = entry->hashvalue;
+		volatile CacheAnchor *anchor = SyncHTLookup(cache->syncHashtable, &hashvalue);
+		if (NULL == anchor)
+		{
+			continue;
+		}
+
+		bool removeEntry = false;
+
+		SpinLockAcquire(&anchor->spinlock);
+
+		/* The entry may have been removed or reused since we first looked at it */
+		CacheEntry *crtEntry = anchor->firstEntry;
+		while (NULL != crtEntry && crtEntry != entry)
+		{
+			crtEntry = crtEntry->nextEntry;
+		}
+
+		if (NULL != crtEntry && match(entry, param))
+		{
+			uint32 expected = CACHE_ENTRY_CACHED;
+			if (pg_atomic_compare_exchange_u32((pg_atomic_uint32 *)&entry->state, &expected, CACHE_ENTRY_DELETED))
+			{
+				/* Pin the entry, so that releasing it below deletes it if unused */
+				Cache_EntryAddRef(cache, entry);
+				removeEntry = true;
+			}
+		}
+
+		SpinLockRelease(&anchor->spinlock);
+
+		SyncHTRelease(cache->syncHashtable, (void *) anchor);
+
+		if (removeEntry)
+		{
+			Cache_DecPerfCounter(&cacheHdr->cacheStats.noCachedEntries, 1 /* delta */);
+			Cache_AddPerfCounter(&cacheHdr->cacheStats.noDeletedEntries, 1 /* delta */);
+			Cache_AddPerfCounter(&cacheHdr->cacheStats.noEvicts, 1 /* delta */);
+
+			Cache_ReleaseCached(cache, entry, false /* unregisterCleanup */);
+
+			nRemoved++;
+			if (0 < maxEntries && nRemoved >= maxEntries)
+			{
+				break;
+			}
+		}
+	}
+
+	return nRemoved;
+}
+
 /*
  * Unlink a cache entry from the chain anchored at a CacheAnchor.
  *
@@ -809,7 +958,7 @@ Cache_ReleaseCached(Cache *cache, CacheEntry *entry, bool unregisterCleanup)
  * The entry will physically be removed once all using clients release it.
  *
  * This function is not synchronized. Multiple clients can mark an entry
- * deleted.
+ * deleted; only the first one has any effect.
  */
 void
 Cache_Remove(Cache *cache, CacheEntry *entry)
@@ -817,11 +966,11 @@ Cache_Remove(Cache *cache, CacheEntry *entry)
 	Assert(NULL != entry);
 
 	uint32 expected = CACHE_ENTRY_CACHED;
-#ifdef USE_ASSERT_CHECKING
-	int32 casResult =
-#endif
-	pg_atomic_compare_exchange_u32((pg_atomic_uint32 *)&entry->state, &expected, CACHE_ENTRY_DELETED);
-	Assert(casResult == 1);
+	if (!pg_atomic_compare_exchange_u32((pg_atomic_uint32 *)&entry->state, &expected, CACHE_ENTRY_DELETED))
+	{
+		Assert(CACHE_ENTRY_DELETED == expected);
+		return;
+	}
 
 	Cache_DecPerfCounter(&cache->cacheHdr->cacheStats.noCachedEntries, 1 /* delta */);
 	Cache_AddPerfCounter(&cache->cacheHdr->cacheStats.noDeletedEntries, 1 /* delta */);
@@ -2699,6 +2699,12 @@ static bool reporting_enabled;	/* TRUE to enable GUC_REPORT */
 
 static int	GUCNestLevel = 0;	/* 1 when in main transaction */
 
+/*
+ * Incremented whenever the value of any variable may have changed, so that
+ * caches of results that depend on the settings can tell they are stale.
+ */
+uint32		GUCChangeCount = 0;
+
 
 static int	guc_var_compare(const void *a, const void *b);
 static int	guc_name_compare(const char *namea, const char *nameb);
@@ -3661,6 +3667,8 @@ ResetAllOptions(void)
 {
 	int			i;
 
+	GUCChangeCount++;
+
 	for (i = 0; i < num_guc_variables; i++)
 	{
 		struct config_generic *gconf = guc_variables[i];
@@ -4115,6 +4123,9 @@ AtEOXact_GUC(bool isCommit, int nestLevel)
 			gconf->stack = prev;
 			pfree(stack);
 
+			if (changed)
+				GUCChangeCount++;
+
 			/* Report new value if we changed it */
 			if (changed && (gconf->flags & GUC_REPORT))
 				ReportGUCOption(gconf);
@@ -5130,6 +5141,9 @@ set_config_option(const char *name, const char *value,
 			}
 	}
 
+	if (changeVal)
+		GUCChangeCount++;
+
 	if (changeVal && (record->flags & GUC_REPORT))
 		ReportGUCOption(record);
 
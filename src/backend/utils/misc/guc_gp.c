@@ -350,6 +350,7 @@ static char *gp_log_fts_str;
 static char *gp_log_interconnect_str;
 static char *gp_interconnect_type_str;
 static char *gp_interconnect_fc_method_str;
+static char *gp_interconnect_congestion_control_str;
 
 /*
  * These variables are all dummies that don't do anything, except in some
@@ -487,6 +488,11 @@ bool		optimizer_print_plan;
 bool		optimizer_print_xform;
 bool		optimizer_metadata_caching;
 int		optimizer_mdcache_size;
+int		optimizer_mdcache_shared_entries;
+int		optimizer_mdcache_shared_entry_size;
+int		optimizer_plan_cache_size;
+int		optimizer_parallel_workers;
+int		optimizer_time_budget;
 bool		optimizer_disable_xform_result_printing;
 bool		optimizer_print_memo_after_exploration;
 bool		optimizer_print_memo_after_implementation;
@@ -496,6 +502,7 @@ bool		optimizer_print_expression_properties;
 bool		optimizer_print_group_properties;
 bool		optimizer_print_optimization_context;
 bool		optimizer_print_optimization_stats;
+bool		optimizer_print_translation_stats;
 bool		optimizer_local;
 int			optimizer_retries;
 /* array of xforms disable flags */
@@ -577,9 +584,17 @@ bool		codegen_exec_variable_list;
 bool		codegen_slot_getattr;
 bool		codegen_exec_eval_expr;
 bool		codegen_advance_aggregate;
+bool		codegen_eval_hash_key;
+bool		codegen_memtuple_deform;
+bool		codegen_hash_join;
+bool		codegen_async_compile;
 int		codegen_varlen_tolerance;
 int		codegen_optimization_level;
+int		codegen_min_rows;
+int		codegen_aggressive_rows;
 static char 	*codegen_optimization_level_str = NULL;
+int		codegen_object_cache_size;
+char	   *codegen_object_cache_directory = NULL;
 
 
 /* Security */
@@ -1290,6 +1305,17 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_coalesce_recv", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Forms received tuples straight from the interconnect packets."),
+			gettext_noop("Each packet is handed to the motion layer as a whole, and the whole "
+						 "tuples in it are formed without going through a list of tuple chunks."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&gp_interconnect_coalesce_recv,
+		false, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_log_stats", PGC_USERSET, QUERY_TUNING_OTHER,
 			gettext_noop("Emit statistics from the UDP-IC at the end of every statement."),
@@ -2743,6 +2769,16 @@ struct config_bool ConfigureNamesBool_gp[] =
 		false, NULL, NULL
 	},
 
+	{
+		{"optimizer_print_translation_stats", PGC_USERSET, LOGGING_WHAT,
+			gettext_noop("Print the time spent translating each kind of DXL operator to a plan."),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE
+		},
+		&optimizer_print_translation_stats,
+		false, NULL, NULL
+	},
+
 	{
 		{"optimizer_extract_dxl_stats", PGC_USERSET, LOGGING_WHAT,
 			gettext_noop("Extract plan stats in dxl."),
@@ -3352,6 +3388,62 @@ struct config_bool ConfigureNamesBool_gp[] =
 #endif
 		assign_codegen, NULL
 	},
+	{
+		{"codegen_eval_hash_key", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Enable codegen for hash key evaluation in redistribute motions"),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&codegen_eval_hash_key,
+#ifdef USE_CODEGEN
+		true,
+#else
+		false,
+#endif
+		assign_codegen, NULL
+	},
+	{
+		{"codegen_memtuple_deform", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Enable codegen for deforming memtuples in slot_getattr"),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&codegen_memtuple_deform,
+#ifdef USE_CODEGEN
+		true,
+#else
+		false,
+#endif
+		assign_codegen, NULL
+	},
+	{
+		{"codegen_hash_join", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Enable codegen for hash value computation and bucket scans of hash joins"),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&codegen_hash_join,
+#ifdef USE_CODEGEN
+		true,
+#else
+		false,
+#endif
+		assign_codegen, NULL
+	},
+	{
+		{"codegen_async_compile", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Compile generated code in the background, while the first tuples are processed without it"),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&codegen_async_compile,
+#ifdef USE_CODEGEN
+		true,
+#else
+		false,
+#endif
+		assign_codegen, NULL
+	},
 
 	{
 		{"vmem_process_interrupt", PGC_USERSET, DEVELOPER_OPTIONS,
@@ -3818,6 +3910,16 @@ struct config_int ConfigureNamesInt_gp[] =
 		2, 1, 4096, NULL, NULL
 	},
 
+	{
+		{"gp_interconnect_batch_size", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the maximum number of packets sent or received with one system call in the UDP interconnect"),
+			gettext_noop("Batches use sendmmsg() and recvmmsg() where available. 1 sends and receives packets one at a time."),
+			GUC_GPDB_ADDOPT
+		},
+		&Gp_interconnect_batch_size,
+		1, 1, 64, NULL, NULL
+	},
+
 	{
 		{"gp_interconnect_timer_period", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Sets the timer period (in ms) for UDP interconnect"),
@@ -4678,6 +4780,58 @@ struct config_int ConfigureNamesInt_gp[] =
 		0, 0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"optimizer_mdcache_shared_entries", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the number of entries of the MDCache shared by all sessions."),
+			gettext_noop("Zero disables the shared MDCache."),
+			GUC_GPDB_ADDOPT
+		},
+		&optimizer_mdcache_shared_entries,
+		0, 0, INT_MAX / 2, NULL, NULL
+	},
+
+	{
+		{"optimizer_mdcache_shared_entry_size", PGC_POSTMASTER, RESOURCES_MEM,
+			gettext_noop("Sets the size of an entry of the MDCache shared by all sessions."),
+			gettext_noop("Metadata objects larger than this are not shared."),
+			GUC_UNIT_KB | GUC_GPDB_ADDOPT
+		},
+		&optimizer_mdcache_shared_entry_size,
+		32, 1, 1024, NULL, NULL
+	},
+
+	{
+		{"optimizer_plan_cache_size", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the number of plans produced by ORCA that are cached for reuse in a session."),
+			gettext_noop("Zero disables the cache."),
+			GUC_GPDB_ADDOPT
+		},
+		&optimizer_plan_cache_size,
+		0, 0, INT_MAX, NULL, NULL
+	},
+
+	{
+		{"optimizer_parallel_workers", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the number of worker threads ORCA uses to optimize a query."),
+			gettext_noop("Values of 0 and 1 optimize serially. The number is limited by the number of cores, "
+						 "shared among the active statements allowed by the resource queue."),
+			GUC_GPDB_ADDOPT
+		},
+		&optimizer_parallel_workers,
+		0, 0, 64, NULL, NULL
+	},
+
+	{
+		{"optimizer_time_budget", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Sets the maximum time ORCA searches for a plan."),
+			gettext_noop("When the budget is exhausted, the cheapest plan found so far is used. "
+						 "Zero means no limit. Ignored when optimizer_search_strategy_path is set."),
+			GUC_UNIT_MS | GUC_GPDB_ADDOPT
+		},
+		&optimizer_time_budget,
+		0, 0, INT_MAX, NULL, NULL
+	},
+
 	{
 		{"memory_profiler_dataset_size", PGC_USERSET, DEVELOPER_OPTIONS,
 			gettext_noop("Set the size in GB"),
@@ -4753,6 +4907,41 @@ struct config_int ConfigureNamesInt_gp[] =
 		0, INT_MAX, NULL, NULL
 	},
 
+	{
+		{"codegen_object_cache_size", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Sets the maximum number of compiled codegen modules kept in memory for reuse by later queries."),
+			gettext_noop("Zero disables the in-memory cache."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&codegen_object_cache_size,
+#ifdef USE_CODEGEN
+		64,
+#else
+		0,
+#endif
+		0, INT_MAX, NULL, NULL
+	},
+
+	{
+		{"codegen_min_rows", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Sets the minimum estimated number of rows a plan node must process to generate code for it."),
+			NULL,
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&codegen_min_rows,
+		10000, 0, INT_MAX, NULL, NULL
+	},
+
+	{
+		{"codegen_aggressive_rows", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Sets the estimated number of rows above which the code generated for a plan node is compiled with aggressive optimization."),
+			gettext_noop("Zero always uses codegen_optimization_level."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_GPDB_ADDOPT
+		},
+		&codegen_aggressive_rows,
+		1000000, 0, INT_MAX, NULL, NULL
+	},
+
 	{
 		{"dtx_phase2_retry_count", PGC_SUSET, DEVELOPER_OPTIONS,
 			gettext_noop("Maximum number of retries during two phase commit after which master PANICs."),
@@ -5192,7 +5381,8 @@ struct config_string ConfigureNamesString_gp[] =
 	{
 		{"gp_interconnect_type", PGC_USERSET, GP_ARRAY_TUNING,
 			gettext_noop("Sets the protocol used for inter-node communication."),
-			gettext_noop("Only support \"udpifc\" for now."),
+			gettext_noop("Valid values are \"udpifc\" and \"udpifc_shm\". \"udpifc_shm\" sends the "
+						 "motions between segments on the same host through shared memory."),
 			GUC_GPDB_ADDOPT | GUC_NO_SHOW_ALL | GUC_DISALLOW_IN_FILE
 		},
 		&gp_interconnect_type_str,
@@ -5209,6 +5399,16 @@ struct config_string ConfigureNamesString_gp[] =
 		"loss", gpvars_assign_gp_interconnect_fc_method, gpvars_show_gp_interconnect_fc_method
 	},
 
+	{
+		{"gp_interconnect_congestion_control", PGC_USERSET, GP_ARRAY_TUNING,
+			gettext_noop("Sets the congestion control algorithm of the loss flow control method of UDP interconnect."),
+			gettext_noop("Valid values are \"reno\", \"cubic\" and \"paced\"."),
+			GUC_GPDB_ADDOPT
+		},
+		&gp_interconnect_congestion_control_str,
+		"reno", gpvars_assign_gp_interconnect_congestion_control, gpvars_show_gp_interconnect_congestion_control
+	},
+
 	{
 		{"gp_qd_hostname", PGC_BACKEND, GP_WORKER_IDENTITY,
 			gettext_noop("Shows the QD Hostname. Blank when run on the QD"),
@@ -5543,6 +5743,16 @@ struct config_string ConfigureNamesString_gp[] =
 		assign_codegen_optimization_level, NULL
 	},
 
+	{
+		{"codegen_object_cache_directory", PGC_SUSET, DEVELOPER_OPTIONS,
+			gettext_noop("Sets the directory where compiled codegen modules are saved for reuse by other sessions."),
+			gettext_noop("An empty string disables the on-disk cache."),
+			GUC_NO_SHOW_ALL | GUC_NOT_IN_SAMPLE | GUC_SUPERUSER_ONLY
+		},
+		&codegen_object_cache_directory,
+		"", NULL, NULL
+	},
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, NULL, NULL, NULL
@@ -925,6 +925,31 @@ GetResQueueId(void)
 }
 
 
+/*
+ * GetResQueueActiveStatementsLimit -- return the limit on active statements
+ * of the resource queue of the current role, or INVALID_RES_LIMIT_THRESHOLD
+ * if there is none.
+ */
+int
+GetResQueueActiveStatementsLimit(void)
+{
+	ResQueue	queue;
+	int			limit = INVALID_RES_LIMIT_THRESHOLD;
+
+	if (!ResourceScheduler || !OidIsValid(MyQueueId))
+		return INVALID_RES_LIMIT_THRESHOLD;
+
+	LWLockAcquire(ResQueueLock, LW_SHARED);
+	queue = ResQueueHashFind(MyQueueId);
+	if (queue != NULL &&
+		queue->limits[RES_COUNT_LIMIT].threshold_value != INVALID_RES_LIMIT_THRESHOLD)
+		limit = (int) queue->limits[RES_COUNT_LIMIT].threshold_value;
+	LWLockRelease(ResQueueLock);
+
+	return limit;
+}
+
+
 /*
  * ResQueueIdForName -- Return the Oid for a resource queue name
  *
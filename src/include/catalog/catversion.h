@@ -56,6 +56,6 @@
  */
 
 /*							3yyymmddN */
-#define CATALOG_VERSION_NO	301612281
+#define CATALOG_VERSION_NO	301612284
 
 #endif
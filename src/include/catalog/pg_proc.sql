@@ -1759,6 +1759,10 @@ CREATE FUNCTION gp_nondbspecific_ptcat_verification() RETURNS bool LANGUAGE inte
  CREATE FUNCTION enable_xform(text) RETURNS text LANGUAGE internal IMMUTABLE STRICT AS 'enable_xform' WITH (OID=6088, DESCRIPTION="enables transformations in the optimizer");
 
  CREATE FUNCTION gp_opt_version() RETURNS text LANGUAGE internal IMMUTABLE STRICT AS 'gp_opt_version' WITH (OID=6089, DESCRIPTION="Returns the optimizer and gpos library versions");
+
+ CREATE FUNCTION gp_opt_stats(OUT phase text, OUT time_ms float8, OUT memory_kb int8, OUT shared_cache_hits int8, OUT cache_misses int8) RETURNS SETOF pg_catalog.record LANGUAGE internal VOLATILE AS 'gp_opt_stats' WITH (OID=6083, DESCRIPTION="Returns per-phase statistics of the last query optimized by the optimizer");
+
+ CREATE FUNCTION gp_interconnect_shm_packets() RETURNS int8 LANGUAGE internal VOLATILE STRICT AS 'gp_interconnect_shm_packets' WITH (OID=6119, DESCRIPTION="Returns the number of interconnect packets sent through shared memory on this segment");
  
  
   -- functions for the complex data type
@@ -2913,6 +2913,14 @@ DESCR("enables transformations in the optimizer");
 DATA(insert OID = 6089 ( gp_opt_version  PGNSP PGUID 12 1 0 0 f f t f i 0 0 25 f "" _null_ _null_ _null_ _null_ gp_opt_version _null_ _null_ _null_ n ));
 DESCR("Returns the optimizer and gpos library versions");
 
+/* gp_opt_stats(OUT phase text, OUT time_ms float8, OUT memory_kb int8, OUT shared_cache_hits int8, OUT cache_misses int8) => SETOF pg_catalog.record */ 
+DATA(insert OID = 6083 ( gp_opt_stats  PGNSP PGUID 12 1 1000 0 f f f t v 0 0 2249 f "" "{25,701,20,20,20}" "{o,o,o,o,o}" "{phase,time_ms,memory_kb,shared_cache_hits,cache_misses}" _null_ gp_opt_stats _null_ _null_ _null_ n ));
+DESCR("Returns per-phase statistics of the last query optimized by the optimizer");
+
+/* gp_interconnect_shm_packets() => int8 */ 
+DATA(insert OID = 6119 ( gp_interconnect_shm_packets  PGNSP PGUID 12 1 0 0 f f t f v 0 0 20 f "" _null_ _null_ _null_ _null_ gp_interconnect_shm_packets _null_ _null_ _null_ n ));
+DESCR("Returns the number of interconnect packets sent through shared memory on this segment");
+
 
   /* functions for the complex data type */
 /* complex_in(cstring) => complex */ 
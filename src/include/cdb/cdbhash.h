@@ -10,6 +10,20 @@
 #ifndef CDBHASH_H
 #define CDBHASH_H
 
+/*
+ * The following constants are exposed so that generated code for hash key
+ * evaluation (see eval_hash_key_codegen.cc) produces the same hash values.
+ */
+
+/* 32 bit FNV-1  non-zero initial basis */
+#define FNV1_32_INIT ((uint32)0x811c9dc5)
+
+/* Constant prime value used for an FNV1 hash */
+#define FNV_32_PRIME ((uint32)0x01000193)
+
+/* Constant used for hashing a NULL value */
+#define NULL_VAL ((uint32)0XF0F0F0F1)
+
 /*
  * hashing algorithms.
  */
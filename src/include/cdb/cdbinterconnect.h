@@ -270,6 +270,12 @@ struct MotionConn
 	int			pkt_q_tail;
 	uint8		**pkt_q;
 
+	/*
+	 * Ring in shared memory that replaces the UDP socket for a connection
+	 * between two processes on the same host, NULL for UDP connections.
+	 */
+	struct ICShmRing *shmRing;
+
 	/* Statistics info for this connection */
 	GpMonotonicTime ackWaitBeginTime;
 
@@ -407,6 +407,12 @@ extern int	Gp_max_packet_size;	/* GUC var */
  * Support for multiple "types" of interconnect
  */
 #define INTERCONNECT_TYPE_UDPIFC (0)
+/*
+ * UDPIFC, but motion connections between two segment processes on the same
+ * host (same interconnect listener address) go through a ring buffer in
+ * shared memory instead of UDP sockets.
+ */
+#define INTERCONNECT_TYPE_UDPIFC_SHM (1)
 
 extern int Gp_interconnect_type;
 
@@ -421,6 +427,26 @@ extern int Gp_interconnect_fc_method;
 extern const char *gpvars_assign_gp_interconnect_fc_method(const char *newval, bool doit, GucSource source __attribute__((unused)) );
 extern const char *gpvars_show_gp_interconnect_fc_method(void);
 
+/*
+ * Parameter Gp_interconnect_congestion_control
+ *
+ * The congestion control algorithm of the "loss" flow control method of the
+ * UDP interconnect. "capacity" flow control uses a fixed window instead.
+ *
+ * reno:  additive increase, multiplicative decrease of the window
+ * cubic: window grows as a cubic function of the time since the last loss
+ * paced: window and pacing rate follow the estimated bottleneck bandwidth
+ *        and minimum round-trip time, isolated losses are ignored
+ */
+#define INTERCONNECT_CC_RENO	(0)
+#define INTERCONNECT_CC_CUBIC	(1)
+#define INTERCONNECT_CC_PACED	(2)
+
+extern int Gp_interconnect_congestion_control;
+
+extern const char *gpvars_assign_gp_interconnect_congestion_control(const char *newval, bool doit, GucSource source __attribute__((unused)) );
+extern const char *gpvars_show_gp_interconnect_congestion_control(void);
+
 /*
  * Parameter Gp_interconnect_queue_depth
  *
@@ -443,6 +469,19 @@ extern int	Gp_interconnect_queue_depth;
  *
  */
 extern int	Gp_interconnect_snd_queue_depth;
+
+/*
+ * Parameter Gp_interconnect_batch_size
+ *
+ * The run-time parameter Gp_interconnect_batch_size controls the maximum
+ * number of packets sent with one sendmmsg() call, and received with one
+ * recvmmsg() call. 1 sends and receives packets one at a time.
+ *
+ * This guc is specific to the UDP-interconnect, and has no effect on
+ * platforms without sendmmsg() and recvmmsg().
+ *
+ */
+extern int	Gp_interconnect_batch_size;
 extern int	Gp_interconnect_timer_period;
 extern int	Gp_interconnect_timer_checking_period;
 extern int	Gp_interconnect_default_rtt;
@@ -478,6 +517,15 @@ extern bool gp_interconnect_full_crc;
  */
 extern bool gp_interconnect_log_stats;
 
+/*
+ * Parameter gp_interconnect_coalesce_recv
+ *
+ * Hand each received packet to the motion layer as a whole, and form the
+ * whole tuples in it straight from the receive buffer, instead of going
+ * through a list of tuple chunks.
+ */
+extern bool gp_interconnect_coalesce_recv;
+
 extern bool gp_interconnect_cache_future_packets;
 
 /*
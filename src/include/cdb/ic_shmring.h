@@ -0,0 +1,49 @@
+/*-------------------------------------------------------------------------
+* ic_shmring.h
+*	Shared-memory packet ring for interconnect connections between
+*	processes on the same host.
+*
+* Copyright (c) 2016, Pivotal Software, Inc.
+*-------------------------------------------------------------------------
+*/
+#ifndef IC_SHMRING_H
+#define IC_SHMRING_H
+
+/*
+ * A ring of fixed-size packet slots in a POSIX shared memory object, with a
+ * single sender and a single receiver. The sender fills the slot returned by
+ * ICShmRingGetWriteSlot() in place and publishes it; the receiver reads the
+ * slot returned by ICShmRingPeek() in place and releases it. Neither side
+ * takes a lock. A sender waiting for a free slot can sleep in
+ * ICShmRingWaitRelease(), and is woken up when the receiver releases one.
+ */
+typedef struct ICShmRing ICShmRing;
+
+extern void ICShmRingName(char *buf, int bufsize, int sessionId, int icId,
+			  int motNodeId, int srcPid, int dstPid);
+
+extern ICShmRing *ICShmRingAttach(const char *name, int nslots, int slotSize,
+				bool isSender);
+extern void ICShmRingDetach(ICShmRing *ring);
+extern void ICShmRingRemoveLeftovers(void);
+extern void ICShmRingRemoveOrphans(void);
+
+/* sender side */
+extern uint8 *ICShmRingGetWriteSlot(ICShmRing *ring);
+extern void ICShmRingPublish(ICShmRing *ring);
+extern bool ICShmRingIsEmpty(ICShmRing *ring);
+extern bool ICShmRingStopRequested(ICShmRing *ring);
+extern uint32 ICShmRingNumReleased(ICShmRing *ring);
+extern void ICShmRingWaitRelease(ICShmRing *ring, uint32 released, long timeout);
+
+/* receiver side */
+extern uint8 *ICShmRingPeek(ICShmRing *ring);
+extern void ICShmRingRelease(ICShmRing *ring);
+extern void ICShmRingRequestStop(ICShmRing *ring);
+
+/* statistics of the segment */
+extern Size ICShmRingShmemSize(void);
+extern void ICShmRingShmemInit(void);
+extern void ICShmRingCountSent(uint64 npackets);
+
+#endif   /* IC_SHMRING_H */
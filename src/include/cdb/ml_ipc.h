@@ -181,7 +181,9 @@ extern void SendEosToAMS(MotionLayerState *mlStates,
  * been read from recently).
  *
  * NOTE: The TupleChunkListItem can have other's chained to it.  The caller
- *		 should check and process all in list.
+ *		 should check and process all in list.  With
+ *		 gp_interconnect_coalesce_recv, there is instead a single item, which
+ *		 holds all the chunks of a packet.
  *
  * PARAMETERS:
  *	- motNodeID:  motion node id to receive for.
@@ -107,4 +107,7 @@ extern HeapTuple DeserializeTuple(SerTupInfo * pSerInfo, StringInfo serialTup);
  */
 extern HeapTuple CvtChunksToHeapTup(TupleChunkList tclist, SerTupInfo * pSerInfo);
 
+/* Convert a single TC_WHOLE or TC_EMPTY chunk into a HeapTuple, in place. */
+extern HeapTuple CvtChunkToHeapTup(const char *chunk, int chunkLength, SerTupInfo *pSerInfo);
+
 #endif   /* TUPSER_H */
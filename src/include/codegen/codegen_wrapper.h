@@ -34,6 +34,12 @@ struct PlanState;
 struct AggState;
 struct MemoryManagerContainer;
 struct AggStatePerGroupData;
+struct List;
+struct CdbHash;
+struct HashState;
+struct HashJoinState;
+struct HashJoinTableData;
+struct HashJoinTupleData;
 /*
  * Enum used to mimic ExprDoneCond in ExecEvalExpr function pointer.
  */
@@ -45,16 +51,22 @@ typedef void (*AdvanceAggregatesFn) (struct AggState *aggstate, /*struct AggStat
 typedef void (*ExecVariableListFn) (struct ProjectionInfo *projInfo, Datum *values, bool *isnull);
 typedef Datum (*ExecEvalExprFn) (struct ExprState *expression, struct ExprContext *econtext, bool *isNull, /*ExprDoneCond*/ tmp_enum *isDone);
 typedef Datum (*SlotGetAttrFn) (struct TupleTableSlot *slot, int attnum, bool *isnull);
+typedef uint32 (*EvalHashKeyFn) (struct ExprContext *econtext, struct List *hashkeys, struct List *hashtypes, struct CdbHash *h);
+typedef bool (*ExecHashGetHashValueFn) (struct HashState *hashState, struct HashJoinTableData *hashtable, struct ExprContext *econtext, struct List *hashkeys, bool outer_tuple, bool keep_nulls, uint32 *hashvalue, bool *hashkeys_null);
+typedef struct HashJoinTupleData *(*ExecScanHashBucketFn) (struct HashState *hashState, struct HashJoinState *hjstate, struct ExprContext *econtext);
 
 #ifndef USE_CODEGEN
 
 #define InitCodegen() ((void) 1)
-#define CodeGeneratorManagerCreate(module_name) ((void *) NULL)
+#define CodeGeneratorManagerCreate(module_name, estimated_rows) ((void *) NULL)
 #define CodeGeneratorManagerGenerateCode(manager) ((unsigned int) 1)
 #define CodeGeneratorManagerPrepareGeneratedFunctions(manager) ((unsigned int) 1)
+#define CodeGeneratorManagerPollGeneratedFunctions(manager) ((bool) false)
 #define CodeGeneratorManagerNotifyParameterChange(manager) ((unsigned int) 1)
 #define CodeGeneratorManagerAccumulateExplainString(manager) ((void) 1)
 #define CodeGeneratorManagerGetExplainString(manager) ((char *) NULL)
+#define CodeGeneratorManagerGetCacheHitCount(manager) ((unsigned int) 0)
+#define CodeGeneratorManagerGetCacheMissCount(manager) ((unsigned int) 0)
 #define CodeGeneratorManagerDestroy(manager) ((void) 1)
 #define GetActiveCodeGeneratorManager() ((void *) NULL)
 #define SetActiveCodeGeneratorManager(manager) ((void) 1)
@@ -67,6 +79,12 @@ typedef Datum (*SlotGetAttrFn) (struct TupleTableSlot *slot, int attnum, bool *i
 #define enroll_ExecVariableList_codegen(regular_func, ptr_to_chosen_func, proj_info, slot)
 #define call_AdvanceAggregates(aggstate, pergroup, mem_manager) advance_aggregates(aggstate, pergroup, mem_manager)
 #define enroll_AdvanceAggregates_codegen(regular_func, ptr_to_chosen_func, aggstate)
+#define call_EvalHashKey(motionstate, econtext, hashkeys, hashtypes, h) evalHashKey(econtext, hashkeys, hashtypes, h)
+#define enroll_EvalHashKey_codegen(regular_func, ptr_to_chosen_func, motionstate, hashtypes)
+#define call_ExecHashGetHashValue(owner, hashState, hashtable, econtext, hashkeys, outer_tuple, keep_nulls, hashvalue, hashkeys_null) ExecHashGetHashValue(hashState, hashtable, econtext, hashkeys, outer_tuple, keep_nulls, hashvalue, hashkeys_null)
+#define enroll_ExecHashGetHashValue_codegen(regular_func, ptr_to_chosen_func, owner, hashkeys, hashoperators, outer_tuple, econtext)
+#define call_ExecScanHashBucket(hashState, hjstate, econtext) ExecScanHashBucket(hashState, hjstate, econtext)
+#define enroll_ExecScanHashBucket_codegen(regular_func, ptr_to_chosen_func, hjstate)
 #else
 
 /*
@@ -106,10 +124,11 @@ unsigned int
 InitCodegen();
 
 /*
- * Creates a manager for an operator
+ * Creates a manager for an operator expected to process estimated_rows rows
+ * (negative if unknown)
  */
 void*
-CodeGeneratorManagerCreate(const char* module_name);
+CodeGeneratorManagerCreate(const char* module_name, double estimated_rows);
 
 /*
  * Calls all the registered CodegenInterface to generate code
@@ -124,6 +143,13 @@ CodeGeneratorManagerGenerateCode(void* manager);
 unsigned int
 CodeGeneratorManagerPrepareGeneratedFunctions(void* manager);
 
+/*
+ * Switches to the generated functions if their background compilation has
+ * finished. Returns true while the compilation is still running
+ */
+bool
+CodeGeneratorManagerPollGeneratedFunctions(void* manager);
+
 /*
  * Notifies a manager that the underlying operator has a parameter change
  */
@@ -149,6 +175,20 @@ CodeGeneratorManagerAccumulateExplainString(void* manager);
 char*
 CodeGeneratorManagerGetExplainString(void* manager);
 
+/*
+ * Number of compiled modules that the last PrepareGeneratedFunctions of a
+ * manager found in the compiled object cache
+ */
+unsigned int
+CodeGeneratorManagerGetCacheHitCount(void* manager);
+
+/*
+ * Number of modules that the last PrepareGeneratedFunctions of a manager had
+ * to compile
+ */
+unsigned int
+CodeGeneratorManagerGetCacheMissCount(void* manager);
+
 /*
  * Get the active code generator manager
  */
@@ -185,6 +225,20 @@ SET_VARSIZE_regular(void* ptr, size_t len);
 uint32
 VARSIZE_regular(void* ptr);
 
+/*
+ * Equality for text with a memcmp fast path for in-line, uncompressed
+ * values; falls back to texteq() otherwise.
+ */
+bool
+texteq_regular(Datum arg0, Datum arg1);
+
+/*
+ * Equality for bpchar with a memcmp fast path for in-line, uncompressed
+ * values; falls back to bpchareq() otherwise.
+ */
+bool
+bpchareq_regular(Datum arg0, Datum arg1);
+
 /*
  * returns the pointer to the ExecVariableList
  */
@@ -212,6 +266,36 @@ AdvanceAggregatesCodegenEnroll(AdvanceAggregatesFn regular_func_ptr,
 		AdvanceAggregatesFn* ptr_to_regular_func_ptr,
 		struct AggState *aggstate);
 
+/*
+ * Enroll and returns the pointer to EvalHashKeyGenerator
+ */
+void*
+EvalHashKeyCodegenEnroll(EvalHashKeyFn regular_func_ptr,
+                         EvalHashKeyFn* ptr_to_regular_func_ptr,
+                         struct List *hashkeys,
+                         struct List *hashtypes,
+                         struct ExprContext *econtext,
+                         struct PlanState* plan_state);
+
+/*
+ * Enroll and returns the pointer to ExecHashGetHashValueGenerator
+ */
+void*
+ExecHashGetHashValueCodegenEnroll(ExecHashGetHashValueFn regular_func_ptr,
+                                  ExecHashGetHashValueFn* ptr_to_regular_func_ptr,
+                                  struct List *hashkeys,
+                                  struct List *hashoperators,
+                                  bool outer_tuple,
+                                  struct ExprContext *econtext);
+
+/*
+ * Enroll and returns the pointer to ExecScanHashBucketGenerator
+ */
+void*
+ExecScanHashBucketCodegenEnroll(ExecScanHashBucketFn regular_func_ptr,
+                                ExecScanHashBucketFn* ptr_to_regular_func_ptr,
+                                struct HashJoinState *hjstate);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
@@ -269,6 +353,30 @@ AdvanceAggregatesCodegenEnroll(AdvanceAggregatesFn regular_func_ptr,
 #define call_AdvanceAggregates(aggstate, pergroup, mem_manager) \
 		aggstate->AdvanceAggregates_gen_info.AdvanceAggregates_fn(aggstate, pergroup, mem_manager)
 
+/*
+ * Call evalHashKey using function pointer EvalHashKey_fn.
+ * Function pointer may point to regular version or generated function
+ */
+#define call_EvalHashKey(motionstate, econtext, hashkeys, hashtypes, h) \
+		(motionstate)->EvalHashKey_gen_info.EvalHashKey_fn(econtext, hashkeys, hashtypes, h)
+
+/*
+ * Call ExecHashGetHashValue using function pointer ExecHashGetHashValue_fn of
+ * the node that owns the hash keys (the Hash node for the inner side, the
+ * HashJoin node for the outer side).
+ * Function pointer may point to regular version or generated function
+ */
+#define call_ExecHashGetHashValue(owner, hashState, hashtable, econtext, hashkeys, outer_tuple, keep_nulls, hashvalue, hashkeys_null) \
+		(owner)->ExecHashGetHashValue_gen_info.ExecHashGetHashValue_fn(hashState, \
+				hashtable, econtext, hashkeys, outer_tuple, keep_nulls, hashvalue, hashkeys_null)
+
+/*
+ * Call ExecScanHashBucket using function pointer ExecScanHashBucket_fn.
+ * Function pointer may point to regular version or generated function
+ */
+#define call_ExecScanHashBucket(hashState, hjstate, econtext) \
+		(hjstate)->ExecScanHashBucket_gen_info.ExecScanHashBucket_fn(hashState, hjstate, econtext)
+
 /*
  * Enrollment macros
  * The enrollment process also ensures that the generated function pointer
@@ -289,6 +397,22 @@ AdvanceAggregatesCodegenEnroll(AdvanceAggregatesFn regular_func_ptr,
 				regular_func, ptr_to_regular_func_ptr, aggstate); \
 				Assert(aggstate->AdvanceAggregates_gen_info.AdvanceAggregates_fn == regular_func); \
 
+#define enroll_EvalHashKey_codegen(regular_func, ptr_to_regular_func_ptr, motionstate, hashtypes) \
+		(motionstate)->EvalHashKey_gen_info.code_generator = EvalHashKeyCodegenEnroll( \
+				regular_func, ptr_to_regular_func_ptr, (motionstate)->hashExpr, hashtypes, \
+				(motionstate)->ps.ps_ExprContext, (struct PlanState *) (motionstate)); \
+				Assert((motionstate)->EvalHashKey_gen_info.EvalHashKey_fn == regular_func); \
+
+#define enroll_ExecHashGetHashValue_codegen(regular_func, ptr_to_regular_func_ptr, owner, hashkeys, hashoperators, outer_tuple, econtext) \
+		(owner)->ExecHashGetHashValue_gen_info.code_generator = ExecHashGetHashValueCodegenEnroll( \
+				regular_func, ptr_to_regular_func_ptr, hashkeys, hashoperators, outer_tuple, econtext); \
+				Assert((owner)->ExecHashGetHashValue_gen_info.ExecHashGetHashValue_fn == regular_func); \
+
+#define enroll_ExecScanHashBucket_codegen(regular_func, ptr_to_regular_func_ptr, hjstate) \
+		(hjstate)->ExecScanHashBucket_gen_info.code_generator = ExecScanHashBucketCodegenEnroll( \
+				regular_func, ptr_to_regular_func_ptr, hjstate); \
+				Assert((hjstate)->ExecScanHashBucket_gen_info.ExecScanHashBucket_fn == regular_func); \
+
 #endif //USE_CODEGEN
 
 #endif  // CODEGEN_WRAPPER_H_
@@ -38,6 +38,8 @@ typedef struct Instrumentation
 	instr_time	firststart;		/* CDB: Start time of first iteration of node */
 	bool		workfileCreated;/* TRUE if workfiles are created in this node */
 	int		numPartScanned; /* Number of part tables scanned */
+	int		codegenCacheHits;	/* Compiled codegen modules found in cache */
+	int		codegenCacheMisses;	/* Codegen modules compiled for this node */
     struct CdbExplain_NodeSummary  *cdbNodeSummary; /* stats from all qExecs */
 } Instrumentation;
 
@@ -24,6 +24,8 @@ extern void ExecStopMotion(MotionState *node);
 
 extern bool isMotionGather(const Motion *m);
 
+extern uint32 evalHashKey(ExprContext *econtext, List *hashkeys, List *hashtypes, struct CdbHash *h);
+
 
 enum 
 {
@@ -18,6 +18,7 @@
 #include "postgres.h"
 #include "access/attnum.h"
 #include "utils/faultinjector.h"
+#include "utils/mdsharedcache.h"
 
 // fwd declarations
 typedef struct SysScanDescData *SysScanDesc;
@@ -609,10 +610,46 @@ namespace gpdb {
 	// return the number of leaf partition for a given table oid
 	gpos::ULONG UlLeafPartitions(Oid oidRelation);
 
-	// Does the metadata cache need to be reset (because of a catalog
+	// Does the whole metadata cache need to be reset (because of a catalog
 	// table has been changed?)
 	bool FMDCacheNeedsReset(void);
 
+	// metadata cache entries invalidated by catalog changes since the last call
+	List *PlMDCacheInvalidatedEntries(void);
+
+	// record an object loaded into the metadata cache
+	void MDCacheRecordEntry(const MDCacheEntry *pentry);
+
+	// is the metadata cache shared by all backends?
+	bool FMDSharedCacheEnabled(void);
+
+	// current invalidation generation of the shared metadata cache
+	uint32 UlMDSharedCacheGeneration(void);
+
+	// look up a serialized object in the shared metadata cache
+	char *SzMDSharedCacheLookup(MDCacheEntry *pentry);
+
+	// share a serialized object through the shared metadata cache
+	void MDSharedCacheInsert(const MDCacheEntry *pentry, const char *szObject, uint32 ulGeneration);
+
+	// record the calling thread as the only one allowed to call GPDB functions
+	void SetBackendThread(void);
+
+	// has a GPDB function been called from an optimizer worker thread since the last call?
+	bool FCallFromWorkerRefused(void);
+
+	// block the backend's signals in the calling thread, for the threads it starts, or unblock them
+	void BlockThreadSignals(bool fBlock);
+
+	// limit on active statements of the resource queue of the current role, -1 if none
+	int IResQueueActiveStatementsLimit(void);
+
+	// cache the logical indexes and part constraints of partitioned tables
+	void BeginPartMetadataCaching(void);
+
+	// stop caching partition metadata, and drop the cached results
+	void EndPartMetadataCaching(void);
+
 } //namespace gpdb
 
 #define ForEach(cell, l)	\
@@ -0,0 +1,69 @@
+//---------------------------------------------------------------------------
+//	Greenplum Database
+//	Copyright (C) 2016 Pivotal Software, Inc.
+//
+//	@filename:
+//		CMDCacheInvalidator.h
+//
+//	@doc:
+//		Per-object invalidation of the metadata cache
+//
+//	@test:
+//
+//
+//---------------------------------------------------------------------------
+
+#ifndef GPMD_CMDCacheInvalidator_H
+#define GPMD_CMDCacheInvalidator_H
+
+#include "gpos/base.h"
+
+#include "naucrates/md/IMDId.h"
+#include "naucrates/md/IMDCacheObject.h"
+
+struct MDCacheEntry;
+
+namespace gpmd
+{
+	using namespace gpos;
+
+	//---------------------------------------------------------------------------
+	//	@class:
+	//		CMDCacheInvalidator
+	//
+	//	@doc:
+	//		Records the objects loaded into the metadata cache from the relcache,
+	//		and evicts the ones whose catalog entries have changed. The
+	//		invalidation callbacks themselves are in gpdbwrappers.cpp.
+	//
+	//---------------------------------------------------------------------------
+	class CMDCacheInvalidator
+	{
+		private:
+			// rebuild the cache key of a recorded entry
+			static
+			IMDId *PmdidCacheKey(IMemoryPool *pmp, const MDCacheEntry *pentry);
+
+		public:
+			// initialize the identity of the entry describing an object,
+			// returns false if the object is not loaded from the relcache
+			static
+			BOOL FInitEntry(const IMDId *pmdid, MDCacheEntry *pentry);
+
+			// set the kind and relation of the entry describing an object
+			static
+			void SetObjectKind(const IMDCacheObject *pimdobj, MDCacheEntry *pentry);
+
+			// record an object that is about to be inserted in the metadata cache
+			static
+			void RecordObject(const MDCacheEntry *pentry);
+
+			// evict the objects invalidated since the last call from the metadata cache
+			static
+			void EvictInvalidatedObjects(IMemoryPool *pmp);
+	};
+}
+
+#endif // !GPMD_CMDCacheInvalidator_H
+
+// EOF
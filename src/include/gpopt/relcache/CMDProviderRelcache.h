@@ -49,6 +49,15 @@ namespace gpmd
 			// memory pool
 			IMemoryPool *m_pmp;
 
+			// number of objects translated from the catalog
+			mutable ULONG m_ulTranslated;
+
+			// number of objects found in the metadata shared cache
+			mutable ULONG m_ulSharedHits;
+
+			// time spent fetching objects, in microseconds
+			mutable ULLONG m_ullFetchUs;
+
 			// private copy ctor
 			CMDProviderRelcache(const CMDProviderRelcache&);
 
@@ -65,6 +74,24 @@ namespace gpmd
 			virtual
 			CWStringBase *PstrObject(IMemoryPool *pmp, CMDAccessor *pmda, IMDId *pmdid) const;
 
+			// number of objects translated from the catalog
+			ULONG UlTranslated() const
+			{
+				return m_ulTranslated;
+			}
+
+			// number of objects found in the metadata shared cache
+			ULONG UlSharedHits() const
+			{
+				return m_ulSharedHits;
+			}
+
+			// time spent fetching objects, in microseconds
+			ULLONG UllFetchUs() const
+			{
+				return m_ullFetchUs;
+			}
+
 			// return the mdid for the requested type
 			virtual
 			IMDId *Pmdid
@@ -23,6 +23,7 @@
 
 #include "naucrates/dxl/gpdb_types.h"
 #include "naucrates/dxl/CIdGenerator.h"
+#include "naucrates/dxl/operators/CDXLOperator.h"
 #include "naucrates/dxl/operators/CDXLScalarIdent.h"
 
 #include "gpopt/gpdbwrappers.h"
@@ -131,7 +132,23 @@ namespace gpdxl
 			
 			// CTAS distribution policy
 			GpPolicy  *m_pdistrpolicy;
-			
+
+			// is the time spent translating each DXL operator recorded?
+			BOOL m_fProfile;
+
+			// time spent translating each kind of DXL operator, excluding its
+			// children, in microseconds
+			ULLONG m_rgullProfileUs[EdxlopSentinel];
+
+			// number of translated operators of each kind
+			ULONG m_rgulProfileCount[EdxlopSentinel];
+
+			// name of each kind of translated operator
+			const CWStringConst *m_rgpstrProfileOpName[EdxlopSentinel];
+
+			// total time recorded so far
+			ULLONG m_ullProfileUs;
+
 		public:
 			// ctor/dtor
 			CContextDXLToPlStmt
@@ -219,6 +236,31 @@ namespace gpdxl
 				return m_pdistrpolicy;
 			}
 
+			// record the time spent translating each DXL operator
+			void EnableProfile()
+			{
+				m_fProfile = true;
+			}
+
+			// is the time spent translating each DXL operator recorded?
+			BOOL FProfile() const
+			{
+				return m_fProfile;
+			}
+
+			// total time recorded so far, in microseconds
+			ULLONG UllProfileUs() const
+			{
+				return m_ullProfileUs;
+			}
+
+			// record the translation of an operator, given the time spent in it
+			// and the time recorded for its children
+			void RecordProfile(const CDXLOperator *pdxlop, ULLONG ullElapsedUs, ULLONG ullChildrenUs);
+
+			// log the time spent translating each kind of DXL operator
+			void PrintProfile() const;
+
 	};
 
 	}
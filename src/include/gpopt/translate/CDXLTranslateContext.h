@@ -62,10 +62,25 @@ namespace gpdxl
 			// private copy ctor
 			CDXLTranslateContext(const CDXLTranslateContext&);
 
-			// mappings ColId->TargetEntry used for intermediate DXL nodes
+			// mappings ColId->TargetEntry used for intermediate DXL nodes, as an
+			// array indexed by ColId - m_ulColIdFirst while the ColIds are dense
+			TargetEntry **m_rgpte;
+
+			// first ColId of the array
+			ULONG m_ulColIdFirst;
+
+			// number of slots in the array
+			ULONG m_ulSlots;
+
+			// number of mappings
+			ULONG m_ulEntries;
+
+			// mappings ColId->TargetEntry, used instead of the array once the
+			// ColIds are too sparse
 			HMUlTe *m_phmulte;
 
-			// mappings ColId->ParamId used for outer refs in subplans
+			// mappings ColId->ParamId used for outer refs in subplans, shared
+			// with the parent context until either inserts a mapping
 			HMColParam *m_phmcolparam;
 
 			// is the node for which this context is built a child of an aggregate node
@@ -78,6 +93,12 @@ namespace gpdxl
 			// copy the params hashmap
 			void CopyParamHashmap(HMColParam *phmOriginal);
 
+			// make the array cover the given ColId, or switch to the hash map
+			void GrowMapping(ULONG ulColId);
+
+			// move the mappings from the array to the hash map
+			void SwitchToHashMap();
+
 		public:
 			// ctor/dtor
 			CDXLTranslateContext(IMemoryPool *pmp, BOOL fChildAggNode);
@@ -89,7 +110,7 @@ namespace gpdxl
 			// is parent an aggregate node
 			BOOL FParentAggNode() const;
 
-			// return the params hashmap
+			// return the params hashmap, to be shared by a child context
 			HMColParam *PhmColParam()
 			{
 				return m_phmcolparam;
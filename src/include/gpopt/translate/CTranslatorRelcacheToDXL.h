@@ -246,7 +246,7 @@ namespace gpdxl
 			DrgPdxlbucket *PdrgpdxlbucketTransformStats
 								(
 								IMemoryPool *pmp,
-								OID oidAttType,
+								const IMDType *pmdtype,
 								CDouble dDistinct,
 								CDouble dNullFreq,
 								const Datum *pdrgdatumMCVValues,
@@ -276,9 +276,10 @@ namespace gpdxl
 			static
 			DrgPmdcol *Pdrgpmdcol(IMemoryPool *pmp, CMDAccessor *pmda, Relation rel, IMDRelation::Erelstoragetype erelstorage);
 
-			// return the dxl representation of the column's default value
+			// return the dxl representation of the column's default value, given
+			// the default expression defined on the column, if any
 			static
-			CDXLNode *PdxlnDefaultColumnValue(IMemoryPool *pmp, CMDAccessor *pmda, TupleDesc rd_att, AttrNumber attrno);
+			CDXLNode *PdxlnDefaultColumnValue(IMemoryPool *pmp, CMDAccessor *pmda, TupleDesc rd_att, AttrNumber attrno, const char *szDefault);
 
 
 			// get the distribution columns
@@ -47,6 +47,7 @@ struct PlannedStmt;
 struct Query;
 struct List;
 struct MemoryContextData;
+struct OptimizerPhaseStats;
 
 using namespace gpos;
 using namespace gpdxl;
@@ -91,6 +92,12 @@ struct SOptContext
 	// buffer for optimizer error messages
 	CHAR *m_szErrorMsg;
 
+	// number of worker threads to optimize with
+	ULONG m_ulWorkers;
+
+	// did a worker thread need GPDB, so that optimization must be retried serially?
+	BOOL m_fRetrySerially;
+
 	// ctor
 	SOptContext();
 
@@ -209,6 +216,18 @@ class COptTasks
 		static
 		void* PvOptimizeTask(void *pv);
 
+		// number of worker threads to optimize a query with
+		static
+		ULONG UlParallelWorkers();
+
+		// resize the gpos worker pool, starting any new worker with the backend's signals blocked
+		static
+		void SetWorkersMax(ULONG ulWorkersMax);
+
+		// execute the optimization task, in parallel if configured
+		static
+		void ExecuteOptimizeTask(SOptContext *poctx);
+
 		// optimize the query in a minidump and return resulting plan in DXL format
 		static
 		void* PvOptimizeMinidumpTask(void *pv);
@@ -221,6 +240,14 @@ class COptTasks
 		static
 		DrgPss *PdrgPssLoad(IMemoryPool *pmp, char *szPath);
 
+		// create a search strategy that stops at the given time budget
+		static
+		DrgPss *PdrgPssTimeBudget(IMemoryPool *pmp, ULONG ulTimeBudget);
+
+		// record the time and the memory of an optimization phase
+		static
+		void RecordPhase(IMemoryPool *pmp, OptimizerPhaseStats *pphase, ULONG ulElapsedUs);
+
 		// allocate memory for string
 		static
 		CHAR *SzAllocate(IMemoryPool *pmp, ULONG ulSize);
@@ -51,6 +51,7 @@ extern "C" {
 #include "utils/typcache.h"
 #include "utils/numeric.h"
 #include "optimizer/tlist.h"
+#include "optimizer/optstats.h"
 #include "nodes/makefuncs.h"
 #include "catalog/pg_operator.h"
 #include "lib/stringinfo.h"
@@ -65,6 +66,10 @@ extern "C" {
 #include "parser/parse_coerce.h"
 #include "utils/selfuncs.h"
 #include "utils/faultinjector.h"
+#include "utils/hsearch.h"
+#include "utils/mdsharedcache.h"
+#include "utils/resscheduler.h"
+#include "utils/memutils.h"
 
 extern
 Query *preprocess_query_optimizer(Query *pquery, ParamListInfo boundParams);
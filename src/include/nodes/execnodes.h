@@ -1367,6 +1367,8 @@ typedef struct PlanState
 
 	/* The manager manages all the code generators and generation process */
 	void *CodegenManager;
+	/* True while the generated code is being compiled in the background */
+	bool CodegenPending;
 
 	/*
 	 * EXPLAIN ANALYZE statistics collection
@@ -2173,6 +2175,22 @@ typedef struct MergeJoinState
 typedef struct HashJoinTupleData *HashJoinTuple;
 typedef struct HashJoinTableData *HashJoinTable;
 
+typedef struct ExecHashGetHashValueCodegenInfo
+{
+	/* Pointer to store ExecHashGetHashValueCodegen from Codegen */
+	void* code_generator;
+	/* Function pointer that points to either regular or generated ExecHashGetHashValue */
+	ExecHashGetHashValueFn ExecHashGetHashValue_fn;
+} ExecHashGetHashValueCodegenInfo;
+
+typedef struct ExecScanHashBucketCodegenInfo
+{
+	/* Pointer to store ExecScanHashBucketCodegen from Codegen */
+	void* code_generator;
+	/* Function pointer that points to either regular or generated ExecScanHashBucket */
+	ExecScanHashBucketFn ExecScanHashBucket_fn;
+} ExecScanHashBucketCodegenInfo;
+
 typedef struct HashJoinState
 {
 	JoinState	js;				/* its first field is NodeTag */
@@ -2198,6 +2216,12 @@ typedef struct HashJoinState
 
 	/* set if the operator created workfiles */
 	bool workfiles_created;
+
+#ifdef USE_CODEGEN
+	/* hash values of the outer tuples */
+	ExecHashGetHashValueCodegenInfo ExecHashGetHashValue_gen_info;
+	ExecScanHashBucketCodegenInfo ExecScanHashBucket_gen_info;
+#endif
 } HashJoinState;
 
 
@@ -2459,6 +2483,11 @@ typedef struct HashState
 	bool		hs_quit_if_hashkeys_null;	/* quit building hash table if hashkeys are all null */
 	bool		hs_hashkeys_null;	/* found an instance wherein hashkeys are all null */
 	/* hashkeys is same as parent's hj_InnerHashKeys */
+
+#ifdef USE_CODEGEN
+	/* hash values of the inner tuples; enrolled by the parent HashJoin */
+	ExecHashGetHashValueCodegenInfo ExecHashGetHashValue_gen_info;
+#endif
 } HashState;
 
 /* ----------------
@@ -2585,6 +2614,14 @@ typedef enum MotionStateType
 	MOTIONSTATE_RECV,			/* The motion is recver */
 } MotionStateType;
 
+typedef struct EvalHashKeyCodegenInfo
+{
+	/* Pointer to store EvalHashKeyCodegen from Codegen */
+	void* code_generator;
+	/* Function pointer that points to either regular or generated evalHashKey */
+	EvalHashKeyFn EvalHashKey_fn;
+} EvalHashKeyCodegenInfo;
+
 /* ----------------
  *         MotionState information
  * ----------------
@@ -2626,6 +2663,10 @@ typedef struct MotionState
 	Oid		   *outputFunArray;	/* output functions for each column (debug only) */
 
 	int			numInputSegs;	/* the number of segments on the sending slice */
+
+#ifdef USE_CODEGEN
+	EvalHashKeyCodegenInfo EvalHashKey_gen_info;
+#endif
 } MotionState;
 
 /*
@@ -151,6 +151,23 @@ typedef struct PlannedStmt
 	 */
 	struct GpPolicy  *intoPolicy;
 
+	/* GPDB: Used only on QD. Don't serialize. Was the plan reused from the
+	 *       ORCA plan cache? Reported by EXPLAIN.
+	 */
+	bool		planFromCache;
+
+	/* GPDB: Used only on QD. Don't serialize. Time ORCA spent optimizing
+	 *       the query, in milliseconds, and whether the search was stopped
+	 *       by optimizer_time_budget. Reported by EXPLAIN.
+	 */
+	double		optimizerTime;
+	bool		optimizerBudgetExceeded;
+
+	/* GPDB: Used only on QD. Don't serialize. Per-phase statistics of the
+	 *       optimization by ORCA. Reported by EXPLAIN VERBOSE.
+	 */
+	struct OptimizerStats *optimizerStats;
+
 	/* What is the memory reserved for this query's execution? */
 	uint64		query_mem;
 
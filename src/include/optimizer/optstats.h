@@ -0,0 +1,51 @@
+/*-------------------------------------------------------------------------
+ *
+ * optstats.h
+ *	  Per-phase statistics of an optimization by ORCA.
+ *
+ * COptTasks fills in an OptimizerStats record for every query it optimizes.
+ * The record of the last optimization in the backend is returned by
+ * gp_opt_stats(), and the record of a plan is shown by EXPLAIN VERBOSE.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef OPTSTATS_H
+#define OPTSTATS_H
+
+#include "lib/stringinfo.h"
+
+typedef enum OptimizerPhase
+{
+	OPT_PHASE_QUERY_TO_DXL,		/* Query to DXL translation */
+	OPT_PHASE_METADATA,			/* metadata fetch, part of the other phases */
+	OPT_PHASE_SEARCH,			/* exploration, implementation and costing */
+	OPT_PHASE_DXL_TO_PLSTMT,	/* DXL to PlannedStmt translation */
+
+	OPT_PHASE_COUNT
+} OptimizerPhase;
+
+typedef struct OptimizerPhaseStats
+{
+	double		time_ms;		/* elapsed time */
+	int64		memory_kb;		/* optimizer memory at the end, -1 if unknown */
+	int64		shared_cache_hits;	/* objects found in the shared metadata
+									 * cache, -1 if not applicable */
+	int64		cache_misses;	/* objects translated from the catalog, -1 if
+								 * not applicable */
+} OptimizerPhaseStats;
+
+typedef struct OptimizerStats
+{
+	bool		valid;
+	OptimizerPhaseStats phases[OPT_PHASE_COUNT];
+} OptimizerStats;
+
+/* Statistics of the last query optimized in this backend */
+extern OptimizerStats optimizer_last_stats;
+
+extern const char *OptimizerPhaseName(OptimizerPhase phase);
+extern void AppendOptimizerStats(StringInfo buf, const OptimizerStats *stats);
+
+#endif   /* OPTSTATS_H */
@@ -474,6 +474,7 @@ extern int ExceptionalCondition(const char *conditionName,
 extern int SyncAgentMain(int, char **, const char *);
 extern void CdbProgramErrorHandler(SIGNAL_ARGS);
 extern void gp_set_thread_sigmasks(void);
+extern void gp_block_thread_signals(bool block);
 
 
 #ifdef __cplusplus
@@ -34,6 +34,9 @@
 /* Number of partitions of the workfile query diskspace hashtable */
 #define NUM_WORKFILE_QUERYSPACE_PARTITIONS 128
 
+/* Number of partitions of the ORCA metadata shared cache hashtable */
+#define NUM_MDSHAREDCACHE_PARTITIONS 16
+
 /*
  * We have a number of predefined LWLocks, plus a bunch of LWLocks that are
  * dynamically assigned (e.g., for shared buffers).  The LWLock structures
@@ -94,7 +97,8 @@ typedef enum LWLockId
 	ErrorLogLock,
 	FirstWorkfileMgrLock,
 	FirstWorkfileQuerySpaceLock = FirstWorkfileMgrLock + NUM_WORKFILEMGR_PARTITIONS,
-	FirstBufMappingLock = FirstWorkfileQuerySpaceLock + NUM_WORKFILE_QUERYSPACE_PARTITIONS,
+	FirstMDSharedCacheLock = FirstWorkfileQuerySpaceLock + NUM_WORKFILE_QUERYSPACE_PARTITIONS,
+	FirstBufMappingLock = FirstMDSharedCacheLock + NUM_MDSHAREDCACHE_PARTITIONS,
 	FirstLockMgrLock = FirstBufMappingLock + NUM_BUFFER_PARTITIONS,
 	SessionStateLock = FirstLockMgrLock + NUM_LOCK_PARTITIONS,
 
@@ -1238,4 +1238,10 @@ extern Datum enable_xform(PG_FUNCTION_ARGS);
 /* Optimizer's version */
 extern Datum gp_opt_version(PG_FUNCTION_ARGS);
 
+/* Optimizer's statistics of the last optimized query */
+extern Datum gp_opt_stats(PG_FUNCTION_ARGS);
+
+/* ic_shmring.c */
+extern Datum gp_interconnect_shm_packets(PG_FUNCTION_ARGS);
+
 #endif   /* BUILTINS_H */
@@ -399,6 +399,11 @@ extern bool optimizer_print_plan;
 extern bool optimizer_print_xform;
 extern bool optimizer_metadata_caching;
 extern int optimizer_mdcache_size;
+extern int optimizer_mdcache_shared_entries;
+extern int optimizer_mdcache_shared_entry_size;
+extern int optimizer_plan_cache_size;
+extern int optimizer_parallel_workers;
+extern int optimizer_time_budget;
 extern bool optimizer_disable_xform_result_printing;
 extern bool	optimizer_print_memo_after_exploration;
 extern bool	optimizer_print_memo_after_implementation;
@@ -408,6 +413,7 @@ extern bool	optimizer_print_expression_properties;
 extern bool	optimizer_print_group_properties;
 extern bool	optimizer_print_optimization_context;
 extern bool optimizer_print_optimization_stats;
+extern bool optimizer_print_translation_stats;
 extern bool	optimizer_local;
 extern int  optimizer_retries;
 extern bool  optimizer_xforms[OPTIMIZER_XFORMS_COUNT];
@@ -490,8 +496,13 @@ extern bool optimizer_array_constraints;
 extern bool init_codegen;
 extern bool codegen;
 extern bool codegen_validate_functions;
+extern bool codegen_async_compile;
 extern int codegen_varlen_tolerance;
 extern int codegen_optimization_level;
+extern int codegen_min_rows;
+extern int codegen_aggressive_rows;
+extern int codegen_object_cache_size;
+extern char *codegen_object_cache_directory;
 
 /**
  * Enable logging of DPE match in optimizer.
@@ -620,6 +631,7 @@ extern bool SelectConfigFiles(const char *userDoption, const char *progname);
 extern void ResetAllOptions(void);
 extern void AtStart_GUC(void);
 extern int	NewGUCNestLevel(void);
+extern uint32 GUCChangeCount;
 extern void AtEOXact_GUC(bool isCommit, int nestLevel);
 extern void BeginReportingGUCOptions(void);
 extern void ParseLongOption(const char *string, char **name, char **value);
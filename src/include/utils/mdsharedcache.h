@@ -0,0 +1,71 @@
+/*-------------------------------------------------------------------------
+ *
+ * mdsharedcache.h
+ *	  Interface for the cache of ORCA metadata objects shared by all
+ *	  backends.
+ *
+ * Copyright (c) 2016, Pivotal Software, Inc.
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef MDSHAREDCACHE_H
+#define MDSHAREDCACHE_H
+
+#include "storage/sinval.h"
+
+/* Kinds of objects in the optimizer's metadata cache */
+#define MDCACHE_RELATION			(1 << 0)
+#define MDCACHE_INDEX				(1 << 1)
+#define MDCACHE_TYPE				(1 << 2)
+#define MDCACHE_OPERATOR			(1 << 3)
+#define MDCACHE_FUNCTION			(1 << 4)
+#define MDCACHE_AGGREGATE			(1 << 5)
+#define MDCACHE_TRIGGER				(1 << 6)
+#define MDCACHE_CHECK_CONSTRAINT	(1 << 7)
+#define MDCACHE_REL_STATS			(1 << 8)
+#define MDCACHE_COL_STATS			(1 << 9)
+#define MDCACHE_CAST				(1 << 10)
+#define MDCACHE_SCALAR_CMP			(1 << 11)
+
+#define MDCACHE_NUM_KINDS			12
+
+/*
+ * An object in the optimizer's metadata cache, as recorded for invalidation.
+ *
+ * The mdid type, oids and aux value identify the object, and are enough to
+ * rebuild its cache key. They come first, so that they can be used as the
+ * key of the shared cache.
+ */
+typedef struct MDCacheEntry
+{
+	int			mdidtype;		/* IMDId::EMDIdType of the cache key */
+	Oid			oids[2];		/* oids in the cache key */
+	uint32		aux;			/* column position or comparison type, if any */
+
+	int			kind;			/* one of the MDCACHE_* kinds */
+	Oid			relid;			/* relation the object belongs to, or InvalidOid */
+} MDCacheEntry;
+
+#define MDCACHE_ENTRY_KEY_SIZE	offsetof(MDCacheEntry, kind)
+
+/* A catalog cache, and the kinds of objects that are built from its catalog */
+typedef struct MDCacheSyscache
+{
+	int			cacheid;
+	int			kinds;
+} MDCacheSyscache;
+
+extern const MDCacheSyscache MDCacheSyscaches[];
+extern const int MDCacheNumSyscaches;
+
+extern Size MDSharedCache_ShmemSize(void);
+extern void MDSharedCache_ShmemInit(void);
+extern bool MDSharedCache_IsEnabled(void);
+extern uint32 MDSharedCache_GetGeneration(void);
+extern char *MDSharedCache_Lookup(MDCacheEntry *desc);
+extern void MDSharedCache_Insert(const MDCacheEntry *desc, const char *data,
+					 uint32 generation);
+extern void MDSharedCache_InvalidateMessages(const SharedInvalidationMessage *msgs,
+								 int n);
+
+#endif   /* MDSHAREDCACHE_H */
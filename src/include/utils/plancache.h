@@ -18,6 +18,7 @@
 #include "access/tupdesc.h"
 #include "nodes/params.h"
 #include "nodes/parsenodes.h"
+#include "nodes/plannodes.h"
 
 /*
  * CachedPlanSource represents the portion of a cached plan that persists
@@ -120,4 +121,7 @@ extern TupleDesc PlanCacheComputeResultDesc(List *stmt_list);
 
 extern void ResetPlanCache(void);
 
+extern PlannedStmt *OptimizerPlanCacheLookup(Query *query, char **key);
+extern void OptimizerPlanCacheStore(char *key, PlannedStmt *stmt);
+
 #endif   /* PLANCACHE_H */
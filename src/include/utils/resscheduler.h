@@ -175,6 +175,7 @@ extern void ResUnLockPortal(Portal portal);
 extern void ResCheckPortalType(Portal portal);
 extern Oid	GetResQueueForRole(Oid roleid);
 extern Oid	GetResQueueId(void);
+extern int	GetResQueueActiveStatementsLimit(void);
 extern Oid	GetResQueueIdForName(char *name);
 extern void SetResQueueId(void);
 extern uint32 ResCreatePortalId(const char *name);
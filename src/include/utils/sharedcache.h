@@ -46,12 +46,17 @@ typedef enum Cache_EntryState
 	CACHE_ENTRY_RESERVED  /* Entry is in the process of being acquired, but it is not populated yet */
 } Cache_EntryState;
 
+struct CacheEntry;
+
 /* Signature for function to clean up a resource before removing from cache */
 typedef void (*Cache_ClientCleanupFunc) (const void *resource);
 
 /* Signature for a function to populate a new entry after acquiring */
 typedef void (*Cache_ClientPopulateFunc) (const void *resource, const void *param);
 
+/* Signature for a function selecting cached entries to remove */
+typedef bool (*Cache_ClientMatchFunc) (const struct CacheEntry *entry, const void *param);
+
 
 /*
  * An entry in the Cache. The caller's data
@@ -260,6 +265,9 @@ void Cache_Insert(Cache *cache, CacheEntry *entry);
 void Cache_Remove(Cache *cache, CacheEntry *entry);
 void Cache_Release(Cache *cache, CacheEntry *entry);
 CacheEntry *Cache_AcquireEntry(Cache *cache, void *populate_param);
+CacheEntry *Cache_Lookup(Cache *cache, const void *key);
+uint32 Cache_RemoveMatching(Cache *cache, Cache_ClientMatchFunc match, const void *param,
+		uint32 startIdx, uint32 maxEntries);
 bool Cache_IsCached(CacheEntry *entry);
 void Cache_SurrenderClientEntries(Cache *cache);
 
@@ -0,0 +1,120 @@
+--
+-- Generated code for expressions in quals and target lists
+-- (codegen_exec_eval_expr), compared against the interpreted results
+--
+-- Codegen can't be turned on in a build without it, only off, so the runs
+-- with generated code use the defaults. Without codegen, both runs are
+-- interpreted and must agree all the same.
+--
+set codegen_min_rows = 0;
+set codegen_async_compile = off;
+
+-- a and b go through true, false and NULL (as a > 0, b > 0) every nine rows
+create table codegen_expr_t (id int, a int, b int, i2 int2, i8 int8, d date) distributed by (id);
+insert into codegen_expr_t
+  select id,
+         case (id - 1) / 3 % 3 when 0 then 1 when 1 then 0 end,
+         case (id - 1) % 3 when 0 then 1 when 1 then 0 end,
+         nullif(id % 8, 0),
+         case when id % 5 <> 0 then id * 10000000000 end,
+         case when id % 6 <> 0 then date '2016-01-01' + id end
+  from generate_series(1, 27) id;
+
+-- AND, OR and NOT with NULLs, and short-circuits that avoid a division by
+-- zero. CASE with and without a test value, nested, and without ELSE.
+-- IS [NOT] NULL. IN-lists and ANY/ALL: int2, int4, int8 and date equality
+-- become a switch, even with more elements than are unrolled; other
+-- operators are unrolled per element. Empty arrays, NULL elements and a
+-- NULL array.
+create view codegen_expr_proj as
+  select id,
+         a > 0 and b > 0 as and2,
+         a > 0 or b > 0 as or2,
+         not (a > 0) or b > 0 as not_or,
+         a > 0 and b > 0 and i2 > 3 as and3,
+         a > 0 or b > 0 or i2 > 3 as or3,
+         b <> 0 and 10 / b > 1 as and_guard,
+         b = 0 or 10 / b > 1 as or_guard,
+         case when a > 0 then 'a' when b > 0 then 'b' else 'neither' end as case_searched,
+         case when a > 0 then 'a' end as case_no_else,
+         case a when 1 then 'one' when 0 then 'zero' end as case_simple,
+         case i2 when 1 then case b when 1 then 'x' else 'y' end when 2 then 'two' else 'other' end as case_nested,
+         case when b = 0 then 0 else 10 / b end as case_guard,
+         a is null as a_is_null,
+         a is not null as a_is_not_null,
+         (a > 0 and b > 0) is null as and_is_null,
+         i2 = any('{1,3,5}'::int2[]) as in_int2,
+         a in (1, 2, 3) as in_int4,
+         i8 in (10000000000, 30000000000, 50000000000) as in_int8,
+         d in (date '2016-01-02', date '2016-01-05') as in_date,
+         a not in (0, 2) as not_in_int4,
+         a in (1, null) as in_null,
+         a not in (0, null) as not_in_null,
+         a = any('{}'::int4[]) as any_empty,
+         a <> all('{}'::int4[]) as all_empty,
+         a = any(null::int4[]) as any_null_array,
+         i2 > any('{3,5}'::int2[]) as gt_any,
+         i8 < all('{50000000000,90000000000}'::int8[]) as lt_all,
+         i2 > any('{3,null}'::int2[]) as gt_any_null,
+         i2 < all('{null,5}'::int2[]) as lt_all_null,
+         id = any('{0,2,4,6,8,10,12,14,16,18,20,22,24,26,28,30,32,34,36,38,40,42,44,46,48,50,52,54,56,58,60,62,64,66,68,70,72,74,76,78,80,82,84,86,88,90,92,94,96,98,100,102,104,106,108,110,112,114,116,118,120,122,124,126,128,130,132,134,136,138}'::int4[]) as in_long,
+         id < all('{0,2,4,6,8,10,12,14,16,18,20,22,24,26,28,30,32,34,36,38,40,42,44,46,48,50,52,54,56,58,60,62,64,66,68,70,72,74,76,78,80,82,84,86,88,90,92,94,96,98,100,102,104,106,108,110,112,114,116,118,120,122,124,126,128,130,132,134,136,138}'::int4[]) as lt_all_long
+  from codegen_expr_t;
+
+create view codegen_expr_qual as
+  select 'and' as qual, count(*) from codegen_expr_t where a > 0 and b > 0
+union all
+  select 'or', count(*) from codegen_expr_t where a > 0 or b > 0
+union all
+  select 'not and', count(*) from codegen_expr_t where not (a > 0 and b > 0)
+union all
+  select 'and guard', count(*) from codegen_expr_t where b <> 0 and 10 / b > 1
+union all
+  select 'case guard', count(*) from codegen_expr_t where case when b = 0 then false else 10 / b > 1 end
+union all
+  select 'is null', count(*) from codegen_expr_t where a is null
+union all
+  select 'is not null', count(*) from codegen_expr_t where a is not null
+union all
+  select 'in int2', count(*) from codegen_expr_t where i2 = any('{1,3,5}'::int2[])
+union all
+  select 'not in null', count(*) from codegen_expr_t where a not in (0, null)
+union all
+  select 'in long', count(*) from codegen_expr_t where id = any('{0,2,4,6,8,10,12,14,16,18,20,22,24,26,28,30,32,34,36,38,40,42,44,46,48,50,52,54,56,58,60,62,64,66,68,70,72,74,76,78,80,82,84,86,88,90,92,94,96,98,100,102,104,106,108,110,112,114,116,118,120,122,124,126,128,130,132,134,136,138}'::int4[])
+union all
+  select 'gt any null', count(*) from codegen_expr_t where i2 > any('{3,null}'::int2[]);
+
+create table codegen_expr_proj_codegen as select * from codegen_expr_proj distributed randomly;
+create table codegen_expr_qual_codegen as select * from codegen_expr_qual distributed randomly;
+set codegen_exec_eval_expr = off;
+create table codegen_expr_proj_interp as select * from codegen_expr_proj distributed randomly;
+create table codegen_expr_qual_interp as select * from codegen_expr_qual distributed randomly;
+reset codegen_exec_eval_expr;
+
+select id, and2, or2, not_or from codegen_expr_proj_codegen where id <= 9 order by id;
+select * from codegen_expr_qual_codegen order by qual;
+-- Rows that differ from the interpreted ones
+select (select count(*) from codegen_expr_proj_codegen) as proj_rows,
+       (select count(*) from (select * from codegen_expr_proj_codegen
+                              except all
+                              select * from codegen_expr_proj_interp) x) as proj_codegen_only,
+       (select count(*) from (select * from codegen_expr_proj_interp
+                              except all
+                              select * from codegen_expr_proj_codegen) x) as proj_interp_only;
+select (select count(*) from codegen_expr_qual_codegen) as qual_rows,
+       (select count(*) from (select * from codegen_expr_qual_codegen
+                              except all
+                              select * from codegen_expr_qual_interp) x) as qual_codegen_only,
+       (select count(*) from (select * from codegen_expr_qual_interp
+                              except all
+                              select * from codegen_expr_qual_codegen) x) as qual_interp_only;
+
+drop table codegen_expr_proj_codegen;
+drop table codegen_expr_qual_codegen;
+drop table codegen_expr_proj_interp;
+drop table codegen_expr_qual_interp;
+drop view codegen_expr_proj;
+drop view codegen_expr_qual;
+drop table codegen_expr_t;
+reset codegen_min_rows;
+reset codegen_async_compile;
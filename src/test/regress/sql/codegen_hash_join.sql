@@ -0,0 +1,79 @@
+--
+-- Hash joins with generated code for the hash values and the bucket scans
+-- (codegen_hash_join), compared against the interpreted results
+--
+-- Codegen can't be turned on in a build without it, only off, so the runs
+-- with generated code use the defaults. Without codegen, all the runs are
+-- interpreted and must agree all the same.
+--
+set codegen_min_rows = 0;
+set codegen_async_compile = off;
+set enable_mergejoin = off;
+set enable_nestloop = off;
+
+-- Every tenth outer row has NULL keys. Inner keys are the even numbers up to
+-- 598, twice each, so odd and larger outer keys miss, most of them in the
+-- bloom filter. m only matches for the first copy of each inner key.
+create table codegen_hj_outer (id int, i2 int2, i4 int4, i8 int8, o oid, m int4) distributed by (id);
+create table codegen_hj_inner (id int, i2 int2, i4 int4, i8 int8, o oid, m int4) distributed by (id);
+insert into codegen_hj_outer
+  select id, k::int2, k, k * 4294967297, k::oid, k
+  from (select id, case when id % 10 = 0 then null else id end as k
+        from generate_series(1, 1000) id) s;
+insert into codegen_hj_inner
+  select id, k::int2, k, k * 4294967297, k::oid, case when id <= 300 then k else k + 1 end
+  from (select id, case when id > 600 then null else (id % 300) * 2 end as k
+        from generate_series(1, 610) id) s;
+
+create view codegen_hj_joins as
+  select 'int2' as keys, count(*) as n, sum(o.id * 1000 + i.id) as checksum
+  from codegen_hj_outer o join codegen_hj_inner i on o.i2 = i.i2
+union all
+  select 'int4', count(*), sum(o.id * 1000 + i.id)
+  from codegen_hj_outer o join codegen_hj_inner i on o.i4 = i.i4
+union all
+  select 'int8', count(*), sum(o.id * 1000 + i.id)
+  from codegen_hj_outer o join codegen_hj_inner i on o.i8 = i.i8
+union all
+  select 'oid', count(*), sum(o.id * 1000 + i.id)
+  from codegen_hj_outer o join codegen_hj_inner i on o.o = i.o
+union all
+  select 'int4, int4', count(*), sum(o.id * 1000 + i.id)
+  from codegen_hj_outer o join codegen_hj_inner i on o.i4 = i.i4 and o.m = i.m
+union all
+  select 'int2, int8, oid', count(*), sum(o.id * 1000 + i.id)
+  from codegen_hj_outer o join codegen_hj_inner i on o.i2 = i.i2 and o.i8 = i.i8 and o.o = i.o
+union all
+  select 'int4 + 2', count(*), sum(o.id * 1000 + i.id)
+  from codegen_hj_outer o join codegen_hj_inner i on o.i4 + 2 = i.i4
+union all
+  select 'int4, left join', count(*), sum(o.id * 1000 + coalesce(i.id, 0))
+  from codegen_hj_outer o left join codegen_hj_inner i on o.i4 = i.i4;
+
+create table codegen_hj_results (run text, keys text, n int8, checksum int8) distributed randomly;
+insert into codegen_hj_results select 'codegen', * from codegen_hj_joins;
+set gp_hashjoin_bloomfilter = 0;
+insert into codegen_hj_results select 'codegen, no bloom filter', * from codegen_hj_joins;
+reset gp_hashjoin_bloomfilter;
+set codegen_hash_join = off;
+insert into codegen_hj_results select 'interpreted', * from codegen_hj_joins;
+reset codegen_hash_join;
+
+select keys, n, checksum from codegen_hj_results where run = 'interpreted' order by keys;
+select run, count(*) from codegen_hj_results group by run order by run;
+-- Results that differ from the interpreted ones
+select r.run, r.keys, r.n, r.checksum
+from codegen_hj_results r
+  left join (select * from codegen_hj_results where run = 'interpreted') i on r.keys = i.keys
+where r.run <> 'interpreted'
+  and (i.keys is null or r.n <> i.n or r.checksum is distinct from i.checksum)
+order by r.run, r.keys;
+
+drop view codegen_hj_joins;
+drop table codegen_hj_results;
+drop table codegen_hj_outer;
+drop table codegen_hj_inner;
+reset codegen_min_rows;
+reset codegen_async_compile;
+reset enable_mergejoin;
+reset enable_nestloop;
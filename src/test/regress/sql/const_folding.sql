@@ -0,0 +1,49 @@
+--
+-- Constant folding of function and operator calls
+--
+-- The planner calls a function on constant arguments directly, without
+-- setting up the executor. It must give the same results, and raise the
+-- same errors, as the executor.
+--
+create table const_fold_t (a int, b text) distributed by (a);
+insert into const_fold_t values (1, 'one'), (2, 'two'), (3, NULL);
+
+-- Built-in functions. Strict ones are not called on NULL input.
+select int4pl(1, NULL) is null as strict_null;
+select array_append(NULL::int[], 1) as nonstrict_null;
+select a from const_fold_t where a = 1 + 1;
+select a from const_fold_t where b = 't' || 'wo';
+select a from const_fold_t where a = int4pl(NULL, 1);
+select a from const_fold_t where a = any(array_append(array[1], 3)) order by a;
+
+-- SQL and PL/pgSQL functions
+create function const_fold_sql_coalesce(int) returns int as
+  'select coalesce($1, -1)' language sql immutable;
+create function const_fold_sql_plus(int, int) returns int as
+  'select $1 + $2' language sql immutable strict;
+create function const_fold_plpgsql(int) returns int as $$
+begin
+	raise notice 'const_fold_plpgsql(%)', $1;
+	return coalesce($1, 0) + 1;
+end;
+$$ language plpgsql immutable;
+
+select const_fold_sql_coalesce(NULL);
+select const_fold_sql_plus(1, NULL) is null as strict_null;
+select a from const_fold_t where a = const_fold_sql_plus(1, 2);
+-- folded once, when the query is planned, rather than once per row
+select a from const_fold_t where a = const_fold_plpgsql(1);
+select a from const_fold_t where a = const_fold_plpgsql(NULL);
+
+-- The execute privilege is checked when folding, like in the executor
+create role const_fold_role;
+revoke execute on function const_fold_sql_plus(int, int) from public;
+set role const_fold_role;
+select const_fold_sql_plus(1, 2);
+reset role;
+drop role const_fold_role;
+
+drop function const_fold_sql_coalesce(int);
+drop function const_fold_sql_plus(int, int);
+drop function const_fold_plpgsql(int);
+drop table const_fold_t;
@@ -199,6 +199,52 @@ SELECT SUM(length(long_tval)) AS sum_len_tval
           FROM small_table ORDER BY dkey LIMIT 20) foo
             JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
 
+-- Redistribute all tuples with batched sends and receives
+SET gp_interconnect_batch_size TO 16;
+SELECT SUM(length(long_tval)) AS sum_len_tval
+  FROM (SELECT jkey, repeat(tval, 20000) AS long_tval
+          FROM small_table ORDER BY dkey LIMIT 20) foo
+            JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
+RESET gp_interconnect_batch_size;
+
+-- Redistribute all tuples with the other congestion control algorithms
+SET gp_interconnect_congestion_control TO cubic;
+SELECT SUM(length(long_tval)) AS sum_len_tval
+  FROM (SELECT jkey, repeat(tval, 20000) AS long_tval
+          FROM small_table ORDER BY dkey LIMIT 20) foo
+            JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
+SET gp_interconnect_congestion_control TO paced;
+SELECT SUM(length(long_tval)) AS sum_len_tval
+  FROM (SELECT jkey, repeat(tval, 20000) AS long_tval
+          FROM small_table ORDER BY dkey LIMIT 20) foo
+            JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
+SET gp_interconnect_congestion_control TO vegas; -- ERROR
+RESET gp_interconnect_congestion_control;
+RESET gp_interconnect_snd_queue_depth;
+RESET gp_interconnect_queue_depth;
+
+-- Redistribute all tuples through shared memory between segments on the same host
+SET gp_interconnect_type TO udpifc_shm;
+CREATE TEMP TABLE ic_shm_before AS
+  SELECT SUM(gp_interconnect_shm_packets()) AS n FROM gp_dist_random('gp_id') DISTRIBUTED RANDOMLY;
+SELECT SUM(length(long_tval)) AS sum_len_tval
+  FROM (SELECT jkey, repeat(tval, 20000) AS long_tval
+          FROM small_table ORDER BY dkey LIMIT 20) foo
+            JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
+-- The segments are all on this host, so the packets between them went through shared memory
+SELECT a.n > b.n AS used_shm
+  FROM (SELECT SUM(gp_interconnect_shm_packets()) AS n FROM gp_dist_random('gp_id')) a, ic_shm_before b;
+RESET gp_interconnect_type;
+DROP TABLE ic_shm_before;
+
+-- Redistribute all tuples forming them straight from the received packets
+SET gp_interconnect_coalesce_recv TO on;
+SELECT SUM(length(long_tval)) AS sum_len_tval
+  FROM (SELECT jkey, repeat(tval, 20000) AS long_tval
+          FROM small_table ORDER BY dkey LIMIT 20) foo
+            JOIN (SELECT * FROM small_table ORDER BY dkey LIMIT 100) bar USING(jkey);
+RESET gp_interconnect_coalesce_recv;
+
 -- Paramter range
 SET gp_interconnect_snd_queue_depth TO -1; -- ERROR
 SET gp_interconnect_snd_queue_depth TO 0; -- ERROR
@@ -206,10 +252,8 @@ SET gp_interconnect_snd_queue_depth TO 4097; -- ERROR
 SET gp_interconnect_queue_depth TO -1; -- ERROR
 SET gp_interconnect_queue_depth TO 0; -- ERROR
 SET gp_interconnect_queue_depth TO 4097; -- ERROR
-
--- Reset parameters
-RESET gp_interconnect_snd_queue_depth;
-RESET gp_interconnect_queue_depth;
+SET gp_interconnect_batch_size TO 0; -- ERROR
+SET gp_interconnect_batch_size TO 65; -- ERROR
 
 -- Lots of connections
 CREATE FUNCTION icudp_history_test() RETURNS void LANGUAGE plpgsql READS SQL DATA AS $$
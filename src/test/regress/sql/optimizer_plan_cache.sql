@@ -0,0 +1,64 @@
+--
+-- Tests for the cache of plans produced by ORCA (optimizer_plan_cache_size)
+--
+
+-- Returns true if EXPLAIN reports that the plan of the query came from the
+-- cache.
+create or replace function plan_cache_hit(query text) returns bool as
+$$
+declare
+	r record;
+begin
+	for r in execute 'explain ' || query loop
+		if r."QUERY PLAN" = 'Optimizer plan cache: hit' then
+			return true;
+		end if;
+	end loop;
+	return false;
+end;
+$$
+language plpgsql;
+
+set optimizer = on;
+set optimizer_plan_cache_size = 10;
+
+create table plancache_t (a int, b int) distributed by (a);
+insert into plancache_t select i, i % 10 from generate_series(1, 100) i;
+
+-- The first EXPLAIN optimizes the query, the second one reuses the plan.
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+
+-- Updating the statistics of a table invalidates the plans that use it.
+analyze plancache_t;
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+
+-- So does DDL on it.
+create index plancache_t_b on plancache_t (b);
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+alter table plancache_t add column c int;
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+
+-- Changing a setting invalidates all plans.
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+set optimizer_plan_cache_size = 20;
+select plan_cache_hit('select a, b from plancache_t where b = 1');
+
+-- CREATE TABLE AS statements that differ only in their distribution must
+-- not share a plan.
+select plan_cache_hit('create table plancache_ctas as select a, b from plancache_t distributed by (a)');
+select plan_cache_hit('create table plancache_ctas as select a, b from plancache_t distributed by (b)');
+select plan_cache_hit('create table plancache_ctas as select a, b from plancache_t distributed by (b)');
+select plan_cache_hit('create table plancache_ctas as select a, b from plancache_t distributed randomly');
+
+create table plancache_ctas as select a, b from plancache_t distributed by (b);
+select localoid::regclass, attrnums from gp_distribution_policy where localoid = 'plancache_ctas'::regclass;
+
+drop table plancache_ctas;
+drop table plancache_t;
+drop function plan_cache_hit(text);
+reset optimizer_plan_cache_size;
+reset optimizer;
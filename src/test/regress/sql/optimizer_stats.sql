@@ -0,0 +1,20 @@
+--
+-- Tests for gp_opt_stats(), the per-phase statistics of the last query
+-- optimized by ORCA
+--
+create table optstats_t (a int, b int) distributed by (a);
+insert into optstats_t select i, i % 10 from generate_series(1, 100) i;
+
+set optimizer = on;
+select count(*) from optstats_t where b > 5;
+
+-- Read the statistics with the planner, so that they are not replaced by
+-- those of this query. Only the metadata phase counts cache hits and misses,
+-- and the new table has to be translated from the catalog.
+set optimizer = off;
+select phase, time_ms >= 0 as time_ok, memory_kb > 0 as memory_ok,
+       shared_cache_hits >= 0 as hits_ok, cache_misses > 0 as misses_ok
+  from gp_opt_stats();
+
+drop table optstats_t;
+reset optimizer;
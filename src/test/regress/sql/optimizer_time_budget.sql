@@ -0,0 +1,54 @@
+--
+-- Tests for optimizer_time_budget, which ends the ORCA search when the budget
+-- runs out and uses the best plan found so far
+--
+create table optbudget_t (a int, b int) distributed by (a);
+insert into optbudget_t select i, i % 10 from generate_series(1, 100) i;
+analyze optbudget_t;
+
+-- Who planned the query, and whether EXPLAIN reports the budget as exceeded
+create function optbudget_explain(query text) returns setof text as $$
+declare
+	line text;
+begin
+	for line in execute 'explain ' || query loop
+		if line like 'Optimizer status:%' then
+			return next case when line like '%legacy%' then 'planner' else 'orca' end;
+		elsif line like 'Optimizer time budget exceeded%' then
+			return next line;
+		end if;
+	end loop;
+	return;
+end;
+$$ language plpgsql;
+
+set optimizer = on;
+set optimizer_explain_show_status = on;
+
+-- No budget by default
+select * from optbudget_explain('select count(*) from optbudget_t t1
+  join optbudget_t t2 on t1.a = t2.b join optbudget_t t3 on t2.a = t3.b
+  join optbudget_t t4 on t3.a = t4.b join optbudget_t t5 on t4.a = t5.b');
+select count(*) from optbudget_t t1
+  join optbudget_t t2 on t1.a = t2.b join optbudget_t t3 on t2.a = t3.b
+  join optbudget_t t4 on t3.a = t4.b join optbudget_t t5 on t4.a = t5.b;
+
+-- A budget the search can't finish in. ORCA still plans the query, and the
+-- plan gives the same result.
+set optimizer_time_budget = 1;
+select * from optbudget_explain('select count(*) from optbudget_t t1
+  join optbudget_t t2 on t1.a = t2.b join optbudget_t t3 on t2.a = t3.b
+  join optbudget_t t4 on t3.a = t4.b join optbudget_t t5 on t4.a = t5.b');
+select count(*) from optbudget_t t1
+  join optbudget_t t2 on t1.a = t2.b join optbudget_t t3 on t2.a = t3.b
+  join optbudget_t t4 on t3.a = t4.b join optbudget_t t5 on t4.a = t5.b;
+
+-- A budget that is not used up
+set optimizer_time_budget = '1h';
+select * from optbudget_explain('select count(*) from optbudget_t where b = 1');
+
+drop function optbudget_explain(text);
+drop table optbudget_t;
+reset optimizer_time_budget;
+reset optimizer_explain_show_status;
+reset optimizer;
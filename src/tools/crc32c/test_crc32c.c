@@ -0,0 +1,141 @@
+/*
+ *	test_crc32c.c
+ *		measure the per-packet cost of the CRC-32C implementations
+ *
+ * The UDP interconnect checksums every packet with CRC-32C when
+ * gp_interconnect_full_crc is on. This program times the implementations
+ * that can be used on this machine, for a packet of a given size.
+ */
+
+#include "c.h"
+
+#include "port/pg_crc32c.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define DEFAULT_PACKET_SIZE	8192	/* default of gp_max_packet_size */
+#define DEFAULT_LOOPS		100000
+
+typedef pg_crc32c (*crc32c_func) (pg_crc32c crc, const void *data, size_t len);
+
+static void die(const char *str);
+static pg_crc32c test_one(const char *name, crc32c_func func, const char *buf,
+		 size_t len, int loops);
+
+int
+main(int argc, char *argv[])
+{
+	int			len = DEFAULT_PACKET_SIZE;
+	int			loops = DEFAULT_LOOPS;
+	char	   *buf;
+	int			i;
+	pg_crc32c	crc;
+	const char *chosen = "slicing-by-8";
+	pg_crc32c	crc_sb8 = 0;
+	pg_crc32c	crc_sse42 = 0;
+	bool		have_sb8 = false;
+	bool		have_sse42 = false;
+
+	if (argc > 2 && strcmp(argv[1], "-s") == 0)
+	{
+		len = atoi(argv[2]);
+		argv += 2;
+		argc -= 2;
+	}
+
+	if (argc > 1)
+		loops = atoi(argv[1]);
+
+	if (len <= 0 || loops <= 0)
+		die("packet size and loops must be positive");
+
+	buf = (char *) malloc(len);
+	if (buf == NULL)
+		die("out of memory");
+
+	/* some data that is not all the same byte */
+	for (i = 0; i < len; i++)
+		buf[i] = (char) (i * 31 + 7);
+
+	/* the first computation makes the runtime choice */
+	INIT_CRC32C(crc);
+	COMP_CRC32C(crc, buf, len);
+	FIN_CRC32C(crc);
+
+#if defined(USE_SSE42_CRC32C)
+	chosen = "SSE 4.2";
+	have_sse42 = true;
+#elif defined(USE_SSE42_CRC32C_WITH_RUNTIME_CHECK)
+	have_sb8 = true;
+	if (pg_comp_crc32c == pg_comp_crc32c_sse42)
+	{
+		chosen = "SSE 4.2 (runtime check)";
+		have_sse42 = true;
+	}
+	else
+		chosen = "slicing-by-8 (no SSE 4.2 at runtime)";
+#else
+	have_sb8 = true;
+#endif
+
+	printf("Packet size %d bytes, %d loops\n", len, loops);
+	printf("Implementation chosen by the server: %s\n\n", chosen);
+	printf("%-16s %14s %12s\n", "implementation", "ns/packet", "MB/s");
+
+#if !defined(USE_SSE42_CRC32C)
+	crc_sb8 = test_one("slicing-by-8", pg_comp_crc32c_sb8, buf, len, loops);
+#endif
+#if defined(USE_SSE42_CRC32C) || defined(USE_SSE42_CRC32C_WITH_RUNTIME_CHECK)
+	if (have_sse42)
+		crc_sse42 = test_one("SSE 4.2", pg_comp_crc32c_sse42, buf, len, loops);
+#endif
+
+	if (have_sb8 && have_sse42 && crc_sb8 != crc_sse42)
+		die("the implementations disagree");
+
+	free(buf);
+	return 0;
+}
+
+/*
+ * Time loops computations of the CRC of buf, and print the cost per packet.
+ * Returns the CRC.
+ */
+static pg_crc32c
+test_one(const char *name, crc32c_func func, const char *buf, size_t len,
+		 int loops)
+{
+	struct timeval start_t;
+	struct timeval stop_t;
+	double		usecs;
+	pg_crc32c	crc = 0;
+	int			i;
+
+	gettimeofday(&start_t, NULL);
+	for (i = 0; i < loops; i++)
+	{
+		crc = 0xFFFFFFFF;
+		crc = func(crc, buf, len);
+		crc ^= 0xFFFFFFFF;
+	}
+	gettimeofday(&stop_t, NULL);
+
+	usecs = (stop_t.tv_sec - start_t.tv_sec) * 1000000.0 +
+		(stop_t.tv_usec - start_t.tv_usec);
+
+	printf("%-16s %14.1f %12.1f\n", name,
+		   usecs * 1000 / loops,
+		   usecs > 0 ? (double) len * loops / usecs : 0);
+
+	return crc;
+}
+
+static void
+die(const char *str)
+{
+	fprintf(stderr, "%s\n", str);
+	exit(1);
+}